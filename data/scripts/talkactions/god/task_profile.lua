@@ -0,0 +1,24 @@
+local taskProfile = TalkAction("/taskprofile")
+
+function taskProfile.onSay(player, words, param)
+	-- create log
+	logCommand(player, words, param)
+
+	local count = tonumber(param) or 10
+	local profiles = Game.getTaskProfile(count)
+	if #profiles == 0 then
+		player:sendTextMessage(MESSAGE_ADMINISTRATOR, "No task profile available, the server must be built with metrics enabled.")
+		return true
+	end
+
+	local text = "Slowest dispatcher tasks (total / avg / max / avg wait, in microseconds):"
+	for index, profile in ipairs(profiles) do
+		text = string.format("%s\n%d. %s: %d calls, %d / %d / %d / %d", text, index, profile.name, profile.executions, profile.totalTime, profile.averageTime, profile.maxTime, profile.averageWait)
+	end
+	player:showTextDialog(2160, text)
+	return true
+end
+
+taskProfile:separator(" ")
+taskProfile:groupType("god")
+taskProfile:register()
@@ -306,7 +306,7 @@ void CanaryServer::initializeDatabase() {
 	if (!Database::getInstance().connect()) {
 		throw FailedToInitializeCanary("Failed to connect to database!");
 	}
-	logger.debug("MySQL Version: {}", Database::getClientVersion());
+	logger.debug("MySQL Version: {}, connection pool of {}", Database::getClientVersion(), Database::getInstance().getPoolSize());
 
 	logger.debug("Running database manager...");
 	if (!DatabaseManager::isDatabaseSetup()) {
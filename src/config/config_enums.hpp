@@ -167,8 +167,10 @@ enum ConfigKey_t : uint16_t {
 	MYSQL_DB,
 	MYSQL_HOST,
 	MYSQL_PASS,
+	MYSQL_POOL_SIZE,
 	MYSQL_SOCK,
 	MYSQL_USER,
+	NETWORK_THREADS,
 	OLD_PROTOCOL,
 	ONE_PLAYER_ON_ACCOUNT,
 	ONLY_INVITED_CAN_MOVE_HOUSE_ITEMS,
@@ -180,6 +182,8 @@ enum ConfigKey_t : uint16_t {
 	ORANGE_SKULL_DURATION,
 	OWNER_EMAIL,
 	OWNER_NAME,
+	PACKET_COMPRESSION_DICTIONARY,
+	PACKET_COMPRESSION_STREAMING,
 	PARALLELISM,
 	PARTY_AUTO_SHARE_EXPERIENCE,
 	PARTY_SHARE_RANGE_MULTIPLIER,
@@ -293,6 +297,7 @@ enum ConfigKey_t : uint16_t {
 	TOGGLE_MAINTAIN_MODE,
 	TOGGLE_MAP_CUSTOM,
 	TOGGLE_MOUNT_IN_PZ,
+	TOGGLE_PARALLEL_CREATURE_THINK,
 	TOGGLE_RECEIVE_REWARD,
 	TOGGLE_SAVE_ASYNC,
 	TOGGLE_SAVE_INTERVAL_CLEAN_MAP,
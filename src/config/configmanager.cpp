@@ -19,6 +19,21 @@
 	#define lua_strlen lua_rawlen
 #endif
 
+// Keys are declared without explicit values, so they go from 0 to the count minus one
+constexpr size_t CONFIG_KEYS_COUNT = magic_enum::enum_count<ConfigKey_t>();
+static_assert(magic_enum::enum_integer(magic_enum::enum_values<ConfigKey_t>().back()) + 1 == CONFIG_KEYS_COUNT);
+
+ConfigSnapshot::ConfigSnapshot() :
+	values(CONFIG_KEYS_COUNT) { }
+
+void ConfigSnapshot::invalidAccess(const char* function, const ConfigKey_t &key, const std::source_location &location) {
+	g_logger().warn("[{}] accessing invalid or wrong type index: {}[{}]. Called line: {}:{}, in {}", function, magic_enum::enum_name(key), fmt::underlying(key), location.line(), location.column(), location.function_name());
+}
+
+ConfigManager::ConfigManager() {
+	snapshot.store(snapshots.emplace_back(std::make_unique<const ConfigSnapshot>()).get(), std::memory_order_release);
+}
+
 ConfigManager &ConfigManager::getInstance() {
 	return inject<ConfigManager>();
 }
@@ -37,6 +52,10 @@ bool ConfigManager::load() {
 		return false;
 	}
 
+	// Starts from the current values, those loaded one time only carry over
+	auto next = std::make_unique<ConfigSnapshot>(getSnapshot());
+	pending = next.get();
+
 	// Parse config
 	// Info that must be loaded one time (unless we reset the modules involved)
 	if (!loaded) {
@@ -58,6 +77,7 @@ bool ConfigManager::load() {
 		loadIntConfig(L, LOGIN_PORT, "loginProtocolPort", 7171);
 		loadIntConfig(L, MARKET_OFFER_DURATION, "marketOfferDuration", 30 * 24 * 60 * 60);
 		loadIntConfig(L, MARKET_REFRESH_PRICES, "marketRefreshPricesInterval", 30);
+		loadIntConfig(L, MYSQL_POOL_SIZE, "mysqlPoolSize", 4);
 		loadIntConfig(L, PREMIUM_DEPOT_LIMIT, "premiumDepotLimit", 8000);
 		loadIntConfig(L, SQL_PORT, "mysqlPort", 3306);
 		loadIntConfig(L, STASH_ITEMS, "stashItemCount", 5000);
@@ -106,6 +126,8 @@ bool ConfigManager::load() {
 	loadBoolConfig(L, METRICS_ENABLE_PROMETHEUS, "metricsEnablePrometheus", false);
 	loadBoolConfig(L, ONLY_INVITED_CAN_MOVE_HOUSE_ITEMS, "onlyInvitedCanMoveHouseItems", true);
 	loadBoolConfig(L, ONLY_PREMIUM_ACCOUNT, "onlyPremiumAccount", false);
+	loadBoolConfig(L, PACKET_COMPRESSION_DICTIONARY, "packetCompressionDictionary", false);
+	loadBoolConfig(L, PACKET_COMPRESSION_STREAMING, "packetCompressionStreaming", false);
 	loadBoolConfig(L, PARTY_AUTO_SHARE_EXPERIENCE, "partyAutoShareExperience", true);
 	loadBoolConfig(L, PARTY_SHARE_LOOT_BOOSTS, "partyShareLootBoosts", true);
 	loadBoolConfig(L, PREY_ENABLED, "preySystemEnabled", true);
@@ -143,6 +165,7 @@ bool ConfigManager::load() {
 	loadBoolConfig(L, TOGGLE_IMBUEMENT_NON_AGGRESSIVE_FIGHT_ONLY, "toggleImbuementNonAggressiveFightOnly", false);
 	loadBoolConfig(L, TOGGLE_IMBUEMENT_SHRINE_STORAGE, "toggleImbuementShrineStorage", true);
 	loadBoolConfig(L, TOGGLE_MOUNT_IN_PZ, "toggleMountInProtectionZone", false);
+	loadBoolConfig(L, TOGGLE_PARALLEL_CREATURE_THINK, "toggleParallelCreatureThink", false);
 	loadBoolConfig(L, TOGGLE_RECEIVE_REWARD, "toggleReceiveReward", false);
 	loadBoolConfig(L, TOGGLE_SAVE_ASYNC, "toggleSaveAsync", false);
 	loadBoolConfig(L, TOGGLE_SAVE_INTERVAL_CLEAN_MAP, "toggleSaveIntervalCleanMap", false);
@@ -283,6 +306,7 @@ bool ConfigManager::load() {
 	loadIntConfig(L, MIN_TOWN_ID_TO_BANK_TRANSFER_FROM_MAIN, "minTownIdToBankTransferFromMain", 4);
 	loadIntConfig(L, MONTH_KILLS_TO_RED, "monthKillsToRedSkull", 10);
 	loadIntConfig(L, MULTIPLIER_ATTACKONFIST, "multiplierSpeedOnFist", 5);
+	loadIntConfig(L, NETWORK_THREADS, "networkThreads", 0);
 	loadIntConfig(L, ORANGE_SKULL_DURATION, "orangeSkullDuration", 7);
 	loadIntConfig(L, PARALLELISM, "parallelism", 2);
 	loadIntConfig(L, PARTY_LIST_MAX_DISTANCE, "partyListMaxDistance", 0);
@@ -365,6 +389,10 @@ bool ConfigManager::load() {
 
 	loaded = true;
 	lua_close(L);
+
+	pending = nullptr;
+	snapshot.store(next.get(), std::memory_order_release);
+	snapshots.emplace_back(std::move(next));
 	return true;
 }
 
@@ -388,7 +416,7 @@ std::string ConfigManager::loadStringConfig(lua_State* L, const ConfigKey_t &key
 	} else {
 		missingConfigWarning(identifier);
 	}
-	configs[key] = value;
+	pending->values[key] = value;
 	lua_pop(L, 1);
 	return value;
 }
@@ -401,7 +429,7 @@ int32_t ConfigManager::loadIntConfig(lua_State* L, const ConfigKey_t &key, const
 	} else {
 		missingConfigWarning(identifier);
 	}
-	configs[key] = value;
+	pending->values[key] = value;
 	lua_pop(L, 1);
 	return value;
 }
@@ -414,7 +442,7 @@ bool ConfigManager::loadBoolConfig(lua_State* L, const ConfigKey_t &key, const c
 	} else {
 		missingConfigWarning(identifier);
 	}
-	configs[key] = value;
+	pending->values[key] = value;
 	lua_pop(L, 1);
 	return value;
 }
@@ -427,40 +455,7 @@ float ConfigManager::loadFloatConfig(lua_State* L, const ConfigKey_t &key, const
 	} else {
 		missingConfigWarning(identifier);
 	}
-	configs[key] = value;
+	pending->values[key] = value;
 	lua_pop(L, 1);
 	return value;
 }
-
-const std::string &ConfigManager::getString(const ConfigKey_t &key, const std::source_location &location /*= std::source_location::current()*/) const {
-	static const std::string dummyStr;
-	if (configs.contains(key) && std::holds_alternative<std::string>(configs.at(key))) {
-		return std::get<std::string>(configs.at(key));
-	}
-	g_logger().warn("[{}] accessing invalid or wrong type index: {}[{}]. Called line: {}:{}, in {}", __FUNCTION__, magic_enum::enum_name(key), fmt::underlying(key), location.line(), location.column(), location.function_name());
-	return dummyStr;
-}
-
-int32_t ConfigManager::getNumber(const ConfigKey_t &key, const std::source_location &location /*= std::source_location::current()*/) const {
-	if (configs.contains(key) && std::holds_alternative<int32_t>(configs.at(key))) {
-		return std::get<int32_t>(configs.at(key));
-	}
-	g_logger().warn("[{}] accessing invalid or wrong type index: {}[{}]. Called line: {}:{}, in {}", __FUNCTION__, magic_enum::enum_name(key), fmt::underlying(key), location.line(), location.column(), location.function_name());
-	return 0;
-}
-
-bool ConfigManager::getBoolean(const ConfigKey_t &key, const std::source_location &location /*= std::source_location::current()*/) const {
-	if (configs.contains(key) && std::holds_alternative<bool>(configs.at(key))) {
-		return std::get<bool>(configs.at(key));
-	}
-	g_logger().warn("[{}] accessing invalid or wrong type index: {}[{}]. Called line: {}:{}, in {}", __FUNCTION__, magic_enum::enum_name(key), fmt::underlying(key), location.line(), location.column(), location.function_name());
-	return false;
-}
-
-float ConfigManager::getFloat(const ConfigKey_t &key, const std::source_location &location /*= std::source_location::current()*/) const {
-	if (configs.contains(key) && std::holds_alternative<float>(configs.at(key))) {
-		return std::get<float>(configs.at(key));
-	}
-	g_logger().warn("[{}] accessing invalid or wrong type index: {}[{}]. Called line: {}:{}, in {}", __FUNCTION__, magic_enum::enum_name(key), fmt::underlying(key), location.line(), location.column(), location.function_name());
-	return 0.0f;
-}
@@ -11,11 +11,68 @@
 
 #include "config_enums.hpp"
 
-using ConfigValue = std::variant<std::string, int32_t, bool, float>;
+// std::monostate: the key was never loaded
+using ConfigValue = std::variant<std::monostate, std::string, int32_t, bool, float>;
+
+/**
+ * Immutable set of configuration values, a flat array indexed by ConfigKey_t.
+ * Every load publishes a new snapshot and snapshots are never freed, so a reference
+ * to one (or to a string in it) stays valid and consistent for as long as the server runs.
+ * Hot paths can take one with g_configManager().getSnapshot() and read from it for a whole tick.
+ */
+class ConfigSnapshot {
+public:
+	ConfigSnapshot();
+
+	[[nodiscard]] const std::string &getString(const ConfigKey_t &key, const std::source_location &location = std::source_location::current()) const {
+		if (const auto* value = find<std::string>(key)) {
+			return *value;
+		}
+		static const std::string dummyStr;
+		invalidAccess("getString", key, location);
+		return dummyStr;
+	}
+
+	[[nodiscard]] int32_t getNumber(const ConfigKey_t &key, const std::source_location &location = std::source_location::current()) const {
+		if (const auto* value = find<int32_t>(key)) {
+			return *value;
+		}
+		invalidAccess("getNumber", key, location);
+		return 0;
+	}
+
+	[[nodiscard]] bool getBoolean(const ConfigKey_t &key, const std::source_location &location = std::source_location::current()) const {
+		if (const auto* value = find<bool>(key)) {
+			return *value;
+		}
+		invalidAccess("getBoolean", key, location);
+		return false;
+	}
+
+	[[nodiscard]] float getFloat(const ConfigKey_t &key, const std::source_location &location = std::source_location::current()) const {
+		if (const auto* value = find<float>(key)) {
+			return *value;
+		}
+		invalidAccess("getFloat", key, location);
+		return 0.0f;
+	}
+
+private:
+	template <typename T>
+	const T* find(const ConfigKey_t &key) const {
+		return key < values.size() ? std::get_if<T>(&values[key]) : nullptr;
+	}
+
+	static void invalidAccess(const char* function, const ConfigKey_t &key, const std::source_location &location);
+
+	std::vector<ConfigValue> values;
+
+	friend class ConfigManager;
+};
 
 class ConfigManager {
 public:
-	ConfigManager() = default;
+	ConfigManager();
 
 	// Singleton - ensures we don't accidentally copy it
 	ConfigManager(const ConfigManager &) = delete;
@@ -36,13 +93,33 @@ public:
 		return configFileLua;
 	};
 
-	[[nodiscard]] const std::string &getString(const ConfigKey_t &key, const std::source_location &location = std::source_location::current()) const;
-	[[nodiscard]] int32_t getNumber(const ConfigKey_t &key, const std::source_location &location = std::source_location::current()) const;
-	[[nodiscard]] bool getBoolean(const ConfigKey_t &key, const std::source_location &location = std::source_location::current()) const;
-	[[nodiscard]] float getFloat(const ConfigKey_t &key, const std::source_location &location = std::source_location::current()) const;
+	/**
+	 * Values of the last completed load, safe to read from any thread without locking.
+	 */
+	[[nodiscard]] const ConfigSnapshot &getSnapshot() const {
+		return *snapshot.load(std::memory_order_acquire);
+	}
+
+	[[nodiscard]] const std::string &getString(const ConfigKey_t &key, const std::source_location &location = std::source_location::current()) const {
+		return getSnapshot().getString(key, location);
+	}
+	[[nodiscard]] int32_t getNumber(const ConfigKey_t &key, const std::source_location &location = std::source_location::current()) const {
+		return getSnapshot().getNumber(key, location);
+	}
+	[[nodiscard]] bool getBoolean(const ConfigKey_t &key, const std::source_location &location = std::source_location::current()) const {
+		return getSnapshot().getBoolean(key, location);
+	}
+	[[nodiscard]] float getFloat(const ConfigKey_t &key, const std::source_location &location = std::source_location::current()) const {
+		return getSnapshot().getFloat(key, location);
+	}
 
 private:
-	phmap::flat_hash_map<ConfigKey_t, ConfigValue> configs;
+	// Published snapshot and every one before it, reloads are rare and readers may still hold the old ones
+	std::atomic<const ConfigSnapshot*> snapshot;
+	std::vector<std::unique_ptr<const ConfigSnapshot>> snapshots;
+	// Filled by the load in progress, published once it is complete
+	ConfigSnapshot* pending = nullptr;
+
 	std::string loadStringConfig(lua_State* L, const ConfigKey_t &key, const char* identifier, const std::string &defaultValue);
 	int32_t loadIntConfig(lua_State* L, const ConfigKey_t &key, const char* identifier, const int32_t &defaultValue);
 	bool loadBoolConfig(lua_State* L, const ConfigKey_t &key, const char* identifier, const bool &defaultValue);
@@ -917,7 +917,9 @@ void Creature::goToFollowCreature() {
 	}
 
 	if (listDir.empty()) {
-		hasFollowPath = getPathTo(followCreature->getPosition(), listDir, fpp);
+		// Monsters chasing the same target share one search
+		const auto sharedPath = monster ? g_game().map.getSharedFollowPath(monster, followCreature->getPosition(), listDir, fpp) : std::nullopt;
+		hasFollowPath = sharedPath ? *sharedPath : getPathTo(followCreature->getPosition(), listDir, fpp);
 	}
 
 	startAutoWalk(listDir);
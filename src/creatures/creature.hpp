@@ -482,6 +482,11 @@ public:
 	void setCreatureLight(LightInfo lightInfo);
 
 	virtual void onThink(uint32_t interval);
+	/**
+	 * Read-only part of onThink, run for many creatures in parallel right before they think.
+	 * It must not change any game state, what it computes is only a hint for the next onThink.
+	 */
+	virtual void prepareThink(uint32_t /*interval*/) { }
 	void onAttacking(uint32_t interval);
 	virtual void onCreatureWalk();
 	virtual bool getNextStep(Direction &dir, uint32_t &flags);
@@ -729,7 +734,7 @@ protected:
 	uint64_t lastStep = 0;
 	uint32_t id = 0;
 	uint32_t scriptEventsBitField = 0;
-	uint32_t eventWalk = 0;
+	uint64_t eventWalk = 0;
 	uint32_t walkUpdateTicks = 0;
 	uint32_t lastHitCreatureId = 0;
 	uint32_t blockCount = 0;
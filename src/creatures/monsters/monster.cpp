@@ -572,6 +572,7 @@ bool Monster::addTarget(const std::shared_ptr<Creature> &creature, bool pushFron
 	} else {
 		targetList.emplace_back(creature);
 	}
+	++targetListVersion;
 
 	const auto &master = getMaster();
 	if (!master && getFaction() != FACTION_DEFAULT && creature->getPlayer()) {
@@ -597,6 +598,7 @@ bool Monster::removeTarget(const std::shared_ptr<Creature> &creature) {
 	}
 
 	targetList.erase(it);
+	++targetListVersion;
 
 	return true;
 }
@@ -612,10 +614,13 @@ void Monster::updateTargetList() {
 		return !target || target->getHealth() <= 0 || !canSee(target->getPosition());
 	});
 
-	std::erase_if(targetList, [this](const std::weak_ptr<Creature> &ref) {
+	const auto removedTargets = std::erase_if(targetList, [this](const std::weak_ptr<Creature> &ref) {
 		const auto &target = ref.lock();
 		return !target || target->getHealth() <= 0 || !canSee(target->getPosition());
 	});
+	if (removedTargets > 0) {
+		++targetListVersion;
+	}
 
 	for (const auto &spectator : Spectators().find<Creature>(position, true, 0, 0, 0, 0, false)) {
 		if (spectator.get() != this && canSee(spectator->getPosition())) {
@@ -626,6 +631,7 @@ void Monster::updateTargetList() {
 
 void Monster::clearTargetList() {
 	targetList.clear();
+	++targetListVersion;
 }
 
 void Monster::clearFriendList() {
@@ -743,13 +749,28 @@ bool Monster::searchTarget(TargetSearchType_t searchType /*= TARGETSEARCH_DEFAUL
 	std::vector<std::shared_ptr<Creature>> resultList;
 	const Position &myPos = getPosition();
 
-	for (const auto &cref : targetList) {
-		const auto &creature = cref.lock();
-		if (creature && isTarget(creature)) {
-			if ((static_self_cast<Monster>()->targetDistance == 1) || canUseAttack(myPos, creature)) {
+	// Reuses the sight lines checked by prepareThink, unless the monster or its target list changed since then,
+	// the line of a target that moved meanwhile is checked again
+	if (hasPreparedTargets && preparedPosition == myPos && preparedTargetListVersion == targetListVersion) {
+		for (const auto &[cref, position, attackable] : preparedTargets) {
+			const auto &creature = cref.lock();
+			if (!creature || !isTarget(creature)) {
+				continue;
+			}
+
+			if (targetDistance == 1 || (creature->getPosition() == position ? attackable : canUseAttack(myPos, creature))) {
 				resultList.emplace_back(creature);
 			}
 		}
+	} else {
+		for (const auto &cref : targetList) {
+			const auto &creature = cref.lock();
+			if (creature && isTarget(creature)) {
+				if (targetDistance == 1 || canUseAttack(myPos, creature)) {
+					resultList.emplace_back(creature);
+				}
+			}
+		}
 	}
 
 	if (resultList.empty()) {
@@ -1022,7 +1043,34 @@ void Monster::onEndCondition(ConditionType_t type) {
 	onConditionStatusChange(type);
 }
 
+void Monster::prepareThink(uint32_t) {
+	if (isIdle || isSummon() || targetList.empty()) {
+		return;
+	}
+
+	const Position &myPos = getPosition();
+	preparedTargets.clear();
+	for (const auto &cref : targetList) {
+		const auto &creature = cref.lock();
+		if (creature && isTarget(creature)) {
+			// The sight line checks are what makes target searching expensive
+			preparedTargets.emplace_back(PreparedTarget { creature, creature->getPosition(), canUseAttack(myPos, creature) });
+		}
+	}
+
+	preparedPosition = myPos;
+	preparedTargetListVersion = targetListVersion;
+	hasPreparedTargets = true;
+}
+
 void Monster::onThink(uint32_t interval) {
+	doThink(interval);
+
+	hasPreparedTargets = false;
+	preparedTargets.clear();
+}
+
+void Monster::doThink(uint32_t interval) {
 	Creature::onThink(interval);
 
 	if (mType->info.thinkEvent != -1) {
@@ -99,6 +99,7 @@ public:
 	void onFollowCreatureComplete(const std::shared_ptr<Creature> &creature) override;
 
 	void onThink(uint32_t interval) override;
+	void prepareThink(uint32_t interval) override;
 
 	bool challengeCreature(const std::shared_ptr<Creature> &creature, int targetChangeCooldown) override;
 
@@ -120,7 +121,7 @@ public:
 		CreatureVector list;
 		list.reserve(targetList.size());
 
-		std::erase_if(targetList, [&list](const std::weak_ptr<Creature> &ref) {
+		const auto removedTargets = std::erase_if(targetList, [&list](const std::weak_ptr<Creature> &ref) {
 			if (const auto &creature = ref.lock()) {
 				list.emplace_back(creature);
 				return false;
@@ -128,6 +129,9 @@ public:
 
 			return true;
 		});
+		if (removedTargets > 0) {
+			++targetListVersion;
+		}
 
 		return list;
 	}
@@ -235,6 +239,21 @@ private:
 	std::unordered_map<uint32_t, std::weak_ptr<Creature>> friendList;
 	std::deque<std::weak_ptr<Creature>> targetList;
 
+	// Bumped on every change of targetList
+	uint64_t targetListVersion = 0;
+
+	// Targets evaluated by prepareThink, only valid until the end of the following onThink
+	struct PreparedTarget {
+		std::weak_ptr<Creature> creature;
+		// Where the target was when its sight line was checked
+		Position position;
+		bool attackable = false;
+	};
+	std::vector<PreparedTarget> preparedTargets;
+	Position preparedPosition;
+	uint64_t preparedTargetListVersion = 0;
+	bool hasPreparedTargets = false;
+
 	time_t timeToChangeFiendish = 0;
 
 	// Forge System
@@ -320,6 +339,7 @@ private:
 	static bool pushCreature(const std::shared_ptr<Creature> &creature);
 	static void pushCreatures(const std::shared_ptr<Tile> &tile);
 
+	void doThink(uint32_t interval);
 	void onThinkTarget(uint32_t interval);
 	void onThinkYell(uint32_t interval);
 	void onThinkDefense(uint32_t interval);
@@ -69,7 +69,7 @@ private:
 	Position centerPos;
 	int32_t radius;
 	uint32_t interval = 30000;
-	uint32_t checkSpawnMonsterEvent = 0;
+	uint64_t checkSpawnMonsterEvent = 0;
 
 	static bool findPlayer(const Position &pos);
 	bool spawnMonster(uint32_t spawnMonsterId, spawnBlock_t &sb, const std::shared_ptr<MonsterType> &monsterType, bool startup = false);
@@ -57,7 +57,7 @@ private:
 	int32_t radius;
 
 	uint32_t interval = 60000;
-	uint32_t checkSpawnNpcEvent = 0;
+	uint64_t checkSpawnNpcEvent = 0;
 
 	static bool findPlayer(const Position &pos);
 	bool spawnNpc(uint32_t spawnId, const std::shared_ptr<NpcType> &npcType, const Position &pos, Direction dir, bool startup = false);
@@ -44,6 +44,7 @@
 #include "game/scheduling/task.hpp"
 #include "grouping/familiars.hpp"
 #include "grouping/guild.hpp"
+#include "io/functions/player_save_state.hpp"
 #include "io/iobestiary.hpp"
 #include "io/iologindata.hpp"
 #include "io/ioprey.hpp"
@@ -77,6 +78,7 @@ Player::Player(std::shared_ptr<ProtocolGame> p) :
 	m_playerBadge = std::make_unique<PlayerBadge>(*this);
 	m_playerCyclopedia = std::make_unique<PlayerCyclopedia>(*this);
 	m_playerTitle = std::make_unique<PlayerTitle>(*this);
+	m_playerSaveState = std::make_shared<PlayerSaveState>();
 }
 
 Player::~Player() {
@@ -123,8 +125,8 @@ bool Player::isPushable() {
 	return Creature::isPushable();
 }
 
-std::shared_ptr<Task> Player::createPlayerTask(uint32_t delay, std::function<void(void)> f, const std::string &context) {
-	return std::make_shared<Task>(std::move(f), context, delay);
+std::shared_ptr<Task> Player::createPlayerTask(uint32_t delay, TaskFunction &&f, std::string_view context) {
+	return Task::create(std::move(f), context, delay);
 }
 
 uint32_t Player::playerFirstID = 0x10000000;
@@ -1874,6 +1876,12 @@ void Player::sendCreatureHealth(const std::shared_ptr<Creature> &creature) const
 	}
 }
 
+void Player::sendCreatureHealth(const std::shared_ptr<Creature> &creature, SharedMessageCache &shared) const {
+	if (client) {
+		client->sendCreatureHealth(creature, shared);
+	}
+}
+
 void Player::sendPartyCreatureUpdate(const std::shared_ptr<Creature> &creature) const {
 	if (client) {
 		client->sendPartyCreatureUpdate(creature);
@@ -1928,6 +1936,12 @@ void Player::sendDistanceShoot(const Position &from, const Position &to, uint16_
 	}
 }
 
+void Player::sendDistanceShoot(const Position &from, const Position &to, uint16_t type, SharedMessageCache &shared) const {
+	if (client) {
+		client->sendDistanceShoot(from, to, type, shared);
+	}
+}
+
 void Player::sendHouseWindow(const std::shared_ptr<House> &house, uint32_t listId) const {
 	if (!client) {
 		return;
@@ -2023,6 +2037,12 @@ void Player::sendMagicEffect(const Position &pos, uint16_t type) const {
 	}
 }
 
+void Player::sendMagicEffect(const Position &pos, uint16_t type, SharedMessageCache &shared) const {
+	if (client) {
+		client->sendMagicEffect(pos, type, shared);
+	}
+}
+
 void Player::removeMagicEffect(const Position &pos, uint16_t type) const {
 	if (client) {
 		client->removeMagicEffect(pos, type);
@@ -9593,12 +9613,24 @@ void Player::sendSingleSoundEffect(const Position &pos, SoundEffect_t id, Source
 	}
 }
 
+void Player::sendSingleSoundEffect(const Position &pos, SoundEffect_t id, SourceEffect_t source, SharedMessageCache &shared) const {
+	if (client) {
+		client->sendSingleSoundEffect(pos, id, source, shared);
+	}
+}
+
 void Player::sendDoubleSoundEffect(const Position &pos, SoundEffect_t mainSoundId, SourceEffect_t mainSource, SoundEffect_t secondarySoundId, SourceEffect_t secondarySource) const {
 	if (client) {
 		client->sendDoubleSoundEffect(pos, mainSoundId, mainSource, secondarySoundId, secondarySource);
 	}
 }
 
+void Player::sendDoubleSoundEffect(const Position &pos, SoundEffect_t mainSoundId, SourceEffect_t mainSource, SoundEffect_t secondarySoundId, SourceEffect_t secondarySource, SharedMessageCache &shared) const {
+	if (client) {
+		client->sendDoubleSoundEffect(pos, mainSoundId, mainSource, secondarySoundId, secondarySource, shared);
+	}
+}
+
 SoundEffect_t Player::getAttackSoundEffect() const {
 	const auto &tool = getWeapon();
 	if (tool == nullptr) {
@@ -10251,6 +10283,11 @@ const std::unique_ptr<PlayerVIP> &Player::vip() const {
 	return m_playerVIP;
 }
 
+// Save state
+const std::shared_ptr<PlayerSaveState> &Player::saveState() const {
+	return m_playerSaveState;
+}
+
 // Cyclopedia
 std::unique_ptr<PlayerCyclopedia> &Player::cyclopedia() {
 	return m_playerCyclopedia;
@@ -16,13 +16,13 @@
 #include "items/cylinder.hpp"
 #include "game/movement/position.hpp"
 #include "creatures/creatures_definitions.hpp"
+#include "game/scheduling/task.hpp"
 
 class House;
 class NetworkMessage;
 class Weapon;
 class ProtocolGame;
 class Party;
-class Task;
 class Guild;
 class Imbuement;
 class PreySlot;
@@ -34,6 +34,7 @@ class PlayerBadge;
 class PlayerCyclopedia;
 class PlayerTitle;
 class PlayerVIP;
+class PlayerSaveState;
 class Spectators;
 class Account;
 class RewardChest;
@@ -48,6 +49,7 @@ class Container;
 class KV;
 class BedItem;
 class Npc;
+class SharedMessageCache;
 
 struct ModalWindow;
 struct Achievement;
@@ -145,7 +147,7 @@ public:
 		return static_self_cast<Player>();
 	}
 
-	static std::shared_ptr<Task> createPlayerTask(uint32_t delay, std::function<void(void)> f, const std::string &context);
+	static std::shared_ptr<Task> createPlayerTask(uint32_t delay, TaskFunction &&f, std::string_view context);
 
 	void setID() override;
 
@@ -788,8 +790,10 @@ public:
 	void sendLootContainers() const;
 
 	void sendSingleSoundEffect(const Position &pos, SoundEffect_t id, SourceEffect_t source) const;
+	void sendSingleSoundEffect(const Position &pos, SoundEffect_t id, SourceEffect_t source, SharedMessageCache &shared) const;
 
 	void sendDoubleSoundEffect(const Position &pos, SoundEffect_t mainSoundId, SourceEffect_t mainSource, SoundEffect_t secondarySoundId, SourceEffect_t secondarySource) const;
+	void sendDoubleSoundEffect(const Position &pos, SoundEffect_t mainSoundId, SourceEffect_t mainSource, SoundEffect_t secondarySoundId, SourceEffect_t secondarySource, SharedMessageCache &shared) const;
 
 	SoundEffect_t getAttackSoundEffect() const;
 	SoundEffect_t getHitSoundEffect() const;
@@ -830,6 +834,7 @@ public:
 	void sendCancelWalk() const;
 	void sendChangeSpeed(const std::shared_ptr<Creature> &creature, uint16_t newSpeed) const;
 	void sendCreatureHealth(const std::shared_ptr<Creature> &creature) const;
+	void sendCreatureHealth(const std::shared_ptr<Creature> &creature, SharedMessageCache &shared) const;
 	void sendPartyCreatureUpdate(const std::shared_ptr<Creature> &creature) const;
 	void sendPartyCreatureShield(const std::shared_ptr<Creature> &creature) const;
 	void sendPartyCreatureSkull(const std::shared_ptr<Creature> &creature) const;
@@ -839,6 +844,7 @@ public:
 	void sendPartyPlayerVocation(const std::shared_ptr<Player> &player) const;
 	void sendPlayerVocation(const std::shared_ptr<Player> &player) const;
 	void sendDistanceShoot(const Position &from, const Position &to, uint16_t type) const;
+	void sendDistanceShoot(const Position &from, const Position &to, uint16_t type, SharedMessageCache &shared) const;
 	void sendHouseWindow(const std::shared_ptr<House> &house, uint32_t listId) const;
 	void sendCreatePrivateChannel(uint16_t channelId, const std::string &channelName) const;
 	void sendClosePrivate(uint16_t channelId);
@@ -849,6 +855,7 @@ public:
 	void sendClientCheck() const;
 	void sendGameNews() const;
 	void sendMagicEffect(const Position &pos, uint16_t type) const;
+	void sendMagicEffect(const Position &pos, uint16_t type, SharedMessageCache &shared) const;
 	void removeMagicEffect(const Position &pos, uint16_t type) const;
 	void sendPing();
 	void sendPingBack() const;
@@ -1252,6 +1259,9 @@ public:
 	std::unique_ptr<PlayerVIP> &vip();
 	const std::unique_ptr<PlayerVIP> &vip() const;
 
+	// Player save state interface, shared with the snapshots of the player being written
+	const std::shared_ptr<PlayerSaveState> &saveState() const;
+
 	void sendLootMessage(const std::string &message) const;
 
 	std::shared_ptr<Container> getLootPouch();
@@ -1441,11 +1451,11 @@ private:
 
 	uint32_t level = 1;
 	uint32_t magLevel = 0;
-	uint32_t actionTaskEvent = 0;
-	uint32_t actionTaskEventPush = 0;
-	uint32_t actionPotionTaskEvent = 0;
-	uint32_t nextStepEvent = 0;
-	uint32_t walkTaskEvent = 0;
+	uint64_t actionTaskEvent = 0;
+	uint64_t actionTaskEventPush = 0;
+	uint64_t actionPotionTaskEvent = 0;
+	uint64_t nextStepEvent = 0;
+	uint64_t walkTaskEvent = 0;
 	uint32_t MessageBufferTicks = 0;
 	uint32_t lastIP = 0;
 	uint32_t guid = 0;
@@ -1623,6 +1633,7 @@ private:
 	std::unique_ptr<PlayerCyclopedia> m_playerCyclopedia;
 	std::unique_ptr<PlayerTitle> m_playerTitle;
 	std::unique_ptr<PlayerVIP> m_playerVIP;
+	std::shared_ptr<PlayerSaveState> m_playerSaveState;
 
 	std::mutex quickLootMutex;
 
@@ -1697,9 +1697,7 @@ void PlayerWheel::loadDBPlayerSlotPointsOnLogin() {
 	}
 }
 
-bool PlayerWheel::saveDBPlayerSlotPointsOnLogout() const {
-	DBInsert insertWheelData("INSERT INTO `player_wheeldata` (`player_id`, `slot`) VALUES ");
-	insertWheelData.upsert({ "slot" });
+std::string PlayerWheel::serializeDBPlayerSlotPoints() const {
 	PropWriteStream stream;
 	const auto wheelSlots = getSlots();
 	for (uint8_t i = 1; i < wheelSlots.size(); ++i) {
@@ -1712,20 +1710,11 @@ bool PlayerWheel::saveDBPlayerSlotPointsOnLogout() const {
 
 	size_t attributesSize;
 	const char* attributes = stream.getStream(attributesSize);
-	if (attributesSize > 0) {
-		const auto query = fmt::format("{}, {}", m_player.getGUID(), g_database().escapeBlob(attributes, static_cast<uint32_t>(attributesSize)));
-		if (!insertWheelData.addRow(query)) {
-			g_logger().debug("[{}] failed to insert row data", __FUNCTION__);
-			return false;
-		}
-	}
-
-	if (!insertWheelData.execute()) {
-		g_logger().debug("[{}] failed to execute database insert", __FUNCTION__);
-		return false;
+	if (attributesSize == 0) {
+		return {};
 	}
 
-	return true;
+	return fmt::format("{}, {}", m_player.getGUID(), g_database().escapeBlob(attributes, static_cast<uint32_t>(attributesSize)));
 }
 
 uint16_t PlayerWheel::getExtraPoints() const {
@@ -63,7 +63,11 @@ public:
 	 * Functions for load and save player database informations
 	 */
 	void loadDBPlayerSlotPointsOnLogin();
-	bool saveDBPlayerSlotPointsOnLogout() const;
+	/**
+	 * @brief The row of `player_wheeldata` holding the slot points, written by the player save.
+	 * @return The values of the row, empty when there is nothing to write.
+	 */
+	std::string serializeDBPlayerSlotPoints() const;
 
 	/*
 	 * Functions for manipulate the client bytes
@@ -12,9 +12,29 @@
 #include "config/configmanager.hpp"
 #include "lib/di/container.hpp"
 #include "lib/metrics/metrics.hpp"
+#include "utils/hash.hpp"
+
+namespace {
+	// Connection a thread keeps from DBTransaction::begin to its commit or rollback
+	struct TransactionAffinity {
+		const Database* database = nullptr;
+		MYSQL* handle = nullptr;
+		uint32_t depth = 0;
+		std::chrono::steady_clock::time_point leasedAt;
+	};
+
+	thread_local TransactionAffinity transactionAffinity;
+	thread_local uint64_t lastInsertId = 0;
+}
 
 Database::~Database() {
-	if (handle != nullptr) {
+	for (const auto &[handle, statements] : statementCaches) {
+		for (const auto &[query, stmt] : statements) {
+			mysql_stmt_close(stmt);
+		}
+	}
+
+	for (const auto handle : connections) {
 		mysql_close(handle);
 	}
 }
@@ -23,34 +43,80 @@ Database &Database::getInstance() {
 	return inject<Database>();
 }
 
-bool Database::connect() {
-	return connect(&g_configManager().getString(MYSQL_HOST), &g_configManager().getString(MYSQL_USER), &g_configManager().getString(MYSQL_PASS), &g_configManager().getString(MYSQL_DB), g_configManager().getNumber(SQL_PORT), &g_configManager().getString(MYSQL_SOCK));
+Database::ConnectionLease::ConnectionLease(Database &db) :
+	db(db) {
+	const auto &affinity = transactionAffinity;
+	if (affinity.database == &db && affinity.handle) {
+		handle = affinity.handle;
+		pinned = true;
+		return;
+	}
+
+	handle = db.acquireConnection();
+	leasedAt = std::chrono::steady_clock::now();
 }
 
-bool Database::connect(const std::string* host, const std::string* user, const std::string* password, const std::string* database, uint32_t port, const std::string* sock) {
-	// connection handle initialization
-	handle = mysql_init(nullptr);
-	if (!handle) {
-		g_logger().error("Failed to initialize MySQL connection handle.");
-		return false;
+Database::ConnectionLease::~ConnectionLease() {
+	if (!pinned) {
+		db.releaseConnection(handle, leasedAt);
 	}
+}
 
+bool Database::connect() {
+	return connect(&g_configManager().getString(MYSQL_HOST), &g_configManager().getString(MYSQL_USER), &g_configManager().getString(MYSQL_PASS), &g_configManager().getString(MYSQL_DB), g_configManager().getNumber(SQL_PORT), &g_configManager().getString(MYSQL_SOCK), std::max<int32_t>(1, g_configManager().getNumber(MYSQL_POOL_SIZE)));
+}
+
+bool Database::connect(const std::string* host, const std::string* user, const std::string* password, const std::string* database, uint32_t port, const std::string* sock, uint32_t poolSize /* = 1*/) {
 	if (host->empty() || user->empty() || password->empty() || database->empty() || port <= 0) {
 		g_logger().warn("MySQL host, user, password, database or port not provided");
 	}
 
-	// automatic reconnect
-	bool reconnect = true;
-	mysql_options(handle, MYSQL_OPT_RECONNECT, &reconnect);
+	std::vector<MYSQL*> handles;
+	const auto closeAll = [&handles] {
+		for (const auto handle : handles) {
+			mysql_close(handle);
+		}
+	};
+
+	for (uint32_t i = 0; i < std::max<uint32_t>(1, poolSize); ++i) {
+		// connection handle initialization
+		MYSQL* handle = mysql_init(nullptr);
+		if (!handle) {
+			g_logger().error("Failed to initialize MySQL connection handle.");
+			closeAll();
+			return false;
+		}
+		handles.emplace_back(handle);
+
+		// automatic reconnect
+		bool reconnect = true;
+		mysql_options(handle, MYSQL_OPT_RECONNECT, &reconnect);
 
-	// Remove ssl verification
-	bool ssl_enabled = false;
-	mysql_options(handle, MYSQL_OPT_SSL_VERIFY_SERVER_CERT, &ssl_enabled);
+		// Remove ssl verification
+		bool ssl_enabled = false;
+		mysql_options(handle, MYSQL_OPT_SSL_VERIFY_SERVER_CERT, &ssl_enabled);
 
-	// connects to database
-	if (!mysql_real_connect(handle, host->c_str(), user->c_str(), password->c_str(), database->c_str(), port, sock->c_str(), 0)) {
-		g_logger().error("MySQL Error Message: {}", mysql_error(handle));
-		return false;
+		// connects to database
+		if (!mysql_real_connect(handle, host->c_str(), user->c_str(), password->c_str(), database->c_str(), port, sock->c_str(), 0)) {
+			g_logger().error("MySQL Error Message: {}", mysql_error(handle));
+			closeAll();
+			return false;
+		}
+	}
+
+	{
+		std::scoped_lock lock(poolMutex);
+		connections = handles;
+		for (const auto handle : handles) {
+			statementCaches.try_emplace(handle);
+		}
+		// Stack of idle connections, the first one on top
+		idleConnections.assign(handles.rbegin(), handles.rend());
+
+		// Only these multi-byte character sets can hide a backslash inside a character
+		static constexpr auto backslashCharsets = std::to_array<std::string_view>({ "big5", "cp932", "gb18030", "gbk", "sjis" });
+		const std::string_view charset = mysql_character_set_name(handles.front());
+		escapeWithConnection = std::ranges::find(backslashCharsets, charset) != backslashCharsets.end();
 	}
 
 	DBResult_ptr result = storeQuery("SHOW VARIABLES LIKE 'max_allowed_packet'");
@@ -60,53 +126,112 @@ bool Database::connect(const std::string* host, const std::string* user, const s
 	return true;
 }
 
+MYSQL* Database::acquireConnection() {
+	metrics::lock_latency measureLock("database");
+	std::unique_lock lock(poolMutex);
+	poolCondition.wait(lock, [this] { return !idleConnections.empty(); });
+	measureLock.stop();
+
+	MYSQL* handle = idleConnections.back();
+	idleConnections.pop_back();
+	g_metrics().recordHistogram("database_connections_in_use", static_cast<double>(connections.size() - idleConnections.size()));
+	return handle;
+}
+
+void Database::releaseConnection(MYSQL* handle, std::chrono::steady_clock::time_point leasedAt) {
+	const auto leaseTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - leasedAt).count();
+	// Same histogram and unit (us) as the wait measured by lock_latency
+	g_metrics().recordHistogram("lock_latency", static_cast<double>(leaseTime) / 1000, { { "scope", "database_lease" } });
+
+	{
+		std::scoped_lock lock(poolMutex);
+		idleConnections.emplace_back(handle);
+	}
+	poolCondition.notify_one();
+}
+
+size_t Database::getIdleConnections() const {
+	std::scoped_lock lock(poolMutex);
+	return idleConnections.size();
+}
+
+uint64_t Database::getLastInsertId() const {
+	return lastInsertId;
+}
+
 bool Database::beginTransaction() {
+	if (!isConnected()) {
+		g_logger().error("Database not initialized!");
+		return false;
+	}
+
+	auto &affinity = transactionAffinity;
+	if (affinity.depth != 0 && affinity.database != this) {
+		g_logger().error("[{}] The thread is already inside a transaction of another database", __FUNCTION__);
+		return false;
+	}
+
+	if (affinity.depth++ == 0) {
+		affinity.database = this;
+		affinity.handle = acquireConnection();
+		affinity.leasedAt = std::chrono::steady_clock::now();
+	}
+
 	if (!executeQuery("BEGIN")) {
+		endTransaction();
 		return false;
 	}
-	metrics::lock_latency measureLock("database");
-	databaseLock.lock();
-	measureLock.stop();
 
 	return true;
 }
 
 bool Database::rollback() {
-	if (!handle) {
-		g_logger().error("Database not initialized!");
+	auto &affinity = transactionAffinity;
+	if (affinity.depth == 0 || affinity.database != this) {
+		g_logger().error("[{}] No transaction started", __FUNCTION__);
 		return false;
 	}
 
-	if (mysql_rollback(handle) != 0) {
-		g_logger().error("Message: {}", mysql_error(handle));
-		databaseLock.unlock();
-		return false;
+	const bool success = mysql_rollback(affinity.handle) == 0;
+	if (!success) {
+		g_logger().error("Message: {}", mysql_error(affinity.handle));
 	}
 
-	databaseLock.unlock();
-	return true;
+	endTransaction();
+	return success;
 }
 
 bool Database::commit() {
-	if (!handle) {
-		g_logger().error("Database not initialized!");
+	auto &affinity = transactionAffinity;
+	if (affinity.depth == 0 || affinity.database != this) {
+		g_logger().error("[{}] No transaction started", __FUNCTION__);
 		return false;
 	}
-	if (mysql_commit(handle) != 0) {
-		g_logger().error("Message: {}", mysql_error(handle));
-		databaseLock.unlock();
-		return false;
+
+	const bool success = mysql_commit(affinity.handle) == 0;
+	if (!success) {
+		g_logger().error("Message: {}", mysql_error(affinity.handle));
 	}
 
-	databaseLock.unlock();
-	return true;
+	endTransaction();
+	return success;
+}
+
+void Database::endTransaction() {
+	auto &affinity = transactionAffinity;
+	if (--affinity.depth != 0) {
+		return;
+	}
+
+	releaseConnection(std::exchange(affinity.handle, nullptr), affinity.leasedAt);
+	affinity.database = nullptr;
 }
 
 bool Database::isRecoverableError(unsigned int error) {
 	return error == CR_SERVER_LOST || error == CR_SERVER_GONE_ERROR || error == CR_CONN_HOST_ERROR || error == 1053 /*ER_SERVER_SHUTDOWN*/ || error == CR_CONNECTION_ERROR;
 }
 
-bool Database::retryQuery(std::string_view query, int retries) {
+bool Database::retryQuery(MYSQL* handle, std::string_view query, int retries) {
 	while (retries > 0 && mysql_query(handle, query.data()) != 0) {
 		g_logger().error("Query: {}", query.substr(0, 256));
 		g_logger().error("MySQL error [{}]: {}", mysql_errno(handle), mysql_error(handle));
@@ -125,34 +250,167 @@ bool Database::retryQuery(std::string_view query, int retries) {
 }
 
 bool Database::executeQuery(std::string_view query) {
-	if (!handle) {
+	if (!isConnected()) {
 		g_logger().error("Database not initialized!");
 		return false;
 	}
 
 	g_logger().trace("Executing Query: {}", query);
 
-	metrics::lock_latency measureLock("database");
-	std::scoped_lock lock { databaseLock };
-	measureLock.stop();
+	const ConnectionLease connection(*this);
+	MYSQL* handle = connection.get();
 
 	metrics::query_latency measure(query.substr(0, 50));
-	bool success = retryQuery(query, 10);
+	bool success = retryQuery(handle, query, 10);
 	mysql_free_result(mysql_store_result(handle));
+	lastInsertId = static_cast<uint64_t>(mysql_insert_id(handle));
 
 	return success;
 }
 
+MYSQL_STMT* Database::getStatement(MYSQL* handle, StatementCache &statements, std::string_view query) {
+	if (const auto it = statements.find(query); it != statements.end()) {
+		return it->second;
+	}
+
+	MYSQL_STMT* stmt = mysql_stmt_init(handle);
+	if (!stmt) {
+		g_logger().error("Failed to initialize MySQL statement handle.");
+		return nullptr;
+	}
+
+	if (mysql_stmt_prepare(stmt, query.data(), query.size()) != 0) {
+		g_logger().error("Query: {}", query.substr(0, 256));
+		g_logger().error("MySQL error [{}]: {}", mysql_stmt_errno(stmt), mysql_stmt_error(stmt));
+		mysql_stmt_close(stmt);
+		return nullptr;
+	}
+
+	// Lets DBResult size the buffers of the bytes columns from the stored result set
+	const decltype(MYSQL_BIND::is_null_value) updateMaxLength = 1;
+	mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength);
+
+	statements.emplace(query, stmt);
+	return stmt;
+}
+
+MYSQL_STMT* Database::executeStatement(MYSQL* handle, const DBStatement &statement) {
+	const auto query = statement.getQuery();
+	auto &statements = statementCaches.at(handle);
+
+	std::vector<MYSQL_BIND> binds(statement.parameters.size());
+	for (size_t i = 0; i < binds.size(); ++i) {
+		const auto &parameter = statement.parameters[i];
+		auto &bind = binds[i];
+		bind.buffer_type = parameter.type;
+		bind.is_unsigned = parameter.isUnsigned;
+		if (parameter.type == MYSQL_TYPE_LONGLONG) {
+			bind.buffer = const_cast<int64_t*>(&parameter.integer);
+		} else if (parameter.type == MYSQL_TYPE_DOUBLE) {
+			bind.buffer = const_cast<double*>(&parameter.real);
+		} else {
+			bind.buffer = const_cast<char*>(parameter.data.data());
+			bind.buffer_length = static_cast<unsigned long>(parameter.data.size());
+		}
+	}
+
+	for (int retries = 10; retries > 0; --retries) {
+		MYSQL_STMT* stmt = getStatement(handle, statements, query);
+		if (!stmt) {
+			return nullptr;
+		}
+
+		if (mysql_stmt_param_count(stmt) != binds.size()) {
+			g_logger().error("Query: {}", query.substr(0, 256));
+			g_logger().error("Statement expects {} parameters, {} were bound", mysql_stmt_param_count(stmt), binds.size());
+			return nullptr;
+		}
+
+		if ((binds.empty() || mysql_stmt_bind_param(stmt, binds.data()) == 0) && mysql_stmt_execute(stmt) == 0) {
+			return stmt;
+		}
+
+		const auto error = mysql_stmt_errno(stmt);
+		g_logger().error("Query: {}", query.substr(0, 256));
+		g_logger().error("MySQL error [{}]: {}", error, mysql_stmt_error(stmt));
+
+		// The server forgets the statements of a lost connection, it's prepared again on the next try
+		mysql_stmt_close(stmt);
+		statements.erase(statements.find(query));
+		const bool unknownStatement = error == 1243 /*ER_UNKNOWN_STMT_HANDLER*/ || error == 1615 /*ER_NEED_REPREPARE*/;
+		if (!unknownStatement && !isRecoverableError(error)) {
+			return nullptr;
+		}
+
+		if (!unknownStatement) {
+			std::this_thread::sleep_for(std::chrono::seconds(1));
+		}
+	}
+
+	g_logger().error("Query {} failed after {} retries.", query.substr(0, 256), 10);
+	return nullptr;
+}
+
+bool Database::executeQuery(const DBStatement &statement) {
+	if (!isConnected()) {
+		g_logger().error("Database not initialized!");
+		return false;
+	}
+
+	g_logger().trace("Executing Statement: {}", statement.getQuery());
+
+	const ConnectionLease connection(*this);
+	metrics::query_latency measure(statement.getQuery().substr(0, 50));
+	MYSQL_STMT* stmt = executeStatement(connection.get(), statement);
+	if (!stmt) {
+		return false;
+	}
+
+	if (mysql_stmt_field_count(stmt) != 0) {
+		mysql_stmt_free_result(stmt);
+	}
+	lastInsertId = static_cast<uint64_t>(mysql_stmt_insert_id(stmt));
+	return true;
+}
+
+DBResult_ptr Database::storeQuery(const DBStatement &statement) {
+	if (!isConnected()) {
+		g_logger().error("Database not initialized!");
+		return nullptr;
+	}
+
+	g_logger().trace("Storing Statement: {}", statement.getQuery());
+
+	const ConnectionLease connection(*this);
+	metrics::query_latency measure(statement.getQuery().substr(0, 50));
+	MYSQL_STMT* stmt = executeStatement(connection.get(), statement);
+	if (!stmt || mysql_stmt_field_count(stmt) == 0) {
+		return nullptr;
+	}
+
+	if (mysql_stmt_store_result(stmt) != 0) {
+		g_logger().error("Query: {}", statement.getQuery().substr(0, 256));
+		g_logger().error("MySQL error [{}]: {}", mysql_stmt_errno(stmt), mysql_stmt_error(stmt));
+		mysql_stmt_free_result(stmt);
+		return nullptr;
+	}
+
+	DBResult_ptr result = std::make_shared<DBResult>(stmt);
+	if (!result->hasNext()) {
+		return nullptr;
+	}
+	return result;
+}
+
 DBResult_ptr Database::storeQuery(std::string_view query) {
-	if (!handle) {
+	if (!isConnected()) {
 		g_logger().error("Database not initialized!");
 		return nullptr;
 	}
 	g_logger().trace("Storing Query: {}", query);
 
-	metrics::lock_latency measureLock("database");
-	std::scoped_lock lock { databaseLock };
-	measureLock.stop();
+	const ConnectionLease connection(*this);
+	MYSQL* handle = connection.get();
 
 	metrics::query_latency measure(query.substr(0, 50));
 retry:
@@ -166,7 +424,7 @@ retry:
 		goto retry;
 	}
 
-	// Retrieving results of query
+	// Retrieving results of query, the result set is fully read so it outlives the lease
 	MYSQL_RES* res = mysql_store_result(handle);
 	if (res != nullptr) {
 		DBResult_ptr result = std::make_shared<DBResult>(res);
@@ -197,7 +455,14 @@ std::string Database::escapeBlob(const char* s, uint32_t length) const {
 
 	if (length != 0) {
 		std::string output(maxLength, '\0');
-		size_t escapedLength = mysql_real_escape_string(handle, &output[0], s, length);
+		size_t escapedLength;
+		if (escapeWithConnection) {
+			const ConnectionLease connection(const_cast<Database &>(*this));
+			escapedLength = mysql_real_escape_string(connection.get(), &output[0], s, length);
+		} else {
+			// Same result as the connection gives for its character set, without taking one from the pool
+			escapedLength = mysql_escape_string(&output[0], s, length);
+		}
 		output.resize(escapedLength);
 		escaped.append(output);
 	}
@@ -213,13 +478,126 @@ DBResult::DBResult(MYSQL_RES* res) {
 
 	const MYSQL_FIELD* fields = mysql_fetch_fields(handle);
 	for (size_t i = 0; i < num_fields; i++) {
+		columnNames.emplace_back(fields[i].name);
 		listNames[fields[i].name] = i;
 	}
 	row = mysql_fetch_row(handle);
 }
 
+DBResult::DBResult(MYSQL_STMT* stmt) :
+	binary(true) {
+	MYSQL_RES* metadata = mysql_stmt_result_metadata(stmt);
+	const size_t columns = mysql_num_fields(metadata);
+	const MYSQL_FIELD* fields = mysql_fetch_fields(metadata);
+
+	// The names are referenced by columnNames and listNames, the storage must not grow once they are in
+	size_t namesSize = 0;
+	for (size_t i = 0; i < columns; ++i) {
+		namesSize += fields[i].name_length;
+	}
+	columnNameData.reserve(namesSize);
+
+	using BindFlag = decltype(MYSQL_BIND::is_null_value);
+	std::vector<MYSQL_BIND> binds(columns);
+	std::vector<BinaryValue> rowValues(columns);
+	std::vector<unsigned long> lengths(columns);
+	std::vector<BindFlag> nulls(columns);
+	std::vector<std::string> buffers(columns);
+	binaryTypes.resize(columns);
+	for (size_t i = 0; i < columns; ++i) {
+		const auto &field = fields[i];
+		const auto nameOffset = columnNameData.size();
+		columnNameData.append(field.name, field.name_length);
+		columnNames.emplace_back(columnNameData.data() + nameOffset, field.name_length);
+		listNames[columnNames.back()] = i;
+
+		auto &bind = binds[i];
+		bind.is_null = &nulls[i];
+		bind.length = &lengths[i];
+		switch (field.type) {
+			case MYSQL_TYPE_TINY:
+			case MYSQL_TYPE_SHORT:
+			case MYSQL_TYPE_INT24:
+			case MYSQL_TYPE_LONG:
+			case MYSQL_TYPE_LONGLONG:
+			case MYSQL_TYPE_YEAR:
+				binaryTypes[i] = (field.flags & UNSIGNED_FLAG) ? BinaryType::UnsignedInteger : BinaryType::Integer;
+				bind.buffer_type = MYSQL_TYPE_LONGLONG;
+				bind.buffer = &rowValues[i].integer;
+				bind.is_unsigned = (field.flags & UNSIGNED_FLAG) != 0;
+				break;
+			case MYSQL_TYPE_FLOAT:
+			case MYSQL_TYPE_DOUBLE:
+				binaryTypes[i] = BinaryType::Real;
+				bind.buffer_type = MYSQL_TYPE_DOUBLE;
+				bind.buffer = &rowValues[i].real;
+				break;
+			default:
+				// Strings, blobs, decimals and dates, sized by the longest value of the result set
+				binaryTypes[i] = BinaryType::Bytes;
+				buffers[i].resize(std::max<unsigned long>(field.max_length, 1));
+				bind.buffer_type = MYSQL_TYPE_BLOB;
+				bind.buffer = buffers[i].data();
+				bind.buffer_length = static_cast<unsigned long>(buffers[i].size());
+				break;
+		}
+	}
+	mysql_free_result(metadata);
+
+	if (columns != 0 && mysql_stmt_bind_result(stmt, binds.data()) == 0) {
+		binaryValues.reserve(static_cast<size_t>(mysql_stmt_num_rows(stmt)) * columns);
+		int status;
+		while ((status = mysql_stmt_fetch(stmt)) == 0 || status == MYSQL_DATA_TRUNCATED) {
+			for (size_t i = 0; i < columns; ++i) {
+				auto value = rowValues[i];
+				value.isNull = nulls[i];
+				if (binaryTypes[i] == BinaryType::Bytes && !value.isNull) {
+					value.offset = static_cast<uint32_t>(binaryData.size());
+					value.size = static_cast<uint32_t>(lengths[i]);
+					if (lengths[i] <= binds[i].buffer_length) {
+						binaryData.append(buffers[i].data(), value.size);
+					} else {
+						// Longer than the buffer, read the whole value again instead of keeping a cut one
+						binaryData.resize(binaryData.size() + value.size);
+						MYSQL_BIND column = {};
+						column.buffer_type = MYSQL_TYPE_BLOB;
+						column.buffer = binaryData.data() + value.offset;
+						column.buffer_length = lengths[i];
+						if (mysql_stmt_fetch_column(stmt, &column, static_cast<unsigned int>(i), 0) != 0) {
+							g_logger().error("[DBResult::DBResult] - Failed to read column '{}' of {} bytes, MySQL error [{}]: {}", columnNames[i], lengths[i], mysql_stmt_errno(stmt), mysql_stmt_error(stmt));
+							binaryData.resize(value.offset);
+							value.size = 0;
+							value.isNull = true;
+						}
+					}
+					binaryData.push_back('\0');
+				}
+				binaryValues.emplace_back(value);
+			}
+		}
+		binaryRows = binaryValues.size() / columns;
+	} else if (columns != 0) {
+		g_logger().error("MySQL error [{}]: {}", mysql_stmt_errno(stmt), mysql_stmt_error(stmt));
+	}
+	mysql_stmt_free_result(stmt);
+}
+
 DBResult::~DBResult() {
-	mysql_free_result(handle);
+	if (handle) {
+		mysql_free_result(handle);
+	}
+}
+
+const char* DBResult::getText(size_t column) const {
+	if (!binary) {
+		return row[column];
+	}
+
+	const auto &value = binaryValues[binaryRow * columnNames.size() + column];
+	if (value.isNull || binaryTypes[column] != BinaryType::Bytes) {
+		return nullptr;
+	}
+	return binaryData.data() + value.offset;
 }
 
 std::string DBResult::getString(const std::string &s) const {
@@ -228,10 +606,37 @@ std::string DBResult::getString(const std::string &s) const {
 		g_logger().error("Column '{}' does not exist in result set", s);
 		return {};
 	}
-	if (row[it->second] == nullptr) {
+	return getString(it->second);
+}
+
+std::string DBResult::getString(size_t column) const {
+	if (column >= columnNames.size()) {
+		g_logger().error("Column {} does not exist in result set", column);
+		return {};
+	}
+
+	if (binary) {
+		const auto &value = binaryValues[binaryRow * columnNames.size() + column];
+		if (value.isNull) {
+			return {};
+		}
+
+		switch (binaryTypes[column]) {
+			case BinaryType::Integer:
+				return std::to_string(value.integer);
+			case BinaryType::UnsignedInteger:
+				return std::to_string(value.unsignedInteger);
+			case BinaryType::Real:
+				return fmt::format("{}", value.real);
+			default:
+				return std::string(binaryData.data() + value.offset, value.size);
+		}
+	}
+
+	if (row[column] == nullptr) {
 		return {};
 	}
-	return std::string(row[it->second]);
+	return std::string(row[column]);
 }
 
 const char* DBResult::getStream(const std::string &s, unsigned long &size) const {
@@ -241,14 +646,30 @@ const char* DBResult::getStream(const std::string &s, unsigned long &size) const
 		size = 0;
 		return nullptr;
 	}
+	return getStream(it->second, size);
+}
 
-	if (row[it->second] == nullptr) {
-		size = 0;
+const char* DBResult::getStream(size_t column, unsigned long &size) const {
+	size = 0;
+	if (column >= columnNames.size()) {
+		g_logger().error("Column {} doesn't exist in the result set", column);
+		return nullptr;
+	}
+
+	if (binary) {
+		const char* text = getText(column);
+		if (text != nullptr) {
+			size = binaryValues[binaryRow * columnNames.size() + column].size;
+		}
+		return text;
+	}
+
+	if (row[column] == nullptr) {
 		return nullptr;
 	}
 
-	size = mysql_fetch_lengths(handle)[it->second];
-	return row[it->second];
+	size = mysql_fetch_lengths(handle)[column];
+	return row[column];
 }
 
 uint8_t DBResult::getU8FromString(const std::string &string, const std::string &function) {
@@ -272,14 +693,24 @@ int8_t DBResult::getInt8FromString(const std::string &string, const std::string
 }
 
 size_t DBResult::countResults() const {
+	if (binary) {
+		return binaryRows;
+	}
 	return static_cast<size_t>(mysql_num_rows(handle));
 }
 
 bool DBResult::hasNext() const {
+	if (binary) {
+		return binaryRow < binaryRows;
+	}
 	return row != nullptr;
 }
 
 bool DBResult::next() {
+	if (binary) {
+		return binaryRow < binaryRows && ++binaryRow < binaryRows;
+	}
+
 	if (!handle) {
 		g_logger().error("Database not initialized!");
 		return false;
@@ -288,6 +719,33 @@ bool DBResult::next() {
 	return row != nullptr;
 }
 
+size_t DBStatement::hash() const {
+	size_t seed = stdext::hash<std::string_view>()(query);
+	for (const auto &parameter : parameters) {
+		stdext::hash_combine(seed, static_cast<uint8_t>(parameter.type));
+		if (parameter.type == MYSQL_TYPE_DOUBLE) {
+			stdext::hash_combine(seed, std::bit_cast<uint64_t>(parameter.real));
+		} else if (parameter.type == MYSQL_TYPE_LONGLONG) {
+			stdext::hash_combine(seed, static_cast<uint64_t>(parameter.integer));
+		} else {
+			stdext::hash_combine(seed, parameter.data);
+		}
+	}
+	return seed;
+}
+
+size_t DBStatement::getDataSize() const {
+	size_t size = 0;
+	for (const auto &parameter : parameters) {
+		if (parameter.type == MYSQL_TYPE_DOUBLE || parameter.type == MYSQL_TYPE_LONGLONG) {
+			size += sizeof(int64_t);
+		} else {
+			size += parameter.data.size();
+		}
+	}
+	return size;
+}
+
 DBInsert::DBInsert(std::string insertQuery) :
 	query(std::move(insertQuery)) {
 	this->length = this->query.length();
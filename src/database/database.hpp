@@ -13,11 +13,13 @@
 
 #ifndef USE_PRECOMPILED_HEADERS
 	#include <mysql/mysql.h>
+	#include <condition_variable>
 	#include <mutex>
 	#include <utility>
 #endif
 
 class DBResult;
+class DBStatement;
 using DBResult_ptr = std::shared_ptr<DBResult>;
 
 class Database {
@@ -33,22 +35,53 @@ public:
 
 	static Database &getInstance();
 
+	/**
+	 * Exclusive use of one connection of the pool, handed back when the lease goes out of scope.
+	 * A thread inside a transaction keeps its connection until the transaction ends,
+	 * the leases it takes meanwhile get that same connection.
+	 */
+	class ConnectionLease {
+	public:
+		explicit ConnectionLease(Database &db);
+		~ConnectionLease();
+
+		// Non copyable
+		ConnectionLease(const ConnectionLease &) = delete;
+		ConnectionLease &operator=(const ConnectionLease &) = delete;
+
+		MYSQL* get() const {
+			return handle;
+		}
+
+	private:
+		Database &db;
+		MYSQL* handle = nullptr;
+		bool pinned = false;
+		std::chrono::steady_clock::time_point leasedAt;
+	};
+
 	bool connect();
 
-	bool connect(const std::string* host, const std::string* user, const std::string* password, const std::string* database, uint32_t port, const std::string* sock);
+	/**
+	 * Opens the connection pool, queries are spread over 'poolSize' connections.
+	 * The pool hands out the most recently returned connection first, so a single thread keeps using the same one.
+	 */
+	bool connect(const std::string* host, const std::string* user, const std::string* password, const std::string* database, uint32_t port, const std::string* sock, uint32_t poolSize = 1);
 
-	bool retryQuery(std::string_view query, int retries);
 	bool executeQuery(std::string_view query);
+	bool executeQuery(const DBStatement &statement);
 
 	DBResult_ptr storeQuery(std::string_view query);
+	DBResult_ptr storeQuery(const DBStatement &statement);
 
 	std::string escapeString(const std::string &s) const;
 
 	std::string escapeBlob(const char* s, uint32_t length) const;
 
-	uint64_t getLastInsertId() const {
-		return static_cast<uint64_t>(mysql_insert_id(handle));
-	}
+	/**
+	 * Id generated by the last INSERT the calling thread executed.
+	 */
+	uint64_t getLastInsertId() const;
 
 	static const char* getClientVersion() {
 		return mysql_get_client_info();
@@ -58,15 +91,45 @@ public:
 		return maxPacketSize;
 	}
 
+	bool isConnected() const {
+		return !connections.empty();
+	}
+
+	size_t getPoolSize() const {
+		return connections.size();
+	}
+
+	size_t getIdleConnections() const;
+
 private:
 	bool beginTransaction();
 	bool rollback();
 	bool commit();
+	void endTransaction();
 
+	MYSQL* acquireConnection();
+	void releaseConnection(MYSQL* handle, std::chrono::steady_clock::time_point leasedAt);
+
+	static bool retryQuery(MYSQL* handle, std::string_view query, int retries);
 	static bool isRecoverableError(unsigned int error);
 
-	MYSQL* handle = nullptr;
-	std::recursive_mutex databaseLock;
+	// Prepared statements of a connection, by query
+	using StatementCache = phmap::flat_hash_map<std::string, MYSQL_STMT*>;
+
+	MYSQL_STMT* executeStatement(MYSQL* handle, const DBStatement &statement);
+	static MYSQL_STMT* getStatement(MYSQL* handle, StatementCache &statements, std::string_view query);
+
+	// Written by connect only, before the pool is shared
+	std::vector<MYSQL*> connections;
+	// The character set of the pool needs a connection to escape, see escapeBlob
+	bool escapeWithConnection = true;
+	// Only the holder of a connection's lease uses its cache
+	std::unordered_map<MYSQL*, StatementCache> statementCaches;
+
+	mutable std::mutex poolMutex;
+	std::condition_variable poolCondition;
+	std::vector<MYSQL*> idleConnections;
+
 	uint64_t maxPacketSize = 1048576;
 
 	friend class DBTransaction;
@@ -77,6 +140,8 @@ constexpr auto g_database = Database::getInstance;
 class DBResult {
 public:
 	explicit DBResult(MYSQL_RES* res);
+	// Reads every row of an executed prepared statement, so the statement can go back to its connection
+	explicit DBResult(MYSQL_STMT* stmt);
 	~DBResult();
 
 	// Non copyable
@@ -91,10 +156,45 @@ public:
 			return T();
 		}
 
-		if (row[it->second] == nullptr) {
+		return getNumber<T>(it->second);
+	}
+
+	/**
+	 * Value of the column at 'column' in the select list, without the lookup by name.
+	 * Numeric columns of prepared statement results are read as is, other values are parsed from their text.
+	 */
+	template <typename T>
+	T getNumber(size_t column) const {
+		if (column >= columnNames.size()) {
+			g_logger().error("[DBResult::getNumber] - Column {} doesn't exist in the result set", column);
 			return T();
 		}
 
+		if (binary) {
+			const auto &value = binaryValues[binaryRow * columnNames.size() + column];
+			if (value.isNull) {
+				return T();
+			}
+
+			switch (binaryTypes[column]) {
+				case BinaryType::Integer:
+					return castNumber<T>(value.integer);
+				case BinaryType::UnsignedInteger:
+					return castNumber<T>(value.unsignedInteger);
+				case BinaryType::Real:
+					return castNumber<T>(value.real);
+				default:
+					break;
+			}
+		}
+
+		const char* text = getText(column);
+		if (text == nullptr) {
+			return T();
+		}
+
+		const auto &s = columnNames[column];
+
 		T data {};
 		try {
 			// Check if the type T is a enum
@@ -102,9 +202,9 @@ public:
 				using underlying_type = std::underlying_type_t<T>;
 				underlying_type value = 0;
 				if constexpr (std::is_signed_v<underlying_type>) {
-					value = static_cast<underlying_type>(std::stoll(row[it->second]));
+					value = static_cast<underlying_type>(std::stoll(text));
 				} else {
-					value = static_cast<underlying_type>(std::stoull(row[it->second]));
+					value = static_cast<underlying_type>(std::stoull(text));
 				}
 				return static_cast<T>(value);
 			}
@@ -113,33 +213,33 @@ public:
 				// Check if the type T is int8_t or int16_t
 				if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t>) {
 					// Use std::stoi to convert string to int8_t
-					data = static_cast<T>(std::stoi(row[it->second]));
+					data = static_cast<T>(std::stoi(text));
 				}
 				// Check if the type T is int32_t
 				else if constexpr (std::is_same_v<T, int32_t>) {
 					// Use std::stol to convert string to int32_t
-					data = static_cast<T>(std::stol(row[it->second]));
+					data = static_cast<T>(std::stol(text));
 				}
 				// Check if the type T is int64_t
 				else if constexpr (std::is_same_v<T, int64_t>) {
 					// Use std::stoll to convert string to int64_t
-					data = static_cast<T>(std::stoll(row[it->second]));
+					data = static_cast<T>(std::stoll(text));
 				} else {
 					// Throws exception indicating that type T is invalid
 					g_logger().error("Invalid signed type T");
 				}
 			} else if (std::is_same<T, bool>::value) {
-				data = static_cast<T>(std::stoi(row[it->second]));
+				data = static_cast<T>(std::stoi(text));
 			} else {
 				// Check if the type T is uint8_t or uint16_t or uint32_t
 				if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t> || std::is_same_v<T, uint32_t>) {
 					// Use std::stoul to convert string to uint8_t
-					data = static_cast<T>(std::stoul(row[it->second]));
+					data = static_cast<T>(std::stoul(text));
 				}
 				// Check if the type T is uint64_t
 				else if constexpr (std::is_same_v<T, uint64_t>) {
 					// Use std::stoull to convert string to uint64_t
-					data = static_cast<T>(std::stoull(row[it->second]));
+					data = static_cast<T>(std::stoull(text));
 				} else {
 					// Send log indicating that type T is invalid
 					g_logger().error("Column '{}' has an invalid unsigned T is invalid", s);
@@ -159,7 +259,9 @@ public:
 	}
 
 	std::string getString(const std::string &s) const;
+	std::string getString(size_t column) const;
 	const char* getStream(const std::string &s, unsigned long &size) const;
+	const char* getStream(size_t column, unsigned long &size) const;
 	static uint8_t getU8FromString(const std::string &string, const std::string &function);
 	static int8_t getInt8FromString(const std::string &string, const std::string &function);
 
@@ -168,9 +270,49 @@ public:
 	bool next();
 
 private:
-	MYSQL_RES* handle;
-	MYSQL_ROW row;
+	template <typename T, typename Value>
+	static T castNumber(Value value) {
+		if constexpr (std::is_enum_v<T>) {
+			return static_cast<T>(static_cast<std::underlying_type_t<T>>(value));
+		} else {
+			return static_cast<T>(value);
+		}
+	}
 
+	// Null terminated text of the column in the current row, nullptr for NULL
+	const char* getText(size_t column) const;
+
+	enum class BinaryType : uint8_t {
+		Integer,
+		UnsignedInteger,
+		Real,
+		Bytes,
+	};
+
+	struct BinaryValue {
+		union {
+			int64_t integer = 0;
+			uint64_t unsignedInteger;
+			double real;
+		};
+		// Bytes values are kept null terminated in binaryData
+		uint32_t offset = 0;
+		uint32_t size = 0;
+		bool isNull = false;
+	};
+
+	MYSQL_RES* handle = nullptr;
+	MYSQL_ROW row = nullptr;
+
+	bool binary = false;
+	size_t binaryRow = 0;
+	size_t binaryRows = 0;
+	std::vector<BinaryType> binaryTypes;
+	std::vector<BinaryValue> binaryValues;
+	std::string binaryData;
+	std::string columnNameData;
+
+	std::vector<std::string_view> columnNames;
 	std::map<std::string_view, size_t> listNames;
 
 	friend class Database;
@@ -194,6 +336,80 @@ private:
 	size_t length;
 };
 
+/**
+ * Query sent as a prepared statement: values are bound to its '?' placeholders and travel in the binary protocol,
+ * so nothing is formatted or escaped. Each connection prepares a query once and keeps it, by its text.
+ * The query and the bound strings and blobs are referenced, not copied, they must outlive the execution.
+ */
+class DBStatement {
+public:
+	explicit DBStatement(std::string_view query) :
+		query(query) { }
+
+	template <typename T>
+		requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+	DBStatement &bind(T value) {
+		if constexpr (std::is_enum_v<T>) {
+			return bind(static_cast<std::underlying_type_t<T>>(value));
+		} else {
+			auto &parameter = parameters.emplace_back();
+			if constexpr (std::is_floating_point_v<T>) {
+				parameter.type = MYSQL_TYPE_DOUBLE;
+				parameter.real = static_cast<double>(value);
+			} else {
+				parameter.type = MYSQL_TYPE_LONGLONG;
+				parameter.isUnsigned = std::is_unsigned_v<T>;
+				parameter.integer = static_cast<int64_t>(value);
+			}
+			return *this;
+		}
+	}
+
+	DBStatement &bind(std::string_view value) {
+		auto &parameter = parameters.emplace_back();
+		parameter.type = MYSQL_TYPE_STRING;
+		parameter.data = value;
+		return *this;
+	}
+
+	DBStatement &bindBlob(const char* data, size_t size) {
+		auto &parameter = parameters.emplace_back();
+		parameter.type = MYSQL_TYPE_BLOB;
+		parameter.data = std::string_view(data, size);
+		return *this;
+	}
+
+	std::string_view getQuery() const {
+		return query;
+	}
+
+	/**
+	 * Hash of the query and its bound values, equal for statements that would write the same.
+	 */
+	size_t hash() const;
+
+	/**
+	 * Bytes of the bound values, as sent to the server.
+	 */
+	size_t getDataSize() const;
+
+private:
+	struct Parameter {
+		enum_field_types type = MYSQL_TYPE_NULL;
+		bool isUnsigned = false;
+		union {
+			int64_t integer = 0;
+			double real;
+		};
+		std::string_view data;
+	};
+
+	std::string_view query;
+	std::vector<Parameter> parameters;
+
+	friend class Database;
+};
+
 class DBTransaction {
 public:
 	explicit DBTransaction() = default;
@@ -208,22 +424,31 @@ public:
 	DBTransaction(const DBTransaction &&) = delete;
 	DBTransaction &operator=(const DBTransaction &&) = delete;
 
+	/**
+	 * Runs the queries of 'toBeExecuted' inside a transaction, on the connection the thread keeps until the commit.
+	 * An exception or a false return from 'toBeExecuted' rolls the transaction back and returns false.
+	 */
 	template <typename Func>
 	static bool executeWithinTransaction(const Func &toBeExecuted) {
-		bool changesExpected = toBeExecuted();
-		if (changesExpected) {
-			DBTransaction transaction;
-			try {
-				transaction.begin();
-				transaction.commit();
-				return changesExpected;
-			} catch (const std::exception &exception) {
+		DBTransaction transaction;
+		if (!transaction.begin()) {
+			g_logger().error("[{}] Failed to start the transaction", __FUNCTION__);
+			return false;
+		}
+
+		try {
+			if (!toBeExecuted()) {
 				transaction.rollback();
-				g_logger().error("[{}] Error occurred during transaction, error: {}", __FUNCTION__, exception.what());
+				g_logger().error("[{}] Transaction rolled back, a query failed", __FUNCTION__);
 				return false;
 			}
-		} else {
-			return true;
+
+			transaction.commit();
+			return transaction.isCommitted();
+		} catch (const std::exception &exception) {
+			transaction.rollback();
+			g_logger().error("[{}] Error occurred during transaction, error: {}", __FUNCTION__, exception.what());
+			return false;
 		}
 	}
 
@@ -236,8 +461,11 @@ private:
 
 		try {
 			// Start the transaction
+			if (!Database::getInstance().beginTransaction()) {
+				return false;
+			}
 			state = STATE_START;
-			return Database::getInstance().beginTransaction();
+			return true;
 		} catch (const std::exception &exception) {
 			// An error occurred while starting the transaction
 			state = STATE_NO_START;
@@ -271,8 +499,7 @@ private:
 
 		try {
 			// Commit the transaction
-			state = STATE_COMMIT;
-			Database::getInstance().commit();
+			state = Database::getInstance().commit() ? STATE_COMMIT : STATE_NO_START;
 		} catch (const std::exception &exception) {
 			// An error occurred while committing the transaction
 			state = STATE_NO_START;
@@ -57,6 +57,7 @@
 #include "map/spectators.hpp"
 #include "server/network/protocol/protocollogin.hpp"
 #include "server/network/protocol/protocolstatus.hpp"
+#include "server/network/message/sharedmessage.hpp"
 #include "server/network/protocol/protocolgame.hpp"
 #include "server/network/webhook/webhook.hpp"
 #include "server/server.hpp"
@@ -200,7 +201,8 @@ namespace InternalGame {
 	}
 } // Namespace InternalGame
 
-Game::Game() {
+Game::Game() :
+	pathFinder(g_dispatcher()) {
 	offlineTrainingWindow.choices.emplace_back("Sword Fighting and Shielding", SKILL_SWORD);
 	offlineTrainingWindow.choices.emplace_back("Axe Fighting and Shielding", SKILL_AXE);
 	offlineTrainingWindow.choices.emplace_back("Club Fighting and Shielding", SKILL_CLUB);
@@ -1454,21 +1456,21 @@ void Game::playerMoveCreature(const std::shared_ptr<Player> &player, const std::
 
 		if (!Position::areInRange<1, 1, 0>(movingCreatureOrigPos, player->getPosition())) {
 			// need to walk to the creature first before moving it
-			std::vector<Direction> listDir;
-			if (player->getPathTo(movingCreatureOrigPos, listDir, 0, 1, true, true)) {
-				g_dispatcher().addEvent([this, playerId = player->getID(), listDir] { playerAutoWalk(playerId, listDir); }, __FUNCTION__);
-				const auto &task = createPlayerTask(
-					600,
-					[this, player, movingCreature, toTile, movingCreatureOrigPos] {
-						playerMoveCreatureByID(player->getID(), movingCreature->getID(), movingCreatureOrigPos, toTile->getPosition());
-					},
-					__FUNCTION__
-				);
-				player->pushEvent(true);
-				player->setNextActionPushTask(task);
-			} else {
-				player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-			}
+			playerAutoWalkTo(
+				player, movingCreatureOrigPos, 1, true,
+				[this, movingCreature, toTile, movingCreatureOrigPos](const std::shared_ptr<Player> &player) {
+					const auto &task = createPlayerTask(
+						600,
+						[this, player, movingCreature, toTile, movingCreatureOrigPos] {
+							playerMoveCreatureByID(player->getID(), movingCreature->getID(), movingCreatureOrigPos, toTile->getPosition());
+						},
+						__FUNCTION__
+					);
+					player->pushEvent(true);
+					player->setNextActionPushTask(task);
+				},
+				__FUNCTION__
+			);
 			return;
 		}
 
@@ -1757,20 +1759,20 @@ void Game::playerMoveItem(const std::shared_ptr<Player> &player, const Position
 
 	if (!Position::areInRange<1, 1>(playerPos, mapFromPos)) {
 		// need to walk to the item first before using it
-		std::vector<Direction> listDir;
-		if (player->getPathTo(item->getPosition(), listDir, 0, 1, true, true)) {
-			g_dispatcher().addEvent([this, playerId = player->getID(), listDir] { playerAutoWalk(playerId, listDir); }, __FUNCTION__);
-			const auto &task = createPlayerTask(
-				400,
-				[this, playerId = player->getID(), fromPos, itemId, fromStackPos, toPos, count] {
-					playerMoveItemByPlayerID(playerId, fromPos, itemId, fromStackPos, toPos, count);
-				},
-				__FUNCTION__
-			);
-			player->setNextWalkActionTask(task);
-		} else {
-			player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-		}
+		playerAutoWalkTo(
+			player, item->getPosition(), 1, true,
+			[this, fromPos, itemId, fromStackPos, toPos, count](const std::shared_ptr<Player> &player) {
+				const auto &task = createPlayerTask(
+					400,
+					[this, playerId = player->getID(), fromPos, itemId, fromStackPos, toPos, count] {
+						playerMoveItemByPlayerID(playerId, fromPos, itemId, fromStackPos, toPos, count);
+					},
+					__FUNCTION__
+				);
+				player->setNextWalkActionTask(task);
+			},
+			__FUNCTION__
+		);
 		return;
 	}
 
@@ -1819,20 +1821,20 @@ void Game::playerMoveItem(const std::shared_ptr<Player> &player, const Position
 				internalGetPosition(moveItem, itemPos, itemStackPos);
 			}
 
-			std::vector<Direction> listDir;
-			if (player->getPathTo(walkPos, listDir, 0, 0, true, true)) {
-				g_dispatcher().addEvent([this, playerId = player->getID(), listDir] { playerAutoWalk(playerId, listDir); }, __FUNCTION__);
-				const auto &task = createPlayerTask(
-					400,
-					[this, playerId = player->getID(), itemPos, itemId, itemStackPos, toPos, count] {
-						playerMoveItemByPlayerID(playerId, itemPos, itemId, itemStackPos, toPos, count);
-					},
-					__FUNCTION__
-				);
-				player->setNextWalkActionTask(task);
-			} else {
-				player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-			}
+			playerAutoWalkTo(
+				player, walkPos, 0, true,
+				[this, itemPos, itemId, itemStackPos, toPos, count](const std::shared_ptr<Player> &player) {
+					const auto &task = createPlayerTask(
+						400,
+						[this, playerId = player->getID(), itemPos, itemId, itemStackPos, toPos, count] {
+							playerMoveItemByPlayerID(playerId, itemPos, itemId, itemStackPos, toPos, count);
+						},
+						__FUNCTION__
+					);
+					player->setNextWalkActionTask(task);
+				},
+				__FUNCTION__
+			);
 			return;
 		}
 	}
@@ -3772,24 +3774,24 @@ void Game::playerUseItemEx(uint32_t playerId, const Position &fromPos, uint8_t f
 				internalGetPosition(moveItem, itemPos, itemStackPos);
 			}
 
-			std::vector<Direction> listDir;
-			if (player->getPathTo(walkToPos, listDir, 0, 1, true, true)) {
-				g_dispatcher().addEvent([this, playerId = player->getID(), listDir] { playerAutoWalk(playerId, listDir); }, __FUNCTION__);
-				const auto &task = createPlayerTask(
-					400,
-					[this, playerId, itemPos, itemStackPos, fromItemId, toPos, toStackPos, toItemId] {
-						playerUseItemEx(playerId, itemPos, itemStackPos, fromItemId, toPos, toStackPos, toItemId);
-					},
-					__FUNCTION__
-				);
-				if (it.isRune() || it.type == ITEM_TYPE_POTION) {
-					player->setNextPotionActionTask(task);
-				} else {
-					player->setNextWalkActionTask(task);
-				}
-			} else {
-				player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-			}
+			playerAutoWalkTo(
+				player, walkToPos, 1, true,
+				[this, playerId, itemPos, itemStackPos, fromItemId, toPos, toStackPos, toItemId, isPotion = it.isRune() || it.type == ITEM_TYPE_POTION](const std::shared_ptr<Player> &player) {
+					const auto &task = createPlayerTask(
+						400,
+						[this, playerId, itemPos, itemStackPos, fromItemId, toPos, toStackPos, toItemId] {
+							playerUseItemEx(playerId, itemPos, itemStackPos, fromItemId, toPos, toStackPos, toItemId);
+						},
+						__FUNCTION__
+					);
+					if (isPotion) {
+						player->setNextPotionActionTask(task);
+					} else {
+						player->setNextWalkActionTask(task);
+					}
+				},
+				__FUNCTION__
+			);
 			return;
 		}
 
@@ -3893,25 +3895,25 @@ void Game::playerUseItem(uint32_t playerId, const Position &pos, uint8_t stackPo
 	ReturnValue ret = g_actions().canUse(player, pos);
 	if (ret != RETURNVALUE_NOERROR) {
 		if (ret == RETURNVALUE_TOOFARAWAY) {
-			std::vector<Direction> listDir;
-			if (player->getPathTo(pos, listDir, 0, 1, true, true)) {
-				g_dispatcher().addEvent([this, playerId = player->getID(), listDir] { playerAutoWalk(playerId, listDir); }, __FUNCTION__);
-				const auto &task = createPlayerTask(
-					400,
-					[this, playerId, pos, stackPos, index, itemId] {
-						playerUseItem(playerId, pos, stackPos, index, itemId);
-					},
-					__FUNCTION__
-				);
-				if (it.isRune() || it.type == ITEM_TYPE_POTION) {
-					player->setNextPotionActionTask(task);
-				} else {
-					player->setNextWalkActionTask(task);
-				}
-				return;
-			}
-
-			ret = RETURNVALUE_THEREISNOWAY;
+			playerAutoWalkTo(
+				player, pos, 1, true,
+				[this, playerId, pos, stackPos, index, itemId, isPotion = it.isRune() || it.type == ITEM_TYPE_POTION](const std::shared_ptr<Player> &player) {
+					const auto &task = createPlayerTask(
+						400,
+						[this, playerId, pos, stackPos, index, itemId] {
+							playerUseItem(playerId, pos, stackPos, index, itemId);
+						},
+						__FUNCTION__
+					);
+					if (isPotion) {
+						player->setNextPotionActionTask(task);
+					} else {
+						player->setNextWalkActionTask(task);
+					}
+				},
+				__FUNCTION__
+			);
+			return;
 		}
 
 		player->sendCancelMessage(ret);
@@ -4057,24 +4059,24 @@ void Game::playerUseWithCreature(uint32_t playerId, const Position &fromPos, uin
 				internalGetPosition(moveItem, itemPos, itemStackPos);
 			}
 
-			std::vector<Direction> listDir;
-			if (player->getPathTo(walkToPos, listDir, 0, 1, true, true)) {
-				g_dispatcher().addEvent([this, playerId = player->getID(), listDir] { playerAutoWalk(playerId, listDir); }, __FUNCTION__);
-				const auto &task = createPlayerTask(
-					400,
-					[this, playerId, itemPos, itemStackPos, creatureId, itemId] {
-						playerUseWithCreature(playerId, itemPos, itemStackPos, creatureId, itemId);
-					},
-					__FUNCTION__
-				);
-				if (it.isRune() || it.type == ITEM_TYPE_POTION) {
-					player->setNextPotionActionTask(task);
-				} else {
-					player->setNextWalkActionTask(task);
-				}
-			} else {
-				player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-			}
+			playerAutoWalkTo(
+				player, walkToPos, 1, true,
+				[this, playerId, itemPos, itemStackPos, creatureId, itemId, isPotion = it.isRune() || it.type == ITEM_TYPE_POTION](const std::shared_ptr<Player> &player) {
+					const auto &task = createPlayerTask(
+						400,
+						[this, playerId, itemPos, itemStackPos, creatureId, itemId] {
+							playerUseWithCreature(playerId, itemPos, itemStackPos, creatureId, itemId);
+						},
+						__FUNCTION__
+					);
+					if (isPotion) {
+						player->setNextPotionActionTask(task);
+					} else {
+						player->setNextWalkActionTask(task);
+					}
+				},
+				__FUNCTION__
+			);
 			return;
 		}
 
@@ -4221,20 +4223,20 @@ void Game::playerRotateItem(uint32_t playerId, const Position &pos, uint8_t stac
 	}
 
 	if (pos.x != 0xFFFF && !Position::areInRange<1, 1, 0>(pos, player->getPosition())) {
-		std::vector<Direction> listDir;
-		if (player->getPathTo(pos, listDir, 0, 1, true, true)) {
-			g_dispatcher().addEvent([this, playerId = player->getID(), listDir] { playerAutoWalk(playerId, listDir); }, __FUNCTION__);
-			const auto &task = createPlayerTask(
-				400,
-				[this, playerId, pos, stackPos, itemId] {
-					playerRotateItem(playerId, pos, stackPos, itemId);
-				},
-				__FUNCTION__
-			);
-			player->setNextWalkActionTask(task);
-		} else {
-			player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-		}
+		playerAutoWalkTo(
+			player, pos, 1, true,
+			[this, playerId, pos, stackPos, itemId](const std::shared_ptr<Player> &player) {
+				const auto &task = createPlayerTask(
+					400,
+					[this, playerId, pos, stackPos, itemId] {
+						playerRotateItem(playerId, pos, stackPos, itemId);
+					},
+					__FUNCTION__
+				);
+				player->setNextWalkActionTask(task);
+			},
+			__FUNCTION__
+		);
 		return;
 	}
 
@@ -4277,31 +4279,31 @@ void Game::playerConfigureShowOffSocket(uint32_t playerId, const Position &pos,
 
 	bool isPodiumOfRenown = itemId == ITEM_PODIUM_OF_RENOWN1 || itemId == ITEM_PODIUM_OF_RENOWN2;
 	if (!Position::areInRange<1, 1, 0>(pos, player->getPosition())) {
-		std::vector<Direction> listDir;
-		if (player->getPathTo(pos, listDir, 0, 1, true, false)) {
-			g_dispatcher().addEvent([this, playerId = player->getID(), listDir] { playerAutoWalk(playerId, listDir); }, __FUNCTION__);
-			if (isPodiumOfRenown) {
-				const auto &task = createPlayerTask(
-					400,
-					[player, item, pos, itemId, stackPos] {
-						player->sendPodiumWindow(item, pos, itemId, stackPos);
-					},
-					__FUNCTION__
-				);
-				player->setNextWalkActionTask(task);
-			} else {
-				const auto &task = createPlayerTask(
-					400,
-					[player, item, pos, itemId, stackPos] {
-						player->sendMonsterPodiumWindow(item, pos, itemId, stackPos);
-					},
-					__FUNCTION__
-				);
-				player->setNextWalkActionTask(task);
-			}
-		} else {
-			player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-		}
+		playerAutoWalkTo(
+			player, pos, 1, false,
+			[this, item, pos, itemId, stackPos, isPodiumOfRenown](const std::shared_ptr<Player> &player) {
+				if (isPodiumOfRenown) {
+					const auto &task = createPlayerTask(
+						400,
+						[player, item, pos, itemId, stackPos] {
+							player->sendPodiumWindow(item, pos, itemId, stackPos);
+						},
+						__FUNCTION__
+					);
+					player->setNextWalkActionTask(task);
+				} else {
+					const auto &task = createPlayerTask(
+						400,
+						[player, item, pos, itemId, stackPos] {
+							player->sendMonsterPodiumWindow(item, pos, itemId, stackPos);
+						},
+						__FUNCTION__
+					);
+					player->setNextWalkActionTask(task);
+				}
+			},
+			__FUNCTION__
+		);
 		return;
 	}
 
@@ -4346,20 +4348,20 @@ void Game::playerSetShowOffSocket(uint32_t playerId, Outfit_t &outfit, const Pos
 	}
 
 	if (!Position::areInRange<1, 1, 0>(pos, player->getPosition())) {
-		std::vector<Direction> listDir;
-		if (player->getPathTo(pos, listDir, 0, 1, true, false)) {
-			g_dispatcher().addEvent([this, playerId = player->getID(), listDir] { playerAutoWalk(playerId, listDir); }, __FUNCTION__);
-			const auto &task = createPlayerTask(
-				400,
-				[this, playerId, pos] {
-					playerBrowseField(playerId, pos);
-				},
-				__FUNCTION__
-			);
-			player->setNextWalkActionTask(task);
-		} else {
-			player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-		}
+		playerAutoWalkTo(
+			player, pos, 1, false,
+			[this, playerId, pos](const std::shared_ptr<Player> &player) {
+				const auto &task = createPlayerTask(
+					400,
+					[this, playerId, pos] {
+						playerBrowseField(playerId, pos);
+					},
+					__FUNCTION__
+				);
+				player->setNextWalkActionTask(task);
+			},
+			__FUNCTION__
+		);
 		return;
 	}
 
@@ -4502,20 +4504,20 @@ void Game::playerWrapableItem(uint32_t playerId, const Position &pos, uint8_t st
 	}
 
 	if (pos.x != 0xFFFF && !Position::areInRange<1, 1, 0>(pos, player->getPosition())) {
-		std::vector<Direction> listDir;
-		if (player->getPathTo(pos, listDir, 0, 1, true, true)) {
-			g_dispatcher().addEvent([this, playerId = player->getID(), listDir] { playerAutoWalk(playerId, listDir); }, __FUNCTION__);
-			const auto &task = createPlayerTask(
-				400,
-				[this, playerId, pos, stackPos, itemId] {
-					playerWrapableItem(playerId, pos, stackPos, itemId);
-				},
-				__FUNCTION__
-			);
-			player->setNextWalkActionTask(task);
-		} else {
-			player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-		}
+		playerAutoWalkTo(
+			player, pos, 1, true,
+			[this, playerId, pos, stackPos, itemId](const std::shared_ptr<Player> &player) {
+				const auto &task = createPlayerTask(
+					400,
+					[this, playerId, pos, stackPos, itemId] {
+						playerWrapableItem(playerId, pos, stackPos, itemId);
+					},
+					__FUNCTION__
+				);
+				player->setNextWalkActionTask(task);
+			},
+			__FUNCTION__
+		);
 		return;
 	}
 
@@ -4664,6 +4666,7 @@ void Game::playerWriteItem(uint32_t playerId, uint32_t windowTextId, const std::
 		writeItem->removeAttribute(ItemAttribute_t::WRITER);
 		writeItem->removeAttribute(ItemAttribute_t::DATE);
 	}
+	writeItem->markHouseItemsDirty();
 
 	uint16_t newId = Item::items[writeItem->getID()].writeOnceItemId;
 	if (newId != 0) {
@@ -4686,20 +4689,20 @@ void Game::playerBrowseField(uint32_t playerId, const Position &pos) {
 	}
 
 	if (!Position::areInRange<1, 1>(playerPos, pos)) {
-		std::vector<Direction> listDir;
-		if (player->getPathTo(pos, listDir, 0, 1, true, true)) {
-			g_dispatcher().addEvent([this, playerId = player->getID(), listDir] { playerAutoWalk(playerId, listDir); }, __FUNCTION__);
-			const auto &task = createPlayerTask(
-				400,
-				[this, playerId, pos] {
-					playerBrowseField(playerId, pos);
-				},
-				__FUNCTION__
-			);
-			player->setNextWalkActionTask(task);
-		} else {
-			player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-		}
+		playerAutoWalkTo(
+			player, pos, 1, true,
+			[this, playerId, pos](const std::shared_ptr<Player> &player) {
+				const auto &task = createPlayerTask(
+					400,
+					[this, playerId, pos] {
+						playerBrowseField(playerId, pos);
+					},
+					__FUNCTION__
+				);
+				player->setNextWalkActionTask(task);
+			},
+			__FUNCTION__
+		);
 		return;
 	}
 
@@ -4953,20 +4956,20 @@ void Game::playerRequestTrade(uint32_t playerId, const Position &pos, uint8_t st
 	}
 
 	if (!Position::areInRange<1, 1>(tradeItemPosition, playerPosition)) {
-		std::vector<Direction> listDir;
-		if (player->getPathTo(pos, listDir, 0, 1, true, true)) {
-			g_dispatcher().addEvent([this, playerId = player->getID(), listDir] { playerAutoWalk(playerId, listDir); }, __FUNCTION__);
-			const auto &task = createPlayerTask(
-				400,
-				[this, playerId, pos, stackPos, tradePlayerId, itemId] {
-					playerRequestTrade(playerId, pos, stackPos, tradePlayerId, itemId);
-				},
-				__FUNCTION__
-			);
-			player->setNextWalkActionTask(task);
-		} else {
-			player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-		}
+		playerAutoWalkTo(
+			player, pos, 1, true,
+			[this, playerId, pos, stackPos, tradePlayerId, itemId](const std::shared_ptr<Player> &player) {
+				const auto &task = createPlayerTask(
+					400,
+					[this, playerId, pos, stackPos, tradePlayerId, itemId] {
+						playerRequestTrade(playerId, pos, stackPos, tradePlayerId, itemId);
+					},
+					__FUNCTION__
+				);
+				player->setNextWalkActionTask(task);
+			},
+			__FUNCTION__
+		);
 		return;
 	}
 
@@ -5535,20 +5538,20 @@ void Game::playerQuickLoot(uint32_t playerId, const Position &pos, uint16_t item
 	if (!autoLoot && pos.x != 0xffff) {
 		if (!Position::areInRange<1, 1, 0>(pos, player->getPosition())) {
 			// need to walk to the corpse first before looting it
-			std::vector<Direction> listDir;
-			if (player->getPathTo(pos, listDir, 0, 1, true, true)) {
-				g_dispatcher().addEvent([this, playerId = player->getID(), listDir] { playerAutoWalk(playerId, listDir); }, __FUNCTION__);
-				const auto &task = createPlayerTask(
-					300,
-					[this, playerId = player->getID(), pos, itemId, stackPos, defaultItem, lootAllCorpses, autoLoot] {
-						playerQuickLoot(playerId, pos, itemId, stackPos, defaultItem, lootAllCorpses, autoLoot);
-					},
-					__FUNCTION__
-				);
-				player->setNextWalkActionTask(task);
-			} else {
-				player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-			}
+			playerAutoWalkTo(
+				player, pos, 1, true,
+				[this, pos, itemId, stackPos, defaultItem, lootAllCorpses, autoLoot](const std::shared_ptr<Player> &player) {
+					const auto &task = createPlayerTask(
+						300,
+						[this, playerId = player->getID(), pos, itemId, stackPos, defaultItem, lootAllCorpses, autoLoot] {
+							playerQuickLoot(playerId, pos, itemId, stackPos, defaultItem, lootAllCorpses, autoLoot);
+						},
+						__FUNCTION__
+					);
+					player->setNextWalkActionTask(task);
+				},
+				__FUNCTION__
+			);
 
 			return;
 		}
@@ -6360,10 +6363,40 @@ void Game::playerSpeakToNpc(const std::shared_ptr<Player> &player, const std::st
 	player->updateUIExhausted();
 }
 
-std::shared_ptr<Task> Game::createPlayerTask(uint32_t delay, std::function<void(void)> f, const std::string &context) const {
+std::shared_ptr<Task> Game::createPlayerTask(uint32_t delay, TaskFunction &&f, std::string_view context) const {
 	return Player::createPlayerTask(delay, std::move(f), context);
 }
 
+void Game::playerAutoWalkTo(const std::shared_ptr<Player> &player, const Position &pos, int32_t maxTargetDist, bool clearSight, std::function<void(const std::shared_ptr<Player> &)> &&onPathFound, std::string_view context) {
+	// Same search as player->getPathTo(pos, listDir, 0, maxTargetDist, true, clearSight)
+	FindPathParams fpp;
+	fpp.clearSight = clearSight;
+	fpp.maxSearchDist = 7;
+	fpp.minTargetDist = 0;
+	fpp.maxTargetDist = maxTargetDist;
+
+	pathFinder.request(
+		[player, pos, fpp](std::vector<Direction> &listDir) {
+			return player->getPathTo(pos, listDir, fpp);
+		},
+		[this, playerId = player->getID(), onPathFound = std::move(onPathFound)](bool found, const std::vector<Direction> &listDir) {
+			const auto &player = getPlayerByID(playerId);
+			if (!player) {
+				return;
+			}
+
+			if (!found) {
+				player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
+				return;
+			}
+
+			onPathFound(player);
+			playerAutoWalk(playerId, listDir);
+		},
+		context
+	);
+}
+
 //--
 bool Game::canThrowObjectTo(const Position &fromPos, const Position &toPos, const SightLines_t lineOfSight /*= SightLine_CheckSightLine*/, const int32_t rangex /*= Map::maxClientViewportX*/, const int32_t rangey /*= Map::maxClientViewportY*/) {
 	return map.canThrowObjectTo(fromPos, toPos, lineOfSight, rangex, rangey);
@@ -6480,10 +6513,54 @@ void Game::removeCreatureCheck(const std::shared_ptr<Creature> &creature) {
 	}
 }
 
+void Game::prepareCreaturesThink(const std::vector<std::shared_ptr<Creature>> &creatures) {
+	// Below this the round trip to the thread pool costs more than it saves
+	static constexpr size_t MIN_PARALLEL_CREATURES = 256;
+	// Regions of 128x128 tiles (8x8 map sectors), creatures of a shard read the same sectors
+	static constexpr uint8_t REGION_BITS = 7;
+	// Crowded regions are split further, so one hunting spot does not end up on a single thread
+	static constexpr size_t MAX_SHARD_SIZE = 64;
+
+	thinkRegionCreatures.clear();
+	for (const auto &creature : creatures) {
+		if (creature->creatureCheck && creature->isAlive()) {
+			const auto &pos = creature->getPosition();
+			const auto region = static_cast<uint64_t>(pos.z) << 32 | static_cast<uint64_t>(pos.x >> REGION_BITS) << 16 | static_cast<uint64_t>(pos.y >> REGION_BITS);
+			thinkRegionCreatures.emplace_back(region, creature.get());
+		}
+	}
+
+	if (thinkRegionCreatures.size() < MIN_PARALLEL_CREATURES) {
+		return;
+	}
+
+	std::ranges::sort(thinkRegionCreatures, {}, &std::pair<uint64_t, Creature*>::first);
+
+	thinkShards.clear();
+	for (size_t i = 0; i < thinkRegionCreatures.size(); ++i) {
+		if (i == 0 || thinkRegionCreatures[i].first != thinkRegionCreatures[i - 1].first || i - thinkShards.back() == MAX_SHARD_SIZE) {
+			thinkShards.emplace_back(i);
+		}
+	}
+	thinkShards.emplace_back(thinkRegionCreatures.size());
+
+	// Nothing is committed here, the creatures only evaluate what their onThink will need
+	g_dispatcher().asyncWait(thinkShards.size() - 1, [this](size_t i) {
+		for (auto j = thinkShards[i]; j < thinkShards[i + 1]; ++j) {
+			thinkRegionCreatures[j].second->prepareThink(EVENT_CREATURE_THINK_INTERVAL);
+		}
+	});
+}
+
 void Game::checkCreatures() {
 	metrics::method_latency measure(__METRICS_METHOD_NAME__);
 	static size_t index = 0;
 
+	if (g_configManager().getBoolean(TOGGLE_PARALLEL_CREATURE_THINK)) {
+		prepareCreaturesThink(checkCreatureLists[index]);
+	}
+
+	// Creatures think and commit their changes serially, in the same order as always
 	std::erase_if(checkCreatureLists[index], [this](const std::shared_ptr<Creature> creature) {
 		if (creature->creatureCheck && creature->isAlive()) {
 			creature->onThink(EVENT_CREATURE_THINK_INTERVAL);
@@ -6591,6 +6668,7 @@ void Game::sendSingleSoundEffect(const Position &pos, SoundEffect_t soundId, con
 	}
 
 	using enum SourceEffect_t;
+	SharedMessageCache shared;
 	for (const auto &spectator : Spectators().find<Player>(pos)) {
 		SourceEffect_t source = CREATURES;
 		if (!actor || actor->getNpc()) {
@@ -6601,7 +6679,7 @@ void Game::sendSingleSoundEffect(const Position &pos, SoundEffect_t soundId, con
 			source = OTHERS;
 		}
 
-		spectator->getPlayer()->sendSingleSoundEffect(pos, soundId, source);
+		spectator->getPlayer()->sendSingleSoundEffect(pos, soundId, source, shared);
 	}
 }
 
@@ -6612,6 +6690,7 @@ void Game::sendDoubleSoundEffect(const Position &pos, SoundEffect_t mainSoundEff
 	}
 
 	using enum SourceEffect_t;
+	SharedMessageCache shared;
 	for (const auto &spectator : Spectators().find<Player>(pos)) {
 		SourceEffect_t source = CREATURES;
 		if (!actor || actor->getNpc()) {
@@ -6622,7 +6701,7 @@ void Game::sendDoubleSoundEffect(const Position &pos, SoundEffect_t mainSoundEff
 			source = OTHERS;
 		}
 
-		spectator->getPlayer()->sendDoubleSoundEffect(pos, mainSoundEffect, source, secondarySoundEffect, source);
+		spectator->getPlayer()->sendDoubleSoundEffect(pos, mainSoundEffect, source, secondarySoundEffect, source, shared);
 	}
 }
 
@@ -7970,9 +8049,10 @@ void Game::addCreatureHealth(const CreatureVector &spectators, const std::shared
 			}
 		}
 	}
+	SharedMessageCache shared;
 	for (const auto &spectator : spectators) {
 		if (const auto &tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendCreatureHealth(target);
+			tmpPlayer->sendCreatureHealth(target, shared);
 		}
 	}
 }
@@ -8000,9 +8080,10 @@ void Game::addMagicEffect(const Position &pos, uint16_t effect) {
 }
 
 void Game::addMagicEffect(const CreatureVector &spectators, const Position &pos, uint16_t effect) {
+	SharedMessageCache shared;
 	for (const auto &spectator : spectators) {
 		if (const auto &tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendMagicEffect(pos, effect);
+			tmpPlayer->sendMagicEffect(pos, effect, shared);
 		}
 	}
 }
@@ -8026,9 +8107,10 @@ void Game::addDistanceEffect(const Position &fromPos, const Position &toPos, uin
 }
 
 void Game::addDistanceEffect(const CreatureVector &spectators, const Position &fromPos, const Position &toPos, uint16_t effect) {
+	SharedMessageCache shared;
 	for (const auto &spectator : spectators) {
 		if (const auto &tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendDistanceShoot(fromPos, toPos, effect);
+			tmpPlayer->sendDistanceShoot(fromPos, toPos, effect, shared);
 		}
 	}
 }
@@ -9629,20 +9711,20 @@ void Game::playerSetMonsterPodium(uint32_t playerId, uint32_t monsterRaceId, con
 	}
 
 	if (!Position::areInRange<1, 1, 0>(pos, player->getPosition())) {
-		if (std::vector<Direction> listDir;
-		    player->getPathTo(pos, listDir, 0, 1, true, false)) {
-			g_dispatcher().addEvent([this, playerId = player->getID(), listDir] { playerAutoWalk(playerId, listDir); }, __FUNCTION__);
-			const auto &task = createPlayerTask(
-				400,
-				[this, playerId, pos] {
-					playerBrowseField(playerId, pos);
-				},
-				__FUNCTION__
-			);
-			player->setNextWalkActionTask(task);
-		} else {
-			player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-		}
+		playerAutoWalkTo(
+			player, pos, 1, false,
+			[this, playerId, pos](const std::shared_ptr<Player> &player) {
+				const auto &task = createPlayerTask(
+					400,
+					[this, playerId, pos] {
+						playerBrowseField(playerId, pos);
+					},
+					__FUNCTION__
+				);
+				player->setNextWalkActionTask(task);
+			},
+			__FUNCTION__
+		);
 		return;
 	}
 
@@ -9733,20 +9815,20 @@ void Game::playerRotatePodium(uint32_t playerId, const Position &pos, uint8_t st
 	}
 
 	if (pos.x != 0xFFFF && !Position::areInRange<1, 1, 0>(pos, player->getPosition())) {
-		if (std::vector<Direction> listDir;
-		    player->getPathTo(pos, listDir, 0, 1, true, true)) {
-			g_dispatcher().addEvent([this, playerId = player->getID(), listDir] { playerAutoWalk(playerId, listDir); }, __FUNCTION__);
-			const auto &task = createPlayerTask(
-				400,
-				[this, playerId, pos, stackPos, itemId] {
-					playerRotatePodium(playerId, pos, stackPos, itemId);
-				},
-				__FUNCTION__
-			);
-			player->setNextWalkActionTask(task);
-		} else {
-			player->sendCancelMessage(RETURNVALUE_THEREISNOWAY);
-		}
+		playerAutoWalkTo(
+			player, pos, 1, true,
+			[this, playerId, pos, stackPos, itemId](const std::shared_ptr<Player> &player) {
+				const auto &task = createPlayerTask(
+					400,
+					[this, playerId, pos, stackPos, itemId] {
+						playerRotatePodium(playerId, pos, stackPos, itemId);
+					},
+					__FUNCTION__
+				);
+				player->setNextWalkActionTask(task);
+			},
+			__FUNCTION__
+		);
 		return;
 	}
 
@@ -10831,7 +10913,6 @@ void Game::updatePlayersOnline() const {
 	// Function to be executed within the transaction
 	auto updateOperation = [this]() {
 		const auto &m_players = getPlayers();
-		bool changesMade = false;
 
 		// g_metrics().addUpDownCounter("players_online", 1);
 		// g_metrics().addUpDownCounter("players_online", -1);
@@ -10842,7 +10923,6 @@ void Game::updatePlayersOnline() const {
 			int count = result->getNumber<int>("count");
 			if (count > 0) {
 				g_database().executeQuery("DELETE FROM `players_online`;");
-				changesMade = true;
 			}
 		} else {
 			// Insert the current players
@@ -10853,7 +10933,6 @@ void Game::updatePlayersOnline() const {
 				stmt.addRow(playerQuery.str());
 			}
 			stmt.execute();
-			changesMade = true;
 
 			// Remove players who are no longer online
 			std::ostringstream cleanupQuery;
@@ -10866,7 +10945,8 @@ void Game::updatePlayersOnline() const {
 			g_database().executeQuery(cleanupQuery.str());
 		}
 
-		return changesMade;
+		// Nothing to change is not a failure, returning false would roll back and log an error
+		return true;
 	};
 
 	const bool success = DBTransaction::executeWithinTransaction(updateOperation);
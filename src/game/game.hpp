@@ -14,8 +14,10 @@
 #include "creatures/players/cyclopedia/player_title.hpp"
 #include "creatures/players/grouping/familiars.hpp"
 #include "creatures/players/grouping/groups.hpp"
+#include "game/scheduling/task.hpp"
 #include "lua/creature/raids.hpp"
 #include "map/map.hpp"
+#include "map/utils/pathfinder.hpp"
 #include "modal_window/modal_window.hpp"
 #include "movement/position.hpp"
 
@@ -43,7 +45,6 @@ class Player;
 class Account;
 class TeamFinder;
 class NetworkMessage;
-class Task;
 class Container;
 class ContainerIterator;
 class Item;
@@ -558,6 +559,7 @@ public:
 	Groups groups;
 	[[no_unique_address]] Familiars familiars;
 	Map map;
+	PathFinder pathFinder;
 	std::unique_ptr<Mounts> mounts;
 	[[no_unique_address]] Outfits outfits;
 	Raids raids;
@@ -727,16 +729,26 @@ private:
 	std::unordered_map<uint16_t, std::string> m_hirelingSkills;
 	std::unordered_map<uint16_t, std::string> m_hirelingOutfits;
 
-	std::map<uint32_t, int32_t> forgeMonsterEventIds;
+	std::map<uint32_t, uint64_t> forgeMonsterEventIds;
 	std::unordered_set<uint32_t> fiendishMonsters;
 	std::unordered_set<uint32_t> influencedMonsters;
+
+	// Scratch buffers of prepareCreaturesThink: creatures sorted by map region and the shard boundaries
+	std::vector<std::pair<uint64_t, Creature*>> thinkRegionCreatures;
+	std::vector<size_t> thinkShards;
+	void prepareCreaturesThink(const std::vector<std::shared_ptr<Creature>> &creatures);
 	void checkImbuements() const;
 	bool playerSaySpell(const std::shared_ptr<Player> &player, SpeakClasses type, const std::string &text);
 	void playerWhisper(const std::shared_ptr<Player> &player, const std::string &text);
 	bool playerYell(const std::shared_ptr<Player> &player, const std::string &text);
 	bool playerSpeakTo(const std::shared_ptr<Player> &player, SpeakClasses type, const std::string &receiver, const std::string &text);
 	void playerSpeakToNpc(const std::shared_ptr<Player> &player, const std::string &text);
-	std::shared_ptr<Task> createPlayerTask(uint32_t delay, std::function<void(void)> f, const std::string &context) const;
+	std::shared_ptr<Task> createPlayerTask(uint32_t delay, TaskFunction &&f, std::string_view context) const;
+	/**
+	 * Walks the player to 'pos' (next to it with maxTargetDist 1) on a path from the path finder.
+	 * Once the path is found 'onPathFound' sets up what the player does on arrival, without one the player is told there is no way.
+	 */
+	void playerAutoWalkTo(const std::shared_ptr<Player> &player, const Position &pos, int32_t maxTargetDist, bool clearSight, std::function<void(const std::shared_ptr<Player> &)> &&onPathFound, std::string_view context);
 
 	/**
 	 * @brief Finds the managed container for loot or obtain based on the given parameters.
@@ -11,6 +11,7 @@
 
 #include "lib/thread/thread_pool.hpp"
 #include "lib/di/container.hpp"
+#include "lib/metrics/metrics.hpp"
 #include "utils/tools.hpp"
 
 thread_local DispatcherContext Dispatcher::dispacherContext;
@@ -22,8 +23,11 @@ Dispatcher &Dispatcher::getInstance() {
 void Dispatcher::init() {
 	UPDATE_OTSYS_TIME();
 
+	timingWheel.start(OTSYS_TIME());
+
 	threadPool.detach_task([this] {
 		std::unique_lock asyncLock(dummyMutex);
+		dispatcherThreadId = ThreadPool::getThreadId();
 
 		while (!threadPool.isStopped()) {
 			UPDATE_OTSYS_TIME();
@@ -39,18 +43,45 @@ void Dispatcher::init() {
 	});
 }
 
+// Runs a task on the dispatcher thread, feeding the task profiler in metrics builds
+bool Dispatcher::executeTask(const Task &task) {
+#ifdef FEATURE_METRICS
+	const auto waitTime = task.getWaitTime();
+	const auto start = std::chrono::steady_clock::now();
+	if (!task.execute()) {
+		return false;
+	}
+
+	const auto executionTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	taskProfiler.record(task.getContext(), executionTime, waitTime);
+	return true;
+#else
+	return task.execute();
+#endif
+}
+
+void Dispatcher::recordQueueDepth([[maybe_unused]] std::string_view group, [[maybe_unused]] size_t depth) const {
+#ifdef FEATURE_METRICS
+	g_metrics().recordHistogram("dispatcher_queue_depth", static_cast<double>(depth), { { "group", std::string(group) } });
+#endif
+}
+
 void Dispatcher::executeSerialEvents(const uint8_t groupId) {
 	auto &tasks = m_tasks[groupId];
 	if (tasks.empty()) {
 		return;
 	}
 
+	const auto groupName = magic_enum::enum_name(static_cast<TaskGroup>(groupId));
+	recordQueueDepth(groupName, tasks.size());
+	metrics::dispatcher_latency measure(groupName);
+
 	dispacherContext.group = static_cast<TaskGroup>(groupId);
 	dispacherContext.type = DispatcherType::Event;
 
 	for (const auto &task : tasks) {
 		dispacherContext.taskName = task.getContext();
-		if (task.execute()) {
+		if (executeTask(task)) {
 			++dispatcherCycle;
 		}
 	}
@@ -65,6 +96,10 @@ void Dispatcher::executeParallelEvents(const uint8_t groupId) {
 		return;
 	}
 
+	const auto groupName = magic_enum::enum_name(static_cast<TaskGroup>(groupId));
+	recordQueueDepth(groupName, tasks.size());
+	metrics::dispatcher_latency measure(groupName);
+
 	asyncWait(tasks.size(), [groupId, &tasks](size_t i) {
 		dispacherContext.type = DispatcherType::AsyncEvent;
 		dispacherContext.group = static_cast<TaskGroup>(groupId);
@@ -89,27 +124,33 @@ void Dispatcher::asyncWait(size_t requestSize, std::function<void(size_t i)> &&f
 		return;
 	}
 
-	const auto &partitions = generatePartition(requestSize);
-	const auto pSize = partitions.size();
+	// Written before any helper starts, only read while the batch runs
+	++asyncBatch;
 
-	BS::multi_future<void> retFuture;
+	const auto chunkSize = getAsyncChunkSize(requestSize);
+	const auto chunks = (requestSize + chunkSize - 1) / chunkSize;
+	const auto helpers = std::min<size_t>(threadPool.get_thread_count(), chunks - 1);
 
-	if (pSize > 1) {
-		asyncWaitDisabled = true;
-		const auto min = partitions[1].first;
-		const auto max = partitions[partitions.size() - 1].second;
-		retFuture = threadPool.submit_loop(min, max, [&f](const unsigned int i) { f(i); });
-	}
-
-	const auto &[min, max] = partitions[0];
-	for (uint_fast64_t i = min; i < max; ++i) {
-		f(i);
-	}
+	asyncWaitDisabled = helpers > 0;
 
-	if (pSize > 1) {
-		retFuture.wait();
+	try {
+		threadPool.parallelFor(requestSize, chunkSize, helpers, [&f](size_t i) {
+			// Indexes run concurrently, so whatever must reach the dispatcher thread has to be deferred (see safeCall)
+			const auto previousType = std::exchange(dispacherContext.type, DispatcherType::AsyncEvent);
+			try {
+				f(i);
+			} catch (...) {
+				dispacherContext.type = previousType;
+				throw;
+			}
+			dispacherContext.type = previousType;
+		});
+	} catch (...) {
 		asyncWaitDisabled = false;
+		throw;
 	}
+
+	asyncWaitDisabled = false;
 }
 
 void Dispatcher::executeEvents(const TaskGroup startGroup) {
@@ -127,61 +168,82 @@ void Dispatcher::executeEvents(const TaskGroup startGroup) {
 }
 
 void Dispatcher::executeScheduledEvents() {
-	auto &threadScheduledTasks = getThreadTask()->scheduledTasks;
+	expiredTimers.clear();
+	timingWheel.advance(OTSYS_TIME(), expiredTimers);
+	if (!expiredTimers.empty()) {
+		executeExpiredTimers();
+	}
+
+	mergeAsyncEvents(); // merge async events requested by scheduled events
+	executeEvents(TaskGroup::GenericParallel); // execute async events requested by scheduled events
+}
+
+void Dispatcher::executeExpiredTimers() {
+	recordQueueDepth("Scheduled", timingWheel.size() + expiredTimers.size());
+	metrics::dispatcher_latency measure("Scheduled");
+
+	for (const auto index : expiredTimers) {
+		const auto &task = timerSlots.at(index).task;
+		const auto eventId = task->getId();
 
-	auto it = scheduledTasks.begin();
-	while (it != scheduledTasks.end()) {
-		const auto &task = *it;
-		if (task->getTime() > OTSYS_TIME()) {
-			break;
+		// Cancelled by stopEvent after it was placed in the wheel
+		if (!timerSlots.isActive(eventId)) {
+			timerSlots.release(eventId);
+			continue;
 		}
 
 		dispacherContext.type = task->isCycle() ? DispatcherType::CycleEvent : DispatcherType::ScheduledEvent;
 		dispacherContext.group = TaskGroup::Serial;
 		dispacherContext.taskName = task->getContext();
 
-		if (task->execute() && task->isCycle()) {
+		if (executeTask(*task) && task->isCycle() && timerSlots.isActive(eventId)) {
+			// Cycle events keep their slot and event id, they are only linked again further ahead
 			task->updateTime();
-			threadScheduledTasks.emplace_back(task);
+			timingWheel.insert(index, task->getTime());
 		} else {
-			scheduledTasksRef.erase(task->getId());
+			timerSlots.release(eventId);
 		}
-
-		++it;
-	}
-
-	if (it != scheduledTasks.begin()) {
-		scheduledTasks.erase(scheduledTasks.begin(), it);
 	}
 
 	dispacherContext.reset();
+}
 
-	mergeAsyncEvents(); // merge async events requested by scheduled events
-	executeEvents(TaskGroup::GenericParallel); // execute async events requested by scheduled events
+void Dispatcher::addScheduledEvent(std::shared_ptr<Task> &&task) {
+	const auto eventId = task->getId();
+	if (!timerSlots.isActive(eventId)) {
+		// Stopped before it reached the dispatcher
+		timerSlots.release(eventId);
+		return;
+	}
+
+	const auto index = TimerSlots::indexOf(eventId);
+	auto &slot = timerSlots.at(index);
+	slot.task = std::move(task);
+	timingWheel.insert(index, slot.task->getTime());
 }
 
 void Dispatcher::__mergeEvents(const std::array<uint8_t, 2> &groups, const bool mergeScheduledEvents) {
-	for (const auto &thread : threads) {
-		std::scoped_lock lock(thread->mutex);
+	const auto merge = [&](ThreadTask &thread) {
 		for (const auto group : groups) {
-			auto &threadTasks = thread->tasks[group];
 			auto &tasks = m_tasks[group];
-
-			if (threadTasks.size() > tasks.size()) {
-				tasks.swap(threadTasks);
-			}
-
-			if (!threadTasks.empty()) {
-				tasks.insert(tasks.end(), make_move_iterator(threadTasks.begin()), make_move_iterator(threadTasks.end()));
-				threadTasks.clear();
-			}
+			thread.tasks[group].drain([&tasks](Task &&task) {
+				tasks.emplace_back(std::move(task));
+			});
 		}
 
-		if (mergeScheduledEvents && !thread->scheduledTasks.empty()) {
-			scheduledTasks.insert(make_move_iterator(thread->scheduledTasks.begin()), make_move_iterator(thread->scheduledTasks.end()));
-			thread->scheduledTasks.clear();
+		if (mergeScheduledEvents) {
+			thread.scheduledTasks.drain([this](std::shared_ptr<Task> &&task) {
+				addScheduledEvent(std::move(task));
+			});
 		}
+	};
+
+	for (const auto &thread : threads) {
+		merge(*thread);
 	}
+
+	// Only producers take the lock, the dispatcher is the single consumer of every task
+	merge(sharedThreadTask);
 }
 
 // Merge only async thread events with main dispatch events
@@ -201,53 +263,64 @@ std::chrono::milliseconds Dispatcher::timeUntilNextScheduledTask() const {
 	constexpr auto CHRONO_0 = std::chrono::milliseconds(0);
 	constexpr auto CHRONO_MILI_MAX = std::chrono::milliseconds::max();
 
-	if (scheduledTasks.empty()) {
+	const auto nextExpiration = timingWheel.nextExpiration();
+	if (nextExpiration == std::numeric_limits<int64_t>::max()) {
 		return CHRONO_MILI_MAX;
 	}
 
-	const auto &task = *scheduledTasks.begin();
-	const auto timeRemaining = std::chrono::milliseconds(task->getTime() - OTSYS_TIME());
+	const auto timeRemaining = std::chrono::milliseconds(nextExpiration - OTSYS_TIME());
 	return std::max<std::chrono::milliseconds>(timeRemaining, CHRONO_0);
 }
 
-void Dispatcher::addEvent(std::function<void(void)> &&f, std::string_view context, uint32_t expiresAfterMs) {
-	const auto &thread = getThreadTask();
-	std::scoped_lock lock(thread->mutex);
-	thread->tasks[static_cast<uint8_t>(TaskGroup::Serial)].emplace_back(expiresAfterMs, std::move(f), context);
+void Dispatcher::addEvent(TaskFunction &&f, std::string_view context, uint32_t expiresAfterMs) {
+	withThreadTask([&](ThreadTask &thread) {
+		thread.tasks[static_cast<uint8_t>(TaskGroup::Serial)].emplace(expiresAfterMs, std::move(f), context);
+	});
 	notify();
 }
 
-void Dispatcher::addWalkEvent(std::function<void(void)> &&f, uint32_t expiresAfterMs) {
-	const auto &thread = getThreadTask();
-	std::scoped_lock lock(thread->mutex);
-	thread->tasks[static_cast<uint8_t>(TaskGroup::Walk)].emplace_back(expiresAfterMs, std::move(f), this->context().taskName);
+void Dispatcher::addWalkEvent(TaskFunction &&f, uint32_t expiresAfterMs) {
+	withThreadTask([&](ThreadTask &thread) {
+		thread.tasks[static_cast<uint8_t>(TaskGroup::Walk)].emplace(expiresAfterMs, std::move(f), this->context().taskName);
+	});
 	notify();
 }
 
 uint64_t Dispatcher::scheduleEvent(const std::shared_ptr<Task> &task) {
-	const auto &thread = getThreadTask();
-	std::scoped_lock lock(thread->mutex);
+	const auto eventId = timerSlots.acquire();
+	if (eventId == 0) {
+		return 0;
+	}
 
-	auto eventId = scheduledTasksRef
-					   .emplace(task->getId(), thread->scheduledTasks.emplace_back(task))
-					   .first->first;
+	task->id = eventId;
+	withThreadTask([&task](ThreadTask &thread) {
+		thread.scheduledTasks.emplace(task);
+	});
 
 	notify();
 	return eventId;
 }
 
-void Dispatcher::asyncEvent(std::function<void(void)> &&f, TaskGroup group) {
-	const auto &thread = getThreadTask();
-	std::scoped_lock lock(thread->mutex);
-	thread->tasks[static_cast<uint8_t>(group)].emplace_back(0, std::move(f), dispacherContext.taskName);
+void Dispatcher::asyncEvent(TaskFunction &&f, TaskGroup group) {
+	withThreadTask([&](ThreadTask &thread) {
+		thread.tasks[static_cast<uint8_t>(group)].emplace(0, std::move(f), dispacherContext.taskName);
+	});
 	notify();
 }
 
 void Dispatcher::stopEvent(uint64_t eventId) {
-	auto it = scheduledTasksRef.find(eventId);
-	if (it != scheduledTasksRef.end()) {
-		it->second->cancel();
-		scheduledTasksRef.erase(it);
+	if (!timerSlots.cancel(eventId)) {
+		return;
+	}
+
+	// On the dispatcher thread the event is dropped right away, releasing whatever its callback captured.
+	// Other threads only invalidate the id, the dispatcher discards the event when the wheel reaches it.
+	if (ThreadPool::getThreadId() == dispatcherThreadId) {
+		const auto index = TimerSlots::indexOf(eventId);
+		if (timerSlots.at(index).linked) {
+			timingWheel.remove(index);
+			timerSlots.release(eventId);
+		}
 	}
 }
 
@@ -10,7 +10,10 @@
 #pragma once
 
 #include "task.hpp"
+#include "task_profiler.hpp"
+#include "timing_wheel.hpp"
 #include "lib/thread/thread_pool.hpp"
+#include "utils/lockfree.hpp"
 
 static constexpr uint16_t DISPATCHER_TASK_EXPIRATION = 2000;
 static constexpr uint16_t SCHEDULER_MINTICKS = 50;
@@ -69,6 +72,55 @@ private:
 	friend class Dispatcher;
 };
 
+/**
+ * Lock-free submission channel owned by a single producer thread and drained by the dispatcher thread.
+ * When the ring is full, the tasks spill into a mutex-guarded overflow vector so submitting never fails.
+ * Once spilled, the producer keeps using the overflow until the dispatcher drains it, preserving FIFO order.
+ */
+template <typename T>
+class TaskChannel {
+public:
+	static constexpr size_t RING_CAPACITY = 2048;
+
+	template <typename... Args>
+	void emplace(Args &&... args) {
+		if (!spilled.load(std::memory_order_acquire) && ring.try_emplace(std::forward<Args>(args)...)) {
+			return;
+		}
+
+		std::scoped_lock lock(overflowMutex);
+		overflow.emplace_back(std::forward<Args>(args)...);
+		spilled.store(true, std::memory_order_release);
+	}
+
+	template <typename F>
+	void drain(F &&f) {
+		// Checked before draining the ring: if the producer had already spilled,
+		// everything in the ring is older than the overflow and must run first.
+		const bool hasOverflow = spilled.load(std::memory_order_acquire);
+		ring.consume_all(f);
+
+		if (hasOverflow) {
+			std::scoped_lock lock(overflowMutex);
+			for (auto &item : overflow) {
+				f(std::move(item));
+			}
+			overflow.clear();
+			spilled.store(false, std::memory_order_release);
+		}
+	}
+
+	[[nodiscard]] bool empty() const {
+		return ring.empty() && !spilled.load(std::memory_order_acquire);
+	}
+
+private:
+	SPSCQueue<T, RING_CAPACITY> ring;
+	std::atomic_bool spilled = false;
+	std::mutex overflowMutex;
+	std::vector<T> overflow;
+};
+
 /**
  * Dispatcher allow you to dispatch a task async to be executed
  * in the dispatching thread. You can dispatch with an expiration
@@ -77,13 +129,13 @@ private:
 class Dispatcher {
 public:
 	explicit Dispatcher(ThreadPool &threadPool) :
-		threadPool(threadPool) {
+		threadPool(threadPool), timingWheel(timerSlots) {
 		threads.reserve(threadPool.get_thread_count() + 1);
 		for (uint_fast16_t i = 0; i < threads.capacity(); ++i) {
 			threads.emplace_back(std::make_unique<ThreadTask>());
 		}
 
-		scheduledTasksRef.reserve(2000);
+		expiredTimers.reserve(2000);
 	}
 
 	// Ensures that we don't accidentally copy it
@@ -92,19 +144,19 @@ public:
 
 	static Dispatcher &getInstance();
 
-	void addEvent(std::function<void(void)> &&f, std::string_view context, uint32_t expiresAfterMs = 0);
-	void addWalkEvent(std::function<void(void)> &&f, uint32_t expiresAfterMs = 0); // No need context name
+	void addEvent(TaskFunction &&f, std::string_view context, uint32_t expiresAfterMs = 0);
+	void addWalkEvent(TaskFunction &&f, uint32_t expiresAfterMs = 0); // No need context name
 
-	uint64_t cycleEvent(uint32_t delay, std::function<void(void)> &&f, std::string_view context) {
+	uint64_t cycleEvent(uint32_t delay, TaskFunction &&f, std::string_view context) {
 		return scheduleEvent(delay, std::move(f), context, true);
 	}
 
 	uint64_t scheduleEvent(const std::shared_ptr<Task> &task);
-	uint64_t scheduleEvent(uint32_t delay, std::function<void(void)> &&f, std::string_view context) {
+	uint64_t scheduleEvent(uint32_t delay, TaskFunction &&f, std::string_view context) {
 		return scheduleEvent(delay, std::move(f), context, false);
 	}
 
-	void asyncEvent(std::function<void(void)> &&f, TaskGroup group = TaskGroup::GenericParallel);
+	void asyncEvent(TaskFunction &&f, TaskGroup group = TaskGroup::GenericParallel);
 	void asyncWait(size_t size, std::function<void(size_t i)> &&f);
 
 	uint64_t asyncCycleEvent(uint32_t delay, std::function<void(void)> &&f, TaskGroup group = TaskGroup::GenericParallel) {
@@ -123,21 +175,42 @@ public:
 		return dispatcherCycle;
 	}
 
+	// Changes every time asyncWait fans out, the map doesn't change while the parallel events of one batch run
+	[[nodiscard]] uint64_t getAsyncBatch() const {
+		return asyncBatch;
+	}
+
 	void stopEvent(uint64_t eventId);
 
 	const auto &context() const {
 		return dispacherContext;
 	}
 
+	const TaskProfiler &getTaskProfiler() const {
+		return taskProfiler;
+	}
+
 private:
 	thread_local static DispatcherContext dispacherContext;
 
-	const auto &getThreadTask() const {
-		return threads[ThreadPool::getThreadId()];
+	/**
+	 * Hands the task of the calling thread to 'f'. Each pool thread owns a slot and is the only producer
+	 * of its rings, threads outside the pool (network, signals) share one task and take turns on it.
+	 */
+	template <typename F>
+	void withThreadTask(F &&f) {
+		const auto id = static_cast<size_t>(ThreadPool::getThreadId());
+		if (id < threads.size()) {
+			f(*threads[id]);
+			return;
+		}
+
+		std::scoped_lock lock(sharedThreadTaskMutex);
+		f(sharedThreadTask);
 	}
 
-	uint64_t scheduleEvent(uint32_t delay, std::function<void(void)> &&f, std::string_view context, bool cycle, bool log = true) {
-		return scheduleEvent(std::make_shared<Task>(std::move(f), context, delay, cycle, log));
+	uint64_t scheduleEvent(uint32_t delay, TaskFunction &&f, std::string_view context, bool cycle, bool log = true) {
+		return scheduleEvent(Task::create(std::move(f), context, delay, cycle, log));
 	}
 
 	void init();
@@ -151,6 +224,11 @@ private:
 
 	inline void executeEvents(const TaskGroup startGroup = TaskGroup::Walk);
 	inline void executeScheduledEvents();
+	inline void executeExpiredTimers();
+	inline void addScheduledEvent(std::shared_ptr<Task> &&task);
+
+	inline bool executeTask(const Task &task);
+	inline void recordQueueDepth(std::string_view group, size_t depth) const;
 
 	inline void executeSerialEvents(const uint8_t groupId);
 	inline void executeParallelEvents(const uint8_t groupId);
@@ -173,23 +251,19 @@ private:
 		}
 	}
 
-	std::vector<std::pair<uint64_t, uint64_t>> generatePartition(size_t size) const {
-		if (size == 0) {
-			return {};
-		}
-
-		std::vector<std::pair<uint64_t, uint64_t>> list;
-		list.reserve(threadPool.get_thread_count());
-
-		const auto size_per_block = std::ceil(size / static_cast<float>(threadPool.get_thread_count()));
-		for (uint_fast64_t i = 0; i < size; i += size_per_block) {
-			list.emplace_back(i, std::min<uint64_t>(size, i + size_per_block));
-		}
-
-		return list;
+	/**
+	 * Number of indexes claimed at once by each worker in asyncWait.
+	 * Small enough for idle threads to steal the remaining work of a busy one,
+	 * big enough to keep the shared counter off the hot path.
+	 */
+	size_t getAsyncChunkSize(size_t size) const {
+		static constexpr size_t CHUNKS_PER_THREAD = 4;
+		const auto chunks = static_cast<size_t>(threadPool.get_thread_count()) * CHUNKS_PER_THREAD;
+		return std::max<size_t>(1, size / chunks);
 	}
 
 	uint_fast64_t dispatcherCycle = 0;
+	uint64_t asyncBatch = 0;
 
 	ThreadPool &threadPool;
 	std::condition_variable signalSchedule;
@@ -198,24 +272,25 @@ private:
 
 	// Thread Events
 	struct ThreadTask {
-		ThreadTask() {
-			for (auto &task : tasks) {
-				task.reserve(2000);
-			}
-			scheduledTasks.reserve(2000);
-		}
-
-		std::array<std::vector<Task>, static_cast<uint8_t>(TaskGroup::Last)> tasks;
-		std::vector<std::shared_ptr<Task>> scheduledTasks;
-		std::mutex mutex;
+		std::array<TaskChannel<Task>, static_cast<uint8_t>(TaskGroup::Last)> tasks;
+		TaskChannel<std::shared_ptr<Task>> scheduledTasks;
 	};
 
 	std::vector<std::unique_ptr<ThreadTask>> threads;
+	ThreadTask sharedThreadTask;
+	std::mutex sharedThreadTaskMutex;
 
 	// Main Events
 	std::array<std::vector<Task>, static_cast<uint8_t>(TaskGroup::Last)> m_tasks;
-	phmap::btree_multiset<std::shared_ptr<Task>, Task::Compare> scheduledTasks {};
-	phmap::parallel_flat_hash_map_m<uint64_t, std::shared_ptr<Task>> scheduledTasksRef {};
+
+	// Scheduled Events, addressed by event id
+	TimerSlots timerSlots;
+	TimingWheel timingWheel;
+	std::vector<uint32_t> expiredTimers;
+	std::atomic_int16_t dispatcherThreadId = -1;
+
+	// Fed by the dispatcher thread in FEATURE_METRICS builds
+	TaskProfiler taskProfiler;
 
 	bool asyncWaitDisabled = false;
 
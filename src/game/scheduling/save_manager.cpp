@@ -10,12 +10,16 @@
 #include "game/scheduling/save_manager.hpp"
 
 #include "config/configmanager.hpp"
+#include "database/database.hpp"
 #include "creatures/players/grouping/guild.hpp"
 #include "game/game.hpp"
+#include "io/functions/player_save_snapshot.hpp"
 #include "io/ioguild.hpp"
 #include "io/iologindata.hpp"
+#include "io/iomapserialize.hpp"
 #include "kv/kv.hpp"
 #include "lib/di/container.hpp"
+#include "lib/metrics/metrics.hpp"
 #include "creatures/players/player.hpp"
 
 SaveManager::SaveManager(ThreadPool &threadPool, KVStore &kvStore, Logger &logger, Game &game) :
@@ -25,24 +29,19 @@ SaveManager &SaveManager::getInstance() {
 	return inject<SaveManager>();
 }
 
+struct SaveManager::ServerSnapshot {
+	std::vector<std::shared_ptr<PlayerSaveSnapshot>> players;
+	HouseItemsSnapshot houseItems;
+};
+
 void SaveManager::saveAll() {
 	Benchmark bm_saveAll;
 	logger.info("Saving server...");
-	const auto players = game.getPlayers();
-
-	for (const auto &[_, player] : players) {
-		player->loginPosition = player->getPosition();
-		doSavePlayer(player);
-	}
-
-	auto guilds = game.getGuilds();
-	for (const auto &[_, guild] : guilds) {
-		saveGuild(guild);
-	}
+	writeAll(*captureAll());
 
-	saveMap();
-	saveKV();
-	logger.info("Server saved in {} milliseconds.", bm_saveAll.duration());
+	const auto duration = bm_saveAll.duration();
+	recordStall("sync", duration);
+	logger.info("Server saved in {} milliseconds.", duration);
 }
 
 void SaveManager::scheduleAll() {
@@ -55,15 +54,72 @@ void SaveManager::scheduleAll() {
 		return;
 	}
 
-	threadPool.detach_task([this, scheduledAt]() {
+	// The capture holds the dispatcher, the snapshot is written while the game goes on.
+	// Saving used to read the live objects from a pool task without stopping the game, so this stall is new:
+	// it grows with the players online, in exchange for writing what they had at one single point in time.
+	Benchmark bm_capture;
+	auto snapshot = captureAll();
+	const auto captureDuration = bm_capture.duration();
+	recordStall("async", captureDuration);
+	logger.info("Saving server, captured {} players in {} milliseconds.", snapshot->players.size(), captureDuration);
+
+	threadPool.detach_task([this, scheduledAt, snapshot]() {
 		if (m_scheduledAt.load() != scheduledAt) {
 			logger.warn("Skipping save for server because another save has been scheduled.");
 			return;
 		}
-		saveAll();
+
+		Benchmark bm_saveAll;
+		writeAll(*snapshot);
+		logger.info("Server saved in {} milliseconds.", bm_saveAll.duration());
 	});
 }
 
+std::shared_ptr<SaveManager::ServerSnapshot> SaveManager::captureAll() {
+	auto snapshot = std::make_shared<ServerSnapshot>();
+	const auto players = game.getPlayers();
+	snapshot->players.reserve(players.size());
+	for (const auto &[_, player] : players) {
+		player->loginPosition = player->getPosition();
+		snapshot->players.emplace_back(IOLoginData::capturePlayer(player));
+	}
+
+	snapshot->houseItems = IOMapSerialize::snapshotHouseItems();
+	return snapshot;
+}
+
+void SaveManager::writeAll(const ServerSnapshot &snapshot) {
+	savePlayers(snapshot.players);
+
+	auto guilds = game.getGuilds();
+	for (const auto &[_, guild] : guilds) {
+		saveGuild(guild);
+	}
+
+	saveMap(snapshot);
+	saveKV();
+}
+
+void SaveManager::savePlayers(const std::vector<std::shared_ptr<PlayerSaveSnapshot>> &players) {
+	const auto total = players.size();
+	if (total == 0) {
+		return;
+	}
+
+	// Each player is written in its own transaction, so they are spread over the connections of the pool.
+	// One connection is left to the dispatcher, logins and market or house reads go on during the save.
+	const auto poolSize = g_database().getPoolSize();
+	const auto writers = std::min({ static_cast<size_t>(threadPool.get_thread_count()), std::max<size_t>(poolSize, 2) - 1, total });
+	threadPool.parallelFor(total, 1, writers - 1, [this, &players](size_t i) {
+		doSavePlayer(players[i]);
+	});
+}
+
+void SaveManager::recordStall(std::string_view mode, double durationMs) const {
+	g_metrics().recordHistogram("save_stall_latency", durationMs, { { "mode", std::string(mode) } });
+	logger.debug("Server save held the dispatcher for {} milliseconds ({}).", durationMs, mode);
+}
+
 void SaveManager::schedulePlayer(std::weak_ptr<Player> playerPtr) {
 	auto playerToSave = playerPtr.lock();
 	if (!playerToSave) {
@@ -76,47 +132,45 @@ void SaveManager::schedulePlayer(std::weak_ptr<Player> playerPtr) {
 		if (g_game().getGameState() == GAME_STATE_NORMAL) {
 			logger.debug("Saving player {}.", playerToSave->getName());
 		}
-		doSavePlayer(playerToSave);
+		doSavePlayer(IOLoginData::capturePlayer(playerToSave));
 		return;
 	}
 
 	logger.debug("Scheduling player {} for saving.", playerToSave->getName());
+	const auto guid = playerToSave->getGUID();
 	auto scheduledAt = std::chrono::steady_clock::now();
-	m_playerMap[playerToSave->getGUID()] = scheduledAt;
-	threadPool.detach_task([this, playerPtr, scheduledAt]() {
-		auto player = playerPtr.lock();
-		if (!player) {
-			logger.debug("Skipping save for player because player is no longer online.");
-			return;
-		}
-		if (m_playerMap[player->getGUID()] != scheduledAt) {
+	m_playerMap[guid] = scheduledAt;
+	// The player is read now, on the dispatcher, the task only writes what was read
+	auto snapshot = IOLoginData::capturePlayer(playerToSave);
+	threadPool.detach_task([this, guid, snapshot, scheduledAt]() {
+		// A later save of the player was scheduled meanwhile, that one writes it
+		if (!m_playerMap.erase_if(guid, [scheduledAt](const auto &entry) { return entry.second == scheduledAt; })) {
 			logger.warn("Skipping save for player because another save has been scheduled.");
 			return;
 		}
-		doSavePlayer(player);
+		doSavePlayer(snapshot);
 	});
 }
 
-bool SaveManager::doSavePlayer(std::shared_ptr<Player> player) {
-	if (!player) {
+bool SaveManager::doSavePlayer(const std::shared_ptr<PlayerSaveSnapshot> &snapshot) {
+	if (!snapshot) {
 		logger.debug("Failed to save player because player is null.");
 		return false;
 	}
 
 	Benchmark bm_savePlayer;
-	Player::PlayerLock lock(player);
-	m_playerMap.erase(player->getGUID());
 	if (g_game().getGameState() == GAME_STATE_NORMAL) {
-		logger.debug("Saving player {}.", player->getName());
+		logger.debug("Saving player {}.", snapshot->name);
 	}
 
-	bool saveSuccess = IOLoginData::savePlayer(player);
+	bool saveSuccess = IOLoginData::savePlayer(*snapshot);
 	if (!saveSuccess) {
-		logger.error("Failed to save player {}.", player->getName());
+		logger.error("Failed to save player {}.", snapshot->name);
 	}
 
 	auto duration = bm_savePlayer.duration();
-	logger.debug("Saving player {} took {} milliseconds.", player->getName(), duration);
+	const auto &lastSave = snapshot->saveState->getLastSave();
+	logger.debug("Saving player {} took {} milliseconds, {} sections written ({} bytes), {} unchanged.", snapshot->name, duration, lastSave.written, lastSave.bytes, lastSave.skipped);
 	return saveSuccess;
 }
 
@@ -125,7 +179,7 @@ bool SaveManager::savePlayer(std::shared_ptr<Player> player) {
 		schedulePlayer(player);
 		return true;
 	}
-	return doSavePlayer(player);
+	return doSavePlayer(IOLoginData::capturePlayer(player));
 }
 
 void SaveManager::saveGuild(std::shared_ptr<Guild> guild) {
@@ -142,10 +196,10 @@ void SaveManager::saveGuild(std::shared_ptr<Guild> guild) {
 	logger.debug("Saving guild {} took {} milliseconds.", guild->getName(), duration);
 }
 
-void SaveManager::saveMap() {
+void SaveManager::saveMap(const ServerSnapshot &snapshot) {
 	Benchmark bm_saveMap;
 	logger.debug("Saving map...");
-	bool saveSuccess = Map::save();
+	bool saveSuccess = Map::save(snapshot.houseItems);
 	if (!saveSuccess) {
 		logger.error("Failed to save map.");
 	}
@@ -16,6 +16,7 @@ class Logger;
 class Game;
 class Player;
 class Guild;
+struct PlayerSaveSnapshot;
 
 class SaveManager {
 public:
@@ -33,11 +34,25 @@ public:
 	void saveGuild(std::shared_ptr<Guild> guild);
 
 private:
-	void saveMap();
+	/**
+	 * What a server save writes, taken on the dispatcher thread and written from any thread.
+	 */
+	struct ServerSnapshot;
+
+	std::shared_ptr<ServerSnapshot> captureAll();
+	void writeAll(const ServerSnapshot &snapshot);
+	void savePlayers(const std::vector<std::shared_ptr<PlayerSaveSnapshot>> &players);
+	void saveMap(const ServerSnapshot &snapshot);
 	void saveKV();
 
+	/**
+	 * Time the dispatcher was held by a save: the whole save when it is synchronous, the capture when it is not.
+	 * Recorded as save_stall_latency with a mode of "sync" or "async".
+	 */
+	void recordStall(std::string_view mode, double durationMs) const;
+
 	void schedulePlayer(std::weak_ptr<Player> player);
-	bool doSavePlayer(std::shared_ptr<Player> player);
+	bool doSavePlayer(const std::shared_ptr<PlayerSaveSnapshot> &snapshot);
 
 	std::atomic<std::chrono::steady_clock::time_point> m_scheduledAt;
 	phmap::parallel_flat_hash_map<uint32_t, std::chrono::steady_clock::time_point> m_playerMap;
@@ -11,13 +11,16 @@
 
 #include "lib/metrics/metrics.hpp"
 
+#include "utils/lockfree.hpp"
 #include "utils/tools.hpp"
 
-std::atomic_uint_fast64_t Task::LAST_EVENT_ID = 0;
-
-Task::Task(uint32_t expiresAfterMs, std::function<void(void)> &&f, std::string_view context) :
+Task::Task(uint32_t expiresAfterMs, TaskFunction &&f, std::string_view context) :
 	func(std::move(f)), context(context), utime(OTSYS_TIME()),
 	expiration(expiresAfterMs > 0 ? OTSYS_TIME() + expiresAfterMs : 0) {
+#ifdef FEATURE_METRICS
+	readyAt = std::chrono::steady_clock::now();
+#endif
+
 	if (this->context.empty()) {
 		g_logger().error("[{}]: task context cannot be empty!", __FUNCTION__);
 		return;
@@ -26,9 +29,13 @@ Task::Task(uint32_t expiresAfterMs, std::function<void(void)> &&f, std::string_v
 	assert(!this->context.empty() && "Context cannot be empty!");
 }
 
-Task::Task(std::function<void(void)> &&f, std::string_view context, uint32_t delay, bool cycle /* = false*/, bool log /*= true*/) :
+Task::Task(TaskFunction &&f, std::string_view context, uint32_t delay, bool cycle /* = false*/, bool log /*= true*/) :
 	func(std::move(f)), context(context), utime(OTSYS_TIME() + delay), delay(delay),
 	cycle(cycle), log(log) {
+#ifdef FEATURE_METRICS
+	readyAt = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay);
+#endif
+
 	if (this->context.empty()) {
 		g_logger().error("[{}]: task context cannot be empty!", __FUNCTION__);
 		return;
@@ -37,6 +44,10 @@ Task::Task(std::function<void(void)> &&f, std::string_view context, uint32_t del
 	assert(!this->context.empty() && "Context cannot be empty!");
 }
 
+std::shared_ptr<Task> Task::create(TaskFunction &&f, std::string_view context, uint32_t delay, bool cycle /* = false*/, bool log /*= true*/) {
+	return std::allocate_shared<Task>(LockfreePoolingAllocator<Task, SCHEDULED_TASK_FREE_LIST_CAPACITY>(), std::move(f), context, delay, cycle, log);
+}
+
 [[nodiscard]] bool Task::hasExpired() const {
 	return expiration != 0 && expiration < OTSYS_TIME();
 }
@@ -52,6 +63,10 @@ bool Task::execute() const {
 		return false;
 	}
 
+#ifdef FEATURE_METRICS
+	g_metrics().recordHistogram("task_wait_latency", static_cast<double>(getWaitTime()), { { "task", std::string(context) } });
+#endif
+
 	if (log) {
 		if (hasTraceableContext()) {
 			g_logger().trace("Executing task {}.", getContext());
@@ -66,4 +81,14 @@ bool Task::execute() const {
 
 void Task::updateTime() {
 	utime = OTSYS_TIME() + delay;
+#ifdef FEATURE_METRICS
+	readyAt = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay);
+#endif
+}
+
+#ifdef FEATURE_METRICS
+int64_t Task::getWaitTime() const {
+	const auto waited = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - readyAt).count();
+	return std::max<int64_t>(0, waited);
 }
+#endif
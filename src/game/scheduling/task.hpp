@@ -9,23 +9,37 @@
 
 #pragma once
 
+#include "utils/inplace_function.hpp"
+
 class Dispatcher;
 
+// Room for a few ids and a shared pointer, which covers almost every lambda given to the dispatcher
+static constexpr size_t TASK_FUNCTION_CAPACITY = 56;
+// Scheduled task nodes (control block included) kept for reuse instead of being freed
+static constexpr size_t SCHEDULED_TASK_FREE_LIST_CAPACITY = 4096;
+
+using TaskFunction = InplaceFunction<void(void), TASK_FUNCTION_CAPACITY>;
+
+/**
+ * The context must outlive the task, give it a string literal or __FUNCTION__.
+ */
 class Task {
 public:
-	Task(uint32_t expiresAfterMs, std::function<void(void)> &&f, std::string_view context);
+	Task(uint32_t expiresAfterMs, TaskFunction &&f, std::string_view context);
+
+	Task(TaskFunction &&f, std::string_view context, uint32_t delay, bool cycle = false, bool log = true);
 
-	Task(std::function<void(void)> &&f, std::string_view context, uint32_t delay, bool cycle = false, bool log = true);
+	/**
+	 * Creates a task to be scheduled, its node is taken from a pool so the common case does not allocate.
+	 */
+	static std::shared_ptr<Task> create(TaskFunction &&f, std::string_view context, uint32_t delay, bool cycle = false, bool log = true);
 
 	~Task() = default;
 
-	uint64_t getId() {
-		if (id == 0) {
-			if (++LAST_EVENT_ID == 0) {
-				LAST_EVENT_ID = 1;
-			}
-			id = LAST_EVENT_ID;
-		}
+	Task(Task &&) noexcept = default;
+	Task &operator=(Task &&) noexcept = default;
+
+	[[nodiscard]] uint64_t getId() const {
 		return id;
 	}
 
@@ -57,9 +71,14 @@ public:
 
 	bool execute() const;
 
-private:
-	static std::atomic_uint_fast64_t LAST_EVENT_ID;
+#ifdef FEATURE_METRICS
+	/**
+	 * Microseconds the task has been waiting since it was queued, or since it became due for scheduled tasks.
+	 */
+	[[nodiscard]] int64_t getWaitTime() const;
+#endif
 
+private:
 	void updateTime();
 
 	bool hasTraceableContext() const {
@@ -87,28 +106,27 @@ private:
 			"SpawnMonster::startup",
 			"SpawnNpc::checkSpawnNpc",
 			"Webhook::run",
-			"Protocol::sendRecvMessageCallback",
+			"Connection::drainInputMessages",
 			"Player::addInFightTicks"
 		};
 
 		return tasksContext.contains(context);
 	}
 
-	struct Compare {
-		bool operator()(const std::shared_ptr<Task> &a, const std::shared_ptr<Task> &b) const {
-			return a->getTime() < b->getTime();
-		}
-	};
-
-	std::function<void(void)> func;
-	std::string context;
+	TaskFunction func;
+	std::string_view context;
 
 	int64_t utime = 0;
 	int64_t expiration = 0;
+	// Assigned by the dispatcher when scheduled, see TimerSlots
 	uint64_t id = 0;
 	uint32_t delay = 0;
 	bool cycle = false;
 	bool log = true;
 
+#ifdef FEATURE_METRICS
+	std::chrono::steady_clock::time_point readyAt;
+#endif
+
 	friend class Dispatcher;
 };
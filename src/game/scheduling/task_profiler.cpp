@@ -0,0 +1,74 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "game/scheduling/task_profiler.hpp"
+
+#include "utils/tools.hpp"
+
+void TaskProfiler::record(std::string_view context, int64_t executionTime, int64_t waitTime) {
+	const auto now = OTSYS_TIME();
+	if (now - windowStart >= WINDOW_MS) {
+		previous = std::move(current);
+		current.clear();
+		windowStart = now;
+	}
+
+	auto it = current.find(context);
+	if (it == current.end()) {
+		it = current.try_emplace(std::string(context)).first;
+		it->second.name = it->first;
+	}
+
+	auto &profile = it->second;
+	++profile.executions;
+	profile.totalTime += executionTime;
+	profile.maxTime = std::max(profile.maxTime, executionTime);
+	profile.totalWait += waitTime;
+}
+
+std::vector<TaskProfile> TaskProfiler::getSlowest(size_t count) const {
+	ProfileMap merged = previous;
+	for (const auto &[name, profile] : current) {
+		auto &total = merged[name];
+		total.name = name;
+		total.executions += profile.executions;
+		total.totalTime += profile.totalTime;
+		total.maxTime = std::max(total.maxTime, profile.maxTime);
+		total.totalWait += profile.totalWait;
+	}
+
+	std::vector<TaskProfile> profiles;
+	profiles.reserve(merged.size());
+	for (auto &[name, profile] : merged) {
+		profiles.emplace_back(std::move(profile));
+	}
+
+	const auto limit = std::min(count, profiles.size());
+	std::partial_sort(profiles.begin(), profiles.begin() + limit, profiles.end(), [](const TaskProfile &a, const TaskProfile &b) {
+		return a.totalTime > b.totalTime;
+	});
+	profiles.resize(limit);
+	return profiles;
+}
+
+void TaskProfiler::report(size_t count) const {
+	if (!isEnabled()) {
+		g_logger().warn("[TaskProfiler::report] - Task profiling requires a build with FEATURE_METRICS enabled");
+		return;
+	}
+
+	const auto profiles = getSlowest(count);
+	g_logger().info("Slowest dispatcher tasks of the last {} seconds:", (WINDOW_MS * 2) / 1000);
+	for (const auto &profile : profiles) {
+		g_logger().info(
+			"  {}: {} executions, total {:.2f}ms, avg {}us, max {}us, avg wait {}us",
+			profile.name, profile.executions, profile.totalTime / 1000.0, profile.averageTime(), profile.maxTime, profile.averageWait()
+		);
+	}
+}
@@ -0,0 +1,65 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "utils/transparent_string_hash.hpp"
+
+struct TaskProfile {
+	std::string name;
+	uint64_t executions = 0;
+	int64_t totalTime = 0; // microseconds
+	int64_t maxTime = 0; // microseconds
+	int64_t totalWait = 0; // microseconds
+
+	[[nodiscard]] int64_t averageTime() const {
+		return executions == 0 ? 0 : totalTime / static_cast<int64_t>(executions);
+	}
+
+	[[nodiscard]] int64_t averageWait() const {
+		return executions == 0 ? 0 : totalWait / static_cast<int64_t>(executions);
+	}
+};
+
+/**
+ * Rolling execution statistics of the task contexts that run on the dispatcher thread.
+ * Covers the current window plus the previous complete one, so a report always spans at least one full window.
+ * Only fed when the server is built with FEATURE_METRICS, and only from the dispatcher thread.
+ */
+class TaskProfiler {
+public:
+	static constexpr int64_t WINDOW_MS = 60 * 1000;
+
+	static constexpr bool isEnabled() {
+#ifdef FEATURE_METRICS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void record(std::string_view context, int64_t executionTime, int64_t waitTime);
+
+	/**
+	 * Task contexts sorted by the total time they kept the dispatcher thread busy.
+	 */
+	[[nodiscard]] std::vector<TaskProfile> getSlowest(size_t count) const;
+
+	/**
+	 * Writes the slowest task contexts to the server log.
+	 */
+	void report(size_t count) const;
+
+private:
+	using ProfileMap = std::unordered_map<std::string, TaskProfile, TransparentStringHasher, std::equal_to<>>;
+
+	ProfileMap current;
+	ProfileMap previous;
+	int64_t windowStart = 0;
+};
@@ -0,0 +1,266 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "game/scheduling/timing_wheel.hpp"
+
+#include "game/scheduling/task.hpp"
+
+TimerSlots::~TimerSlots() {
+	for (auto &chunk : chunks) {
+		delete[] chunk.load(std::memory_order_relaxed);
+	}
+}
+
+uint64_t TimerSlots::acquire() {
+	auto head = freeHead.load(std::memory_order_acquire);
+	while (static_cast<uint32_t>(head) != 0) {
+		const auto index = static_cast<uint32_t>(head);
+		const uint64_t next = at(index).nextFree.load(std::memory_order_relaxed);
+		const auto tag = (head >> 32) + 1;
+		if (freeHead.compare_exchange_weak(head, (tag << 32) | next, std::memory_order_acq_rel, std::memory_order_acquire)) {
+			return makeId(index);
+		}
+	}
+
+	const auto index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+	const auto chunkId = index >> CHUNK_BITS;
+	if (chunkId >= MAX_CHUNKS) {
+		nextIndex.fetch_sub(1, std::memory_order_relaxed);
+		g_logger().error("[{}] scheduled events limit reached ({}), event discarded.", __FUNCTION__, MAX_CHUNKS * CHUNK_SIZE);
+		return 0;
+	}
+
+	auto &chunk = chunks[chunkId];
+	if (chunk.load(std::memory_order_acquire) == nullptr) {
+		Slot* expected = nullptr;
+		auto* created = new Slot[CHUNK_SIZE];
+		if (!chunk.compare_exchange_strong(expected, created, std::memory_order_acq_rel)) {
+			delete[] created;
+		}
+	}
+
+	return makeId(index);
+}
+
+void TimerSlots::release(uint64_t eventId) {
+	const auto index = indexOf(eventId);
+	auto &slot = at(index);
+
+	// No-op when the event was cancelled, the generation has already moved on
+	auto generation = generationOf(eventId);
+	slot.generation.compare_exchange_strong(generation, generation + 1, std::memory_order_acq_rel);
+
+	slot.task.reset();
+	slot.linked = false;
+
+	auto head = freeHead.load(std::memory_order_relaxed);
+	uint64_t newHead;
+	do {
+		slot.nextFree.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+		newHead = (((head >> 32) + 1) << 32) | index;
+	} while (!freeHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+}
+
+TimerSlots::Slot* TimerSlots::find(uint64_t eventId) const {
+	const auto index = indexOf(eventId);
+	if (index == 0 || index >= nextIndex.load(std::memory_order_acquire)) {
+		return nullptr;
+	}
+
+	// Ids come from scripts too, the chunk of a bogus id may still be being allocated
+	auto* chunk = chunks[index >> CHUNK_BITS].load(std::memory_order_acquire);
+	return chunk ? &chunk[index & (CHUNK_SIZE - 1)] : nullptr;
+}
+
+bool TimerSlots::cancel(uint64_t eventId) {
+	auto* slot = find(eventId);
+	if (!slot) {
+		return false;
+	}
+
+	auto generation = generationOf(eventId);
+	return slot->generation.compare_exchange_strong(generation, generation + 1, std::memory_order_acq_rel);
+}
+
+bool TimerSlots::isActive(uint64_t eventId) const {
+	const auto* slot = find(eventId);
+	return slot && slot->generation.load(std::memory_order_acquire) == generationOf(eventId);
+}
+
+void TimingWheel::start(int64_t now) {
+	if (count == 0) {
+		currentTick = now;
+	}
+}
+
+void TimingWheel::link(uint32_t index, uint8_t level, uint8_t bucket) {
+	auto &slot = slots.at(index);
+	slot.level = level;
+	slot.bucket = bucket;
+	slot.next = 0;
+	slot.prev = tails[level][bucket];
+	slot.linked = true;
+
+	if (slot.prev != 0) {
+		slots.at(slot.prev).next = index;
+	} else {
+		heads[level][bucket] = index;
+	}
+	tails[level][bucket] = index;
+
+	if (level < LEVELS) {
+		occupancy[level] |= uint64_t(1) << bucket;
+	}
+}
+
+void TimingWheel::place(uint32_t index) {
+	const auto expiry = std::max(slots.at(index).expiry, currentTick);
+
+	// The lowest level whose parent block still contains the expiry will reach it without wrapping around
+	for (uint8_t level = 0; level < LEVELS; ++level) {
+		const auto parentShift = BITS * (level + 1);
+		if ((expiry >> parentShift) == (currentTick >> parentShift)) {
+			link(index, level, static_cast<uint8_t>((expiry >> (BITS * level)) & (BUCKETS - 1)));
+			return;
+		}
+	}
+
+	link(index, OVERFLOW_LEVEL, 0);
+}
+
+void TimingWheel::insert(uint32_t index, int64_t expiry) {
+	slots.at(index).expiry = expiry;
+	place(index);
+	++count;
+}
+
+void TimingWheel::remove(uint32_t index) {
+	auto &slot = slots.at(index);
+	if (!slot.linked) {
+		return;
+	}
+
+	const auto level = slot.level;
+	const auto bucket = slot.bucket;
+
+	if (slot.prev != 0) {
+		slots.at(slot.prev).next = slot.next;
+	} else {
+		heads[level][bucket] = slot.next;
+	}
+
+	if (slot.next != 0) {
+		slots.at(slot.next).prev = slot.prev;
+	} else {
+		tails[level][bucket] = slot.prev;
+	}
+
+	if (level < LEVELS && heads[level][bucket] == 0) {
+		occupancy[level] &= ~(uint64_t(1) << bucket);
+	}
+
+	slot.prev = slot.next = 0;
+	slot.linked = false;
+	--count;
+}
+
+void TimingWheel::cascade(uint8_t level, uint8_t bucket) {
+	auto index = heads[level][bucket];
+	heads[level][bucket] = tails[level][bucket] = 0;
+	if (level < LEVELS) {
+		occupancy[level] &= ~(uint64_t(1) << bucket);
+	}
+
+	while (index != 0) {
+		const auto next = slots.at(index).next;
+		place(index);
+		index = next;
+	}
+}
+
+void TimingWheel::process(int64_t tick, std::vector<uint32_t> &expired) {
+	constexpr int64_t wheelMask = (int64_t(1) << (BITS * LEVELS)) - 1;
+	if ((tick & wheelMask) == 0 && heads[OVERFLOW_LEVEL][0] != 0) {
+		cascade(OVERFLOW_LEVEL, 0);
+	}
+
+	// Higher levels first, so their timers can still land in the lower buckets being entered at this tick
+	for (auto level = static_cast<uint8_t>(LEVELS - 1); level > 0; --level) {
+		const auto shift = BITS * level;
+		if ((tick & ((int64_t(1) << shift) - 1)) == 0) {
+			cascade(level, static_cast<uint8_t>((tick >> shift) & (BUCKETS - 1)));
+		}
+	}
+
+	const auto bucket = static_cast<uint8_t>(tick & (BUCKETS - 1));
+	auto index = heads[0][bucket];
+	heads[0][bucket] = tails[0][bucket] = 0;
+	occupancy[0] &= ~(uint64_t(1) << bucket);
+
+	while (index != 0) {
+		auto &slot = slots.at(index);
+		const auto next = slot.next;
+		slot.prev = slot.next = 0;
+		slot.linked = false;
+		--count;
+		expired.emplace_back(index);
+		index = next;
+	}
+}
+
+int64_t TimingWheel::nextExpiration() const {
+	if (count == 0) {
+		return std::numeric_limits<int64_t>::max();
+	}
+
+	auto next = std::numeric_limits<int64_t>::max();
+	for (uint8_t level = 0; level < LEVELS; ++level) {
+		const auto shift = BITS * level;
+		const auto index = static_cast<uint8_t>((currentTick >> shift) & (BUCKETS - 1));
+		// A higher level bucket is cascaded when the wheel enters it, so the current one
+		// only has pending work if the wheel sits exactly on its boundary
+		const bool atBoundary = (currentTick & ((int64_t(1) << shift) - 1)) == 0;
+		const auto first = atBoundary ? index : index + 1;
+		if (first >= BUCKETS) {
+			continue;
+		}
+
+		const auto pending = occupancy[level] & (~uint64_t(0) << first);
+		if (pending != 0) {
+			const auto blockShift = shift + BITS;
+			const auto blockStart = (currentTick >> blockShift) << blockShift;
+			next = std::min(next, blockStart | (static_cast<int64_t>(std::countr_zero(pending)) << shift));
+		}
+	}
+
+	if (heads[OVERFLOW_LEVEL][0] != 0) {
+		constexpr auto wheelShift = BITS * LEVELS;
+		const bool atBoundary = (currentTick & ((int64_t(1) << wheelShift) - 1)) == 0;
+		next = std::min(next, atBoundary ? currentTick : ((currentTick >> wheelShift) + 1) << wheelShift);
+	}
+
+	return next;
+}
+
+void TimingWheel::advance(int64_t now, std::vector<uint32_t> &expired) {
+	while (count > 0) {
+		const auto tick = nextExpiration();
+		if (tick > now) {
+			break;
+		}
+
+		currentTick = tick;
+		process(tick, expired);
+		currentTick = tick + 1;
+	}
+
+	if (currentTick <= now) {
+		currentTick = now + 1;
+	}
+}
@@ -0,0 +1,150 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class Task;
+
+/**
+ * Stable storage for scheduled events, addressed directly by event id.
+ * An event id packs the slot index in its low 32 bits and the slot generation in its high 32 bits,
+ * so an event is resolved and cancelled with one atomic operation instead of a hash map lookup.
+ * Slots can be acquired and cancelled from any thread, everything else belongs to the dispatcher thread.
+ */
+class TimerSlots {
+public:
+	struct Slot {
+		std::atomic_uint32_t generation = 1;
+		std::atomic_uint32_t nextFree = 0;
+
+		// Owned by the dispatcher thread
+		std::shared_ptr<Task> task;
+		int64_t expiry = 0;
+		uint32_t prev = 0;
+		uint32_t next = 0;
+		uint8_t level = 0;
+		uint8_t bucket = 0;
+		bool linked = false;
+	};
+
+	TimerSlots() = default;
+	~TimerSlots();
+
+	// Ensures that we don't accidentally copy it
+	TimerSlots(const TimerSlots &) = delete;
+	TimerSlots &operator=(const TimerSlots &) = delete;
+
+	/**
+	 * Reserves a slot and returns the event id that refers to it, or 0 if every slot is in use.
+	 */
+	uint64_t acquire();
+
+	/**
+	 * Invalidates the event id and returns its slot to the free list.
+	 */
+	void release(uint64_t eventId);
+
+	/**
+	 * Invalidates the event id, returns false if it was already executed or cancelled.
+	 */
+	bool cancel(uint64_t eventId);
+
+	[[nodiscard]] bool isActive(uint64_t eventId) const;
+
+	[[nodiscard]] Slot &at(uint32_t index) const {
+		return chunks[index >> CHUNK_BITS].load(std::memory_order_acquire)[index & (CHUNK_SIZE - 1)];
+	}
+
+	static uint32_t indexOf(uint64_t eventId) {
+		return static_cast<uint32_t>(eventId);
+	}
+
+	static uint32_t generationOf(uint64_t eventId) {
+		return static_cast<uint32_t>(eventId >> 32);
+	}
+
+private:
+	static constexpr uint32_t CHUNK_BITS = 12;
+	static constexpr uint32_t CHUNK_SIZE = 1 << CHUNK_BITS;
+	static constexpr uint32_t MAX_CHUNKS = 1 << 12;
+
+	Slot* find(uint64_t eventId) const;
+
+	uint64_t makeId(uint32_t index) const {
+		return (static_cast<uint64_t>(at(index).generation.load(std::memory_order_acquire)) << 32) | index;
+	}
+
+	std::array<std::atomic<Slot*>, MAX_CHUNKS> chunks {};
+	// Index 0 is reserved as the list terminator, so an event id is never 0
+	std::atomic_uint32_t nextIndex = 1;
+	// Treiber stack of released slots, tagged (high 32 bits) against ABA
+	std::atomic_uint64_t freeHead = 0;
+};
+
+/**
+ * Hierarchical timing wheel with millisecond resolution.
+ * Every level has 64 buckets, each one 64 times wider than the buckets of the level below,
+ * timers further away than the last level are parked in an overflow list until the wheel reaches them.
+ * Insert and remove are O(1) intrusive list operations on the TimerSlots entries, expired timers are
+ * collected bucket by bucket and empty stretches of time are skipped through per-level occupancy bitmaps.
+ * Not thread-safe, it belongs to the dispatcher thread.
+ */
+class TimingWheel {
+public:
+	explicit TimingWheel(TimerSlots &slots) :
+		slots(slots) { }
+
+	/**
+	 * Sets the current time of an empty wheel.
+	 */
+	void start(int64_t now);
+
+	void insert(uint32_t index, int64_t expiry);
+	void remove(uint32_t index);
+
+	/**
+	 * Moves the wheel up to 'now' (inclusive) and appends the expired slot indexes, in expiration order.
+	 */
+	void advance(int64_t now, std::vector<uint32_t> &expired);
+
+	/**
+	 * Time at which the wheel next has work to do, it may be earlier than the closest expiration
+	 * when timers have to be cascaded to a lower level first.
+	 */
+	[[nodiscard]] int64_t nextExpiration() const;
+
+	[[nodiscard]] size_t size() const {
+		return count;
+	}
+
+	[[nodiscard]] bool empty() const {
+		return count == 0;
+	}
+
+private:
+	static constexpr uint8_t BITS = 6;
+	static constexpr uint8_t BUCKETS = 1 << BITS;
+	static constexpr uint8_t LEVELS = 5;
+	static constexpr uint8_t OVERFLOW_LEVEL = LEVELS;
+
+	void link(uint32_t index, uint8_t level, uint8_t bucket);
+	void place(uint32_t index);
+	void cascade(uint8_t level, uint8_t bucket);
+	void process(int64_t tick, std::vector<uint32_t> &expired);
+
+	TimerSlots &slots;
+
+	std::array<std::array<uint32_t, BUCKETS>, LEVELS + 1> heads {};
+	std::array<std::array<uint32_t, BUCKETS>, LEVELS + 1> tails {};
+	std::array<uint64_t, LEVELS> occupancy {};
+
+	// Next tick that has not been processed yet
+	int64_t currentTick = 0;
+	size_t count = 0;
+};
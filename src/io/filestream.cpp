@@ -16,7 +16,7 @@ uint32_t FileStream::tell() const {
 }
 
 void FileStream::seek(uint32_t pos) {
-	if (pos > m_data.size()) {
+	if (pos > static_cast<size_t>(m_end - m_begin)) {
 		g_logger().error("Seek failed");
 		return;
 	}
@@ -28,7 +28,7 @@ void FileStream::skip(uint32_t len) {
 }
 
 uint32_t FileStream::size() const {
-	std::size_t size = m_data.size();
+	const auto size = static_cast<std::size_t>(m_end - m_begin);
 	if (size > std::numeric_limits<uint32_t>::max()) {
 		g_logger().error("File size exceeds uint32_t range");
 		return {};
@@ -37,50 +37,81 @@ uint32_t FileStream::size() const {
 	return static_cast<uint32_t>(size);
 }
 
+namespace {
+	// Whether one of the first 'size' bytes of the word is OTB::Node::ESCAPE, checked for all of them at once
+	bool hasEscape(uint64_t word, size_t size) {
+		constexpr uint64_t ONES = 0x0101010101010101ULL;
+		constexpr uint64_t HIGHS = 0x8080808080808080ULL;
+		const uint64_t x = word ^ (ONES * OTB::Node::ESCAPE);
+		uint64_t zeroBytes = (x - ONES) & ~x & HIGHS;
+		if (size < sizeof(uint64_t)) {
+			zeroBytes &= (uint64_t { 1 } << (size * 8)) - 1;
+		}
+		return zeroBytes != 0;
+	}
+}
+
 template <typename T>
 bool FileStream::read(T &ret, bool escape) {
 	static_assert(std::is_trivially_copyable_v<T>, "Type T must be trivially copyable");
+	static_assert(sizeof(T) <= sizeof(uint64_t), "Type T must fit in a 64 bit word");
 
-	const auto size = sizeof(T);
+	constexpr auto size = sizeof(T);
 
-	if (m_pos + size > m_data.size()) {
+	if (size > remaining()) {
 		g_logger().error("Read failed");
 		return false;
 	}
 
-	std::array<uint8_t, sizeof(T)> array;
+	const uint8_t* data = m_begin + m_pos;
 	if (escape) {
-		for (int_fast8_t i = 0; i < size; ++i) {
-			if (m_data[m_pos] == OTB::Node::ESCAPE) {
-				++m_pos;
+		uint64_t word = 0;
+		std::memcpy(&word, data, size);
+		// Escaped values are rare, a value without an escape byte is read as it is
+		if (std::endian::native != std::endian::little || hasEscape(word, size)) {
+			std::array<uint8_t, size> array;
+			size_t offset = 0;
+			const size_t available = remaining();
+			for (size_t i = 0; i < size; ++i) {
+				if (offset < available && data[offset] == OTB::Node::ESCAPE) {
+					++offset;
+				}
+				if (offset >= available) {
+					g_logger().error("Read failed");
+					return false;
+				}
+				array[i] = data[offset];
+				++offset;
 			}
-			array[i] = m_data[m_pos];
-			++m_pos;
+			m_pos += offset;
+			ret = std::bit_cast<T>(array);
+			return true;
 		}
-	} else {
-		std::span<const uint8_t> sourceSpan(m_data.data() + m_pos, size);
-		std::ranges::copy(sourceSpan, array.begin());
-		m_pos += size;
 	}
 
-	ret = std::bit_cast<T>(array);
+	std::memcpy(&ret, data, size);
+	m_pos += size;
 	return true;
 }
 
 uint8_t FileStream::getU8() {
 	uint8_t v = 0;
 
-	if (m_pos + 1 > m_data.size()) {
+	if (remaining() < 1) {
 		g_logger().error("Failed to getU8");
 		return {};
 	}
 
 	// Fast Escape Val
-	if (m_nodes > 0 && m_data[m_pos] == OTB::Node::ESCAPE) {
+	if (m_nodes > 0 && m_begin[m_pos] == OTB::Node::ESCAPE) {
 		++m_pos;
+		if (remaining() < 1) {
+			g_logger().error("Failed to getU8");
+			return {};
+		}
 	}
 
-	v = m_data[m_pos];
+	v = m_begin[m_pos];
 	++m_pos;
 
 	return v;
@@ -107,12 +138,12 @@ uint64_t FileStream::getU64() {
 std::string FileStream::getString() {
 	std::string str;
 	if (const uint16_t len = getU16(); len > 0 && len < 8192) {
-		if (m_pos + len > m_data.size()) {
+		if (len > remaining()) {
 			g_logger().error("[FileStream::getString] - Read failed");
 			return {};
 		}
 
-		str = { (char*)&m_data[m_pos], len };
+		str = { reinterpret_cast<const char*>(m_begin + m_pos), len };
 		m_pos += len;
 	} else if (len != 0) {
 		g_logger().error("[FileStream::getString] - Read failed because string is too big");
@@ -9,15 +9,22 @@
 
 #pragma once
 
+/**
+ * Reads OTB formatted data straight from memory, nothing is copied.
+ * A stream built from a range only borrows it, the caller keeps the memory alive;
+ * a stream built from a mapping keeps the mapping alive by itself.
+ */
 class FileStream {
 public:
-	FileStream(const char* begin, const char* end) {
-		m_data.insert(m_data.end(), begin, end);
-	}
+	FileStream(const char* begin, const char* end) :
+		m_begin(reinterpret_cast<const uint8_t*>(begin)), m_end(reinterpret_cast<const uint8_t*>(end)) { }
 
-	explicit FileStream(mio::mmap_source source) {
-		m_data.insert(m_data.end(), source.begin(), source.end());
-	}
+	explicit FileStream(mio::mmap_source source) :
+		m_source(std::move(source)), m_begin(reinterpret_cast<const uint8_t*>(m_source.data())), m_end(m_begin + m_source.size()) { }
+
+	// Ensures that we don't accidentally copy it
+	FileStream(const FileStream &) = delete;
+	FileStream &operator=(const FileStream &) = delete;
 
 	void back(uint32_t pos = 1);
 	void seek(uint32_t pos);
@@ -38,8 +45,17 @@ public:
 private:
 	template <typename T>
 	bool read(T &ret, bool escape = false);
+
+	size_t remaining() const {
+		const auto size = static_cast<size_t>(m_end - m_begin);
+		// A skip or seek can leave the position past the end
+		return m_pos >= size ? 0 : size - m_pos;
+	}
+
 	uint32_t m_nodes { 0 };
 	uint32_t m_pos { 0 };
 
-	std::vector<uint8_t> m_data;
+	mio::mmap_source m_source;
+	const uint8_t* m_begin { nullptr };
+	const uint8_t* m_end { nullptr };
 };
@@ -25,6 +25,7 @@
 #include "enums/account_errors.hpp"
 #include "enums/object_category.hpp"
 #include "game/game.hpp"
+#include "io/functions/player_save_state.hpp"
 #include "io/ioguild.hpp"
 #include "io/ioprey.hpp"
 #include "items/containers/depot/depotchest.hpp"
@@ -36,13 +37,14 @@
 
 void IOLoginDataLoad::loadItems(ItemsMap &itemsMap, const DBResult_ptr &result, const std::shared_ptr<Player> &player) {
 	try {
+		// Columns are read by position: `pid`, `sid`, `itemtype`, `count`, `attributes`
 		do {
-			auto sid = result->getNumber<uint32_t>("sid");
-			auto pid = result->getNumber<uint32_t>("pid");
-			auto type = result->getNumber<uint16_t>("itemtype");
-			auto count = result->getNumber<uint16_t>("count");
+			auto sid = result->getNumber<uint32_t>(1);
+			auto pid = result->getNumber<uint32_t>(0);
+			auto type = result->getNumber<uint16_t>(2);
+			auto count = result->getNumber<uint16_t>(3);
 			unsigned long attrSize;
-			const char* attr = result->getStream("attributes", attrSize);
+			const char* attr = result->getStream(4, attrSize);
 			PropStream propStream;
 			propStream.init(attr, attrSize);
 
@@ -70,26 +72,24 @@ void IOLoginDataLoad::loadItems(ItemsMap &itemsMap, const DBResult_ptr &result,
 bool IOLoginDataLoad::preLoadPlayer(const std::shared_ptr<Player> &player, const std::string &name) {
 	Database &db = Database::getInstance();
 
-	std::ostringstream query;
-	query << "SELECT `id`, `account_id`, `group_id`, `deletion` FROM `players` WHERE `name` = " << db.escapeString(name);
-	DBResult_ptr result = db.storeQuery(query.str());
+	DBResult_ptr result = db.storeQuery(DBStatement("SELECT `id`, `account_id`, `group_id`, `deletion` FROM `players` WHERE `name` = ?").bind(name));
 	if (!result) {
 		return false;
 	}
 
-	if (result->getNumber<uint64_t>("deletion") != 0) {
+	if (result->getNumber<uint64_t>(3) != 0) {
 		return false;
 	}
 
-	player->setGUID(result->getNumber<uint32_t>("id"));
-	const auto &group = g_game().groups.getGroup(result->getNumber<uint16_t>("group_id"));
+	player->setGUID(result->getNumber<uint32_t>(0));
+	const auto &group = g_game().groups.getGroup(result->getNumber<uint16_t>(2));
 	if (!group) {
-		g_logger().error("Player {} has group id {} which doesn't exist", player->name, result->getNumber<uint16_t>("group_id"));
+		g_logger().error("Player {} has group id {} which doesn't exist", player->name, result->getNumber<uint16_t>(2));
 		return false;
 	}
 	player->setGroup(group);
 
-	auto accountId = result->getNumber<uint32_t>("account_id");
+	auto accountId = result->getNumber<uint32_t>(1);
 	if (!player->setAccount(accountId)) {
 		g_logger().error("Player {} has account id {} which doesn't exist", player->name, accountId);
 		return false;
@@ -357,13 +357,11 @@ void IOLoginDataLoad::loadPlayerKills(const std::shared_ptr<Player> &player, DBR
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `player_id`, `time`, `target`, `unavenged` FROM `player_kills` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = db.storeQuery(DBStatement("SELECT `time`, `target`, `unavenged` FROM `player_kills` WHERE `player_id` = ?").bind(player->getGUID())))) {
 		do {
-			auto killTime = result->getNumber<time_t>("time");
+			auto killTime = result->getNumber<time_t>(0);
 			if ((time(nullptr) - killTime) <= g_configManager().getNumber(FRAG_TIME)) {
-				player->unjustifiedKills.emplace_back(result->getNumber<uint32_t>("target"), killTime, result->getNumber<bool>("unavenged"));
+				player->unjustifiedKills.emplace_back(result->getNumber<uint32_t>(1), killTime, result->getNumber<bool>(2));
 			}
 		} while (result->next());
 	}
@@ -376,12 +374,10 @@ void IOLoginDataLoad::loadPlayerGuild(const std::shared_ptr<Player> &player, DBR
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `guild_id`, `rank_id`, `nick` FROM `guild_membership` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
-		auto guildId = result->getNumber<uint32_t>("guild_id");
-		auto playerRankId = result->getNumber<uint32_t>("rank_id");
-		player->guildNick = result->getString("nick");
+	if ((result = db.storeQuery(DBStatement("SELECT `guild_id`, `rank_id`, `nick` FROM `guild_membership` WHERE `player_id` = ?").bind(player->getGUID())))) {
+		auto guildId = result->getNumber<uint32_t>(0);
+		auto playerRankId = result->getNumber<uint32_t>(1);
+		player->guildNick = result->getString(2);
 
 		auto guild = g_game().getGuild(guildId);
 		if (!guild) {
@@ -393,11 +389,8 @@ void IOLoginDataLoad::loadPlayerGuild(const std::shared_ptr<Player> &player, DBR
 			player->guild = guild;
 			GuildRank_ptr rank = guild->getRankById(playerRankId);
 			if (!rank) {
-				query.str("");
-				query << "SELECT `id`, `name`, `level` FROM `guild_ranks` WHERE `id` = " << playerRankId;
-
-				if ((result = db.storeQuery(query.str()))) {
-					guild->addRank(result->getNumber<uint32_t>("id"), result->getString("name"), static_cast<uint8_t>(result->getNumber<uint16_t>("level")));
+				if ((result = db.storeQuery(DBStatement("SELECT `id`, `name`, `level` FROM `guild_ranks` WHERE `id` = ?").bind(playerRankId)))) {
+					guild->addRank(result->getNumber<uint32_t>(0), result->getString(1), static_cast<uint8_t>(result->getNumber<uint16_t>(2)));
 				}
 
 				rank = guild->getRankById(playerRankId);
@@ -410,10 +403,8 @@ void IOLoginDataLoad::loadPlayerGuild(const std::shared_ptr<Player> &player, DBR
 
 			IOGuild::getWarList(guildId, player->guildWarVector);
 
-			query.str("");
-			query << "SELECT COUNT(*) AS `members` FROM `guild_membership` WHERE `guild_id` = " << guildId;
-			if ((result = db.storeQuery(query.str()))) {
-				guild->setMemberCount(result->getNumber<uint32_t>("members"));
+			if ((result = db.storeQuery(DBStatement("SELECT COUNT(*) AS `members` FROM `guild_membership` WHERE `guild_id` = ?").bind(guildId)))) {
+				guild->setMemberCount(result->getNumber<uint32_t>(0));
 			}
 		}
 	}
@@ -426,11 +417,9 @@ void IOLoginDataLoad::loadPlayerStashItems(const std::shared_ptr<Player> &player
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `item_count`, `item_id`  FROM `player_stash` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = db.storeQuery(DBStatement("SELECT `item_count`, `item_id` FROM `player_stash` WHERE `player_id` = ?").bind(player->getGUID())))) {
 		do {
-			player->addItemOnStash(result->getNumber<uint16_t>("item_id"), result->getNumber<uint32_t>("item_count"));
+			player->addItemOnStash(result->getNumber<uint16_t>(1), result->getNumber<uint32_t>(0));
 		} while (result->next());
 	}
 }
@@ -442,9 +431,7 @@ void IOLoginDataLoad::loadPlayerBestiaryCharms(const std::shared_ptr<Player> &pl
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT * FROM `player_charms` WHERE `player_guid` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = db.storeQuery(DBStatement("SELECT * FROM `player_charms` WHERE `player_guid` = ?").bind(player->getGUID())))) {
 		player->charmPoints = result->getNumber<uint32_t>("charm_points");
 		player->charmExpansion = result->getNumber<bool>("charm_expansion");
 		player->charmRuneWound = result->getNumber<uint16_t>("rune_wound");
@@ -482,9 +469,7 @@ void IOLoginDataLoad::loadPlayerBestiaryCharms(const std::shared_ptr<Player> &pl
 			}
 		}
 	} else {
-		query.str("");
-		query << "INSERT INTO `player_charms` (`player_guid`) VALUES (" << player->getGUID() << ')';
-		Database::getInstance().executeQuery(query.str());
+		db.executeQuery(DBStatement("INSERT INTO `player_charms` (`player_guid`) VALUES (?)").bind(player->getGUID()));
 	}
 }
 
@@ -495,11 +480,9 @@ void IOLoginDataLoad::loadPlayerInstantSpellList(const std::shared_ptr<Player> &
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `player_id`, `name` FROM `player_spells` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	if ((result = db.storeQuery(DBStatement("SELECT `name` FROM `player_spells` WHERE `player_id` = ?").bind(player->getGUID())))) {
 		do {
-			player->learnedInstantSpellList.emplace_back(result->getString("name"));
+			player->learnedInstantSpellList.emplace_back(result->getString(0));
 		} while (result->next());
 	}
 }
@@ -511,14 +494,15 @@ void IOLoginDataLoad::loadPlayerInventoryItems(const std::shared_ptr<Player> &pl
 	}
 
 	bool oldProtocol = g_configManager().getBoolean(OLD_PROTOCOL) && player->getProtocolVersion() < 1200;
-	auto query = fmt::format("SELECT pid, sid, itemtype, count, attributes FROM player_items WHERE player_id = {} ORDER BY sid DESC", player->getGUID());
+	DBStatement statement("SELECT pid, sid, itemtype, count, attributes FROM player_items WHERE player_id = ? ORDER BY sid DESC");
+	statement.bind(player->getGUID());
 
 	ItemsMap inventoryItems;
 	std::vector<std::pair<uint8_t, std::shared_ptr<Container>>> openContainersList;
 	std::vector<std::shared_ptr<Item>> itemsToStartDecaying;
 
 	try {
-		if ((result = g_database().storeQuery(query))) {
+		if ((result = g_database().storeQuery(statement))) {
 			loadItems(inventoryItems, result, player);
 
 			for (auto it = inventoryItems.rbegin(), end = inventoryItems.rend(); it != end; ++it) {
@@ -609,11 +593,8 @@ void IOLoginDataLoad::loadRewardItems(const std::shared_ptr<Player> &player) {
 	}
 
 	ItemsMap rewardItems;
-	std::ostringstream query;
-	query.str(std::string());
-	query << "SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_rewards` WHERE `player_id` = "
-		  << player->getGUID() << " ORDER BY `pid`, `sid` ASC";
-	if (auto result = Database::getInstance().storeQuery(query.str())) {
+	DBStatement statement("SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_rewards` WHERE `player_id` = ? ORDER BY `pid`, `sid` ASC");
+	if (auto result = Database::getInstance().storeQuery(statement.bind(player->getGUID()))) {
 		loadItems(rewardItems, result, player);
 		bindRewardBag(player, rewardItems);
 		insertItemsIntoRewardBag(rewardItems);
@@ -628,8 +609,8 @@ void IOLoginDataLoad::loadPlayerDepotItems(const std::shared_ptr<Player> &player
 
 	ItemsMap depotItems;
 	std::vector<std::shared_ptr<Item>> itemsToStartDecaying;
-	auto query = fmt::format("SELECT pid, sid, itemtype, count, attributes FROM player_depotitems WHERE player_id = {} ORDER BY sid DESC", player->getGUID());
-	if ((result = g_database().storeQuery(query))) {
+	DBStatement statement("SELECT pid, sid, itemtype, count, attributes FROM player_depotitems WHERE player_id = ? ORDER BY sid DESC");
+	if ((result = g_database().storeQuery(statement.bind(player->getGUID())))) {
 		loadItems(depotItems, result, player);
 		for (auto it = depotItems.rbegin(), end = depotItems.rend(); it != end; ++it) {
 			const std::pair<std::shared_ptr<Item>, int32_t> &pair = it->second;
@@ -674,8 +655,8 @@ void IOLoginDataLoad::loadPlayerInboxItems(const std::shared_ptr<Player> &player
 	}
 
 	std::vector<std::shared_ptr<Item>> itemsToStartDecaying;
-	auto query = fmt::format("SELECT pid, sid, itemtype, count, attributes FROM player_inboxitems WHERE player_id = {} ORDER BY sid DESC", player->getGUID());
-	if ((result = g_database().storeQuery(query))) {
+	DBStatement statement("SELECT pid, sid, itemtype, count, attributes FROM player_inboxitems WHERE player_id = ? ORDER BY sid DESC");
+	if ((result = g_database().storeQuery(statement.bind(player->getGUID())))) {
 		ItemsMap inboxItems;
 		loadItems(inboxItems, result, player);
 
@@ -718,13 +699,18 @@ void IOLoginDataLoad::loadPlayerStorageMap(const std::shared_ptr<Player> &player
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `key`, `value` FROM `player_storage` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	PlayerSaveState::StorageMap storage;
+	if ((result = db.storeQuery(DBStatement("SELECT `key`, `value` FROM `player_storage` WHERE `player_id` = ?").bind(player->getGUID())))) {
 		do {
-			player->addStorageValue(result->getNumber<uint32_t>("key"), result->getNumber<int32_t>("value"), true);
+			const auto key = result->getNumber<uint32_t>(0);
+			const auto value = result->getNumber<int32_t>(1);
+			player->addStorageValue(key, value, true);
+			storage.emplace(key, value);
 		} while (result->next());
 	}
+
+	// The rows as they are in the database, reserved ranges included, storage saves write the difference
+	player->saveState()->onLoad(std::move(storage));
 }
 
 void IOLoginDataLoad::loadPlayerVip(const std::shared_ptr<Player> &player, DBResult_ptr result) {
@@ -736,30 +722,27 @@ void IOLoginDataLoad::loadPlayerVip(const std::shared_ptr<Player> &player, DBRes
 	uint32_t accountId = player->getAccountId();
 
 	Database &db = Database::getInstance();
-	std::string query = fmt::format("SELECT `player_id` FROM `account_viplist` WHERE `account_id` = {}", accountId);
-	if ((result = db.storeQuery(query))) {
+	if ((result = db.storeQuery(DBStatement("SELECT `player_id` FROM `account_viplist` WHERE `account_id` = ?").bind(accountId)))) {
 		do {
-			player->vip()->addInternal(result->getNumber<uint32_t>("player_id"));
+			player->vip()->addInternal(result->getNumber<uint32_t>(0));
 		} while (result->next());
 	}
 
-	query = fmt::format("SELECT `id`, `name`, `customizable` FROM `account_vipgroups` WHERE `account_id` = {}", accountId);
-	if ((result = db.storeQuery(query))) {
+	if ((result = db.storeQuery(DBStatement("SELECT `id`, `name`, `customizable` FROM `account_vipgroups` WHERE `account_id` = ?").bind(accountId)))) {
 		do {
 			player->vip()->addGroupInternal(
-				result->getNumber<uint8_t>("id"),
-				result->getString("name"),
-				result->getNumber<uint8_t>("customizable") == 0 ? false : true
+				result->getNumber<uint8_t>(0),
+				result->getString(1),
+				result->getNumber<uint8_t>(2) == 0 ? false : true
 			);
 		} while (result->next());
 	}
 
-	query = fmt::format("SELECT `player_id`, `vipgroup_id` FROM `account_vipgrouplist` WHERE `account_id` = {}", accountId);
-	if ((result = db.storeQuery(query))) {
+	if ((result = db.storeQuery(DBStatement("SELECT `player_id`, `vipgroup_id` FROM `account_vipgrouplist` WHERE `account_id` = ?").bind(accountId)))) {
 		do {
 			player->vip()->addGuidToGroupInternal(
-				result->getNumber<uint8_t>("vipgroup_id"),
-				result->getNumber<uint32_t>("player_id")
+				result->getNumber<uint8_t>(1),
+				result->getNumber<uint32_t>(0)
 			);
 		} while (result->next());
 	}
@@ -773,9 +756,7 @@ void IOLoginDataLoad::loadPlayerPreyClass(const std::shared_ptr<Player> &player,
 
 	if (g_configManager().getBoolean(PREY_ENABLED)) {
 		Database &db = Database::getInstance();
-		std::ostringstream query;
-		query << "SELECT * FROM `player_prey` WHERE `player_id` = " << player->getGUID();
-		if ((result = db.storeQuery(query.str()))) {
+		if ((result = db.storeQuery(DBStatement("SELECT * FROM `player_prey` WHERE `player_id` = ?").bind(player->getGUID())))) {
 			do {
 				auto slot = std::make_unique<PreySlot>(static_cast<PreySlot_t>(result->getNumber<uint16_t>("slot")));
 				auto state = static_cast<PreyDataState_t>(result->getNumber<uint16_t>("state"));
@@ -820,9 +801,7 @@ void IOLoginDataLoad::loadPlayerTaskHuntingClass(const std::shared_ptr<Player> &
 
 	if (g_configManager().getBoolean(TASK_HUNTING_ENABLED)) {
 		Database &db = Database::getInstance();
-		std::ostringstream query;
-		query << "SELECT * FROM `player_taskhunt` WHERE `player_id` = " << player->getGUID();
-		if ((result = db.storeQuery(query.str()))) {
+		if ((result = db.storeQuery(DBStatement("SELECT * FROM `player_taskhunt` WHERE `player_id` = ?").bind(player->getGUID())))) {
 			do {
 				auto slot = std::make_unique<TaskHuntingSlot>(static_cast<PreySlot_t>(result->getNumber<uint16_t>("slot")));
 				auto state = static_cast<PreyTaskDataState_t>(result->getNumber<uint16_t>("state"));
@@ -868,9 +847,7 @@ void IOLoginDataLoad::loadPlayerForgeHistory(const std::shared_ptr<Player> &play
 		return;
 	}
 
-	std::ostringstream query;
-	query << "SELECT * FROM `forge_history` WHERE `player_id` = " << player->getGUID();
-	if ((result = Database::getInstance().storeQuery(query.str()))) {
+	if ((result = Database::getInstance().storeQuery(DBStatement("SELECT * FROM `forge_history` WHERE `player_id` = ?").bind(player->getGUID())))) {
 		do {
 			auto actionEnum = magic_enum::enum_value<ForgeAction_t>(result->getNumber<uint16_t>("action_type"));
 			ForgeHistory history;
@@ -894,9 +871,7 @@ void IOLoginDataLoad::loadPlayerBosstiary(const std::shared_ptr<Player> &player,
 		return;
 	}
 
-	std::ostringstream query;
-	query << "SELECT * FROM `player_bosstiary` WHERE `player_id` = " << player->getGUID();
-	if ((result = Database::getInstance().storeQuery(query.str()))) {
+	if ((result = Database::getInstance().storeQuery(DBStatement("SELECT * FROM `player_bosstiary` WHERE `player_id` = ?").bind(player->getGUID())))) {
 		do {
 			player->setSlotBossId(1, result->getNumber<uint16_t>("bossIdSlotOne"));
 			player->setSlotBossId(2, result->getNumber<uint16_t>("bossIdSlotTwo"));
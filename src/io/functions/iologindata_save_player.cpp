@@ -13,18 +13,15 @@
 #include "creatures/combat/condition.hpp"
 #include "creatures/monsters/monsters.hpp"
 #include "game/game.hpp"
+#include "io/functions/player_save_state.hpp"
 #include "io/ioprey.hpp"
 #include "items/containers/depot/depotchest.hpp"
 #include "items/containers/inbox/inbox.hpp"
 #include "items/containers/rewards/reward.hpp"
 #include "creatures/players/player.hpp"
+#include "utils/hash.hpp"
 
-bool IOLoginDataSave::saveItems(const std::shared_ptr<Player> &player, const ItemBlockList &itemList, DBInsert &query_insert, PropWriteStream &propWriteStream) {
-	if (!player) {
-		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
-		return false;
-	}
-
+void IOLoginDataSave::saveItems(const std::shared_ptr<Player> &player, const ItemBlockList &itemList, RowList &rows, PropWriteStream &propWriteStream) {
 	const Database &db = Database::getInstance();
 	std::ostringstream ss;
 
@@ -78,12 +75,10 @@ bool IOLoginDataSave::saveItems(const std::shared_ptr<Player> &player, const Ite
 		size_t attributesSize;
 		const char* attributes = propWriteStream.getStream(attributesSize);
 
-		// Build query string and add row
+		// Build the row
 		ss << player->getGUID() << ',' << pid << ',' << runningId << ',' << item->getID() << ',' << item->getSubType() << ',' << db.escapeBlob(attributes, static_cast<uint32_t>(attributesSize));
-		if (!query_insert.addRow(ss)) {
-			g_logger().error("Error adding row to query.");
-			return false;
-		}
+		rows.emplace_back(ss.str());
+		ss.str(std::string());
 	}
 
 	// Loop through containers in queue
@@ -132,54 +127,97 @@ bool IOLoginDataSave::saveItems(const std::shared_ptr<Player> &player, const Ite
 			size_t attributesSize;
 			const char* attributes = propWriteStream.getStream(attributesSize);
 
-			// Build query string and add row
+			// Build the row
 			ss << player->getGUID() << ',' << parentId << ',' << runningId << ',' << item->getID() << ',' << item->getSubType() << ',' << db.escapeBlob(attributes, static_cast<uint32_t>(attributesSize));
-			if (!query_insert.addRow(ss)) {
-				g_logger().error("Error adding row to query for container item.");
-				return false;
-			}
+			rows.emplace_back(ss.str());
+			ss.str(std::string());
 		}
 
 		// Removes the object after processing everything, avoiding memory usage after freeing
 		queue.pop_front();
 	}
+}
 
-	// Execute query
-	if (!query_insert.execute()) {
-		g_logger().error("Error executing query.");
-		return false;
+bool IOLoginDataSave::saveRows(const PlayerSaveSnapshot &snapshot, const PlayerSaveSnapshot::Rows &rows) {
+	size_t hash = 0;
+	size_t bytes = 0;
+	for (const auto &row : rows.rows) {
+		stdext::hash_combine(hash, row);
+		bytes += row.size();
 	}
-	return true;
-}
 
-bool IOLoginDataSave::savePlayerFirst(const std::shared_ptr<Player> &player) {
-	if (!player) {
-		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
+	// Same rows as the last save, the table already holds them
+	if (!snapshot.saveState->stage(rows.section, hash, bytes)) {
+		return true;
+	}
+
+	Database &db = Database::getInstance();
+	const auto deleteQuery = fmt::format("DELETE FROM `{}` WHERE `player_id` = ?", rows.table);
+	if (!db.executeQuery(DBStatement(deleteQuery).bind(snapshot.guid))) {
 		return false;
 	}
 
-	if (player->getHealth() <= 0) {
-		player->changeHealth(1);
+	DBInsert insertRows(std::string(rows.insertQuery));
+	for (const auto &row : rows.rows) {
+		if (!insertRows.addRow(row)) {
+			return false;
+		}
+	}
+	return insertRows.execute();
+}
+
+bool IOLoginDataSave::savePlayerRows(const PlayerSaveSnapshot &snapshot) {
+	for (const auto &rows : snapshot.rows) {
+		if (!saveRows(snapshot, rows)) {
+			g_logger().warn("[IOLoginData::savePlayer] - Failed to save {} of player: {}", rows.table, snapshot.name);
+			return false;
+		}
 	}
+	return true;
+}
 
+bool IOLoginDataSave::savePlayerStatements(const PlayerSaveSnapshot &snapshot) {
 	Database &db = Database::getInstance();
+	for (const auto &section : snapshot.statements) {
+		// Same values as the last save, the rows already hold them
+		if (!snapshot.saveState->stage(section.section, section.hash, section.bytes)) {
+			continue;
+		}
 
-	std::ostringstream query;
-	query << "SELECT `save` FROM `players` WHERE `id` = " << player->getGUID();
-	DBResult_ptr result = db.storeQuery(query.str());
-	if (!result) {
-		g_logger().warn("[IOLoginData::savePlayer] - Error for select result query from player: {}", player->getName());
+		for (const auto &statement : section.statements) {
+			if (!db.executeQuery(statement)) {
+				g_logger().warn("[IOLoginData::savePlayer] - Error saving {} data from player: {}", magic_enum::enum_name(section.section), snapshot.name);
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool IOLoginDataSave::savePlayerWheel(const PlayerSaveSnapshot &snapshot) {
+	DBInsert insertWheelData("INSERT INTO `player_wheeldata` (`player_id`, `slot`) VALUES ");
+	insertWheelData.upsert({ "slot" });
+	if (!snapshot.wheelRow.empty() && !insertWheelData.addRow(snapshot.wheelRow)) {
+		g_logger().debug("[{}] failed to insert row data", __FUNCTION__);
 		return false;
 	}
 
-	if (result->getNumber<uint16_t>("save") == 0) {
-		query.str("");
-		query << "UPDATE `players` SET `lastlogin` = " << player->lastLoginSaved << ", `lastip` = " << player->lastIP << " WHERE `id` = " << player->getGUID();
-		return db.executeQuery(query.str());
+	if (!insertWheelData.execute()) {
+		g_logger().debug("[{}] failed to execute database insert", __FUNCTION__);
+		return false;
+	}
+	return true;
+}
+
+void IOLoginDataSave::capturePlayerFirst(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
+	if (player->getHealth() <= 0) {
+		player->changeHealth(1);
 	}
 
+	const Database &db = Database::getInstance();
+
 	// First, an UPDATE query to write the player itself
-	query.str("");
+	std::ostringstream query;
 	query << "UPDATE `players` SET ";
 	query << "`name` = " << db.escapeString(player->name) << ",";
 	query << "`level` = " << player->level << ",";
@@ -314,166 +352,94 @@ bool IOLoginDataSave::savePlayerFirst(const std::shared_ptr<Player> &player) {
 	}
 	query << " WHERE `id` = " << player->getGUID();
 
-	if (!db.executeQuery(query.str())) {
-		return false;
-	}
-	return true;
+	snapshot.playerQuery = query.str();
+	snapshot.lastLogin = player->lastLoginSaved;
+	snapshot.lastIP = player->lastIP;
 }
 
-bool IOLoginDataSave::savePlayerStash(const std::shared_ptr<Player> &player) {
-	if (!player) {
-		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
+bool IOLoginDataSave::savePlayerFirst(const PlayerSaveSnapshot &snapshot) {
+	Database &db = Database::getInstance();
+
+	DBResult_ptr result = db.storeQuery(DBStatement("SELECT `save` FROM `players` WHERE `id` = ?").bind(snapshot.guid));
+	if (!result) {
+		g_logger().warn("[IOLoginData::savePlayer] - Error for select result query from player: {}", snapshot.name);
 		return false;
 	}
 
-	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "DELETE FROM `player_stash` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
+	if (result->getNumber<uint16_t>(0) == 0) {
+		DBStatement statement("UPDATE `players` SET `lastlogin` = ?, `lastip` = ? WHERE `id` = ?");
+		return db.executeQuery(statement.bind(snapshot.lastLogin).bind(snapshot.lastIP).bind(snapshot.guid));
 	}
 
-	query.str("");
+	return db.executeQuery(snapshot.playerQuery);
+}
+
+void IOLoginDataSave::capturePlayerStash(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
+	std::ostringstream query;
 
-	DBInsert stashQuery("INSERT INTO `player_stash` (`player_id`,`item_id`,`item_count`) VALUES ");
+	RowList rows;
 	for (const auto &[itemId, itemCount] : player->getStashItems()) {
 		query << player->getGUID() << ',' << itemId << ',' << itemCount;
-		if (!stashQuery.addRow(query)) {
-			return false;
-		}
+		rows.emplace_back(query.str());
+		query.str(std::string());
 	}
 
-	if (!stashQuery.execute()) {
-		return false;
-	}
-	return true;
+	snapshot.rows.push_back({ PlayerSaveSection_t::Stash, "player_stash", "INSERT INTO `player_stash` (`player_id`,`item_id`,`item_count`) VALUES ", std::move(rows) });
 }
 
-bool IOLoginDataSave::savePlayerSpells(const std::shared_ptr<Player> &player) {
-	if (!player) {
-		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
-		return false;
-	}
-
-	Database &db = Database::getInstance();
+void IOLoginDataSave::capturePlayerSpells(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
+	const Database &db = Database::getInstance();
 	std::ostringstream query;
-	query << "DELETE FROM `player_spells` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
-	}
-
-	query.str("");
 
-	DBInsert spellsQuery("INSERT INTO `player_spells` (`player_id`, `name` ) VALUES ");
+	RowList rows;
 	for (const std::string &spellName : player->learnedInstantSpellList) {
 		query << player->getGUID() << ',' << db.escapeString(spellName);
-		if (!spellsQuery.addRow(query)) {
-			return false;
-		}
+		rows.emplace_back(query.str());
+		query.str(std::string());
 	}
 
-	if (!spellsQuery.execute()) {
-		return false;
-	}
-	return true;
+	snapshot.rows.push_back({ PlayerSaveSection_t::Spells, "player_spells", "INSERT INTO `player_spells` (`player_id`, `name` ) VALUES ", std::move(rows) });
 }
 
-bool IOLoginDataSave::savePlayerKills(const std::shared_ptr<Player> &player) {
-	if (!player) {
-		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
-		return false;
-	}
-
-	Database &db = Database::getInstance();
+void IOLoginDataSave::capturePlayerKills(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	std::ostringstream query;
-	query << "DELETE FROM `player_kills` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
-	}
 
-	query.str("");
-
-	DBInsert killsQuery("INSERT INTO `player_kills` (`player_id`, `target`, `time`, `unavenged`) VALUES");
+	RowList rows;
 	for (const auto &kill : player->unjustifiedKills) {
 		query << player->getGUID() << ',' << kill.target << ',' << kill.time << ',' << kill.unavenged;
-		if (!killsQuery.addRow(query)) {
-			return false;
-		}
+		rows.emplace_back(query.str());
+		query.str(std::string());
 	}
 
-	if (!killsQuery.execute()) {
-		return false;
-	}
-	return true;
+	snapshot.rows.push_back({ PlayerSaveSection_t::Kills, "player_kills", "INSERT INTO `player_kills` (`player_id`, `target`, `time`, `unavenged`) VALUES", std::move(rows) });
 }
 
-bool IOLoginDataSave::savePlayerBestiarySystem(const std::shared_ptr<Player> &player) {
-	if (!player) {
-		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
-		return false;
-	}
-
-	Database &db = Database::getInstance();
-
-	std::ostringstream query;
-	query << "UPDATE `player_charms` SET ";
-	query << "`charm_points` = " << player->charmPoints << ",";
-	query << "`charm_expansion` = " << ((player->charmExpansion) ? 1 : 0) << ",";
-	query << "`rune_wound` = " << player->charmRuneWound << ",";
-	query << "`rune_enflame` = " << player->charmRuneEnflame << ",";
-	query << "`rune_poison` = " << player->charmRunePoison << ",";
-	query << "`rune_freeze` = " << player->charmRuneFreeze << ",";
-	query << "`rune_zap` = " << player->charmRuneZap << ",";
-	query << "`rune_curse` = " << player->charmRuneCurse << ",";
-	query << "`rune_cripple` = " << player->charmRuneCripple << ",";
-	query << "`rune_parry` = " << player->charmRuneParry << ",";
-	query << "`rune_dodge` = " << player->charmRuneDodge << ",";
-	query << "`rune_adrenaline` = " << player->charmRuneAdrenaline << ",";
-	query << "`rune_numb` = " << player->charmRuneNumb << ",";
-	query << "`rune_cleanse` = " << player->charmRuneCleanse << ",";
-	query << "`rune_bless` = " << player->charmRuneBless << ",";
-	query << "`rune_scavenge` = " << player->charmRuneScavenge << ",";
-	query << "`rune_gut` = " << player->charmRuneGut << ",";
-	query << "`rune_low_blow` = " << player->charmRuneLowBlow << ",";
-	query << "`rune_divine` = " << player->charmRuneDivine << ",";
-	query << "`rune_vamp` = " << player->charmRuneVamp << ",";
-	query << "`rune_void` = " << player->charmRuneVoid << ",";
-	query << "`UsedRunesBit` = " << player->UsedRunesBit << ",";
-	query << "`UnlockedRunesBit` = " << player->UnlockedRunesBit << ",";
-
+void IOLoginDataSave::capturePlayerBestiarySystem(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	PropWriteStream propBestiaryStream;
 	for (const auto &trackedType : player->getCyclopediaMonsterTrackerSet(false)) {
 		propBestiaryStream.write<uint16_t>(trackedType->info.raceid);
 	}
-	size_t trackerSize;
-	const char* trackerList = propBestiaryStream.getStream(trackerSize);
-	query << " `tracker list` = " << db.escapeBlob(trackerList, static_cast<uint32_t>(trackerSize));
-	query << " WHERE `player_guid` = " << player->getGUID();
-
-	if (!db.executeQuery(query.str())) {
-		g_logger().warn("[IOLoginData::savePlayer] - Error saving bestiary data from player: {}", player->getName());
-		return false;
-	}
-	return true;
+	const auto trackerList = snapshot.keepBlob(propBestiaryStream);
+
+	auto &bestiary = snapshot.statements.emplace_back(PlayerSaveSnapshot::Statements { PlayerSaveSection_t::Bestiary });
+	auto &statement = bestiary.statements.emplace_back(
+		"UPDATE `player_charms` SET `charm_points` = ?, `charm_expansion` = ?, "
+		"`rune_wound` = ?, `rune_enflame` = ?, `rune_poison` = ?, `rune_freeze` = ?, `rune_zap` = ?, `rune_curse` = ?, "
+		"`rune_cripple` = ?, `rune_parry` = ?, `rune_dodge` = ?, `rune_adrenaline` = ?, `rune_numb` = ?, `rune_cleanse` = ?, "
+		"`rune_bless` = ?, `rune_scavenge` = ?, `rune_gut` = ?, `rune_low_blow` = ?, `rune_divine` = ?, `rune_vamp` = ?, `rune_void` = ?, "
+		"`UsedRunesBit` = ?, `UnlockedRunesBit` = ?, `tracker list` = ? WHERE `player_guid` = ?"
+	);
+	statement.bind(player->charmPoints).bind(player->charmExpansion);
+	statement.bind(player->charmRuneWound).bind(player->charmRuneEnflame).bind(player->charmRunePoison).bind(player->charmRuneFreeze).bind(player->charmRuneZap).bind(player->charmRuneCurse);
+	statement.bind(player->charmRuneCripple).bind(player->charmRuneParry).bind(player->charmRuneDodge).bind(player->charmRuneAdrenaline).bind(player->charmRuneNumb).bind(player->charmRuneCleanse);
+	statement.bind(player->charmRuneBless).bind(player->charmRuneScavenge).bind(player->charmRuneGut).bind(player->charmRuneLowBlow).bind(player->charmRuneDivine).bind(player->charmRuneVamp).bind(player->charmRuneVoid);
+	statement.bind(player->UsedRunesBit).bind(player->UnlockedRunesBit).bindBlob(trackerList.data(), trackerList.size()).bind(player->getGUID());
+	bestiary.hash = statement.hash();
+	bestiary.bytes = statement.getDataSize();
 }
 
-bool IOLoginDataSave::savePlayerItem(const std::shared_ptr<Player> &player) {
-	if (!player) {
-		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
-		return false;
-	}
-
-	Database &db = Database::getInstance();
+void IOLoginDataSave::capturePlayerItem(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	PropWriteStream propWriteStream;
-	std::ostringstream query;
-	query << "DELETE FROM `player_items` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		g_logger().warn("[IOLoginData::savePlayer] - Error delete query 'player_items' from player: {}", player->getName());
-		return false;
-	}
-
-	DBInsert itemsQuery("INSERT INTO `player_items` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-
 	ItemBlockList itemList;
 	for (int32_t slotId = CONST_SLOT_FIRST; slotId <= CONST_SLOT_LAST; ++slotId) {
 		const auto &item = player->inventory[slotId];
@@ -482,230 +448,155 @@ bool IOLoginDataSave::savePlayerItem(const std::shared_ptr<Player> &player) {
 		}
 	}
 
-	if (!saveItems(player, itemList, itemsQuery, propWriteStream)) {
-		g_logger().warn("[IOLoginData::savePlayer] - Failed for save items from player: {}", player->getName());
-		return false;
-	}
-	return true;
+	RowList rows;
+	saveItems(player, itemList, rows, propWriteStream);
+	snapshot.rows.push_back({ PlayerSaveSection_t::Items, "player_items", "INSERT INTO `player_items` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ", std::move(rows) });
 }
 
-bool IOLoginDataSave::savePlayerDepotItems(const std::shared_ptr<Player> &player) {
-	if (!player) {
-		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
-		return false;
+void IOLoginDataSave::capturePlayerDepotItems(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
+	if (player->lastDepotId == -1) {
+		return;
 	}
 
-	Database &db = Database::getInstance();
 	PropWriteStream propWriteStream;
 	ItemDepotList depotList;
-	if (player->lastDepotId != -1) {
-		std::ostringstream query;
-		query << "DELETE FROM `player_depotitems` WHERE `player_id` = " << player->getGUID();
-
-		if (!db.executeQuery(query.str())) {
-			return false;
+	for (const auto &[pid, depotChest] : player->depotChests) {
+		for (const std::shared_ptr<Item> &item : depotChest->getItemList()) {
+			depotList.emplace_back(pid, item);
 		}
-
-		query.str("");
-
-		DBInsert depotQuery("INSERT INTO `player_depotitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-
-		for (const auto &[pid, depotChest] : player->depotChests) {
-			for (const std::shared_ptr<Item> &item : depotChest->getItemList()) {
-				depotList.emplace_back(pid, item);
-			}
-		}
-
-		if (!saveItems(player, depotList, depotQuery, propWriteStream)) {
-			return false;
-		}
-		return true;
 	}
-	return true;
-}
 
-bool IOLoginDataSave::saveRewardItems(const std::shared_ptr<Player> &player) {
-	if (!player) {
-		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
-		return false;
-	}
-
-	std::ostringstream query;
-	query << "DELETE FROM `player_rewards` WHERE `player_id` = " << player->getGUID();
-
-	if (!Database::getInstance().executeQuery(query.str())) {
-		return false;
-	}
+	RowList rows;
+	saveItems(player, depotList, rows, propWriteStream);
+	snapshot.rows.push_back({ PlayerSaveSection_t::DepotItems, "player_depotitems", "INSERT INTO `player_depotitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ", std::move(rows) });
+}
 
+void IOLoginDataSave::captureRewardItems(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	std::vector<uint64_t> rewardList;
 	player->getRewardList(rewardList);
 
 	ItemRewardList rewardListItems;
-	if (!rewardList.empty()) {
-		for (const auto &rewardId : rewardList) {
-			auto reward = player->getReward(rewardId, false);
-			if (!reward->empty() && (getTimeMsNow() - rewardId <= 1000 * 60 * 60 * 24 * 7)) {
-				rewardListItems.emplace_back(0, reward);
-			}
-		}
-
-		DBInsert rewardQuery("INSERT INTO `player_rewards` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-		PropWriteStream propWriteStream;
-		if (!saveItems(player, rewardListItems, rewardQuery, propWriteStream)) {
-			return false;
+	for (const auto &rewardId : rewardList) {
+		auto reward = player->getReward(rewardId, false);
+		if (!reward->empty() && (getTimeMsNow() - rewardId <= 1000 * 60 * 60 * 24 * 7)) {
+			rewardListItems.emplace_back(0, reward);
 		}
 	}
-	return true;
-}
 
-bool IOLoginDataSave::savePlayerInbox(const std::shared_ptr<Player> &player) {
-	if (!player) {
-		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
-		return false;
-	}
+	PropWriteStream propWriteStream;
+	RowList rows;
+	saveItems(player, rewardListItems, rows, propWriteStream);
+	snapshot.rows.push_back({ PlayerSaveSection_t::RewardItems, "player_rewards", "INSERT INTO `player_rewards` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ", std::move(rows) });
+}
 
-	Database &db = Database::getInstance();
+void IOLoginDataSave::capturePlayerInbox(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	PropWriteStream propWriteStream;
 	ItemInboxList inboxList;
-	std::ostringstream query;
-	query << "DELETE FROM `player_inboxitems` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
-	}
-
-	query.str("");
-	DBInsert inboxQuery("INSERT INTO `player_inboxitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-
 	for (const auto &item : player->getInbox()->getItemList()) {
 		inboxList.emplace_back(0, item);
 	}
 
-	if (!saveItems(player, inboxList, inboxQuery, propWriteStream)) {
-		return false;
-	}
-	return true;
+	RowList rows;
+	saveItems(player, inboxList, rows, propWriteStream);
+	snapshot.rows.push_back({ PlayerSaveSection_t::Inbox, "player_inboxitems", "INSERT INTO `player_inboxitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ", std::move(rows) });
 }
 
-bool IOLoginDataSave::savePlayerPreyClass(const std::shared_ptr<Player> &player) {
-	if (!player) {
-		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
-		return false;
-	}
-
-	Database &db = Database::getInstance();
-	if (g_configManager().getBoolean(PREY_ENABLED)) {
-		std::ostringstream query;
-		for (uint8_t slotId = PreySlot_First; slotId <= PreySlot_Last; slotId++) {
-			if (const auto &slot = player->getPreySlotById(static_cast<PreySlot_t>(slotId))) {
-				query.str(std::string());
-				query << "INSERT INTO player_prey (`player_id`, `slot`, `state`, `raceid`, `option`, `bonus_type`, `bonus_rarity`, `bonus_percentage`, `bonus_time`, `free_reroll`, `monster_list`) "
-					  << "VALUES (" << player->getGUID() << ", "
-					  << static_cast<uint16_t>(slot->id) << ", "
-					  << static_cast<uint16_t>(slot->state) << ", "
-					  << slot->selectedRaceId << ", "
-					  << static_cast<uint16_t>(slot->option) << ", "
-					  << static_cast<uint16_t>(slot->bonus) << ", "
-					  << static_cast<uint16_t>(slot->bonusRarity) << ", "
-					  << slot->bonusPercentage << ", "
-					  << slot->bonusTimeLeft << ", "
-					  << slot->freeRerollTimeStamp << ", ";
-
-				PropWriteStream propPreyStream;
-				std::ranges::for_each(slot->raceIdList, [&propPreyStream](uint16_t raceId) {
-					propPreyStream.write<uint16_t>(raceId);
-				});
-
-				size_t preySize;
-				const char* preyList = propPreyStream.getStream(preySize);
-				query << db.escapeBlob(preyList, static_cast<uint32_t>(preySize)) << ")";
-
-				query << " ON DUPLICATE KEY UPDATE "
-					  << "`state` = VALUES(`state`), "
-					  << "`raceid` = VALUES(`raceid`), "
-					  << "`option` = VALUES(`option`), "
-					  << "`bonus_type` = VALUES(`bonus_type`), "
-					  << "`bonus_rarity` = VALUES(`bonus_rarity`), "
-					  << "`bonus_percentage` = VALUES(`bonus_percentage`), "
-					  << "`bonus_time` = VALUES(`bonus_time`), "
-					  << "`free_reroll` = VALUES(`free_reroll`), "
-					  << "`monster_list` = VALUES(`monster_list`)";
-
-				if (!db.executeQuery(query.str())) {
-					g_logger().warn("[IOLoginData::savePlayer] - Error saving prey slot data from player: {}", player->getName());
-					return false;
-				}
-			}
+void IOLoginDataSave::capturePlayerPreyClass(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
+	if (!g_configManager().getBoolean(PREY_ENABLED)) {
+		return;
+	}
+
+	auto &prey = snapshot.statements.emplace_back(PlayerSaveSnapshot::Statements { PlayerSaveSection_t::Prey });
+	for (uint8_t slotId = PreySlot_First; slotId <= PreySlot_Last; slotId++) {
+		if (const auto &slot = player->getPreySlotById(static_cast<PreySlot_t>(slotId))) {
+			PropWriteStream propPreyStream;
+			std::ranges::for_each(slot->raceIdList, [&propPreyStream](uint16_t raceId) {
+				propPreyStream.write<uint16_t>(raceId);
+			});
+
+			const auto preyList = snapshot.keepBlob(propPreyStream);
+
+			auto &statement = prey.statements.emplace_back(
+				"INSERT INTO player_prey (`player_id`, `slot`, `state`, `raceid`, `option`, `bonus_type`, `bonus_rarity`, `bonus_percentage`, `bonus_time`, `free_reroll`, `monster_list`) "
+				"VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?) "
+				"ON DUPLICATE KEY UPDATE "
+				"`state` = VALUES(`state`), "
+				"`raceid` = VALUES(`raceid`), "
+				"`option` = VALUES(`option`), "
+				"`bonus_type` = VALUES(`bonus_type`), "
+				"`bonus_rarity` = VALUES(`bonus_rarity`), "
+				"`bonus_percentage` = VALUES(`bonus_percentage`), "
+				"`bonus_time` = VALUES(`bonus_time`), "
+				"`free_reroll` = VALUES(`free_reroll`), "
+				"`monster_list` = VALUES(`monster_list`)"
+			);
+			statement.bind(player->getGUID())
+				.bind(static_cast<uint16_t>(slot->id))
+				.bind(static_cast<uint16_t>(slot->state))
+				.bind(slot->selectedRaceId)
+				.bind(static_cast<uint16_t>(slot->option))
+				.bind(static_cast<uint16_t>(slot->bonus))
+				.bind(static_cast<uint16_t>(slot->bonusRarity))
+				.bind(slot->bonusPercentage)
+				.bind(slot->bonusTimeLeft)
+				.bind(slot->freeRerollTimeStamp)
+				.bindBlob(preyList.data(), preyList.size());
+
+			stdext::hash_combine(prey.hash, statement.hash());
+			prey.bytes += statement.getDataSize();
 		}
 	}
-	return true;
 }
 
-bool IOLoginDataSave::savePlayerTaskHuntingClass(const std::shared_ptr<Player> &player) {
-	if (!player) {
-		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
-		return false;
-	}
-
-	Database &db = Database::getInstance();
-	if (g_configManager().getBoolean(TASK_HUNTING_ENABLED)) {
-		std::ostringstream query;
-		for (uint8_t slotId = PreySlot_First; slotId <= PreySlot_Last; slotId++) {
-			if (const auto &slot = player->getTaskHuntingSlotById(static_cast<PreySlot_t>(slotId))) {
-				query.str("");
-				query << "INSERT INTO `player_taskhunt` (`player_id`, `slot`, `state`, `raceid`, `upgrade`, `rarity`, `kills`, `disabled_time`, `free_reroll`, `monster_list`) VALUES (";
-				query << player->getGUID() << ", ";
-				query << static_cast<uint16_t>(slot->id) << ", ";
-				query << static_cast<uint16_t>(slot->state) << ", ";
-				query << slot->selectedRaceId << ", ";
-				query << (slot->upgrade ? 1 : 0) << ", ";
-				query << static_cast<uint16_t>(slot->rarity) << ", ";
-				query << slot->currentKills << ", ";
-				query << slot->disabledUntilTimeStamp << ", ";
-				query << slot->freeRerollTimeStamp << ", ";
-
-				PropWriteStream propTaskHuntingStream;
-				std::ranges::for_each(slot->raceIdList, [&propTaskHuntingStream](uint16_t raceId) {
-					propTaskHuntingStream.write<uint16_t>(raceId);
-				});
-
-				size_t taskHuntingSize;
-				const char* taskHuntingList = propTaskHuntingStream.getStream(taskHuntingSize);
-				query << db.escapeBlob(taskHuntingList, static_cast<uint32_t>(taskHuntingSize)) << ")";
-
-				query << " ON DUPLICATE KEY UPDATE "
-					  << "`state` = VALUES(`state`), "
-					  << "`raceid` = VALUES(`raceid`), "
-					  << "`upgrade` = VALUES(`upgrade`), "
-					  << "`rarity` = VALUES(`rarity`), "
-					  << "`kills` = VALUES(`kills`), "
-					  << "`disabled_time` = VALUES(`disabled_time`), "
-					  << "`free_reroll` = VALUES(`free_reroll`), "
-					  << "`monster_list` = VALUES(`monster_list`)";
-
-				if (!db.executeQuery(query.str())) {
-					g_logger().warn("[IOLoginData::savePlayer] - Error saving task hunting slot data from player: {}", player->getName());
-					return false;
-				}
-			}
+void IOLoginDataSave::capturePlayerTaskHuntingClass(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
+	if (!g_configManager().getBoolean(TASK_HUNTING_ENABLED)) {
+		return;
+	}
+
+	auto &taskHunting = snapshot.statements.emplace_back(PlayerSaveSnapshot::Statements { PlayerSaveSection_t::TaskHunting });
+	for (uint8_t slotId = PreySlot_First; slotId <= PreySlot_Last; slotId++) {
+		if (const auto &slot = player->getTaskHuntingSlotById(static_cast<PreySlot_t>(slotId))) {
+			PropWriteStream propTaskHuntingStream;
+			std::ranges::for_each(slot->raceIdList, [&propTaskHuntingStream](uint16_t raceId) {
+				propTaskHuntingStream.write<uint16_t>(raceId);
+			});
+
+			const auto taskHuntingList = snapshot.keepBlob(propTaskHuntingStream);
+
+			auto &statement = taskHunting.statements.emplace_back(
+				"INSERT INTO `player_taskhunt` (`player_id`, `slot`, `state`, `raceid`, `upgrade`, `rarity`, `kills`, `disabled_time`, `free_reroll`, `monster_list`) "
+				"VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?) "
+				"ON DUPLICATE KEY UPDATE "
+				"`state` = VALUES(`state`), "
+				"`raceid` = VALUES(`raceid`), "
+				"`upgrade` = VALUES(`upgrade`), "
+				"`rarity` = VALUES(`rarity`), "
+				"`kills` = VALUES(`kills`), "
+				"`disabled_time` = VALUES(`disabled_time`), "
+				"`free_reroll` = VALUES(`free_reroll`), "
+				"`monster_list` = VALUES(`monster_list`)"
+			);
+			statement.bind(player->getGUID())
+				.bind(static_cast<uint16_t>(slot->id))
+				.bind(static_cast<uint16_t>(slot->state))
+				.bind(slot->selectedRaceId)
+				.bind(slot->upgrade ? 1 : 0)
+				.bind(static_cast<uint16_t>(slot->rarity))
+				.bind(slot->currentKills)
+				.bind(slot->disabledUntilTimeStamp)
+				.bind(slot->freeRerollTimeStamp)
+				.bindBlob(taskHuntingList.data(), taskHuntingList.size());
+
+			stdext::hash_combine(taskHunting.hash, statement.hash());
+			taskHunting.bytes += statement.getDataSize();
 		}
 	}
-	return true;
 }
 
-bool IOLoginDataSave::savePlayerForgeHistory(const std::shared_ptr<Player> &player) {
-	if (!player) {
-		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
-		return false;
-	}
-
+void IOLoginDataSave::capturePlayerForgeHistory(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	std::ostringstream query;
-	query << "DELETE FROM `forge_history` WHERE `player_id` = " << player->getGUID();
-	if (!Database::getInstance().executeQuery(query.str())) {
-		return false;
-	}
 
-	query.str("");
-	DBInsert insertQuery("INSERT INTO `forge_history` (`player_id`, `action_type`, `description`, `done_at`, `is_success`) VALUES");
+	RowList rows;
 	for (const auto &history : player->getForgeHistory()) {
 		const auto stringDescription = Database::getInstance().escapeString(history.description);
 		auto actionString = magic_enum::enum_integer(history.actionType);
@@ -715,31 +606,15 @@ bool IOLoginDataSave::savePlayerForgeHistory(const std::shared_ptr<Player> &play
 			  << stringDescription << ','
 			  << history.createdAt << ','
 			  << history.success;
-
-		if (!insertQuery.addRow(query)) {
-			return false;
-		}
-	}
-	if (!insertQuery.execute()) {
-		return false;
+		rows.emplace_back(query.str());
+		query.str(std::string());
 	}
-	return true;
-}
 
-bool IOLoginDataSave::savePlayerBosstiary(const std::shared_ptr<Player> &player) {
-	if (!player) {
-		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
-		return false;
-	}
+	snapshot.rows.push_back({ PlayerSaveSection_t::ForgeHistory, "forge_history", "INSERT INTO `forge_history` (`player_id`, `action_type`, `description`, `done_at`, `is_success`) VALUES", std::move(rows) });
+}
 
+void IOLoginDataSave::capturePlayerBosstiary(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	std::ostringstream query;
-	query << "DELETE FROM `player_bosstiary` WHERE `player_id` = " << player->getGUID();
-	if (!Database::getInstance().executeQuery(query.str())) {
-		return false;
-	}
-
-	query.str("");
-	DBInsert insertQuery("INSERT INTO `player_bosstiary` (`player_id`, `bossIdSlotOne`, `bossIdSlotTwo`, `removeTimes`, `tracker`) VALUES");
 
 	// Bosstiary tracker
 	PropWriteStream stream;
@@ -759,44 +634,85 @@ bool IOLoginDataSave::savePlayerBosstiary(const std::shared_ptr<Player> &player)
 		  << std::to_string(player->getRemoveTimes()) << ','
 		  << Database::getInstance().escapeBlob(chars, static_cast<uint32_t>(size));
 
-	if (!insertQuery.addRow(query)) {
-		return false;
-	}
-
-	if (!insertQuery.execute()) {
-		return false;
-	}
+	snapshot.rows.push_back({ PlayerSaveSection_t::Bosstiary, "player_bosstiary", "INSERT INTO `player_bosstiary` (`player_id`, `bossIdSlotOne`, `bossIdSlotTwo`, `removeTimes`, `tracker`) VALUES", { query.str() } });
+}
 
-	return true;
+void IOLoginDataSave::capturePlayerStorage(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
+	player->genReservedStorageRange();
+	snapshot.storage = player->storageMap;
 }
 
-bool IOLoginDataSave::savePlayerStorage(const std::shared_ptr<Player> &player) {
-	if (!player) {
-		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
-		return false;
+bool IOLoginDataSave::savePlayerStorage(const PlayerSaveSnapshot &snapshot) {
+	Database &db = Database::getInstance();
+	const auto &saveState = snapshot.saveState;
+
+	// Without the rows of a load to compare with, the storage is written whole
+	if (!saveState->hasSavedStorage()) {
+		if (!db.executeQuery(DBStatement("DELETE FROM `player_storage` WHERE `player_id` = ?").bind(snapshot.guid))) {
+			return false;
+		}
+
+		std::ostringstream query;
+		size_t bytes = 0;
+		DBInsert storageQuery("INSERT INTO `player_storage` (`player_id`, `key`, `value`) VALUES ");
+		for (const auto &[key, value] : snapshot.storage) {
+			query << snapshot.guid << ',' << key << ',' << value;
+			bytes += query.view().size();
+			if (!storageQuery.addRow(query)) {
+				return false;
+			}
+		}
+
+		if (!storageQuery.execute()) {
+			return false;
+		}
+		saveState->stageStorage(snapshot.storage, true, bytes);
+		return true;
 	}
 
-	Database &db = Database::getInstance();
+	// Both maps are ordered by key, a single pass finds the changed and the removed keys
+	const auto &savedStorage = saveState->getSavedStorage();
 	std::ostringstream query;
-	query << "DELETE FROM `player_storage` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
-	}
+	std::ostringstream removedKeys;
+	size_t bytes = 0;
+	DBInsert storageQuery("INSERT INTO `player_storage` (`player_id`, `key`, `value`) VALUES ");
+	storageQuery.upsert({ "value" });
 
-	query.str("");
+	auto saved = savedStorage.begin();
+	for (const auto &[key, value] : snapshot.storage) {
+		for (; saved != savedStorage.end() && saved->first < key; ++saved) {
+			removedKeys << (removedKeys.view().empty() ? "" : ",") << saved->first;
+		}
 
-	DBInsert storageQuery("INSERT INTO `player_storage` (`player_id`, `key`, `value`) VALUES ");
-	player->genReservedStorageRange();
+		if (saved != savedStorage.end() && saved->first == key) {
+			const bool unchanged = saved->second == value;
+			++saved;
+			if (unchanged) {
+				continue;
+			}
+		}
 
-	for (const auto &[key, value] : player->storageMap) {
-		query << player->getGUID() << ',' << key << ',' << value;
+		query << snapshot.guid << ',' << key << ',' << value;
+		bytes += query.view().size();
 		if (!storageQuery.addRow(query)) {
 			return false;
 		}
 	}
+	for (; saved != savedStorage.end(); ++saved) {
+		removedKeys << (removedKeys.view().empty() ? "" : ",") << saved->first;
+	}
+
+	if (!removedKeys.view().empty()) {
+		query << "DELETE FROM `player_storage` WHERE `player_id` = " << snapshot.guid << " AND `key` IN (" << removedKeys.view() << ')';
+		bytes += removedKeys.view().size();
+		if (!db.executeQuery(query.str())) {
+			return false;
+		}
+	}
 
 	if (!storageQuery.execute()) {
 		return false;
 	}
+	saveState->stageStorage(snapshot.storage, bytes != 0, bytes);
 	return true;
 }
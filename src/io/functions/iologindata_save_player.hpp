@@ -10,26 +10,34 @@
 #pragma once
 
 #include "io/iologindata.hpp"
+#include "io/functions/player_save_snapshot.hpp"
 
-class PropWriteStream;
-class DBInsert;
-
+/**
+ * A player is saved in two steps: the capture functions read the player on the dispatcher thread into
+ * a PlayerSaveSnapshot, the save functions write that snapshot to the database from any thread.
+ */
 class IOLoginDataSave : public IOLoginData {
 public:
-	static bool savePlayerFirst(const std::shared_ptr<Player> &player);
-	static bool savePlayerStash(const std::shared_ptr<Player> &player);
-	static bool savePlayerSpells(const std::shared_ptr<Player> &player);
-	static bool savePlayerKills(const std::shared_ptr<Player> &player);
-	static bool savePlayerBestiarySystem(const std::shared_ptr<Player> &player);
-	static bool savePlayerItem(const std::shared_ptr<Player> &player);
-	static bool savePlayerDepotItems(const std::shared_ptr<Player> &player);
-	static bool saveRewardItems(const std::shared_ptr<Player> &player);
-	static bool savePlayerInbox(const std::shared_ptr<Player> &player);
-	static bool savePlayerPreyClass(const std::shared_ptr<Player> &player);
-	static bool savePlayerTaskHuntingClass(const std::shared_ptr<Player> &player);
-	static bool savePlayerForgeHistory(const std::shared_ptr<Player> &player);
-	static bool savePlayerBosstiary(const std::shared_ptr<Player> &player);
-	static bool savePlayerStorage(const std::shared_ptr<Player> &player);
+	static void capturePlayerFirst(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static void capturePlayerStash(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static void capturePlayerSpells(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static void capturePlayerKills(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static void capturePlayerBestiarySystem(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static void capturePlayerItem(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static void capturePlayerDepotItems(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static void captureRewardItems(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static void capturePlayerInbox(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static void capturePlayerPreyClass(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static void capturePlayerTaskHuntingClass(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static void capturePlayerForgeHistory(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static void capturePlayerBosstiary(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static void capturePlayerStorage(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+
+	static bool savePlayerFirst(const PlayerSaveSnapshot &snapshot);
+	static bool savePlayerRows(const PlayerSaveSnapshot &snapshot);
+	static bool savePlayerStatements(const PlayerSaveSnapshot &snapshot);
+	static bool savePlayerWheel(const PlayerSaveSnapshot &snapshot);
+	static bool savePlayerStorage(const PlayerSaveSnapshot &snapshot);
 
 protected:
 	using ItemBlockList = std::list<std::pair<int32_t, std::shared_ptr<Item>>>;
@@ -37,5 +45,12 @@ protected:
 	using ItemRewardList = std::list<std::pair<int32_t, std::shared_ptr<Item>>>;
 	using ItemInboxList = std::list<std::pair<int32_t, std::shared_ptr<Item>>>;
 
-	static bool saveItems(const std::shared_ptr<Player> &player, const ItemBlockList &itemList, DBInsert &query_insert, PropWriteStream &stream);
+	using RowList = std::vector<std::string>;
+
+	static void saveItems(const std::shared_ptr<Player> &player, const ItemBlockList &itemList, RowList &rows, PropWriteStream &stream);
+
+	/**
+	 * Replaces the rows of the player in a table, unless they are the rows the last save wrote.
+	 */
+	static bool saveRows(const PlayerSaveSnapshot &snapshot, const PlayerSaveSnapshot::Rows &rows);
 };
@@ -0,0 +1,69 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "database/database.hpp"
+#include "io/fileloader.hpp"
+#include "io/functions/player_save_state.hpp"
+
+/**
+ * What a save writes for a player, captured on the dispatcher thread by IOLoginData::capturePlayer.
+ * It holds the rows and statements ready to run and nothing of the live player, so it is written
+ * from any thread while the game goes on. Not copyable, the statements point into 'blobs'.
+ */
+struct PlayerSaveSnapshot {
+	// The rows of the player in a table, replaced whole when they changed
+	struct Rows {
+		PlayerSaveSection_t section;
+		std::string_view table;
+		std::string_view insertQuery;
+		std::vector<std::string> rows;
+	};
+
+	// Upserts of a section, run when their hash changed
+	struct Statements {
+		PlayerSaveSection_t section;
+		std::vector<DBStatement> statements;
+		size_t hash = 0;
+		size_t bytes = 0;
+	};
+
+	PlayerSaveSnapshot() = default;
+
+	// Non copyable
+	PlayerSaveSnapshot(const PlayerSaveSnapshot &) = delete;
+	PlayerSaveSnapshot &operator=(const PlayerSaveSnapshot &) = delete;
+
+	/**
+	 * Keeps a copy of the stream for a statement to bind, the copy never moves.
+	 */
+	std::string_view keepBlob(PropWriteStream &stream) {
+		size_t size;
+		const char* data = stream.getStream(size);
+		return blobs.emplace_back(data, size);
+	}
+
+	uint32_t guid = 0;
+	std::string name;
+	uint64_t sequence = 0;
+	std::shared_ptr<PlayerSaveState> saveState;
+
+	// The `players` row, only the last login when the character is not saved
+	std::string playerQuery;
+	time_t lastLogin = 0;
+	uint32_t lastIP = 0;
+
+	std::vector<Rows> rows;
+	std::vector<Statements> statements;
+	std::string wheelRow;
+	PlayerSaveState::StorageMap storage;
+
+	std::deque<std::string> blobs;
+};
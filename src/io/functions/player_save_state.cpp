@@ -0,0 +1,89 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "io/functions/player_save_state.hpp"
+
+#include "lib/metrics/metrics.hpp"
+
+void PlayerSaveState::onLoad(StorageMap storage) {
+	sections = {};
+	savedStorage = std::move(storage);
+	storageLoaded = true;
+	stagedStorage.reset();
+}
+
+bool PlayerSaveState::stage(PlayerSaveSection_t section, size_t hash, size_t bytes) {
+	auto &state = getSection(section);
+	if (state.saved && state.hash == hash) {
+		state.result = SectionResult_t::Skipped;
+		state.bytes = 0;
+		return false;
+	}
+
+	state.stagedHash = hash;
+	state.result = SectionResult_t::Written;
+	state.bytes = bytes;
+	return true;
+}
+
+void PlayerSaveState::stageStorage(const StorageMap &storage, bool written, size_t bytes) {
+	auto &state = getSection(PlayerSaveSection_t::Storage);
+	if (!written) {
+		state.result = SectionResult_t::Skipped;
+		state.bytes = 0;
+		stagedStorage.reset();
+		return;
+	}
+
+	state.result = SectionResult_t::Written;
+	state.bytes = bytes;
+	stagedStorage = storage;
+}
+
+void PlayerSaveState::commit(uint64_t snapshot /*= 0*/) {
+	writtenSnapshot = std::max(writtenSnapshot, snapshot);
+	lastSave = {};
+	for (size_t i = 0; i < sections.size(); ++i) {
+		auto &state = sections[i];
+		if (state.result == SectionResult_t::None) {
+			continue;
+		}
+
+		const std::string sectionName(magic_enum::enum_name(static_cast<PlayerSaveSection_t>(i)));
+		if (state.result == SectionResult_t::Written) {
+			state.hash = state.stagedHash;
+			state.saved = true;
+			++lastSave.written;
+			lastSave.bytes += state.bytes;
+			g_metrics().addCounter("player_save_sections", 1, { { "section", sectionName }, { "result", "written" } });
+			g_metrics().addCounter("player_save_bytes", static_cast<double>(state.bytes), { { "section", sectionName } });
+		} else {
+			++lastSave.skipped;
+			g_metrics().addCounter("player_save_sections", 1, { { "section", sectionName }, { "result", "skipped" } });
+		}
+
+		state.result = SectionResult_t::None;
+		state.bytes = 0;
+	}
+
+	if (stagedStorage) {
+		savedStorage = std::move(*stagedStorage);
+		storageLoaded = true;
+		stagedStorage.reset();
+	}
+}
+
+void PlayerSaveState::discard() {
+	lastSave = {};
+	for (auto &state : sections) {
+		state.result = SectionResult_t::None;
+		state.bytes = 0;
+	}
+	stagedStorage.reset();
+}
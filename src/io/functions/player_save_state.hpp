@@ -0,0 +1,134 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+enum class PlayerSaveSection_t : uint8_t {
+	Stash,
+	Spells,
+	Kills,
+	Bestiary,
+	Items,
+	DepotItems,
+	RewardItems,
+	Inbox,
+	Prey,
+	TaskHunting,
+	ForgeHistory,
+	Bosstiary,
+	Storage,
+};
+
+/**
+ * What the database holds for a player since its last save, so the next save only writes what changed.
+ * A section is known by a hash of its rows and is rewritten when the hash differs, the storage is known
+ * row by row and only its changed keys are written. A save stages what it writes, which is kept once its
+ * transaction commits; a rolled back save leaves the state of the last committed one.
+ */
+class PlayerSaveState {
+public:
+	using StorageMap = std::map<uint32_t, int32_t>;
+
+	struct SaveStats {
+		uint8_t written = 0;
+		uint8_t skipped = 0;
+		size_t bytes = 0;
+	};
+
+	/**
+	 * The player was loaded with these storage rows, nothing is known about its other sections.
+	 */
+	void onLoad(StorageMap storage);
+
+	/**
+	 * Stages the rows of a section.
+	 * \returns false when they hash the same as the rows in the database, the section can be skipped
+	 */
+	bool stage(PlayerSaveSection_t section, size_t hash, size_t bytes);
+
+	bool hasSavedStorage() const {
+		return storageLoaded;
+	}
+	const StorageMap &getSavedStorage() const {
+		return savedStorage;
+	}
+
+	/**
+	 * Stages the storage as it is after the save when it wrote any of its rows, 'bytes' being their size.
+	 */
+	void stageStorage(const StorageMap &storage, bool written, size_t bytes);
+
+	/**
+	 * Numbers a snapshot of the player, a later snapshot gets a greater number.
+	 */
+	uint64_t nextSnapshot() {
+		return capturedSnapshots.fetch_add(1, std::memory_order_relaxed) + 1;
+	}
+
+	/**
+	 * \returns true when a snapshot taken after this one is already in the database
+	 */
+	bool isStale(uint64_t snapshot) const {
+		return snapshot != 0 && snapshot <= writtenSnapshot;
+	}
+
+	/**
+	 * Held while a snapshot of the player is written, saves of the same player run one at a time.
+	 */
+	std::mutex &getWriteMutex() {
+		return writeMutex;
+	}
+
+	/**
+	 * The transaction of the save committed: keeps what it staged and exports the section counters.
+	 * 'snapshot' is the number of the snapshot it wrote, if any.
+	 */
+	void commit(uint64_t snapshot = 0);
+
+	/**
+	 * The transaction of the save rolled back, what it staged is dropped.
+	 */
+	void discard();
+
+	const SaveStats &getLastSave() const {
+		return lastSave;
+	}
+
+private:
+	enum class SectionResult_t : uint8_t {
+		None,
+		Skipped,
+		Written,
+	};
+
+	struct Section {
+		size_t hash = 0;
+		bool saved = false;
+
+		size_t stagedHash = 0;
+		SectionResult_t result = SectionResult_t::None;
+		size_t bytes = 0;
+	};
+
+	Section &getSection(PlayerSaveSection_t section) {
+		return sections[static_cast<size_t>(section)];
+	}
+
+	std::array<Section, magic_enum::enum_count<PlayerSaveSection_t>()> sections {};
+
+	StorageMap savedStorage;
+	bool storageLoaded = false;
+	std::optional<StorageMap> stagedStorage;
+
+	SaveStats lastSave;
+
+	std::atomic_uint64_t capturedSnapshots = 0;
+	uint64_t writtenSnapshot = 0;
+	std::mutex writeMutex;
+};
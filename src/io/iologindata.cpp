@@ -14,6 +14,7 @@
 #include "database/database.hpp"
 #include "io/functions/iologindata_load_player.hpp"
 #include "io/functions/iologindata_save_player.hpp"
+#include "io/functions/player_save_state.hpp"
 #include "game/game.hpp"
 #include "creatures/monsters/monster.hpp"
 #include "creatures/players/wheel/player_wheel.hpp"
@@ -81,16 +82,12 @@ uint8_t IOLoginData::getAccountType(uint32_t accountId) {
 // The boolean "disableIrrelevantInfo" will deactivate the loading of information that is not relevant to the preload, for example, forge, bosstiary, etc. None of this we need to access if the player is offline
 bool IOLoginData::loadPlayerById(const std::shared_ptr<Player> &player, uint32_t id, bool disableIrrelevantInfo /* = true*/) {
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT * FROM `players` WHERE `id` = " << id;
-	return loadPlayer(player, db.storeQuery(query.str()), disableIrrelevantInfo);
+	return loadPlayer(player, db.storeQuery(DBStatement("SELECT * FROM `players` WHERE `id` = ?").bind(id)), disableIrrelevantInfo);
 }
 
 bool IOLoginData::loadPlayerByName(const std::shared_ptr<Player> &player, const std::string &name, bool disableIrrelevantInfo /* = true*/) {
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT * FROM `players` WHERE `name` = " << db.escapeString(name);
-	return loadPlayer(player, db.storeQuery(query.str()), disableIrrelevantInfo);
+	return loadPlayer(player, db.storeQuery(DBStatement("SELECT * FROM `players` WHERE `name` = ?").bind(name)), disableIrrelevantInfo);
 }
 
 bool IOLoginData::loadPlayer(const std::shared_ptr<Player> &player, const DBResult_ptr &result, bool disableIrrelevantInfo /* = false*/) {
@@ -188,126 +185,123 @@ bool IOLoginData::loadPlayer(const std::shared_ptr<Player> &player, const DBResu
 }
 
 bool IOLoginData::savePlayer(const std::shared_ptr<Player> &player) {
+	if (!player) {
+		g_logger().error("[{}] Player nullptr", __FUNCTION__);
+		return false;
+	}
+
+	return savePlayer(*capturePlayer(player));
+}
+
+std::shared_ptr<PlayerSaveSnapshot> IOLoginData::capturePlayer(const std::shared_ptr<Player> &player) {
+	auto snapshot = std::make_shared<PlayerSaveSnapshot>();
+	snapshot->guid = player->getGUID();
+	snapshot->name = player->getName();
+	snapshot->saveState = player->saveState();
+	snapshot->sequence = snapshot->saveState->nextSnapshot();
+
+	IOLoginDataSave::capturePlayerFirst(player, *snapshot);
+	IOLoginDataSave::capturePlayerStash(player, *snapshot);
+	IOLoginDataSave::capturePlayerSpells(player, *snapshot);
+	IOLoginDataSave::capturePlayerKills(player, *snapshot);
+	IOLoginDataSave::capturePlayerBestiarySystem(player, *snapshot);
+	IOLoginDataSave::capturePlayerItem(player, *snapshot);
+	IOLoginDataSave::capturePlayerDepotItems(player, *snapshot);
+	IOLoginDataSave::captureRewardItems(player, *snapshot);
+	IOLoginDataSave::capturePlayerInbox(player, *snapshot);
+	IOLoginDataSave::capturePlayerPreyClass(player, *snapshot);
+	IOLoginDataSave::capturePlayerTaskHuntingClass(player, *snapshot);
+	IOLoginDataSave::capturePlayerForgeHistory(player, *snapshot);
+	IOLoginDataSave::capturePlayerBosstiary(player, *snapshot);
+	snapshot->wheelRow = player->wheel()->serializeDBPlayerSlotPoints();
+	IOLoginDataSave::capturePlayerStorage(player, *snapshot);
+	return snapshot;
+}
+
+bool IOLoginData::savePlayer(const PlayerSaveSnapshot &snapshot) {
+	const auto &saveState = snapshot.saveState;
+	std::scoped_lock lock(saveState->getWriteMutex());
+	// A later snapshot was written first, this one would roll the player back
+	if (saveState->isStale(snapshot.sequence)) {
+		g_logger().debug("[{}] Skipping save of player {}, a later save was already written", __FUNCTION__, snapshot.name);
+		return true;
+	}
+
 	try {
-		bool success = DBTransaction::executeWithinTransaction([player]() {
-			return savePlayerGuard(player);
+		bool success = DBTransaction::executeWithinTransaction([&snapshot]() {
+			return savePlayerGuard(snapshot);
 		});
 
 		if (!success) {
 			g_logger().error("[{}] Error occurred saving player", __FUNCTION__);
+			saveState->discard();
+			return false;
 		}
 
-		return success;
+		// Only a committed save tells what the database holds
+		saveState->commit(snapshot.sequence);
+		return true;
 	} catch (const DatabaseException &e) {
 		g_logger().error("[{}] Exception occurred: {}", __FUNCTION__, e.what());
 	}
 
+	saveState->discard();
 	return false;
 }
 
-bool IOLoginData::savePlayerGuard(const std::shared_ptr<Player> &player) {
-	if (!player) {
-		throw DatabaseException("Player nullptr in function: " + std::string(__FUNCTION__));
-	}
-
-	if (!IOLoginDataSave::savePlayerFirst(player)) {
-		throw DatabaseException("[" + std::string(__FUNCTION__) + "] - Failed to save player first: " + player->getName());
-	}
-
-	if (!IOLoginDataSave::savePlayerStash(player)) {
-		throw DatabaseException("[IOLoginDataSave::savePlayerFirst] - Failed to save player stash: " + player->getName());
-	}
-
-	if (!IOLoginDataSave::savePlayerSpells(player)) {
-		throw DatabaseException("[IOLoginDataSave::savePlayerSpells] - Failed to save player spells: " + player->getName());
+bool IOLoginData::savePlayerGuard(const PlayerSaveSnapshot &snapshot) {
+	if (!IOLoginDataSave::savePlayerFirst(snapshot)) {
+		throw DatabaseException("[" + std::string(__FUNCTION__) + "] - Failed to save player first: " + snapshot.name);
 	}
 
-	if (!IOLoginDataSave::savePlayerKills(player)) {
-		throw DatabaseException("IOLoginDataSave::savePlayerKills] - Failed to save player kills: " + player->getName());
+	if (!IOLoginDataSave::savePlayerRows(snapshot)) {
+		throw DatabaseException("[IOLoginDataSave::savePlayerRows] - Failed to save player rows: " + snapshot.name);
 	}
 
-	if (!IOLoginDataSave::savePlayerBestiarySystem(player)) {
-		throw DatabaseException("[IOLoginDataSave::savePlayerBestiarySystem] - Failed to save player bestiary system: " + player->getName());
+	if (!IOLoginDataSave::savePlayerStatements(snapshot)) {
+		throw DatabaseException("[IOLoginDataSave::savePlayerStatements] - Failed to save player prey, task hunting or bestiary: " + snapshot.name);
 	}
 
-	if (!IOLoginDataSave::savePlayerItem(player)) {
-		throw DatabaseException("[IOLoginDataSave::savePlayerItem] - Failed to save player item: " + player->getName());
+	if (!IOLoginDataSave::savePlayerWheel(snapshot)) {
+		throw DatabaseException("[IOLoginDataSave::savePlayerWheel] - Failed to save player wheel info: " + snapshot.name);
 	}
 
-	if (!IOLoginDataSave::savePlayerDepotItems(player)) {
-		throw DatabaseException("[IOLoginDataSave::savePlayerDepotItems] - Failed to save player depot items: " + player->getName());
-	}
-
-	if (!IOLoginDataSave::saveRewardItems(player)) {
-		throw DatabaseException("[IOLoginDataSave::saveRewardItems] - Failed to save player reward items: " + player->getName());
-	}
-
-	if (!IOLoginDataSave::savePlayerInbox(player)) {
-		throw DatabaseException("[IOLoginDataSave::savePlayerInbox] - Failed to save player inbox: " + player->getName());
-	}
-
-	if (!IOLoginDataSave::savePlayerPreyClass(player)) {
-		throw DatabaseException("[IOLoginDataSave::savePlayerPreyClass] - Failed to save player prey class: " + player->getName());
-	}
-
-	if (!IOLoginDataSave::savePlayerTaskHuntingClass(player)) {
-		throw DatabaseException("[IOLoginDataSave::savePlayerTaskHuntingClass] - Failed to save player task hunting class: " + player->getName());
-	}
-
-	if (!IOLoginDataSave::savePlayerForgeHistory(player)) {
-		throw DatabaseException("[IOLoginDataSave::savePlayerForgeHistory] - Failed to save player forge history: " + player->getName());
-	}
-
-	if (!IOLoginDataSave::savePlayerBosstiary(player)) {
-		throw DatabaseException("[IOLoginDataSave::savePlayerBosstiary] - Failed to save player bosstiary: " + player->getName());
-	}
-
-	if (!player->wheel()->saveDBPlayerSlotPointsOnLogout()) {
-		throw DatabaseException("[PlayerWheel::saveDBPlayerSlotPointsOnLogout] - Failed to save player wheel info: " + player->getName());
-	}
-
-	if (!IOLoginDataSave::savePlayerStorage(player)) {
-		throw DatabaseException("[IOLoginDataSave::savePlayerStorage] - Failed to save player storage: " + player->getName());
+	if (!IOLoginDataSave::savePlayerStorage(snapshot)) {
+		throw DatabaseException("[IOLoginDataSave::savePlayerStorage] - Failed to save player storage: " + snapshot.name);
 	}
 
 	return true;
 }
 
 std::string IOLoginData::getNameByGuid(uint32_t guid) {
-	std::ostringstream query;
-	query << "SELECT `name` FROM `players` WHERE `id` = " << guid;
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
+	DBResult_ptr result = Database::getInstance().storeQuery(DBStatement("SELECT `name` FROM `players` WHERE `id` = ?").bind(guid));
 	if (!result) {
 		return {};
 	}
-	return result->getString("name");
+	return result->getString(0);
 }
 
 uint32_t IOLoginData::getGuidByName(const std::string &name) {
 	Database &db = Database::getInstance();
 
-	std::ostringstream query;
-	query << "SELECT `id` FROM `players` WHERE `name` = " << db.escapeString(name);
-	DBResult_ptr result = db.storeQuery(query.str());
+	DBResult_ptr result = db.storeQuery(DBStatement("SELECT `id` FROM `players` WHERE `name` = ?").bind(name));
 	if (!result) {
 		return 0;
 	}
-	return result->getNumber<uint32_t>("id");
+	return result->getNumber<uint32_t>(0);
 }
 
 bool IOLoginData::getGuidByNameEx(uint32_t &guid, bool &specialVip, std::string &name) {
 	Database &db = Database::getInstance();
 
-	std::ostringstream query;
-	query << "SELECT `name`, `id`, `group_id`, `account_id` FROM `players` WHERE `name` = " << db.escapeString(name);
-	DBResult_ptr result = db.storeQuery(query.str());
+	DBResult_ptr result = db.storeQuery(DBStatement("SELECT `name`, `id`, `group_id` FROM `players` WHERE `name` = ?").bind(name));
 	if (!result) {
 		return false;
 	}
 
-	name = result->getString("name");
-	guid = result->getNumber<uint32_t>("id");
-	if (auto group = g_game().groups.getGroup(result->getNumber<uint16_t>("group_id"))) {
+	name = result->getString(0);
+	guid = result->getNumber<uint32_t>(1);
+	if (auto group = g_game().groups.getGroup(result->getNumber<uint16_t>(2))) {
 		specialVip = group->flags[Groups::getFlagNumber(PlayerFlags_t::SpecialVIP)];
 	} else {
 		specialVip = false;
@@ -318,15 +312,12 @@ bool IOLoginData::getGuidByNameEx(uint32_t &guid, bool &specialVip, std::string
 bool IOLoginData::formatPlayerName(std::string &name) {
 	Database &db = Database::getInstance();
 
-	std::ostringstream query;
-	query << "SELECT `name` FROM `players` WHERE `name` = " << db.escapeString(name);
-
-	DBResult_ptr result = db.storeQuery(query.str());
+	DBResult_ptr result = db.storeQuery(DBStatement("SELECT `name` FROM `players` WHERE `name` = ?").bind(name));
 	if (!result) {
 		return false;
 	}
 
-	name = result->getString("name");
+	name = result->getString(0);
 	return true;
 }
 
@@ -13,6 +13,7 @@ class Player;
 class Item;
 class DBResult;
 
+struct PlayerSaveSnapshot;
 struct VIPEntry;
 struct VIPGroupEntry;
 
@@ -26,6 +27,15 @@ public:
 	static bool loadPlayerByName(const std::shared_ptr<Player> &player, const std::string &name, bool disableIrrelevantInfo = true);
 	static bool loadPlayer(const std::shared_ptr<Player> &player, const std::shared_ptr<DBResult> &result, bool disableIrrelevantInfo = false);
 	static bool savePlayer(const std::shared_ptr<Player> &player);
+	/**
+	 * Reads what a save writes for the player, must be called from the dispatcher thread.
+	 */
+	static std::shared_ptr<PlayerSaveSnapshot> capturePlayer(const std::shared_ptr<Player> &player);
+	/**
+	 * Writes a snapshot of a player from any thread, nothing of the player itself is read.
+	 * A snapshot older than the last one written for the player is skipped.
+	 */
+	static bool savePlayer(const PlayerSaveSnapshot &snapshot);
 	static uint32_t getGuidByName(const std::string &name);
 	static bool getGuidByNameEx(uint32_t &guid, bool &specialVip, std::string &name);
 	static std::string getNameByGuid(uint32_t guid);
@@ -46,5 +56,5 @@ public:
 	static void removeGuidVIPGroupEntry(uint32_t accountId, uint32_t guid);
 
 private:
-	static bool savePlayerGuard(const std::shared_ptr<Player> &player);
+	static bool savePlayerGuard(const PlayerSaveSnapshot &snapshot);
 };
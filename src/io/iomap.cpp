@@ -78,6 +78,9 @@ void IOMap::loadMap(Map* map, const Position &pos) {
 	map->flush();
 
 	g_logger().debug("Map Loaded {} ({}x{}) in {} milliseconds", map->path.filename().string(), map->width, map->height, bm_mapLoad.duration());
+
+	const auto &sectors = map->getMapSectors();
+	g_logger().debug("Map sectors: {} in {} blocks, table uses {} KB, sectors use {} KB", sectors.size(), sectors.blocks(), sectors.memoryUsage() / 1024, sectors.size() * sizeof(MapSector) / 1024);
 }
 
 void IOMap::parseMapDataAttributes(FileStream &stream, Map* map) {
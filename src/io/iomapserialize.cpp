@@ -12,8 +12,14 @@
 #include "config/configmanager.hpp"
 #include "io/iologindata.hpp"
 #include "game/game.hpp"
+#include "game/scheduling/dispatcher.hpp"
 #include "items/bed.hpp"
 
+std::atomic_bool IOMapSerialize::houseItemsSaved = false;
+std::mutex IOMapSerialize::houseItemsWriteMutex;
+std::atomic_uint64_t IOMapSerialize::houseItemsSnapshots = 0;
+uint64_t IOMapSerialize::houseItemsWritten = 0;
+
 void IOMapSerialize::loadHouseItems(Map* map) {
 	Benchmark bm_context;
 
@@ -52,6 +58,8 @@ void IOMapSerialize::loadHouseItems(Map* map) {
 				if (!isTransferOnRestart && house->getOwner() == 0) {
 					g_logger().trace("Skipping load item from house id: {}, position: {}, house does not have owner", house->getId(), house->getEntryPosition().toString());
 					house->clearHouseInfo(false);
+					// The rows of the skipped items are dropped by the next save
+					house->markItemsDirty();
 					continue;
 				}
 			}
@@ -63,48 +71,113 @@ void IOMapSerialize::loadHouseItems(Map* map) {
 }
 
 bool IOMapSerialize::saveHouseItems() {
-	bool success = DBTransaction::executeWithinTransaction([]() {
-		return SaveHouseItemsGuard();
+	return saveHouseItems(snapshotHouseItems());
+}
+
+HouseItemsSnapshot IOMapSerialize::snapshotHouseItems() {
+	HouseItemsSnapshot snapshot;
+	snapshot.sequence = houseItemsSnapshots.fetch_add(1, std::memory_order_relaxed) + 1;
+	snapshot.full = !houseItemsSaved.load(std::memory_order_relaxed);
+	for (const auto &[key, house] : g_game().map.houses.getHouses()) {
+		if (snapshot.full || house->hasUnsavedItems()) {
+			snapshot.houses.push_back({ house, house->getItemsVersion(), {} });
+		}
+	}
+
+	// Each house is serialised by a single thread into its own stream
+	g_dispatcher().asyncWait(snapshot.houses.size(), [&snapshot](size_t i) {
+		auto &houseTiles = snapshot.houses[i];
+		PropWriteStream stream;
+		for (const auto &tile : houseTiles.house->getTiles()) {
+			saveTile(stream, tile);
+
+			size_t attributesSize;
+			const char* attributes = stream.getStream(attributesSize);
+			if (attributesSize > 0) {
+				houseTiles.tiles.emplace_back(attributes, attributesSize);
+				stream.clear();
+			}
+		}
+	});
+
+	return snapshot;
+}
+
+bool IOMapSerialize::saveHouseItems(const HouseItemsSnapshot &snapshot) {
+	if (snapshot.houses.empty() && !snapshot.full) {
+		return true;
+	}
+
+	// A later snapshot holds every house this one does, they are still unsaved when it is captured.
+	// Writing this one after it would put older rows back while the houses are marked saved.
+	std::scoped_lock lock(houseItemsWriteMutex);
+	if (snapshot.sequence != 0 && snapshot.sequence <= houseItemsWritten) {
+		g_logger().debug("[{}] Skipping house items snapshot {}, a later one was already written", __FUNCTION__, snapshot.sequence);
+		return true;
+	}
+
+	Benchmark bm_saveHouseItems;
+	bool success = DBTransaction::executeWithinTransaction([&snapshot]() {
+		return SaveHouseItemsGuard(snapshot);
 	});
 
 	if (!success) {
 		g_logger().error("[{}] Error occurred saving houses", __FUNCTION__);
+		return false;
 	}
 
-	return success;
+	size_t tiles = 0;
+	for (const auto &houseTiles : snapshot.houses) {
+		houseTiles.house->setItemsSaved(houseTiles.itemsVersion);
+		tiles += houseTiles.tiles.size();
+	}
+	if (snapshot.full) {
+		houseItemsSaved.store(true, std::memory_order_relaxed);
+	}
+	houseItemsWritten = std::max(houseItemsWritten, snapshot.sequence);
+
+	g_logger().debug("Saved {} tiles of {} houses in {} milliseconds", tiles, snapshot.houses.size(), bm_saveHouseItems.duration());
+	return true;
 }
 
-bool IOMapSerialize::SaveHouseItemsGuard() {
+bool IOMapSerialize::SaveHouseItemsGuard(const HouseItemsSnapshot &snapshot) {
 	Database &db = Database::getInstance();
 	std::ostringstream query;
 
-	// clear old tile data
-	if (!db.executeQuery("DELETE FROM `tile_store`")) {
-		return false;
+	// clear old tile data of the houses being written
+	if (snapshot.full) {
+		if (!db.executeQuery("DELETE FROM `tile_store`")) {
+			throw DatabaseException("[IOMapSerialize::SaveHouseItemsGuard] - Failed to clear the house tiles");
+		}
+	} else {
+		query << "DELETE FROM `tile_store` WHERE `house_id` IN (";
+		for (size_t i = 0; i < snapshot.houses.size(); ++i) {
+			if (i != 0) {
+				query << ',';
+			}
+			query << snapshot.houses[i].house->getId();
+		}
+		query << ')';
+
+		if (!db.executeQuery(query.str())) {
+			throw DatabaseException("[IOMapSerialize::SaveHouseItemsGuard] - Failed to clear the tiles of the changed houses");
+		}
+		query.str(std::string());
 	}
 
 	DBInsert stmt("INSERT INTO `tile_store` (`house_id`, `data`) VALUES ");
 
-	PropWriteStream stream;
-	for (const auto &[key, house] : g_game().map.houses.getHouses()) {
-		// save house items
-		for (const auto &tile : house->getTiles()) {
-			saveTile(stream, tile);
-
-			size_t attributesSize;
-			const char* attributes = stream.getStream(attributesSize);
-			if (attributesSize > 0) {
-				query << house->getId() << ',' << db.escapeBlob(attributes, attributesSize);
-				if (!stmt.addRow(query)) {
-					return false;
-				}
-				stream.clear();
+	for (const auto &houseTiles : snapshot.houses) {
+		for (const auto &tile : houseTiles.tiles) {
+			query << houseTiles.house->getId() << ',' << db.escapeBlob(tile.data(), tile.size());
+			if (!stmt.addRow(query)) {
+				throw DatabaseException("[IOMapSerialize::SaveHouseItemsGuard] - Failed to insert the tiles of house " + std::to_string(houseTiles.house->getId()));
 			}
 		}
 	}
 
 	if (!stmt.execute()) {
-		return false;
+		throw DatabaseException("[IOMapSerialize::SaveHouseItemsGuard] - Failed to insert the house tiles");
 	}
 
 	return true;
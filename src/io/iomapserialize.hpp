@@ -11,19 +11,51 @@
 
 #include "map/map.hpp"
 
+/**
+ * Serialised tiles of the houses whose items changed since their last save, taken on the dispatcher
+ * thread so it can be written from any thread while the game goes on.
+ */
+struct HouseItemsSnapshot {
+	struct HouseTiles {
+		std::shared_ptr<House> house;
+		uint64_t itemsVersion = 0;
+		std::vector<std::string> tiles;
+	};
+
+	std::vector<HouseTiles> houses;
+	// Every house is in the snapshot and the rows of houses no longer in the map are dropped as well
+	bool full = false;
+	// Order of the capture, a snapshot older than the last one written is skipped
+	uint64_t sequence = 0;
+};
+
 class IOMapSerialize {
 public:
 	static void loadHouseItems(Map* map);
 	static bool saveHouseItems();
+	/**
+	 * Serialises the houses with unsaved items, in parallel on the thread pool.
+	 * Must be called from the dispatcher thread, the map does not change while it runs.
+	 */
+	static HouseItemsSnapshot snapshotHouseItems();
+	static bool saveHouseItems(const HouseItemsSnapshot &snapshot);
 	static bool loadHouseInfo();
 	static bool saveHouseInfo();
 
 private:
 	static bool SaveHouseInfoGuard();
-	static bool SaveHouseItemsGuard();
+	static bool SaveHouseItemsGuard(const HouseItemsSnapshot &snapshot);
 	static void saveItem(PropWriteStream &stream, const std::shared_ptr<Item> &item);
 	static void saveTile(PropWriteStream &stream, const std::shared_ptr<Tile> &tile);
 
 	static bool loadContainer(PropStream &propStream, const std::shared_ptr<Container> &container);
 	static bool loadItem(PropStream &propStream, const std::shared_ptr<Cylinder> &parent, bool isHouseItem = false);
+
+	// Set once every house was written, until then a save rewrites the whole table
+	static std::atomic_bool houseItemsSaved;
+
+	// Snapshots are written one at a time, in the order they were captured
+	static std::mutex houseItemsWriteMutex;
+	static std::atomic_uint64_t houseItemsSnapshots;
+	static uint64_t houseItemsWritten;
 };
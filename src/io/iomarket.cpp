@@ -19,7 +19,10 @@
 #include "creatures/players/player.hpp"
 
 uint8_t IOMarket::getTierFromDatabaseTable(const std::string &string) {
-	auto tier = static_cast<uint8_t>(std::atoi(string.c_str()));
+	return getTierFromDatabaseTable(static_cast<uint8_t>(std::atoi(string.c_str())));
+}
+
+uint8_t IOMarket::getTierFromDatabaseTable(uint8_t tier) {
 	if (tier > g_configManager().getNumber(FORGE_MAX_ITEM_TIER)) {
 		g_logger().error("{} - Failed to get number value {} for tier table result", __FUNCTION__, tier);
 		return 0;
@@ -31,14 +34,13 @@ uint8_t IOMarket::getTierFromDatabaseTable(const std::string &string) {
 MarketOfferList IOMarket::getActiveOffers(MarketAction_t action) {
 	MarketOfferList offerList;
 
-	std::string query = fmt::format(
+	DBStatement statement(
 		"SELECT `id`, `itemtype`, `amount`, `price`, `tier`, `created`, `anonymous`, "
 		"(SELECT `name` FROM `players` WHERE `id` = `player_id`) AS `player_name` "
-		"FROM `market_offers` WHERE `sale` = {}",
-		action
+		"FROM `market_offers` WHERE `sale` = ?"
 	);
 
-	DBResult_ptr result = g_database().storeQuery(query);
+	DBResult_ptr result = g_database().storeQuery(statement.bind(action));
 	if (!result) {
 		return offerList;
 	}
@@ -47,17 +49,17 @@ MarketOfferList IOMarket::getActiveOffers(MarketAction_t action) {
 
 	do {
 		MarketOffer offer;
-		offer.itemId = result->getNumber<uint16_t>("itemtype");
-		offer.amount = result->getNumber<uint16_t>("amount");
-		offer.price = result->getNumber<uint64_t>("price");
-		offer.timestamp = result->getNumber<uint32_t>("created") + marketOfferDuration;
-		offer.counter = result->getNumber<uint32_t>("id") & 0xFFFF;
-		if (result->getNumber<uint16_t>("anonymous") == 0) {
-			offer.playerName = result->getString("player_name");
+		offer.itemId = result->getNumber<uint16_t>(1);
+		offer.amount = result->getNumber<uint16_t>(2);
+		offer.price = result->getNumber<uint64_t>(3);
+		offer.timestamp = result->getNumber<uint32_t>(5) + marketOfferDuration;
+		offer.counter = result->getNumber<uint32_t>(0) & 0xFFFF;
+		if (result->getNumber<uint16_t>(6) == 0) {
+			offer.playerName = result->getString(7);
 		} else {
 			offer.playerName = "Anonymous";
 		}
-		offer.tier = getTierFromDatabaseTable(result->getString("tier"));
+		offer.tier = getTierFromDatabaseTable(result->getNumber<uint8_t>(4));
 		offerList.push_back(offer);
 	} while (result->next());
 	return offerList;
@@ -66,10 +68,10 @@ MarketOfferList IOMarket::getActiveOffers(MarketAction_t action) {
 MarketOfferList IOMarket::getActiveOffers(MarketAction_t action, uint16_t itemId, uint8_t tier) {
 	MarketOfferList offerList;
 
-	std::ostringstream query;
-	query << "SELECT `id`, `amount`, `price`, `tier`, `created`, `anonymous`, (SELECT `name` FROM `players` WHERE `id` = `player_id`) AS `player_name` FROM `market_offers` WHERE `sale` = " << action << " AND `itemtype` = " << itemId << " AND `tier` = " << std::to_string(tier);
+	DBStatement statement("SELECT `id`, `amount`, `price`, `tier`, `created`, `anonymous`, (SELECT `name` FROM `players` WHERE `id` = `player_id`) AS `player_name` FROM `market_offers` WHERE `sale` = ? AND `itemtype` = ? AND `tier` = ?");
+	statement.bind(action).bind(itemId).bind(tier);
 
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
+	DBResult_ptr result = Database::getInstance().storeQuery(statement);
 	if (!result) {
 		return offerList;
 	}
@@ -79,16 +81,16 @@ MarketOfferList IOMarket::getActiveOffers(MarketAction_t action, uint16_t itemId
 	do {
 		MarketOffer offer;
 		offer.itemId = itemId;
-		offer.amount = result->getNumber<uint16_t>("amount");
-		offer.price = result->getNumber<uint64_t>("price");
-		offer.timestamp = result->getNumber<uint32_t>("created") + marketOfferDuration;
-		offer.counter = result->getNumber<uint32_t>("id") & 0xFFFF;
-		if (result->getNumber<uint16_t>("anonymous") == 0) {
-			offer.playerName = result->getString("player_name");
+		offer.amount = result->getNumber<uint16_t>(1);
+		offer.price = result->getNumber<uint64_t>(2);
+		offer.timestamp = result->getNumber<uint32_t>(4) + marketOfferDuration;
+		offer.counter = result->getNumber<uint32_t>(0) & 0xFFFF;
+		if (result->getNumber<uint16_t>(5) == 0) {
+			offer.playerName = result->getString(6);
 		} else {
 			offer.playerName = "Anonymous";
 		}
-		offer.tier = getTierFromDatabaseTable(result->getString("tier"));
+		offer.tier = getTierFromDatabaseTable(result->getNumber<uint8_t>(3));
 		offerList.push_back(offer);
 	} while (result->next());
 	return offerList;
@@ -99,22 +101,22 @@ MarketOfferList IOMarket::getOwnOffers(MarketAction_t action, uint32_t playerId)
 
 	const int32_t marketOfferDuration = g_configManager().getNumber(MARKET_OFFER_DURATION);
 
-	std::ostringstream query;
-	query << "SELECT `id`, `amount`, `price`, `created`, `itemtype`, `tier` FROM `market_offers` WHERE `player_id` = " << playerId << " AND `sale` = " << action;
+	DBStatement statement("SELECT `id`, `amount`, `price`, `created`, `itemtype`, `tier` FROM `market_offers` WHERE `player_id` = ? AND `sale` = ?");
+	statement.bind(playerId).bind(action);
 
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
+	DBResult_ptr result = Database::getInstance().storeQuery(statement);
 	if (!result) {
 		return offerList;
 	}
 
 	do {
 		MarketOffer offer;
-		offer.amount = result->getNumber<uint16_t>("amount");
-		offer.price = result->getNumber<uint64_t>("price");
-		offer.timestamp = result->getNumber<uint32_t>("created") + marketOfferDuration;
-		offer.counter = result->getNumber<uint32_t>("id") & 0xFFFF;
-		offer.itemId = result->getNumber<uint16_t>("itemtype");
-		offer.tier = getTierFromDatabaseTable(result->getString("tier"));
+		offer.amount = result->getNumber<uint16_t>(1);
+		offer.price = result->getNumber<uint64_t>(2);
+		offer.timestamp = result->getNumber<uint32_t>(3) + marketOfferDuration;
+		offer.counter = result->getNumber<uint32_t>(0) & 0xFFFF;
+		offer.itemId = result->getNumber<uint16_t>(4);
+		offer.tier = getTierFromDatabaseTable(result->getNumber<uint8_t>(5));
 		offerList.push_back(offer);
 	} while (result->next());
 	return offerList;
@@ -123,23 +125,23 @@ MarketOfferList IOMarket::getOwnOffers(MarketAction_t action, uint32_t playerId)
 HistoryMarketOfferList IOMarket::getOwnHistory(MarketAction_t action, uint32_t playerId) {
 	HistoryMarketOfferList offerList;
 
-	std::ostringstream query;
-	query << "SELECT `itemtype`, `amount`, `price`, `expires_at`, `state`, `tier` FROM `market_history` WHERE `player_id` = " << playerId << " AND `sale` = " << action;
+	DBStatement statement("SELECT `itemtype`, `amount`, `price`, `expires_at`, `state`, `tier` FROM `market_history` WHERE `player_id` = ? AND `sale` = ?");
+	statement.bind(playerId).bind(action);
 
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
+	DBResult_ptr result = Database::getInstance().storeQuery(statement);
 	if (!result) {
 		return offerList;
 	}
 
 	do {
 		HistoryMarketOffer offer {};
-		offer.itemId = result->getNumber<uint16_t>("itemtype");
-		offer.amount = result->getNumber<uint16_t>("amount");
-		offer.price = result->getNumber<uint64_t>("price");
-		offer.timestamp = result->getNumber<uint32_t>("expires_at");
-		offer.tier = getTierFromDatabaseTable(result->getString("tier"));
+		offer.itemId = result->getNumber<uint16_t>(0);
+		offer.amount = result->getNumber<uint16_t>(1);
+		offer.price = result->getNumber<uint64_t>(2);
+		offer.timestamp = result->getNumber<uint32_t>(3);
+		offer.tier = getTierFromDatabaseTable(result->getNumber<uint8_t>(5));
 
-		MarketOfferState_t offerState = static_cast<MarketOfferState_t>(result->getNumber<uint16_t>("state"));
+		MarketOfferState_t offerState = static_cast<MarketOfferState_t>(result->getNumber<uint16_t>(4));
 		if (offerState == OFFERSTATE_ACCEPTEDEX) {
 			offerState = OFFERSTATE_ACCEPTED;
 		}
@@ -244,14 +246,11 @@ void IOMarket::checkExpiredOffers() {
 }
 
 uint32_t IOMarket::getPlayerOfferCount(uint32_t playerId) {
-	std::ostringstream query;
-	query << "SELECT COUNT(*) AS `count` FROM `market_offers` WHERE `player_id` = " << playerId;
-
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
+	DBResult_ptr result = Database::getInstance().storeQuery(DBStatement("SELECT COUNT(*) AS `count` FROM `market_offers` WHERE `player_id` = ?").bind(playerId));
 	if (!result) {
 		return 0;
 	}
-	return result->getNumber<int32_t>("count");
+	return result->getNumber<int32_t>(0);
 }
 
 MarketOfferEx IOMarket::getOfferByCounter(uint32_t timestamp, uint16_t counter) {
@@ -259,26 +258,26 @@ MarketOfferEx IOMarket::getOfferByCounter(uint32_t timestamp, uint16_t counter)
 
 	const int32_t created = timestamp - g_configManager().getNumber(MARKET_OFFER_DURATION);
 
-	std::ostringstream query;
-	query << "SELECT `id`, `sale`, `itemtype`, `amount`, `created`, `price`, `player_id`, `anonymous`, `tier`, (SELECT `name` FROM `players` WHERE `id` = `player_id`) AS `player_name` FROM `market_offers` WHERE `created` = " << created << " AND (`id` & 65535) = " << counter << " LIMIT 1";
+	DBStatement statement("SELECT `id`, `sale`, `itemtype`, `amount`, `created`, `price`, `player_id`, `anonymous`, `tier`, (SELECT `name` FROM `players` WHERE `id` = `player_id`) AS `player_name` FROM `market_offers` WHERE `created` = ? AND (`id` & 65535) = ? LIMIT 1");
+	statement.bind(created).bind(counter);
 
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
+	DBResult_ptr result = Database::getInstance().storeQuery(statement);
 	if (!result) {
 		offer.id = 0;
 		return offer;
 	}
 
-	offer.id = result->getNumber<uint32_t>("id");
-	offer.type = static_cast<MarketAction_t>(result->getNumber<uint16_t>("sale"));
-	offer.amount = result->getNumber<uint16_t>("amount");
-	offer.counter = result->getNumber<uint32_t>("id") & 0xFFFF;
-	offer.timestamp = result->getNumber<uint32_t>("created");
-	offer.price = result->getNumber<uint64_t>("price");
-	offer.itemId = result->getNumber<uint16_t>("itemtype");
-	offer.playerId = result->getNumber<uint32_t>("player_id");
-	offer.tier = getTierFromDatabaseTable(result->getString("tier"));
-	if (result->getNumber<uint16_t>("anonymous") == 0) {
-		offer.playerName = result->getString("player_name");
+	offer.id = result->getNumber<uint32_t>(0);
+	offer.type = static_cast<MarketAction_t>(result->getNumber<uint16_t>(1));
+	offer.amount = result->getNumber<uint16_t>(3);
+	offer.counter = result->getNumber<uint32_t>(0) & 0xFFFF;
+	offer.timestamp = result->getNumber<uint32_t>(4);
+	offer.price = result->getNumber<uint64_t>(5);
+	offer.itemId = result->getNumber<uint16_t>(2);
+	offer.playerId = result->getNumber<uint32_t>(6);
+	offer.tier = getTierFromDatabaseTable(result->getNumber<uint8_t>(8));
+	if (result->getNumber<uint16_t>(7) == 0) {
+		offer.playerName = result->getString(9);
 	} else {
 		offer.playerName = "Anonymous";
 	}
@@ -286,21 +285,17 @@ MarketOfferEx IOMarket::getOfferByCounter(uint32_t timestamp, uint16_t counter)
 }
 
 void IOMarket::createOffer(uint32_t playerId, MarketAction_t action, uint32_t itemId, uint16_t amount, uint64_t price, uint8_t tier, bool anonymous) {
-	std::ostringstream query;
-	query << "INSERT INTO `market_offers` (`player_id`, `sale`, `itemtype`, `amount`, `created`, `anonymous`, `price`, `tier`) VALUES (" << playerId << ',' << action << ',' << itemId << ',' << amount << ',' << getTimeNow() << ',' << anonymous << ',' << price << ',' << std::to_string(tier) << ')';
-	Database::getInstance().executeQuery(query.str());
+	DBStatement statement("INSERT INTO `market_offers` (`player_id`, `sale`, `itemtype`, `amount`, `created`, `anonymous`, `price`, `tier`) VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
+	statement.bind(playerId).bind(action).bind(itemId).bind(amount).bind(getTimeNow()).bind(anonymous).bind(price).bind(tier);
+	Database::getInstance().executeQuery(statement);
 }
 
 void IOMarket::acceptOffer(uint32_t offerId, uint16_t amount) {
-	std::ostringstream query;
-	query << "UPDATE `market_offers` SET `amount` = `amount` - " << amount << " WHERE `id` = " << offerId;
-	Database::getInstance().executeQuery(query.str());
+	Database::getInstance().executeQuery(DBStatement("UPDATE `market_offers` SET `amount` = `amount` - ? WHERE `id` = ?").bind(amount).bind(offerId));
 }
 
 void IOMarket::deleteOffer(uint32_t offerId) {
-	std::ostringstream query;
-	query << "DELETE FROM `market_offers` WHERE `id` = " << offerId;
-	Database::getInstance().executeQuery(query.str());
+	Database::getInstance().executeQuery(DBStatement("DELETE FROM `market_offers` WHERE `id` = ?").bind(offerId));
 }
 
 void IOMarket::appendHistory(uint32_t playerId, MarketAction_t type, uint16_t itemId, uint16_t amount, uint64_t price, time_t timestamp, uint8_t tier, MarketOfferState_t state) {
@@ -314,28 +309,23 @@ void IOMarket::appendHistory(uint32_t playerId, MarketAction_t type, uint16_t it
 bool IOMarket::moveOfferToHistory(uint32_t offerId, MarketOfferState_t state) {
 	Database &db = Database::getInstance();
 
-	std::ostringstream query;
-	query << "SELECT `player_id`, `sale`, `itemtype`, `amount`, `price`, `created`, `tier` FROM `market_offers` WHERE `id` = " << offerId;
-
-	DBResult_ptr result = db.storeQuery(query.str());
+	DBResult_ptr result = db.storeQuery(DBStatement("SELECT `player_id`, `sale`, `itemtype`, `amount`, `price`, `tier` FROM `market_offers` WHERE `id` = ?").bind(offerId));
 	if (!result) {
 		return false;
 	}
 
-	query.str(std::string());
-	query << "DELETE FROM `market_offers` WHERE `id` = " << offerId;
-	if (!db.executeQuery(query.str())) {
+	if (!db.executeQuery(DBStatement("DELETE FROM `market_offers` WHERE `id` = ?").bind(offerId))) {
 		return false;
 	}
 
 	appendHistory(
-		result->getNumber<uint32_t>("player_id"),
-		static_cast<MarketAction_t>(result->getNumber<uint16_t>("sale")),
-		result->getNumber<uint16_t>("itemtype"),
-		result->getNumber<uint16_t>("amount"),
-		result->getNumber<uint64_t>("price"),
+		result->getNumber<uint32_t>(0),
+		static_cast<MarketAction_t>(result->getNumber<uint16_t>(1)),
+		result->getNumber<uint16_t>(2),
+		result->getNumber<uint16_t>(3),
+		result->getNumber<uint64_t>(4),
 		getTimeNow(),
-		getTierFromDatabaseTable(result->getString("tier")), state
+		getTierFromDatabaseTable(result->getNumber<uint8_t>(5)), state
 	);
 	return true;
 }
@@ -50,6 +50,7 @@ public:
 	}
 
 	static uint8_t getTierFromDatabaseTable(const std::string &string);
+	static uint8_t getTierFromDatabaseTable(uint8_t tier);
 
 private:
 	// [uint16_t = item id, [uint8_t = item tier, MarketStatistics = structure of the statistics]]
@@ -46,98 +46,44 @@ void Decay::startDecay(const std::shared_ptr<Item> &item) {
 			stopDecay(item);
 		}
 
-		const int64_t timestamp = OTSYS_TIME() + duration;
-		if (decayMap.empty()) {
-			eventId = g_dispatcher().scheduleEvent(
-				std::max<int32_t>(SCHEDULER_MINTICKS, duration), [this] { checkDecay(); }, "Decay::checkDecay"
-			);
-		} else {
-			if (timestamp < decayMap.begin()->first) {
-				g_dispatcher().stopEvent(eventId);
-				eventId = g_dispatcher().scheduleEvent(
-					std::max<int32_t>(SCHEDULER_MINTICKS, duration), [this] { checkDecay(); }, "Decay::checkDecay"
-				);
-			}
-		}
-
+		const int64_t now = OTSYS_TIME();
+		const int64_t timestamp = now + duration;
 		item->setDecaying(DECAYING_TRUE);
 		item->setAttribute(ItemAttribute_t::DURATION_TIMESTAMP, timestamp);
-		decayMap[timestamp].push_back(item);
+		scheduleCheck(decayWheel.add(item, timestamp, now), now);
 	}
 }
 
 void Decay::stopDecay(const std::shared_ptr<Item> &item) {
-	if (!item) {
+	if (!item || !item->hasAttribute(ItemAttribute_t::DECAYSTATE)) {
 		return;
 	}
-	if (item->hasAttribute(ItemAttribute_t::DECAYSTATE)) {
-		const auto timestamp = item->getAttribute<int64_t>(ItemAttribute_t::DURATION_TIMESTAMP);
-		if (item->hasAttribute(ItemAttribute_t::DURATION_TIMESTAMP)) {
-			const auto it = decayMap.find(timestamp);
-			if (it != decayMap.end()) {
-				auto &decayItems = it->second;
-
-				size_t i = 0;
-				const size_t end = decayItems.size();
-				auto decayItem = decayItems[i];
-				if (end == 1) {
-					if (item == decayItem) {
-						if (item->hasAttribute(ItemAttribute_t::DURATION)) {
-							// Incase we removed duration attribute don't assign new duration
-							item->setDuration(item->getDuration());
-						}
-						item->removeAttribute(ItemAttribute_t::DECAYSTATE);
-
-						decayMap.erase(it);
-					}
-					return;
-				}
-				while (i < end) {
-					decayItem = decayItems[i];
-					if (item == decayItem) {
-						if (item->hasAttribute(ItemAttribute_t::DURATION)) {
-							// Incase we removed duration attribute don't assign new duration
-							item->setDuration(item->getDuration());
-						}
-						item->removeAttribute(ItemAttribute_t::DECAYSTATE);
-
-						decayItems[i] = decayItems.back();
-						decayItems.pop_back();
-						return;
-					}
-					++i;
-				}
-			}
-			item->removeAttribute(ItemAttribute_t::DURATION_TIMESTAMP);
-		} else {
-			item->removeAttribute(ItemAttribute_t::DECAYSTATE);
+
+	if (!item->hasAttribute(ItemAttribute_t::DURATION_TIMESTAMP)) {
+		item->removeAttribute(ItemAttribute_t::DECAYSTATE);
+		return;
+	}
+
+	if (decayWheel.remove(item)) {
+		if (item->hasAttribute(ItemAttribute_t::DURATION)) {
+			// Incase we removed duration attribute don't assign new duration
+			item->setDuration(item->getDuration());
 		}
+		item->removeAttribute(ItemAttribute_t::DECAYSTATE);
+		return;
 	}
+	item->removeAttribute(ItemAttribute_t::DURATION_TIMESTAMP);
 }
 
 void Decay::checkDecay() {
-	const int64_t timestamp = OTSYS_TIME();
+	const int64_t now = OTSYS_TIME();
+	eventId = 0;
 
-	std::vector<std::shared_ptr<Item>> tempItems;
-	tempItems.reserve(32); // Small preallocation
-
-	auto it = decayMap.begin();
-	const auto end = decayMap.end();
-	while (it != end) {
-		if (it->first > timestamp) {
-			break;
-		}
-
-		// Iterating here is unsafe so let's copy our items into temporary vector
-		auto &decayItems = it->second;
-		tempItems.reserve(tempItems.size() + decayItems.size());
-		for (auto &decayItem : decayItems) {
-			tempItems.emplace_back(decayItem);
-		}
-		it = decayMap.erase(it);
-	}
+	// Whole slots are taken out of the wheel, the items can start or stop decaying again while they are handled
+	expiredItems.clear();
+	decayWheel.advance(now, expiredItems);
 
-	for (const auto &item : tempItems) {
+	for (const auto &item : expiredItems) {
 		if (!item->canDecay()) {
 			item->setDuration(item->getDuration());
 			item->setDecaying(DECAYING_FALSE);
@@ -146,12 +92,24 @@ void Decay::checkDecay() {
 			internalDecayItem(item);
 		}
 	}
+	expiredItems.clear();
 
-	if (it != end) {
-		eventId = g_dispatcher().scheduleEvent(
-			std::max<int32_t>(SCHEDULER_MINTICKS, static_cast<int32_t>(it->first - timestamp)), [this] { checkDecay(); }, "Decay::checkDecay"
-		);
+	scheduleCheck(decayWheel.getNextCheck(), now);
+}
+
+void Decay::scheduleCheck(int64_t checkTime, int64_t now) {
+	if (checkTime == 0 || (eventId != 0 && eventTime <= checkTime)) {
+		return;
 	}
+
+	if (eventId != 0) {
+		g_dispatcher().stopEvent(eventId);
+	}
+
+	eventTime = checkTime;
+	eventId = g_dispatcher().scheduleEvent(
+		std::max<int32_t>(SCHEDULER_MINTICKS, static_cast<int32_t>(checkTime - now)), [this] { checkDecay(); }, "Decay::checkDecay"
+	);
 }
 
 void Decay::internalDecayItem(const std::shared_ptr<Item> &item) {
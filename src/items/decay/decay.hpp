@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include "items/decay/decaywheel.hpp"
+
 class Item;
 
 class Decay {
@@ -25,11 +27,15 @@ public:
 
 private:
 	void checkDecay();
+	void scheduleCheck(int64_t checkTime, int64_t now);
 	static void internalDecayItem(const std::shared_ptr<Item> &item);
 
-	uint32_t eventId { 0 };
-	// order is important, so we use an std::map
-	std::map<int64_t, std::vector<std::shared_ptr<Item>>> decayMap;
+	uint64_t eventId { 0 };
+	// When the pending checkDecay event runs
+	int64_t eventTime { 0 };
+	DecayWheel<Item> decayWheel;
+	// Reused by every checkDecay
+	std::vector<std::shared_ptr<Item>> expiredItems;
 };
 
 constexpr auto g_decay = Decay::getInstance;
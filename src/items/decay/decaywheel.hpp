@@ -0,0 +1,201 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Where a decaying item sits in the DecayWheel, kept on the item itself so it can be removed in O(1).
+ */
+struct DecayHandle {
+	static constexpr uint16_t NONE = std::numeric_limits<uint16_t>::max();
+
+	bool isQueued() const {
+		return slot != NONE;
+	}
+
+	uint32_t index = 0;
+	uint16_t slot = NONE;
+	uint8_t level = 0;
+};
+
+/**
+ * Two level timing wheel of decaying items.
+ * The first level has one slot per SLOT_DURATION ms of the current epoch (WHEEL_SLOTS slots),
+ * the second one slot per epoch. When an epoch starts its second level slot is spread over the first level.
+ * Items decay on the first slot end at or after their timestamp, so at most SLOT_DURATION ms late and never early.
+ * Each slot keeps the items and their timestamps in two parallel vectors, the timestamps are
+ * all that is read when spreading, and the index in the slot is kept on the item (DecayHandle)
+ * so adding and removing are O(1) (swap with the last one).
+ * T must provide DecayHandle &getDecayHandle().
+ */
+template <typename T>
+class DecayWheel {
+public:
+	static constexpr int64_t SLOT_DURATION = 50;
+	static constexpr uint32_t WHEEL_BITS = 12;
+	static constexpr uint32_t WHEEL_SLOTS = 1 << WHEEL_BITS;
+	static constexpr uint32_t WHEEL_MASK = WHEEL_SLOTS - 1;
+
+	DecayWheel() = default;
+
+	// non-copyable
+	DecayWheel(const DecayWheel &) = delete;
+	DecayWheel &operator=(const DecayWheel &) = delete;
+
+	/**
+	 * Queues the item to expire at 'timestamp' (ms), returns when advance has to run for it next.
+	 */
+	int64_t add(const std::shared_ptr<T> &item, int64_t timestamp, int64_t now) {
+		remove(item);
+		if (count == 0) {
+			// Nothing pending, start from the present instead of walking the idle time
+			nextSlot = now / SLOT_DURATION;
+		}
+		return place(item, timestamp);
+	}
+
+	/**
+	 * Returns false if the item was not queued.
+	 */
+	bool remove(const std::shared_ptr<T> &item) {
+		auto &handle = item->getDecayHandle();
+		if (!handle.isQueued()) {
+			return false;
+		}
+
+		auto &bucket = handle.level == 0 ? nearSlots[handle.slot] : farSlots[handle.slot];
+		const auto index = handle.index;
+		if (index + 1 != bucket.items.size()) {
+			bucket.items[index] = std::move(bucket.items.back());
+			bucket.timestamps[index] = bucket.timestamps.back();
+			bucket.items[index]->getDecayHandle().index = index;
+		}
+		bucket.items.pop_back();
+		bucket.timestamps.pop_back();
+
+		if (handle.level == 0) {
+			--nearCount;
+		}
+		--count;
+		handle = {};
+		return true;
+	}
+
+	/**
+	 * Moves the items of every slot that ended by 'now' into 'expired'.
+	 */
+	void advance(int64_t now, std::vector<std::shared_ptr<T>> &expired) {
+		while ((nextSlot + 1) * SLOT_DURATION <= now) {
+			if (count == 0) {
+				nextSlot = now / SLOT_DURATION;
+				return;
+			}
+
+			auto &bucket = nearSlots[nextSlot & WHEEL_MASK];
+			for (auto &item : bucket.items) {
+				item->getDecayHandle() = {};
+				expired.emplace_back(std::move(item));
+			}
+			nearCount -= bucket.items.size();
+			count -= bucket.items.size();
+			bucket.items.clear();
+			bucket.timestamps.clear();
+
+			++nextSlot;
+			if ((nextSlot & WHEEL_MASK) == 0) {
+				spread(nextSlot >> WHEEL_BITS);
+			}
+		}
+	}
+
+	/**
+	 * When advance has work to do next, 0 if nothing is queued.
+	 */
+	int64_t getNextCheck() const {
+		if (count == 0) {
+			return 0;
+		}
+
+		if (nearCount > 0) {
+			for (int64_t slot = nextSlot; (slot & WHEEL_MASK) != 0 || slot == nextSlot; ++slot) {
+				if (!nearSlots[slot & WHEEL_MASK].items.empty()) {
+					return (slot + 1) * SLOT_DURATION;
+				}
+			}
+		}
+		// Start of the next epoch, when its items are spread
+		return (((nextSlot >> WHEEL_BITS) + 1) << WHEEL_BITS) * SLOT_DURATION;
+	}
+
+	size_t size() const {
+		return count;
+	}
+
+	bool empty() const {
+		return count == 0;
+	}
+
+private:
+	struct Bucket {
+		std::vector<std::shared_ptr<T>> items;
+		std::vector<int64_t> timestamps;
+	};
+
+	int64_t place(const std::shared_ptr<T> &item, int64_t timestamp) {
+		// The slot that ends at or right after the timestamp
+		const int64_t slot = std::max((timestamp - 1) / SLOT_DURATION, nextSlot);
+		const int64_t epoch = slot >> WHEEL_BITS;
+		const int64_t currentEpoch = nextSlot >> WHEEL_BITS;
+
+		auto &handle = item->getDecayHandle();
+		int64_t checkAt;
+		if (epoch == currentEpoch) {
+			handle.level = 0;
+			handle.slot = static_cast<uint16_t>(slot & WHEEL_MASK);
+			++nearCount;
+			checkAt = (slot + 1) * SLOT_DURATION;
+		} else {
+			// Further than the second level reaches: parked in the slot spread last, placed again from there
+			const int64_t farEpoch = epoch - currentEpoch < WHEEL_SLOTS ? epoch : currentEpoch + WHEEL_SLOTS - 1;
+			handle.level = 1;
+			handle.slot = static_cast<uint16_t>(farEpoch & WHEEL_MASK);
+			checkAt = (farEpoch << WHEEL_BITS) * SLOT_DURATION;
+		}
+
+		auto &bucket = handle.level == 0 ? nearSlots[handle.slot] : farSlots[handle.slot];
+		handle.index = static_cast<uint32_t>(bucket.items.size());
+		bucket.items.emplace_back(item);
+		bucket.timestamps.emplace_back(timestamp);
+		++count;
+		return checkAt;
+	}
+
+	void spread(int64_t epoch) {
+		auto &bucket = farSlots[epoch & WHEEL_MASK];
+		std::swap(bucket.items, spreading.items);
+		std::swap(bucket.timestamps, spreading.timestamps);
+		count -= spreading.items.size();
+
+		for (size_t i = 0; i < spreading.items.size(); ++i) {
+			place(spreading.items[i], spreading.timestamps[i]);
+		}
+		spreading.items.clear();
+		spreading.timestamps.clear();
+	}
+
+	std::array<Bucket, WHEEL_SLOTS> nearSlots;
+	std::array<Bucket, WHEEL_SLOTS> farSlots;
+	// Reused while a second level slot is spread
+	Bucket spreading;
+
+	// First slot not expired yet
+	int64_t nextSlot = 0;
+	size_t nearCount = 0;
+	size_t count = 0;
+};
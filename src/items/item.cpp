@@ -447,6 +447,23 @@ std::shared_ptr<Tile> Item::getTile() {
 	return std::dynamic_pointer_cast<Tile>(cylinder);
 }
 
+void Item::markHouseItemsDirty() {
+	// Not placed yet, being created or loaded
+	if (!getParent()) {
+		return;
+	}
+
+	const auto &topParent = getTopParent();
+	// Carried by a creature, not a house item
+	if (!topParent || topParent->getCreature()) {
+		return;
+	}
+
+	if (const auto &tile = getTile()) {
+		tile->markHouseItemsDirty();
+	}
+}
+
 bool Item::isRemoved() {
 	auto parent = getParent();
 	if (parent) {
@@ -3457,6 +3474,11 @@ const std::map<std::string, CustomAttribute, std::less<>> &ItemProperties::getCu
 	return attributePtr->getCustomAttributeMap();
 }
 
+void ItemProperties::markAttributesChanged() const {
+	// Item is the only class deriving from ItemProperties
+	const_cast<Item*>(static_cast<const Item*>(this))->markHouseItemsDirty();
+}
+
 int32_t ItemProperties::getDuration() const {
 	ItemDecayState_t decayState = getDecaying();
 	if (decayState == DECAYING_TRUE || decayState == DECAYING_STOPPING) {
@@ -11,6 +11,7 @@
 
 #include "enums/item_attribute.hpp"
 #include "io/fileloader.hpp"
+#include "items/decay/decaywheel.hpp"
 #include "items/functions/item/attribute.hpp"
 #include "items/items.hpp"
 #include "items/thing.hpp"
@@ -55,14 +56,15 @@ public:
 		return attributePtr->hasAttribute(type);
 	}
 	void removeAttribute(ItemAttribute_t type) const {
-		if (attributePtr) {
-			attributePtr->removeAttribute(type);
+		if (attributePtr && attributePtr->removeAttribute(type)) {
+			markAttributesChanged();
 		}
 	}
 
 	template <typename GenericAttribute>
 	void setAttribute(ItemAttribute_t type, GenericAttribute genericAttribute) {
 		initAttributePtr()->setAttribute(type, genericAttribute);
+		markAttributesChanged();
 	}
 
 	bool isAttributeInteger(ItemAttribute_t type) const {
@@ -86,10 +88,12 @@ public:
 	template <typename GenericType>
 	void setCustomAttribute(const std::string &key, GenericType value) {
 		initAttributePtr()->setCustomAttribute(key, value);
+		markAttributesChanged();
 	}
 
 	void addCustomAttribute(const std::string &key, const CustomAttribute &customAttribute) {
 		initAttributePtr()->addCustomAttribute(key, customAttribute);
+		markAttributesChanged();
 	}
 
 	bool hasCustomAttribute() const {
@@ -97,11 +101,12 @@ public:
 	}
 
 	bool removeCustomAttribute(const std::string &attributeName) const {
-		if (!attributePtr) {
+		if (!attributePtr || !attributePtr->removeCustomAttribute(attributeName)) {
 			return false;
 		}
 
-		return attributePtr->removeCustomAttribute(attributeName);
+		markAttributesChanged();
+		return true;
 	}
 
 	uint16_t getCharges() const {
@@ -192,6 +197,9 @@ protected:
 	}
 
 private:
+	// The attributes are saved with the item, a house holding it is written by the next save
+	void markAttributesChanged() const;
+
 	std::unique_ptr<ItemAttribute> attributePtr;
 
 	friend class Item;
@@ -537,6 +545,10 @@ public:
 	bool isDecayDisabled() const {
 		return decayDisabled;
 	}
+	// Position in the Decay wheel, only touched by it
+	DecayHandle &getDecayHandle() {
+		return decayHandle;
+	}
 
 	const std::string &getName() const {
 		if (hasAttribute(ItemAttribute_t::NAME)) {
@@ -641,6 +653,10 @@ public:
 	}
 	std::shared_ptr<Cylinder> getTopParent();
 	std::shared_ptr<Tile> getTile() override;
+	/**
+	 * The item changed while lying on the map, the house it lies in, if any, is written by the next save.
+	 */
+	void markHouseItemsDirty();
 	bool isRemoved() override;
 
 	bool isInsideDepot(bool includeInbox = false);
@@ -715,6 +731,8 @@ protected:
 	bool isLootTrackeable = false;
 	bool decayDisabled = false;
 
+	DecayHandle decayHandle;
+
 private:
 	void setImbuement(uint8_t slot, uint16_t imbuementId, uint32_t duration);
 	// Don't add variables here, use the ItemAttribute class.
@@ -22,6 +22,7 @@
 #include "items/trashholder.hpp"
 #include "lua/creature/movement.hpp"
 #include "map/spectators.hpp"
+#include "map/utils/walkability.hpp"
 #include "utils/tools.hpp"
 #include "game/scheduling/dispatcher.hpp"
 
@@ -90,6 +91,45 @@ bool Tile::hasFlag(uint32_t flag) const {
 	return hasBitSet(flag, this->flags);
 }
 
+uint8_t Tile::getWalkability() const {
+	uint8_t walkabilityFlags = WALKABILITY_NONE;
+	if (!ground || hasFlag(TILESTATE_FLOORCHANGE | TILESTATE_TELEPORT)) {
+		walkabilityFlags |= WALKABILITY_NOPATH;
+	}
+	if (hasFlag(TILESTATE_BLOCKSOLID)) {
+		walkabilityFlags |= WALKABILITY_BLOCKSOLID;
+	}
+	if (hasFlag(TILESTATE_BLOCKPATH)) {
+		walkabilityFlags |= WALKABILITY_BLOCKPATH;
+	}
+	if (hasFlag(TILESTATE_BLOCKPROJECTILE)) {
+		walkabilityFlags |= WALKABILITY_BLOCKPROJECTILE;
+	}
+	if (hasFlag(TILESTATE_PROTECTIONZONE)) {
+		walkabilityFlags |= WALKABILITY_PROTECTIONZONE;
+	}
+	if (getCreatureCount() != 0) {
+		walkabilityFlags |= WALKABILITY_CREATURE;
+	}
+	return walkabilityFlags;
+}
+
+void Tile::setWalkabilityMap(WalkabilityMap* map) {
+	walkabilityMap = map;
+	if (walkabilityMap) {
+		walkability = getWalkability();
+		walkabilityMap->set(tilePos.x, tilePos.y, walkability);
+	}
+}
+
+void Tile::refreshWalkability() {
+	const uint8_t walkabilityFlags = getWalkability();
+	if (walkabilityFlags != walkability) {
+		walkability = walkabilityFlags;
+		walkabilityMap->set(tilePos.x, tilePos.y, walkability);
+	}
+}
+
 bool Tile::hasHeight(uint32_t n) const {
 	uint32_t height = 0;
 
@@ -1025,17 +1065,20 @@ void Tile::addThing(int32_t, const std::shared_ptr<Thing> &thing) {
 
 	const auto &creature = thing->getCreature();
 	if (creature) {
-		Spectators::clearCache();
+		Spectators::invalidateCache(getPosition());
 		creature->setParent(static_self_cast<Tile>());
 
 		CreatureVector* creatures = makeCreatures();
 		creatures->insert(creatures->begin(), creature);
+		updateWalkability();
 	} else {
 		const auto &item = thing->getItem();
 		if (item == nullptr) {
 			return /*RETURNVALUE_NOTPOSSIBLE*/;
 		}
 
+		markHouseItemsDirty();
+
 		TileItemVector* items = getItemList();
 		if (items && items->size() >= 0xFFFF) {
 			return /*RETURNVALUE_NOTPOSSIBLE*/;
@@ -1152,6 +1195,7 @@ void Tile::updateThing(const std::shared_ptr<Thing> &thing, uint16_t itemId, uin
 	item->setID(itemId);
 	item->setSubType(count);
 	setTileFlags(item);
+	markHouseItemsDirty();
 	onUpdateTileItem(item, oldType, item, newType);
 }
 
@@ -1221,6 +1265,7 @@ void Tile::replaceThing(uint32_t index, const std::shared_ptr<Thing> &thing) {
 
 		resetTileFlags(oldItem);
 		setTileFlags(item);
+		markHouseItemsDirty();
 		const ItemType &oldType = Item::items[oldItem->getID()];
 		const ItemType &newType = Item::items[item->getID()];
 		onUpdateTileItem(oldItem, oldType, item, newType);
@@ -1241,8 +1286,9 @@ void Tile::removeThing(const std::shared_ptr<Thing> &thing, uint32_t count) {
 		if (creatures) {
 			const auto it = std::ranges::find(*creatures, thing);
 			if (it != creatures->end()) {
-				Spectators::clearCache();
+				Spectators::invalidateCache(getPosition());
 				creatures->erase(it);
+				updateWalkability();
 			}
 		}
 		return;
@@ -1258,9 +1304,12 @@ void Tile::removeThing(const std::shared_ptr<Thing> &thing, uint32_t count) {
 		return;
 	}
 
+	markHouseItemsDirty();
+
 	if (item == ground) {
 		ground->resetParent();
 		ground = nullptr;
+		updateWalkability();
 
 		const auto spectators = Spectators().find<Creature>(getPosition(), true);
 		onRemoveTileItem(spectators.data(), std::vector<int32_t>(spectators.size(), 0), item);
@@ -1615,6 +1664,12 @@ void Tile::postRemoveNotification(const std::shared_ptr<Thing> &thing, const std
 	}
 }
 
+void Tile::markHouseItemsDirty() {
+	if (const auto &house = getHouse()) {
+		house->markItemsDirty();
+	}
+}
+
 void Tile::internalAddThing(const std::shared_ptr<Thing> &thing) {
 	internalAddThing(0, thing);
 	if (!thing || !thing->getParent()) {
@@ -1647,10 +1702,11 @@ void Tile::internalAddThing(uint32_t, const std::shared_ptr<Thing> &thing) {
 
 	const auto &creature = thing->getCreature();
 	if (creature) {
-		Spectators::clearCache();
+		Spectators::invalidateCache(getPosition());
 
 		CreatureVector* creatures = makeCreatures();
 		creatures->insert(creatures->begin(), creature);
+		updateWalkability();
 	} else {
 		const auto &item = thing->getItem();
 		if (item == nullptr) {
@@ -1783,6 +1839,9 @@ void Tile::setTileFlags(const std::shared_ptr<Item> &item) {
 	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
 		setFlag(TILESTATE_SUPPORTS_HANGABLE);
 	}
+
+	// The ground may have changed without touching any flag
+	updateWalkability();
 }
 
 void Tile::resetTileFlags(const std::shared_ptr<Item> &item) {
@@ -1864,6 +1923,8 @@ void Tile::resetTileFlags(const std::shared_ptr<Item> &item) {
 	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
 		resetFlag(TILESTATE_SUPPORTS_HANGABLE);
 	}
+
+	updateWalkability();
 }
 
 bool Tile::isMovableBlocking() const {
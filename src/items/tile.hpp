@@ -22,6 +22,7 @@ class Zone;
 class Cylinder;
 class Item;
 class ItemType;
+class WalkabilityMap;
 
 using CreatureVector = std::vector<std::shared_ptr<Creature>>;
 using ItemVector = std::vector<std::shared_ptr<Item>>;
@@ -121,6 +122,11 @@ public:
 		return nullptr;
 	}
 
+	/**
+	 * An item of the tile, or inside one of its containers, changed: the house of the tile is written by the next save.
+	 */
+	void markHouseItemsDirty();
+
 	int32_t getThrowRange() const final {
 		return 0;
 	}
@@ -172,10 +178,22 @@ public:
 	bool hasFlag(uint32_t flag) const;
 	void setFlag(uint32_t flag) {
 		this->flags |= flag;
+		updateWalkability();
 	}
 	void resetFlag(uint32_t flag) {
 		this->flags &= ~flag;
+		updateWalkability();
 	}
+
+	/**
+	 * Walkability bits (WalkabilityFlags_t) of the tile, mirrored in the bitmap of its floor.
+	 */
+	uint8_t getWalkability() const;
+	/**
+	 * Binds the tile to the bitmap of the floor it was placed on, called by Floor::setTile.
+	 */
+	void setWalkabilityMap(WalkabilityMap* map);
+
 	void addZone(const std::shared_ptr<Zone> &zone);
 	void clearZones();
 
@@ -256,6 +274,8 @@ public:
 
 		if ((ground = item)) {
 			setTileFlags(item);
+		} else {
+			updateWalkability();
 		}
 	}
 
@@ -270,6 +290,12 @@ private:
 
 	void setTileFlags(const std::shared_ptr<Item> &item);
 	void resetTileFlags(const std::shared_ptr<Item> &item);
+	void updateWalkability() {
+		if (walkabilityMap) {
+			refreshWalkability();
+		}
+	}
+	void refreshWalkability();
 	bool hasHarmfulField() const;
 	ReturnValue checkNpcCanWalkIntoTile() const;
 
@@ -278,6 +304,10 @@ protected:
 	Position tilePos;
 	uint32_t flags = 0;
 	std::unordered_set<std::shared_ptr<Zone>> zones {};
+
+private:
+	WalkabilityMap* walkabilityMap = nullptr;
+	uint8_t walkability = 0;
 };
 
 // Used for walkable tiles, where there is high likeliness of
@@ -19,20 +19,19 @@ KVSQL::KVSQL(Database &db, Logger &logger) :
 	KVStore(logger), db(db) { }
 
 std::optional<ValueWrapper> KVSQL::load(const std::string &key) {
-	const auto query = fmt::format("SELECT `key_name`, `timestamp`, `value` FROM `kv_store` WHERE `key_name` = {}", db.escapeString(key));
-	const auto result = db.storeQuery(query);
+	const auto result = db.storeQuery(DBStatement("SELECT `timestamp`, `value` FROM `kv_store` WHERE `key_name` = ?").bind(key));
 	if (result == nullptr) {
 		return std::nullopt;
 	}
 
 	unsigned long size;
-	const auto data = result->getStream("value", size);
+	const auto data = result->getStream(1, size);
 	if (data == nullptr) {
 		return std::nullopt;
 	}
 
 	ValueWrapper valueWrapper;
-	const auto timestamp = result->getNumber<uint64_t>("timestamp");
+	const auto timestamp = result->getNumber<uint64_t>(0);
 	Canary::protobuf::kv::ValueWrapper protoValue;
 	if (protoValue.ParseFromArray(data, static_cast<int>(size))) {
 		valueWrapper = ProtoSerializable::fromProto(protoValue, timestamp);
@@ -73,8 +72,7 @@ bool KVSQL::prepareSave(const std::string &key, const ValueWrapper &value, DBIns
 		return false;
 	}
 	if (value.isDeleted()) {
-		const auto query = fmt::format("DELETE FROM `kv_store` WHERE `key_name` = {}", db.escapeString(key));
-		return db.executeQuery(query);
+		return db.executeQuery(DBStatement("DELETE FROM `kv_store` WHERE `key_name` = ?").bind(key));
 	}
 
 	update.addRow(fmt::format("{}, {}, {}", db.escapeString(key), value.getTimestamp(), db.escapeString(data)));
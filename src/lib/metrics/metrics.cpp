@@ -81,6 +81,25 @@ void Metrics::initHistograms() {
 
 		latencyHistograms[name] = getMeter()->CreateDoubleHistogram(name, "Latency", "us");
 	}
+
+	for (auto name : sizeNames) {
+		auto instrumentSelector = metrics_sdk::InstrumentSelectorFactory::Create(metrics_sdk::InstrumentType::kHistogram, name, "1");
+		auto meterSelector = metrics_sdk::MeterSelectorFactory::Create("performance", otelVersion, otelSchema);
+
+		auto aggregationConfig = std::make_unique<metrics_sdk::HistogramAggregationConfig>();
+		aggregationConfig->boundaries_ = { 0.0 };
+		for (double boundary = 1.0; boundary <= 1048576.0; boundary *= 2) {
+			aggregationConfig->boundaries_.emplace_back(boundary);
+		}
+		aggregationConfig->boundaries_.emplace_back(std::numeric_limits<double>::infinity());
+
+		auto view = metrics_sdk::ViewFactory::Create(name, "Size", "1", metrics_sdk::AggregationType::kHistogram, std::move(aggregationConfig));
+		auto provider = metrics_api::Provider::GetMeterProvider();
+		auto* p = static_cast<metrics_sdk::MeterProvider*>(provider.get());
+		p->AddView(std::move(instrumentSelector), std::move(meterSelector), std::move(view));
+
+		latencyHistograms[name] = getMeter()->CreateDoubleHistogram(name, "Size", "1");
+	}
 }
 
 void Metrics::shutdown() {
@@ -83,13 +83,26 @@ namespace metrics {
 	DEFINE_LATENCY_CLASS(query, "query", "truncated_query");
 	DEFINE_LATENCY_CLASS(task, "task", "task");
 	DEFINE_LATENCY_CLASS(lock, "lock", "scope");
+	DEFINE_LATENCY_CLASS(dispatcher, "dispatcher", "group");
 
 	const std::vector<std::string> latencyNames {
 		"method_latency",
 		"lua_latency",
 		"query_latency",
 		"task_latency",
+		"task_wait_latency",
 		"lock_latency",
+		"dispatcher_latency",
+		"spectators_latency",
+		"save_stall_latency",
+	};
+
+	const std::vector<std::string> sizeNames {
+		"dispatcher_queue_depth",
+		"connection_write_bytes",
+		"connection_write_messages",
+		"connection_write_calls",
+		"database_connections_in_use",
 	};
 
 	class Metrics final {
@@ -129,6 +142,19 @@ namespace metrics {
 			upDownCounters[name]->Add(value, attrskv);
 		}
 
+		/**
+		 * Records a value measured elsewhere, such as a wait time, into one of the
+		 * histograms declared in latencyNames or sizeNames.
+		 */
+		void recordHistogram(const std::string &name, double value, std::map<std::string, std::string> attrs = {}) {
+			const auto it = latencyHistograms.find(name);
+			if (it == latencyHistograms.end() || it->second == nullptr) {
+				return;
+			}
+			auto attrskv = opentelemetry::common::KeyValueIterableView<decltype(attrs)> { attrs };
+			it->second->Record(value, attrskv, defaultContext);
+		}
+
 		friend class ScopedLatency;
 
 	protected:
@@ -189,13 +215,26 @@ namespace metrics {
 	DEFINE_LATENCY_CLASS(query, "query", "truncated_query");
 	DEFINE_LATENCY_CLASS(task, "task", "task");
 	DEFINE_LATENCY_CLASS(lock, "lock", "scope");
+	DEFINE_LATENCY_CLASS(dispatcher, "dispatcher", "group");
 
 	const std::vector<std::string> latencyNames {
 		"method_latency",
 		"lua_latency",
 		"query_latency",
 		"task_latency",
+		"task_wait_latency",
 		"lock_latency",
+		"dispatcher_latency",
+		"spectators_latency",
+		"save_stall_latency",
+	};
+
+	const std::vector<std::string> sizeNames {
+		"dispatcher_queue_depth",
+		"connection_write_bytes",
+		"connection_write_messages",
+		"connection_write_calls",
+		"database_connections_in_use",
 	};
 
 	class Metrics final {
@@ -215,6 +254,8 @@ namespace metrics {
 
 		void addUpDownCounter([[maybe_unused]] std::string_view name, [[maybe_unused]] int value, [[maybe_unused]] const std::map<std::string, std::string> &attrs = {}) const { }
 
+		void recordHistogram([[maybe_unused]] const std::string &name, [[maybe_unused]] double value, [[maybe_unused]] const std::map<std::string, std::string> &attrs = {}) const { }
+
 		friend class ScopedLatency;
 	};
 }
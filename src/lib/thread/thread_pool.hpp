@@ -27,8 +27,7 @@ public:
 		thread_local static int16_t id = -1;
 
 		if (id == -1) {
-			lastId.fetch_add(1);
-			id = lastId.load();
+			id = lastId.fetch_add(1) + 1;
 		}
 
 		return id;
@@ -38,6 +37,69 @@ public:
 		return stopped;
 	}
 
+	/**
+	 * Runs f(i) for every i below 'size' on the calling thread and up to 'helpers' pool threads,
+	 * returning once every index ran. The caller takes its share, so the work goes on even when
+	 * every pool thread is busy. If f throws, the indexes not started yet are skipped and the
+	 * first exception is rethrown on the calling thread once every thread left.
+	 */
+	template <typename F>
+	void parallelFor(size_t size, size_t chunkSize, size_t helpers, F &&f) {
+		if (size == 0) {
+			return;
+		}
+
+		// Indexes are claimed in chunks from a shared cursor, so a thread that finishes
+		// early keeps stealing work from the remaining range instead of sitting idle.
+		// Helpers that start after everything was claimed only touch the shared state and leave,
+		// which is why the caller waits for completed indexes instead of the helper futures.
+		struct ParallelState {
+			std::atomic_size_t cursor = 0;
+			std::atomic_size_t done = 0;
+			std::atomic_bool failed = false;
+			// Written by the first thread that failed before it counts its chunk, read once everything was counted
+			std::exception_ptr exception;
+		};
+
+		chunkSize = std::max<size_t>(chunkSize, 1);
+		const auto state = std::make_shared<ParallelState>();
+		const auto work = [state, &f, size, chunkSize] {
+			for (auto min = state->cursor.fetch_add(chunkSize, std::memory_order_relaxed); min < size; min = state->cursor.fetch_add(chunkSize, std::memory_order_relaxed)) {
+				const auto max = std::min(size, min + chunkSize);
+				if (!state->failed.load(std::memory_order_relaxed)) {
+					try {
+						for (auto i = min; i < max; ++i) {
+							f(i);
+						}
+					} catch (...) {
+						if (!state->failed.exchange(true, std::memory_order_relaxed)) {
+							state->exception = std::current_exception();
+						}
+					}
+				}
+
+				// Counted even when it failed or was skipped, otherwise the caller would wait forever
+				if (state->done.fetch_add(max - min, std::memory_order_acq_rel) + (max - min) == size) {
+					state->done.notify_all();
+				}
+			}
+		};
+
+		for (size_t i = 0; i < helpers; ++i) {
+			detach_task(work);
+		}
+
+		work();
+
+		for (auto done = state->done.load(std::memory_order_acquire); done < size; done = state->done.load(std::memory_order_acquire)) {
+			state->done.wait(done, std::memory_order_acquire);
+		}
+
+		if (state->exception) {
+			std::rethrow_exception(state->exception);
+		}
+	}
+
 private:
 	std::mutex mutex;
 	std::condition_variable condition;
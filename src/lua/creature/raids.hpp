@@ -82,7 +82,7 @@ private:
 	std::list<std::shared_ptr<Raid>> raidList;
 	std::shared_ptr<Raid> running = nullptr;
 	uint64_t lastRaidEnd = 0;
-	uint32_t checkRaidsEvent = 0;
+	uint64_t checkRaidsEvent = 0;
 	bool loaded = false;
 	bool started = false;
 };
@@ -134,7 +134,7 @@ private:
 	uint32_t nextEvent = 0;
 	uint64_t margin;
 	RaidState_t state = RAIDSTATE_IDLE;
-	uint32_t nextEventEvent = 0;
+	uint64_t nextEventEvent = 0;
 	bool loaded = false;
 	bool repeat;
 };
@@ -107,6 +107,8 @@ void GameFunctions::init(lua_State* L) {
 	Lua::registerMethod(L, "Game", "getSecretAchievements", GameFunctions::luaGameGetSecretAchievements);
 	Lua::registerMethod(L, "Game", "getPublicAchievements", GameFunctions::luaGameGetPublicAchievements);
 	Lua::registerMethod(L, "Game", "getAchievements", GameFunctions::luaGameGetAchievements);
+
+	Lua::registerMethod(L, "Game", "getTaskProfile", GameFunctions::luaGameGetTaskProfile);
 }
 
 // Game
@@ -994,3 +996,23 @@ int GameFunctions::luaGameGetAchievements(lua_State* L) {
 	}
 	return 1;
 }
+
+int GameFunctions::luaGameGetTaskProfile(lua_State* L) {
+	// Game.getTaskProfile([count = 20])
+	// Empty unless the server was built with metrics enabled
+	const auto count = Lua::getNumber<uint32_t>(L, 1, 20);
+	const auto profiles = g_dispatcher().getTaskProfiler().getSlowest(count);
+	int index = 0;
+	lua_createtable(L, profiles.size(), 0);
+	for (const auto &profile : profiles) {
+		lua_createtable(L, 0, 6);
+		Lua::setField(L, "name", profile.name);
+		Lua::setField(L, "executions", profile.executions);
+		Lua::setField(L, "totalTime", profile.totalTime);
+		Lua::setField(L, "averageTime", profile.averageTime());
+		Lua::setField(L, "maxTime", profile.maxTime);
+		Lua::setField(L, "averageWait", profile.averageWait());
+		lua_rawseti(L, -2, ++index);
+	}
+	return 1;
+}
@@ -20,7 +20,7 @@ struct LuaTimerEventDesc {
 	std::string scriptName;
 	int32_t function = -1;
 	std::list<int32_t> parameters;
-	uint32_t eventId = 0;
+	uint64_t eventId = 0;
 
 	LuaTimerEventDesc() = default;
 	LuaTimerEventDesc(LuaTimerEventDesc &&other) = default;
@@ -233,6 +233,26 @@ public:
 	bool hasNewOwnership() const;
 	void setNewOwnership();
 
+	/**
+	 * Items of the house tiles changed, the next save serialises them again.
+	 */
+	void markItemsDirty() {
+		itemsVersion.fetch_add(1, std::memory_order_relaxed);
+	}
+	uint64_t getItemsVersion() const {
+		return itemsVersion.load(std::memory_order_relaxed);
+	}
+	bool hasUnsavedItems() const {
+		return getItemsVersion() != savedItemsVersion.load(std::memory_order_relaxed);
+	}
+	/**
+	 * The items as they were at 'version' are in the database.
+	 */
+	void setItemsSaved(uint64_t version) {
+		auto saved = savedItemsVersion.load(std::memory_order_relaxed);
+		while (saved < version && !savedItemsVersion.compare_exchange_weak(saved, version, std::memory_order_relaxed)) { }
+	}
+
 private:
 	bool transferToDepot() const;
 
@@ -268,6 +288,9 @@ private:
 
 	bool isLoaded = false;
 
+	std::atomic_uint64_t itemsVersion = 0;
+	std::atomic_uint64_t savedItemsVersion = 0;
+
 	void handleContainer(ItemList &moveItemList, const std::shared_ptr<Item> &item) const;
 	void handleWrapableItem(ItemList &moveItemList, const std::shared_ptr<Item> &item, const std::shared_ptr<Player> &player, const std::shared_ptr<HouseTile> &houseTile) const;
 };
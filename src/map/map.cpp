@@ -132,12 +132,16 @@ void Map::loadHouseInfo() {
 }
 
 bool Map::save() {
+	return save(IOMapSerialize::snapshotHouseItems());
+}
+
+bool Map::save(const HouseItemsSnapshot &houseItems) {
 	bool saved = false;
 	for (uint32_t tries = 0; tries < 6; tries++) {
 		if (IOMapSerialize::saveHouseInfo()) {
 			saved = true;
 		}
-		if (saved && IOMapSerialize::saveHouseItems()) {
+		if (saved && IOMapSerialize::saveHouseItems(houseItems)) {
 			return true;
 		}
 	}
@@ -169,13 +173,12 @@ std::shared_ptr<Tile> Map::getLoadedTile(uint16_t x, uint16_t y, uint8_t z) {
 		return nullptr;
 	}
 
-	const auto &floor = leaf->getFloor(z);
+	const auto floor = leaf->borrowFloor(z);
 	if (!floor) {
 		return nullptr;
 	}
 
-	const auto &tile = floor->getTile(x, y);
-	return tile;
+	return floor->getTile(x, y);
 }
 
 std::shared_ptr<Tile> Map::getTile(uint16_t x, uint16_t y, uint8_t z) {
@@ -188,12 +191,72 @@ std::shared_ptr<Tile> Map::getTile(uint16_t x, uint16_t y, uint8_t z) {
 		return nullptr;
 	}
 
-	const auto &floor = sector->getFloor(z);
+	const auto floor = sector->borrowFloor(z);
 	if (!floor) {
 		return nullptr;
 	}
 
-	return getOrCreateTileFromCache(floor, x, y);
+	return getOrCreateTileFromCache(*floor, x, y);
+}
+
+Tile* Map::borrowTile(uint16_t x, uint16_t y, uint8_t z) {
+	if (z >= MAP_MAX_LAYERS) {
+		return nullptr;
+	}
+
+	const auto sector = getMapSector(x, y);
+	if (!sector) {
+		return nullptr;
+	}
+
+	const auto floor = sector->borrowFloor(z);
+	if (!floor) {
+		return nullptr;
+	}
+
+	if (floor->hasTileCache(x, y)) {
+		// The floor owns the created tile, it outlives the borrowed reference
+		return getOrCreateTileFromCache(*floor, x, y).get();
+	}
+
+	return floor->borrowTile(x, y);
+}
+
+uint8_t Map::getWalkability(uint16_t x, uint16_t y, uint8_t z) const {
+	const auto sector = getMapSector(x, y);
+	const auto floor = sector ? sector->borrowFloor(z) : nullptr;
+	if (!floor) {
+		return WALKABILITY_NOPATH;
+	}
+
+	return floor->getWalkability().get(x, y);
+}
+
+bool Map::isProjectileBlocked(uint16_t x, uint16_t y, uint8_t z) {
+	return isProjectileBlocked(x, x, y, z);
+}
+
+bool Map::isProjectileBlocked(uint16_t fromX, uint16_t toX, uint16_t y, uint8_t z) {
+	for (uint32_t x = fromX; x <= toX;) {
+		// From x to last the tiles are in the same sector, one word of the bitmap
+		const uint32_t last = std::min<uint32_t>(toX, x | SECTOR_MASK);
+		const auto sector = getMapSector(x, y);
+		if (const auto floor = sector ? sector->borrowFloor(z) : nullptr) {
+			const auto &walkability = floor->getWalkability();
+			const auto mask = static_cast<WalkabilityMap::Row>(((1U << (last - x + 1)) - 1) << (x & SECTOR_MASK));
+
+			// Tiles still in the map cache are created first, which fills in their bits
+			for (auto unloaded = walkability.getRow(WALKABILITY_UNLOADED, y) & mask; unloaded != 0; unloaded &= unloaded - 1) {
+				getTile(static_cast<uint16_t>((x & ~static_cast<uint32_t>(SECTOR_MASK)) + std::countr_zero(unloaded)), y, z);
+			}
+
+			if (walkability.getRow(WALKABILITY_BLOCKPROJECTILE, y) & mask) {
+				return true;
+			}
+		}
+		x = last + 1;
+	}
+	return false;
 }
 
 void Map::refreshZones(uint16_t x, uint16_t y, uint8_t z) {
@@ -388,18 +451,20 @@ void Map::moveCreature(const std::shared_ptr<Creature> &creature, const std::sha
 	// remove the creature
 	oldTile->removeThing(creature, 0);
 
+	// add the creature
+	newTile->addThing(creature);
+
 	MapSector* old_sector = getMapSector(oldPos.x, oldPos.y);
 	MapSector* new_sector = getMapSector(newPos.x, newPos.y);
 
-	// Switch the node ownership
+	// Switch the node ownership once the creature stands on its new tile, so the new sector indexes the new position
 	if (old_sector != new_sector) {
 		old_sector->removeCreature(creature);
 		new_sector->addCreature(creature);
+	} else {
+		new_sector->updateCreature(creature);
 	}
 
-	// add the creature
-	newTile->addThing(creature);
-
 	if (!teleport) {
 		if (oldPos.y > newPos.y) {
 			creature->setDirection(DIRECTION_NORTH);
@@ -490,14 +555,8 @@ bool Map::checkSightLine(Position start, Position destination) {
 
 	if (start.y == destination.y) {
 		// Horizontal line
-		const uint16_t delta = start.x < destination.x ? 0x0001 : 0xFFFF;
-		while (--distanceX > 0) {
-			start.x += delta;
-
-			const auto &tile = getTile(start.x, start.y, start.z);
-			if (tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
-				return false;
-			}
+		if (distanceX > 1 && isProjectileBlocked(std::min(start.x, destination.x) + 1, std::max(start.x, destination.x) - 1, start.y, start.z)) {
+			return false;
 		}
 	} else if (start.x == destination.x) {
 		// Vertical line
@@ -505,8 +564,7 @@ bool Map::checkSightLine(Position start, Position destination) {
 		while (--distanceY > 0) {
 			start.y += delta;
 
-			const auto &tile = getTile(start.x, start.y, start.z);
-			if (tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
+			if (isProjectileBlocked(start.x, start.y, start.z)) {
 				return false;
 			}
 		}
@@ -538,8 +596,7 @@ bool Map::checkSightLine(Position start, Position destination) {
 					xIncrease = deltaX;
 				}
 
-				const auto &tile = getTile(start.x + xIncrease, start.y + deltaY, start.z);
-				if (tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
+				if (isProjectileBlocked(start.x + xIncrease, start.y + deltaY, start.z)) {
 					if (Position::areInRange<1, 1>(start, destination)) {
 						return true;
 					}
@@ -569,8 +626,7 @@ bool Map::checkSightLine(Position start, Position destination) {
 					yIncrease = deltaY;
 				}
 
-				const auto &tile = getTile(start.x + deltaX, start.y + yIncrease, start.z);
-				if (tile && tile->hasProperty(CONST_PROP_BLOCKPROJECTILE)) {
+				if (isProjectileBlocked(start.x + deltaX, start.y + yIncrease, start.z)) {
 					if (Position::areInRange<1, 1>(start, destination)) {
 						return true;
 					}
@@ -636,10 +692,23 @@ bool Map::isSightClear(const Position &fromPos, const Position &toPos, bool floo
 }
 
 std::shared_ptr<Tile> Map::canWalkTo(const std::shared_ptr<Creature> &creature, const Position &pos) {
+	if (!creature) {
+		return nullptr;
+	}
+
+	return canWalkTo(creature, pos, getPathBlockingFlags(creature));
+}
+
+std::shared_ptr<Tile> Map::canWalkTo(const std::shared_ptr<Creature> &creature, const Position &pos, uint8_t blockingFlags) {
 	if (!creature || creature->isRemoved()) {
 		return nullptr;
 	}
 
+	// The tile the creature stands on is always accepted
+	if ((getWalkability(pos.x, pos.y, pos.z) & blockingFlags) && pos != creature->getPosition()) {
+		return nullptr;
+	}
+
 	const auto &tile = getTile(pos.x, pos.y, pos.z);
 	if (creature->getTile() != tile) {
 		if (!tile || tile->queryAdd(0, creature, 1, FLAG_PATHFINDING | FLAG_IGNOREFIELDDAMAGE) != RETURNVALUE_NOERROR) {
@@ -650,6 +719,24 @@ std::shared_ptr<Tile> Map::canWalkTo(const std::shared_ptr<Creature> &creature,
 	return tile;
 }
 
+uint8_t Map::getPathBlockingFlags(const std::shared_ptr<Creature> &creature) {
+	uint8_t blockingFlags = WALKABILITY_NOPATH;
+	if (const auto &monster = creature->getMonster()) {
+		if (!monster->isFamiliar()) {
+			blockingFlags |= WALKABILITY_PROTECTIONZONE;
+		}
+		if (!monster->canPushItems()) {
+			blockingFlags |= WALKABILITY_BLOCKSOLID;
+		}
+	} else if (creature->getPlayer()) {
+		// Safe magic walls and wild growths let players through solid tiles
+		blockingFlags |= WALKABILITY_BLOCKPATH;
+	} else {
+		blockingFlags |= WALKABILITY_BLOCKSOLID;
+	}
+	return blockingFlags;
+}
+
 bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Position &_targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp) {
 	static int_fast32_t allNeighbors[8][2] = {
 		{ -1, 0 }, { 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 }
@@ -667,6 +754,7 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Posit
 	};
 
 	const bool withoutCreature = creature == nullptr;
+	const uint8_t blockingFlags = withoutCreature ? WALKABILITY_NONE : getPathBlockingFlags(creature);
 
 	Position pos = withoutCreature ? _targetPos : creature->getPosition();
 	Position endPos;
@@ -751,7 +839,7 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Posit
 			if (neighborNode) {
 				extraCost = neighborNode->c;
 			} else {
-				const auto &tile = withoutCreature ? getTile(pos.x, pos.y, pos.z) : canWalkTo(creature, pos);
+				const auto &tile = withoutCreature ? getTile(pos.x, pos.y, pos.z) : canWalkTo(creature, pos, blockingFlags);
 				if (!tile) {
 					continue;
 				}
@@ -835,6 +923,7 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, std::vector
 
 bool Map::getPathMatchingCond(const std::shared_ptr<Creature> &creature, const Position &targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp) {
 	Position pos = creature->getPosition();
+	const uint8_t blockingFlags = getPathBlockingFlags(creature);
 	Position endPos;
 
 	AStarNodes nodes(pos.x, pos.y, AStarNodes::getTileWalkCost(creature, getTile(pos.x, pos.y, pos.z)));
@@ -938,7 +1027,7 @@ bool Map::getPathMatchingCond(const std::shared_ptr<Creature> &creature, const P
 			if (neighborNode) {
 				extraCost = neighborNode->c;
 			} else {
-				const auto &tile = Map::canWalkTo(creature, pos);
+				const auto &tile = Map::canWalkTo(creature, pos, blockingFlags);
 				if (!tile) {
 					continue;
 				}
@@ -1017,6 +1106,42 @@ bool Map::getPathMatchingCond(const std::shared_ptr<Creature> &creature, const P
 	return true;
 }
 
+std::optional<bool> Map::getSharedFollowPath(const std::shared_ptr<Monster> &monster, const Position &targetPos, std::vector<Direction> &dirList, const FindPathParams &fpp) {
+	// The map is only guaranteed not to change within a batch of parallel events,
+	// and only melee chasers share a goal: any tile next to the target
+	if (!g_dispatcher().context().isAsync() || monster->isSummon() || fpp.keepDistance || !fpp.fullPathSearch || fpp.minTargetDist != 1 || fpp.maxTargetDist != 1) {
+		return std::nullopt;
+	}
+
+	const auto &startPos = monster->getPosition();
+	if (startPos.z != targetPos.z || Position::getDistanceX(startPos, targetPos) > FlowField::RADIUS || Position::getDistanceY(startPos, targetPos) > FlowField::RADIUS) {
+		return std::nullopt;
+	}
+
+	const uint8_t blockingFlags = getPathBlockingFlags(monster);
+	const auto &field = flowFields.get(g_dispatcher().getAsyncBatch(), targetPos, monster->getMonsterType().get(), [&](FlowField &newField) {
+		newField.build(targetPos, [&](const Position &pos) {
+			// Same test as canWalkTo, except that the tile of the monster building the field blocks like any other
+			if (getWalkability(pos.x, pos.y, pos.z) & blockingFlags) {
+				return FlowField::NOT_WALKABLE;
+			}
+
+			const auto &tile = getTile(pos);
+			if (!tile || tile->queryAdd(0, monster, 1, FLAG_PATHFINDING | FLAG_IGNOREFIELDDAMAGE) != RETURNVALUE_NOERROR) {
+				return FlowField::NOT_WALKABLE;
+			}
+			return static_cast<int32_t>(AStarNodes::getTileWalkCost(monster, tile));
+		});
+	});
+	if (!field) {
+		return std::nullopt;
+	}
+
+	return field->getPath(
+		startPos, dirList, [&](const Position &pos) { return canWalkTo(monster, pos, blockingFlags) != nullptr; }, fpp.maxSearchDist
+	);
+}
+
 uint32_t Map::clean() const {
 	const uint64_t start = OTSYS_TIME();
 	size_t qntTiles = 0;
@@ -14,14 +14,17 @@
 #include "map/house/house.hpp"
 #include "creatures/monsters/spawns/spawn_monster.hpp"
 #include "creatures/npcs/spawns/spawn_npc.hpp"
+#include "map/utils/flowfield.hpp"
 
 class Creature;
+class Monster;
 class Player;
 class Game;
 class Tile;
 class Map;
 
 struct FindPathParams;
+struct HouseItemsSnapshot;
 
 class FrozenPathingConditionCall;
 
@@ -68,6 +71,11 @@ public:
 	 * \returns true if the map was saved successfully
 	 */
 	static bool save();
+	/**
+	 * Save a map with the house items serialised beforehand by IOMapSerialize::snapshotHouseItems,
+	 * may be called from any thread.
+	 */
+	static bool save(const HouseItemsSnapshot &houseItems);
 
 	/**
 	 * Get a single tile.
@@ -78,6 +86,18 @@ public:
 		return getTile(pos.x, pos.y, pos.z);
 	}
 
+	/**
+	 * Get a single tile without locking or taking a reference.
+	 * \returns A pointer to that tile, valid until the current dispatcher task returns.
+	 */
+	Tile* borrowTile(uint16_t x, uint16_t y, uint8_t z);
+
+	/**
+	 * Walkability bits (WalkabilityFlags_t) of a position, read from the bitmap of its floor without touching the tile.
+	 * \returns WALKABILITY_NOPATH where there is no floor, only WALKABILITY_UNLOADED while the tile is still in the map cache
+	 */
+	uint8_t getWalkability(uint16_t x, uint16_t y, uint8_t z) const;
+
 	void refreshZones(uint16_t x, uint16_t y, uint8_t z);
 	void refreshZones(const Position &pos) {
 		refreshZones(pos.x, pos.y, pos.z);
@@ -121,6 +141,16 @@ public:
 	bool checkSightLine(Position start, Position destination);
 
 	std::shared_ptr<Tile> canWalkTo(const std::shared_ptr<Creature> &creature, const Position &pos);
+	/**
+	 * Same as above, positions with any of the walkability bits 'blockingFlags' are refused without touching their tile.
+	 * Searches testing many positions for one creature compute the bits once with getPathBlockingFlags.
+	 */
+	std::shared_ptr<Tile> canWalkTo(const std::shared_ptr<Creature> &creature, const Position &pos, uint8_t blockingFlags);
+
+	/**
+	 * Walkability bits that make Tile::queryAdd refuse the creature while pathfinding, whatever else is on the tile.
+	 */
+	static uint8_t getPathBlockingFlags(const std::shared_ptr<Creature> &creature);
 
 	bool getPathMatching(const std::shared_ptr<Creature> &creature, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp);
 	bool getPathMatching(const std::shared_ptr<Creature> &creature, const Position &targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp);
@@ -130,6 +160,13 @@ public:
 		return getPathMatching(nullptr, startPos, dirList, pathCondition, fpp);
 	}
 
+	/**
+	 * Path of a monster closing in on targetPos for melee, read from the flow field shared by every
+	 * monster of its type chasing the same position in the current batch of parallel events.
+	 * \returns whether there is a path, nothing when the shared field can't tell and the monster has to run its own search
+	 */
+	std::optional<bool> getSharedFollowPath(const std::shared_ptr<Monster> &monster, const Position &targetPos, std::vector<Direction> &dirList, const FindPathParams &fpp);
+
 	std::map<std::string, Position> waypoints;
 
 	// Storage made by "loadFromXML" of houses, monsters and npcs for main map
@@ -153,6 +190,10 @@ private:
 	}
 	std::shared_ptr<Tile> getLoadedTile(uint16_t x, uint16_t y, uint8_t z);
 
+	bool isProjectileBlocked(uint16_t x, uint16_t y, uint8_t z);
+	// Whether a tile from fromX to toX (inclusive) of the row blocks projectiles
+	bool isProjectileBlocked(uint16_t fromX, uint16_t toX, uint16_t y, uint8_t z);
+
 	std::filesystem::path path;
 	std::string monsterfile;
 	std::string housefile;
@@ -162,6 +203,8 @@ private:
 	uint32_t width = 0;
 	uint32_t height = 0;
 
+	FlowFieldCache flowFields;
+
 	friend class Game;
 	friend class IOMap;
 	friend class MapCache;
@@ -99,14 +99,14 @@ std::shared_ptr<Item> MapCache::createItem(const std::shared_ptr<BasicItem> &Bas
 	return item;
 }
 
-std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(const std::shared_ptr<Floor> &floor, uint16_t x, uint16_t y) {
-	const auto &cachedTile = floor->getTileCache(x, y);
-	const auto oldTile = floor->getTile(x, y);
+std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(Floor &floor, uint16_t x, uint16_t y) {
+	const auto &cachedTile = floor.getTileCache(x, y);
+	const auto oldTile = floor.getTile(x, y);
 	if (!cachedTile) {
 		return oldTile;
 	}
 
-	const uint8_t z = floor->getZ();
+	const uint8_t z = floor.getZ();
 	const auto map = dynamic_cast<Map*>(this);
 
 	std::vector<std::shared_ptr<Creature>> oldCreatureList;
@@ -157,10 +157,10 @@ std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(const std::shared_ptr<F
 		}
 	});
 
-	floor->setTile(x, y, tile);
+	floor.setTile(x, y, tile);
 
 	// Remove Tile from cache
-	floor->setTileCache(x, y, nullptr);
+	floor.setTileCache(x, y, nullptr);
 
 	return tile;
 }
@@ -184,14 +184,12 @@ std::shared_ptr<BasicItem> MapCache::tryReplaceItemFromCache(const std::shared_p
 }
 
 MapSector* MapCache::createMapSector(const uint32_t x, const uint32_t y) {
-	const uint32_t index = x / SECTOR_SIZE | y / SECTOR_SIZE << 16;
-	const auto it = mapSectors.find(index);
-	if (it != mapSectors.end()) {
-		return &it->second;
+	bool created = false;
+	const auto sector = mapSectors.findOrCreate(x, y, created);
+	if (created) {
+		MapSector::newSector = true;
 	}
-
-	MapSector::newSector = true;
-	return &mapSectors[index];
+	return sector;
 }
 
 MapSector* MapCache::getBestMapSector(uint32_t x, uint32_t y) {
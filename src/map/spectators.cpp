@@ -11,8 +11,10 @@
 
 #include "creatures/creature.hpp"
 #include "game/game.hpp"
+#include "lib/metrics/metrics.hpp"
 
 phmap::flat_hash_map<Position, SpectatorsCache> Spectators::spectatorsCache;
+uint64_t Spectators::cacheEpoch = 0;
 
 void Spectators::clearCache() {
 	spectatorsCache.clear();
@@ -58,15 +60,15 @@ bool Spectators::checkCache(const SpectatorsCache::FloorData &specData, bool onl
 		spectators.reserve(creatures.size());
 		for (const auto &creature : *list) {
 			const auto &specPos = creature->getPosition();
-			if ((centerPos.x - specPos.x >= minRangeX
-			         && centerPos.y - specPos.y >= minRangeY
-			         && centerPos.x - specPos.x <= maxRangeX
-			         && centerPos.y - specPos.y <= maxRangeY
-			         && (multifloor || specPos.z == centerPos.z)
-			         && ((onlyPlayers && creature->getPlayer())
-			             || (onlyMonsters && creature->getMonster())
-			             || (onlyNpcs && creature->getNpc()))
-			     || (!onlyPlayers && !onlyMonsters && !onlyNpcs))) {
+			if (centerPos.x - specPos.x >= minRangeX
+			    && centerPos.y - specPos.y >= minRangeY
+			    && centerPos.x - specPos.x <= maxRangeX
+			    && centerPos.y - specPos.y <= maxRangeY
+			    && (multifloor || specPos.z == centerPos.z)
+			    && ((onlyPlayers && creature->getPlayer())
+			        || (onlyMonsters && creature->getMonster())
+			        || (onlyNpcs && creature->getNpc())
+			        || (!onlyPlayers && !onlyMonsters && !onlyNpcs))) {
 				spectators.emplace_back(creature);
 			}
 		}
@@ -78,7 +80,7 @@ bool Spectators::checkCache(const SpectatorsCache::FloorData &specData, bool onl
 	return true;
 }
 
-CreatureVector Spectators::getSpectators(const Position &centerPos, bool multifloor, bool onlyPlayers, bool onlyMonsters, bool onlyNpcs, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
+std::pair<uint8_t, uint8_t> Spectators::getFloorRange(const Position &centerPos, bool multifloor) {
 	uint8_t minRangeZ = centerPos.z;
 	uint8_t maxRangeZ = centerPos.z;
 
@@ -98,6 +100,29 @@ CreatureVector Spectators::getSpectators(const Position &centerPos, bool multifl
 		}
 	}
 
+	return { minRangeZ, maxRangeZ };
+}
+
+SpectatorsCache::SectorBounds Spectators::getSectorBounds(const Position &centerPos, uint8_t minRangeZ, uint8_t maxRangeZ, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
+	const int32_t minoffset = centerPos.getZ() - maxRangeZ;
+	const int32_t x1 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, centerPos.x + minRangeX + minoffset));
+	const int32_t y1 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, centerPos.y + minRangeY + minoffset));
+
+	const int32_t maxoffset = centerPos.getZ() - minRangeZ;
+	const int32_t x2 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, centerPos.x + maxRangeX + maxoffset));
+	const int32_t y2 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, centerPos.y + maxRangeY + maxoffset));
+
+	return {
+		.startX = x1 - (x1 & SECTOR_MASK),
+		.startY = y1 - (y1 & SECTOR_MASK),
+		.endX = x2 - (x2 & SECTOR_MASK),
+		.endY = y2 - (y2 & SECTOR_MASK),
+	};
+}
+
+CreatureVector Spectators::getSpectators(const Position &centerPos, bool multifloor, bool onlyPlayers, bool onlyMonsters, bool onlyNpcs, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
+	const auto [minRangeZ, maxRangeZ] = getFloorRange(centerPos, multifloor);
+
 	const int32_t min_y = centerPos.y + minRangeY;
 	const int32_t min_x = centerPos.x + minRangeX;
 	const int32_t max_y = centerPos.y + maxRangeY;
@@ -107,18 +132,9 @@ CreatureVector Spectators::getSpectators(const Position &centerPos, bool multifl
 	const auto height = static_cast<uint32_t>(max_y - min_y);
 	const auto depth = static_cast<uint32_t>(maxRangeZ - minRangeZ);
 
-	const int32_t minoffset = centerPos.getZ() - maxRangeZ;
-	const int32_t x1 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, min_x + minoffset));
-	const int32_t y1 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, min_y + minoffset));
+	const auto [startx1, starty1, endx2, endy2] = getSectorBounds(centerPos, minRangeZ, maxRangeZ, minRangeX, maxRangeX, minRangeY, maxRangeY);
 
-	const int32_t maxoffset = centerPos.getZ() - minRangeZ;
-	const int32_t x2 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, max_x + maxoffset));
-	const int32_t y2 = std::min<int32_t>(0xFFFF, std::max<int32_t>(0, max_y + maxoffset));
-
-	const int32_t startx1 = x1 - (x1 & SECTOR_MASK);
-	const int32_t starty1 = y1 - (y1 & SECTOR_MASK);
-	const int32_t endx2 = x2 - (x2 & SECTOR_MASK);
-	const int32_t endy2 = y2 - (y2 & SECTOR_MASK);
+	const SectorRange range { min_x, min_y, static_cast<int32_t>(width), static_cast<int32_t>(height), minRangeZ, static_cast<int32_t>(depth), centerPos.getZ() };
 
 	CreatureVector spectators;
 	spectators.reserve(std::max<uint8_t>(MAP_MAX_VIEW_PORT_X, MAP_MAX_VIEW_PORT_Y) * 2);
@@ -129,20 +145,12 @@ CreatureVector Spectators::getSpectators(const Position &centerPos, bool multifl
 		const MapSector* sectorE = sectorS;
 		for (int32_t nx = startx1; nx <= endx2; nx += SECTOR_SIZE) {
 			if (sectorE) {
-				const auto &nodeList = onlyPlayers ? sectorE->player_list
-					: onlyMonsters                 ? sectorE->monster_list
-					: onlyNpcs                     ? sectorE->npc_list
-												   : sectorE->creature_list;
-
-				for (const auto &creature : nodeList) {
-					const auto &cpos = creature->getPosition();
-					if (static_cast<uint32_t>(static_cast<int32_t>(cpos.z) - minRangeZ) <= depth) {
-						const int_fast16_t offsetZ = Position::getOffsetZ(centerPos, cpos);
-						if (static_cast<uint32_t>(cpos.x - offsetZ - min_x) <= width && static_cast<uint32_t>(cpos.y - offsetZ - min_y) <= height) {
-							spectators.emplace_back(creature);
-						}
-					}
-				}
+				const auto &bucket = onlyPlayers ? sectorE->player_list
+					: onlyMonsters               ? sectorE->monster_list
+					: onlyNpcs                   ? sectorE->npc_list
+												 : sectorE->creature_list;
+
+				bucket.findInRange(range, spectators);
 				sectorE = sectorE->sectorE;
 			} else {
 				sectorE = g_game().map.getMapSector(nx + SECTOR_SIZE, ny);
@@ -159,6 +167,73 @@ CreatureVector Spectators::getSpectators(const Position &centerPos, bool multifl
 	return spectators;
 }
 
+bool Spectators::isCacheValid(const SpectatorsCache &cache) {
+	const auto &[startX, startY, endX, endY] = cache.sectors;
+
+	const MapSector* sectorS = g_game().map.getMapSector(startX, startY);
+	for (int32_t ny = startY; ny <= endY; ny += SECTOR_SIZE) {
+		const MapSector* sectorE = sectorS;
+		for (int32_t nx = startX; nx <= endX; nx += SECTOR_SIZE) {
+			if (sectorE) {
+				if (sectorE->spectatorsEpoch > cache.epoch) {
+					return false;
+				}
+				sectorE = sectorE->sectorE;
+			} else {
+				sectorE = g_game().map.getMapSector(nx + SECTOR_SIZE, ny);
+			}
+		}
+
+		if (sectorS) {
+			sectorS = sectorS->sectorS;
+		} else {
+			sectorS = g_game().map.getMapSector(startX, ny + SECTOR_SIZE);
+		}
+	}
+
+	return true;
+}
+
+void Spectators::resetCache(SpectatorsCache &cache, const Position &centerPos, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
+	// The multifloor area contains the single floor one, so the same sectors cover both lists
+	const auto [minRangeZ, maxRangeZ] = getFloorRange(centerPos, true);
+	cache = SpectatorsCache {
+		.minRangeX = minRangeX,
+		.maxRangeX = maxRangeX,
+		.minRangeY = minRangeY,
+		.maxRangeY = maxRangeY,
+		.creatures = {},
+		.monsters = {},
+		.npcs = {},
+		.players = {},
+		.sectors = getSectorBounds(centerPos, minRangeZ, maxRangeZ, minRangeX, maxRangeX, minRangeY, maxRangeY),
+		.epoch = cacheEpoch,
+	};
+}
+
+void Spectators::invalidateCache(const Position &pos) {
+	if (const auto sector = g_game().map.getMapSector(pos.x, pos.y)) {
+		sector->spectatorsEpoch = ++cacheEpoch;
+	}
+}
+
+void Spectators::recordCacheQuery([[maybe_unused]] bool hit, [[maybe_unused]] std::chrono::steady_clock::time_point begin) {
+#ifdef FEATURE_METRICS
+	const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+	g_metrics().recordHistogram("spectators_latency", static_cast<double>(elapsed) / 1000, { { "result", hit ? "hit" : "miss" } });
+
+	// Counters take a lock, they are flushed in batches
+	static uint32_t hits = 0;
+	static uint32_t misses = 0;
+	++(hit ? hits : misses);
+	if (hits + misses >= CACHE_METRICS_BATCH) {
+		g_metrics().addCounter("spectators_cache_hits", hits);
+		g_metrics().addCounter("spectators_cache_misses", misses);
+		hits = misses = 0;
+	}
+#endif
+}
+
 Spectators Spectators::find(const Position &centerPos, bool multifloor, bool onlyPlayers, bool onlyMonsters, bool onlyNpcs, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY, bool useCache) {
 	minRangeX = (minRangeX == 0 ? -MAP_MAX_VIEW_PORT_X : -minRangeX);
 	maxRangeX = (maxRangeX == 0 ? MAP_MAX_VIEW_PORT_X : maxRangeX);
@@ -170,47 +245,57 @@ Spectators Spectators::find(const Position &centerPos, bool multifloor, bool onl
 		return *this;
 	}
 
-	const auto &it = spectatorsCache.find(centerPos);
-	const bool cacheFound = it != spectatorsCache.end();
-	if (cacheFound) {
-		auto &cache = it->second;
-		if (minRangeX < cache.minRangeX || maxRangeX > cache.maxRangeX || minRangeY < cache.minRangeY || maxRangeY > cache.maxRangeY) {
-			// recache with new range
-			cache.minRangeX = minRangeX = std::min<int32_t>(minRangeX, cache.minRangeX);
-			cache.minRangeY = minRangeY = std::min<int32_t>(minRangeY, cache.minRangeY);
-			cache.maxRangeX = maxRangeX = std::max<int32_t>(maxRangeX, cache.maxRangeX);
-			cache.maxRangeY = maxRangeY = std::max<int32_t>(maxRangeY, cache.maxRangeY);
-		} else {
-			const bool checkDistance = minRangeX != cache.minRangeX || maxRangeX != cache.maxRangeX || minRangeY != cache.minRangeY || maxRangeY != cache.maxRangeY;
+	const auto begin = std::chrono::steady_clock::now();
 
-			if (onlyPlayers || onlyMonsters || onlyNpcs) {
-				static const SpectatorsCache::FloorData EMPTY_FLOOR_DATA;
+	auto it = spectatorsCache.find(centerPos);
+	if (it == spectatorsCache.end()) {
+		if (spectatorsCache.size() >= CACHE_MAX_ENTRIES) {
+			// Stale entries are only refreshed when their position is queried again, drop them before growing further
+			phmap::erase_if(spectatorsCache, [](const auto &entry) { return !isCacheValid(entry.second); });
+			if (spectatorsCache.size() >= CACHE_MAX_ENTRIES) {
+				spectatorsCache.clear();
+			}
+		}
 
-				const auto &creaturesCache = onlyPlayers ? cache.players
-					: onlyMonsters                       ? cache.monsters
-					: onlyNpcs                           ? cache.npcs
-														 : EMPTY_FLOOR_DATA;
+		// It is necessary to create the cache even if no spectators is found, so that there is no future query.
+		it = spectatorsCache.try_emplace(centerPos).first;
+		resetCache(it->second, centerPos, minRangeX, maxRangeX, minRangeY, maxRangeY);
+	} else if (auto &cache = it->second; minRangeX < cache.minRangeX || maxRangeX > cache.maxRangeX || minRangeY < cache.minRangeY || maxRangeY > cache.maxRangeY) {
+		// recache with new range, the lists collected with the smaller one can no longer be trusted
+		resetCache(cache, centerPos, std::min<int32_t>(minRangeX, cache.minRangeX), std::max<int32_t>(maxRangeX, cache.maxRangeX), std::min<int32_t>(minRangeY, cache.minRangeY), std::max<int32_t>(maxRangeY, cache.maxRangeY));
+	} else if (!isCacheValid(cache)) {
+		// A creature entered or left one of the covered sectors
+		resetCache(cache, centerPos, cache.minRangeX, cache.maxRangeX, cache.minRangeY, cache.maxRangeY);
+	} else {
+		const bool checkDistance = minRangeX != cache.minRangeX || maxRangeX != cache.maxRangeX || minRangeY != cache.minRangeY || maxRangeY != cache.maxRangeY;
 
-				// check players/monsters/npcs cache
-				if (checkCache(creaturesCache, onlyPlayers, onlyMonsters, onlyNpcs, centerPos, checkDistance, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)) {
-					return *this;
-				}
+		bool found = false;
+		if (onlyPlayers || onlyMonsters || onlyNpcs) {
+			static const SpectatorsCache::FloorData EMPTY_FLOOR_DATA;
 
-				// if there is no players/monsters/npcs cache, look for players/monsters/npcs in the creatures cache.
-				if (checkCache(cache.creatures, onlyPlayers, onlyMonsters, onlyNpcs, centerPos, true, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)) {
-					return *this;
-				}
-				// All Creatures
-			} else if (checkCache(cache.creatures, false, false, false, centerPos, checkDistance, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)) {
-				return *this;
-			}
+			const auto &creaturesCache = onlyPlayers ? cache.players
+				: onlyMonsters                       ? cache.monsters
+				: onlyNpcs                           ? cache.npcs
+													 : EMPTY_FLOOR_DATA;
+
+			// check players/monsters/npcs cache, if there is none, look for players/monsters/npcs in the creatures cache.
+			found = checkCache(creaturesCache, onlyPlayers, onlyMonsters, onlyNpcs, centerPos, checkDistance, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)
+				|| checkCache(cache.creatures, onlyPlayers, onlyMonsters, onlyNpcs, centerPos, true, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY);
+			// All Creatures
+		} else {
+			found = checkCache(cache.creatures, false, false, false, centerPos, checkDistance, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY);
+		}
+
+		if (found) {
+			recordCacheQuery(true, begin);
+			return *this;
 		}
 	}
 
-	const auto &spectators = getSpectators(centerPos, multifloor, onlyPlayers, onlyMonsters, onlyNpcs, minRangeX, maxRangeX, minRangeY, maxRangeY);
+	// The cached lists always hold the whole cached range, the query range is applied afterwards
+	auto &cache = it->second;
+	const auto &spectators = getSpectators(centerPos, multifloor, onlyPlayers, onlyMonsters, onlyNpcs, cache.minRangeX, cache.maxRangeX, cache.minRangeY, cache.maxRangeY);
 
-	// It is necessary to create the cache even if no spectators is found, so that there is no future query.
-	auto &cache = cacheFound ? it->second : spectatorsCache.emplace(centerPos, SpectatorsCache { .minRangeX = minRangeX, .maxRangeX = maxRangeX, .minRangeY = minRangeY, .maxRangeY = maxRangeY, .creatures = {}, .monsters = {}, .npcs = {}, .players = {} }).first->second;
 	auto &creaturesCache = onlyPlayers ? cache.players
 		: onlyMonsters                 ? cache.monsters
 		: onlyNpcs                     ? cache.npcs
@@ -223,11 +308,16 @@ Spectators Spectators::find(const Position &centerPos, bool multifloor, bool onl
 	}
 
 	if (!spectators.empty()) {
-		insertAll(spectators);
-
 		creatureList->insert(creatureList->end(), spectators.begin(), spectators.end());
+
+		if (minRangeX != cache.minRangeX || maxRangeX != cache.maxRangeX || minRangeY != cache.minRangeY || maxRangeY != cache.maxRangeY) {
+			checkCache(creaturesCache, onlyPlayers, onlyMonsters, onlyNpcs, centerPos, true, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY);
+		} else {
+			insertAll(spectators);
+		}
 	}
 
+	recordCacheQuery(false, begin);
 	return *this;
 }
 
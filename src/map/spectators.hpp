@@ -24,6 +24,14 @@ struct SpectatorsCache {
 		std::optional<CreatureVector> multiFloor;
 	};
 
+	// Corners of the sector area the lists were collected from
+	struct SectorBounds {
+		int32_t startX { 0 };
+		int32_t startY { 0 };
+		int32_t endX { 0 };
+		int32_t endY { 0 };
+	};
+
 	int32_t minRangeX { 0 };
 	int32_t maxRangeX { 0 };
 	int32_t minRangeY { 0 };
@@ -33,12 +41,22 @@ struct SpectatorsCache {
 	FloorData monsters;
 	FloorData npcs;
 	FloorData players;
+
+	SectorBounds sectors;
+	// Invalidation epoch the lists were collected at, a covered sector changed after it makes them stale
+	uint64_t epoch { 0 };
 };
 
 class Spectators {
 public:
 	static void clearCache();
 
+	/**
+	 * Marks the sector of the position as changed, cached viewports covering it are rebuilt on their next lookup.
+	 * Called whenever a creature enters or leaves a tile.
+	 */
+	static void invalidateCache(const Position &pos);
+
 	template <typename T>
 		requires std::is_base_of_v<Creature, T>
 	Spectators find(const Position &centerPos, bool multifloor = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0, bool useCache = true) {
@@ -95,7 +113,18 @@ public:
 	}
 
 private:
+	static constexpr size_t CACHE_MAX_ENTRIES = 8192;
+	static constexpr uint32_t CACHE_METRICS_BATCH = 1024;
+
 	static phmap::flat_hash_map<Position, SpectatorsCache> spectatorsCache;
+	static uint64_t cacheEpoch;
+
+	static std::pair<uint8_t, uint8_t> getFloorRange(const Position &centerPos, bool multifloor);
+	static SpectatorsCache::SectorBounds getSectorBounds(const Position &centerPos, uint8_t minRangeZ, uint8_t maxRangeZ, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY);
+
+	static bool isCacheValid(const SpectatorsCache &cache);
+	static void resetCache(SpectatorsCache &cache, const Position &centerPos, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY);
+	static void recordCacheQuery(bool hit, std::chrono::steady_clock::time_point begin);
 
 	Spectators find(const Position &centerPos, bool multifloor = false, bool onlyPlayers = false, bool onlyMonsters = false, bool onlyNpcs = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0, bool useCache = true);
 	CreatureVector getSpectators(const Position &centerPos, bool multifloor = false, bool onlyPlayers = false, bool onlyMonsters = false, bool onlyNpcs = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0);
@@ -0,0 +1,47 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "map/utils/flowfield.hpp"
+
+Direction FlowField::getDirection(int32_t dx, int32_t dy) {
+	if (dx == 0) {
+		return dy < 0 ? DIRECTION_NORTH : DIRECTION_SOUTH;
+	}
+	if (dy == 0) {
+		return dx < 0 ? DIRECTION_WEST : DIRECTION_EAST;
+	}
+	if (dy < 0) {
+		return dx < 0 ? DIRECTION_NORTHWEST : DIRECTION_NORTHEAST;
+	}
+	return dx < 0 ? DIRECTION_SOUTHWEST : DIRECTION_SOUTHEAST;
+}
+
+std::shared_ptr<const FlowField> FlowFieldCache::get(uint64_t batch, const Position &target, const void* walker, const std::function<void(FlowField &)> &build) {
+	std::shared_ptr<Entry> entry;
+	{
+		std::scoped_lock lock(mutex);
+		if (batch != currentBatch) {
+			// Fields of the previous batch are still held by whoever is using them
+			entries.clear();
+			currentBatch = batch;
+		}
+
+		auto &slot = entries[Key { target, walker }];
+		if (!slot) {
+			slot = std::make_shared<Entry>();
+		}
+		if (++slot->requests < MIN_SHARED_REQUESTS) {
+			return nullptr;
+		}
+		entry = slot;
+	}
+
+	std::call_once(entry->built, build, entry->field);
+	return { entry, &entry->field };
+}
@@ -0,0 +1,247 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/movement/position.hpp"
+
+/**
+ * Cost of walking to a tile next to a target from every tile around it (reverse Dijkstra),
+ * so every walker around the target gets its path from the same search.
+ * Costs are the ones A* uses in Map::getPathMatchingCond: 10 per straight step, 35 per diagonal
+ * step, plus the extra cost of every tile entered (AStarNodes::getTileWalkCost).
+ */
+class FlowField {
+public:
+	// Covers the whole search area (12 tiles around the walker, FindPathParams::maxSearchDist) of walkers up to 8 tiles away
+	static constexpr int32_t RADIUS = 20;
+	static constexpr int32_t SIZE = RADIUS * 2 + 1;
+	static constexpr int32_t NOT_WALKABLE = -1;
+	static constexpr uint32_t UNREACHABLE = std::numeric_limits<uint32_t>::max();
+
+	/**
+	 * tileCost(const Position &) returns the extra cost of entering the tile or NOT_WALKABLE,
+	 * it is asked at most once per tile and only for tiles the search reaches.
+	 */
+	template <typename TileCost>
+	void build(const Position &newTarget, TileCost &&tileCost) {
+		target = newTarget;
+		complete = true;
+		costs.fill(UNREACHABLE);
+		extraCosts.fill(UNKNOWN_COST);
+
+		size_t pending = 0;
+		for (const auto &[dx, dy] : NEIGHBORS) {
+			const auto index = indexOf(RADIUS + dx, RADIUS + dy);
+			if (getExtraCost(index, tileCost) != NOT_WALKABLE) {
+				costs[index] = 0;
+				buckets[0].emplace_back(static_cast<uint32_t>(index));
+				++pending;
+			}
+		}
+
+		// Dial's algorithm: no step costs more than BUCKETS, so the open tiles of every cost fit in a ring of buckets
+		for (uint32_t cost = 0; pending > 0; ++cost) {
+			auto &bucket = buckets[cost & (BUCKETS - 1)];
+			// Tiles are appended to the bucket being processed only by steps that cost nothing, which don't exist
+			for (const auto index : bucket) {
+				--pending;
+				if (cost != costs[index]) {
+					// Reached cheaper since it was queued
+					continue;
+				}
+
+				// Walking backwards: from the neighbour the walker enters this tile, paying for it
+				const auto enterCost = cost + static_cast<uint32_t>(extraCosts[index]);
+				const int32_t x = static_cast<int32_t>(index % SIZE);
+				const int32_t y = static_cast<int32_t>(index / SIZE);
+				for (const auto &[dx, dy] : NEIGHBORS) {
+					const int32_t nx = x + dx;
+					const int32_t ny = y + dy;
+					if (nx < 0 || ny < 0 || nx >= SIZE || ny >= SIZE) {
+						continue;
+					}
+
+					const auto neighbor = indexOf(nx, ny);
+					const auto newCost = enterCost + stepCost(dx, dy);
+					if (newCost >= costs[neighbor]) {
+						continue;
+					}
+
+					// Tiles that can't be walked keep their cost, the walker may stand on one (its own tile),
+					// but nothing is reached through them
+					costs[neighbor] = newCost;
+					if (getExtraCost(neighbor, tileCost) != NOT_WALKABLE) {
+						buckets[newCost & (BUCKETS - 1)].emplace_back(static_cast<uint32_t>(neighbor));
+						++pending;
+						complete = complete && nx != 0 && ny != 0 && nx != SIZE - 1 && ny != SIZE - 1;
+					}
+				}
+			}
+			bucket.clear();
+		}
+	}
+
+	/**
+	 * Steps from 'start' to a tile next to the target, always to the cheapest neighbour, without leaving
+	 * the area A* would search (maxSearchDist around start).
+	 * canStep(const Position &) is asked for every tile on the way, walkers that see the map
+	 * differently than the one the field was built for reject the path there.
+	 * \returns true with the path appended to dirList, false when there is no path in the search area,
+	 * nothing (dirList untouched) when the field can't tell and the walker has to search on its own
+	 */
+	template <typename CanStep>
+	std::optional<bool> getPath(const Position &start, std::vector<Direction> &dirList, CanStep &&canStep, int32_t maxSearchDist) const {
+		if (start.z != target.z || !contains(start)) {
+			return std::nullopt;
+		}
+
+		const auto firstStep = dirList.size();
+		int32_t x = start.x - target.x + RADIUS;
+		int32_t y = start.y - target.y + RADIUS;
+		while (std::max(std::abs(x - RADIUS), std::abs(y - RADIUS)) != 1) {
+			uint32_t bestCost = costs[indexOf(x, y)];
+			int32_t bestX = -1;
+			int32_t bestY = -1;
+			for (const auto &[dx, dy] : NEIGHBORS) {
+				const int32_t nx = x + dx;
+				const int32_t ny = y + dy;
+				if (nx < 0 || ny < 0 || nx >= SIZE || ny >= SIZE) {
+					continue;
+				}
+
+				const auto neighbor = indexOf(nx, ny);
+				if (costs[neighbor] == UNREACHABLE || extraCosts[neighbor] < 0) {
+					continue;
+				}
+
+				const auto cost = costs[neighbor] + static_cast<uint32_t>(extraCosts[neighbor]) + stepCost(dx, dy);
+				if (cost <= bestCost) {
+					bestCost = cost;
+					bestX = nx;
+					bestY = ny;
+				}
+			}
+
+			if (bestX == -1) {
+				// Only happens on the first step, nothing around the walker leads to the target.
+				// Unless the way runs outside of the field, where A* might still find it
+				if (complete || contains(start, maxSearchDist)) {
+					return false;
+				}
+				return std::nullopt;
+			}
+
+			const Position next(target.x + bestX - RADIUS, target.y + bestY - RADIUS, target.z);
+			if (Position::getDistanceX(start, next) > maxSearchDist || Position::getDistanceY(start, next) > maxSearchDist || !canStep(next)) {
+				dirList.resize(firstStep);
+				return std::nullopt;
+			}
+
+			dirList.emplace_back(getDirection(bestX - x, bestY - y));
+			x = bestX;
+			y = bestY;
+		}
+		return true;
+	}
+
+	const Position &getTarget() const {
+		return target;
+	}
+
+	bool contains(const Position &pos, int32_t margin = 0) const {
+		return std::abs(pos.x - target.x) + margin <= RADIUS && std::abs(pos.y - target.y) + margin <= RADIUS;
+	}
+
+private:
+	static constexpr int32_t UNKNOWN_COST = -2;
+	// Enough for a creature and a field on the same tile (AStarNodes::getTileWalkCost)
+	static constexpr int32_t MAX_EXTRA_COST = 220;
+	// Power of two above the most expensive step
+	static constexpr uint32_t BUCKETS = std::bit_ceil(static_cast<uint32_t>(MAX_EXTRA_COST) + 35 + 1);
+	static constexpr std::array<std::pair<int32_t, int32_t>, 8> NEIGHBORS { {
+		{ -1, 0 },
+		{ 0, 1 },
+		{ 1, 0 },
+		{ 0, -1 },
+		{ -1, -1 },
+		{ 1, -1 },
+		{ 1, 1 },
+		{ -1, 1 },
+	} };
+
+	static constexpr size_t indexOf(int32_t x, int32_t y) {
+		return static_cast<size_t>(y * SIZE + x);
+	}
+
+	static constexpr uint32_t stepCost(int32_t dx, int32_t dy) {
+		// Same as AStarNodes::getMapWalkCost
+		return dx != 0 && dy != 0 ? 35 : 10;
+	}
+
+	static Direction getDirection(int32_t dx, int32_t dy);
+
+	template <typename TileCost>
+	int32_t getExtraCost(size_t index, TileCost &tileCost) {
+		auto &extraCost = extraCosts[index];
+		if (extraCost == UNKNOWN_COST) {
+			const int32_t x = static_cast<int32_t>(index % SIZE);
+			const int32_t y = static_cast<int32_t>(index / SIZE);
+			extraCost = std::min(tileCost(Position(target.x + x - RADIUS, target.y + y - RADIUS, target.z)), MAX_EXTRA_COST);
+		}
+		return extraCost;
+	}
+
+	Position target;
+	// Whatever can be reached from the target is inside the field
+	bool complete = true;
+	std::array<uint32_t, SIZE * SIZE> costs {};
+	std::array<int32_t, SIZE * SIZE> extraCosts {};
+	std::array<std::vector<uint32_t>, BUCKETS> buckets;
+};
+
+/**
+ * Flow fields shared by the walkers chasing the same target during one batch of parallel events
+ * (the map doesn't change while it runs). A single walker is better off with its own search,
+ * so the field is only built, once, when a second walker asks for it, the others wait for it.
+ * Walkers only share a field when they see the map the same way ('walker', e.g. the monster type).
+ */
+class FlowFieldCache {
+public:
+	static constexpr uint32_t MIN_SHARED_REQUESTS = 2;
+
+	/**
+	 * \returns nullptr for the first walker asking in the batch
+	 */
+	std::shared_ptr<const FlowField> get(uint64_t batch, const Position &target, const void* walker, const std::function<void(FlowField &)> &build);
+
+private:
+	struct Key {
+		Position target;
+		const void* walker;
+
+		bool operator==(const Key &) const = default;
+	};
+
+	struct KeyHash {
+		size_t operator()(const Key &key) const {
+			return std::hash<uint64_t>()((static_cast<uint64_t>(key.target.x) << 24) | (static_cast<uint64_t>(key.target.y) << 8) | key.target.z) ^ std::hash<const void*>()(key.walker);
+		}
+	};
+
+	struct Entry {
+		std::once_flag built;
+		uint32_t requests = 0;
+		FlowField field;
+	};
+
+	std::mutex mutex;
+	uint64_t currentBatch = 0;
+	std::unordered_map<Key, std::shared_ptr<Entry>, KeyHash> entries;
+};
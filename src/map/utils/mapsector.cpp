@@ -10,60 +10,166 @@
 #include "map/utils/mapsector.hpp"
 
 #include "creatures/creature.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "items/tile.hpp"
 
 bool MapSector::newSector = false;
 
+void Floor::setTile(uint16_t x, uint16_t y, std::shared_ptr<Tile> tile) {
+	std::shared_ptr<Tile> replaced;
+	{
+		std::unique_lock<std::shared_mutex> ul(mutex);
+		auto &slot = tiles[x & SECTOR_MASK][y & SECTOR_MASK].first;
+		replaced = std::exchange(slot, std::move(tile));
+		tileRefs[x & SECTOR_MASK][y & SECTOR_MASK].store(slot.get(), std::memory_order_release);
+
+		if (replaced) {
+			replaced->setWalkabilityMap(nullptr);
+		}
+		if (slot) {
+			slot->setWalkabilityMap(&walkability);
+		} else {
+			walkability.set(x, y, WALKABILITY_NONE);
+		}
+	}
+
+	if (replaced) {
+		// The running task may still hold borrowed references to the old tile
+		g_dispatcher().addEvent([replaced = std::move(replaced)] { }, __FUNCTION__);
+	}
+}
+
+void SectorCreatures::add(const std::shared_ptr<Creature> &creature, const Position &pos) {
+	indexes.emplace(creature.get(), creatures.size());
+	creatures.emplace_back(creature);
+	xs.emplace_back(pos.x);
+	ys.emplace_back(pos.y);
+	zs.emplace_back(pos.z);
+}
+
+bool SectorCreatures::remove(const std::shared_ptr<Creature> &creature) {
+	const auto it = indexes.find(creature.get());
+	if (it == indexes.end()) {
+		return false;
+	}
+
+	const auto index = it->second;
+	indexes.erase(it);
+	if (index != creatures.size() - 1) {
+		creatures[index] = std::move(creatures.back());
+		xs[index] = xs.back();
+		ys[index] = ys.back();
+		zs[index] = zs.back();
+		indexes[creatures[index].get()] = index;
+	}
+	creatures.pop_back();
+	xs.pop_back();
+	ys.pop_back();
+	zs.pop_back();
+	return true;
+}
+
+void SectorCreatures::update(const std::shared_ptr<Creature> &creature, const Position &pos) {
+	const auto it = indexes.find(creature.get());
+	if (it == indexes.end()) {
+		return;
+	}
+
+	const auto index = it->second;
+	xs[index] = pos.x;
+	ys[index] = pos.y;
+	zs[index] = pos.z;
+}
+
+void SectorCreatures::findInRange(const SectorRange &range, CreatureVector &out) const {
+	// x - offsetZ - minX == x + z - (centerZ + minX), same for y
+	const int32_t baseX = range.centerZ + range.minX;
+	const int32_t baseY = range.centerZ + range.minY;
+
+	const size_t size = creatures.size();
+	size_t i = 0;
+#if defined(__SSE2__)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i minZ = _mm_set1_epi32(range.minZ);
+	const __m128i depth = _mm_set1_epi32(range.depth);
+	const __m128i minX = _mm_set1_epi32(baseX);
+	const __m128i width = _mm_set1_epi32(range.width);
+	const __m128i minY = _mm_set1_epi32(baseY);
+	const __m128i height = _mm_set1_epi32(range.height);
+
+	// Lanes outside [0, limit]
+	const auto outside = [zero](const __m128i value, const __m128i limit) {
+		return _mm_or_si128(_mm_cmplt_epi32(value, zero), _mm_cmpgt_epi32(value, limit));
+	};
+
+	for (; i + 4 <= size; i += 4) {
+		const __m128i z = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&zs[i])), zero);
+		const __m128i x = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&xs[i])), zero);
+		const __m128i y = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&ys[i])), zero);
+
+		__m128i rejected = outside(_mm_sub_epi32(z, minZ), depth);
+		rejected = _mm_or_si128(rejected, outside(_mm_sub_epi32(_mm_add_epi32(x, z), minX), width));
+		rejected = _mm_or_si128(rejected, outside(_mm_sub_epi32(_mm_add_epi32(y, z), minY), height));
+
+		auto mask = static_cast<uint32_t>(~_mm_movemask_ps(_mm_castsi128_ps(rejected)) & 0xF);
+		while (mask != 0) {
+			out.emplace_back(creatures[i + mm_ctz(mask)]);
+			mask &= mask - 1;
+		}
+	}
+#endif
+
+	for (; i < size; ++i) {
+		const int32_t z = zs[i];
+		if (static_cast<uint32_t>(z - range.minZ) <= static_cast<uint32_t>(range.depth)
+		    && static_cast<uint32_t>(xs[i] + z - baseX) <= static_cast<uint32_t>(range.width)
+		    && static_cast<uint32_t>(ys[i] + z - baseY) <= static_cast<uint32_t>(range.height)) {
+			out.emplace_back(creatures[i]);
+		}
+	}
+}
+
 void MapSector::addCreature(const std::shared_ptr<Creature> &c) {
-	creature_list.emplace_back(c);
+	const auto &pos = c->getPosition();
+	creature_list.add(c, pos);
 	if (c->getPlayer()) {
-		player_list.emplace_back(c);
+		player_list.add(c, pos);
 	} else if (c->getMonster()) {
-		monster_list.emplace_back(c);
+		monster_list.add(c, pos);
 	} else if (c->getNpc()) {
-		npc_list.emplace_back(c);
+		npc_list.add(c, pos);
 	}
 }
 
 void MapSector::removeCreature(const std::shared_ptr<Creature> &c) {
-	auto iter = std::ranges::find(creature_list, c);
-	if (iter == creature_list.end()) {
+	if (!creature_list.remove(c)) {
 		g_logger().error("[{}]: Creature not found in creature_list!", __FUNCTION__);
 		return;
 	}
 
-	assert(iter != creature_list.end());
-	*iter = creature_list.back();
-	creature_list.pop_back();
-
 	if (c->getPlayer()) {
-		iter = std::ranges::find(player_list, c);
-		if (iter == player_list.end()) {
+		if (!player_list.remove(c)) {
 			g_logger().error("[{}]: Player not found in player_list!", __FUNCTION__);
-			return;
 		}
-
-		assert(iter != player_list.end());
-		*iter = player_list.back();
-		player_list.pop_back();
 	} else if (c->getMonster()) {
-		iter = std::ranges::find(monster_list, c);
-		if (iter == monster_list.end()) {
-			g_logger().error("[{}]: Monster not found in player_list!", __FUNCTION__);
-			return;
+		if (!monster_list.remove(c)) {
+			g_logger().error("[{}]: Monster not found in monster_list!", __FUNCTION__);
 		}
-
-		assert(iter != monster_list.end());
-		*iter = monster_list.back();
-		monster_list.pop_back();
 	} else if (c->getNpc()) {
-		iter = std::ranges::find(npc_list, c);
-		if (iter == npc_list.end()) {
-			g_logger().error("[{}]: NPC not found in player_list!", __FUNCTION__);
-			return;
+		if (!npc_list.remove(c)) {
+			g_logger().error("[{}]: NPC not found in npc_list!", __FUNCTION__);
 		}
+	}
+}
 
-		assert(iter != npc_list.end());
-		*iter = npc_list.back();
-		npc_list.pop_back();
+void MapSector::updateCreature(const std::shared_ptr<Creature> &c) {
+	const auto &pos = c->getPosition();
+	creature_list.update(c, pos);
+	if (c->getPlayer()) {
+		player_list.update(c, pos);
+	} else if (c->getMonster()) {
+		monster_list.update(c, pos);
+	} else if (c->getNpc()) {
+		npc_list.update(c, pos);
 	}
 }
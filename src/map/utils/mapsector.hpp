@@ -10,10 +10,67 @@
 #pragma once
 
 #include "map/map_const.hpp"
+#include "map/utils/walkability.hpp"
 
 class Creature;
 class Tile;
 struct BasicTile;
+struct Position;
+
+using CreatureVector = std::vector<std::shared_ptr<Creature>>;
+
+/**
+ * Viewport tested by Spectators::getSpectators, a creature is inside when
+ * (z - minZ) <= depth, (x - offsetZ - minX) <= width and (y - offsetZ - minY) <= height,
+ * all compared as unsigned, offsetZ being centerZ - z.
+ */
+struct SectorRange {
+	int32_t minX = 0;
+	int32_t minY = 0;
+	int32_t width = 0;
+	int32_t height = 0;
+	int32_t minZ = 0;
+	int32_t depth = 0;
+	int32_t centerZ = 0;
+};
+
+/**
+ * Creatures of a sector with their coordinates mirrored in packed arrays (structure of arrays),
+ * so range queries only dereference the creatures that are actually in range.
+ * The coordinates are kept in sync by MapSector and Map::moveCreature.
+ */
+class SectorCreatures {
+public:
+	void add(const std::shared_ptr<Creature> &creature, const Position &pos);
+	bool remove(const std::shared_ptr<Creature> &creature);
+	void update(const std::shared_ptr<Creature> &creature, const Position &pos);
+
+	/**
+	 * Appends the creatures inside the range to 'out', in list order.
+	 */
+	void findInRange(const SectorRange &range, CreatureVector &out) const;
+
+	const CreatureVector &list() const {
+		return creatures;
+	}
+
+	bool empty() const {
+		return creatures.empty();
+	}
+
+	size_t size() const {
+		return creatures.size();
+	}
+
+private:
+	CreatureVector creatures;
+	std::vector<uint16_t> xs;
+	std::vector<uint16_t> ys;
+	std::vector<uint16_t> zs;
+
+	// Where each creature sits in the arrays, a creature stepping inside the sector doesn't scan the list
+	phmap::flat_hash_map<const Creature*, size_t> indexes;
+};
 
 struct Floor {
 	explicit Floor(uint8_t z) :
@@ -24,19 +81,41 @@ struct Floor {
 		return tiles[x & SECTOR_MASK][y & SECTOR_MASK].first;
 	}
 
-	void setTile(uint16_t x, uint16_t y, std::shared_ptr<Tile> tile) {
-		std::unique_lock<std::shared_mutex> ul(mutex);
-		tiles[x & SECTOR_MASK][y & SECTOR_MASK].first = std::move(tile);
+	/**
+	 * Lock-free lookup that does not touch the reference count.
+	 * The tile stays valid at least until the dispatcher task that borrowed it returns,
+	 * tiles replaced by setTile are released by a later task.
+	 */
+	Tile* borrowTile(uint16_t x, uint16_t y) const {
+		return tileRefs[x & SECTOR_MASK][y & SECTOR_MASK].load(std::memory_order_acquire);
 	}
 
+	void setTile(uint16_t x, uint16_t y, std::shared_ptr<Tile> tile);
+
 	std::shared_ptr<BasicTile> getTileCache(uint16_t x, uint16_t y) const {
 		std::shared_lock<std::shared_mutex> sl(mutex);
 		return tiles[x & SECTOR_MASK][y & SECTOR_MASK].second;
 	}
 
+	/**
+	 * Lock-free check for a tile that still has to be created from the map cache.
+	 */
+	bool hasTileCache(uint16_t x, uint16_t y) const {
+		return cachedTiles[x & SECTOR_MASK][y & SECTOR_MASK].load(std::memory_order_acquire);
+	}
+
 	void setTileCache(uint16_t x, uint16_t y, const std::shared_ptr<BasicTile> &newTile) {
 		std::unique_lock<std::shared_mutex> ul(mutex);
 		tiles[x & SECTOR_MASK][y & SECTOR_MASK].second = newTile;
+		cachedTiles[x & SECTOR_MASK][y & SECTOR_MASK].store(newTile != nullptr, std::memory_order_release);
+		walkability.setUnloaded(x, y, newTile != nullptr);
+	}
+
+	/**
+	 * Walkability bits of the tiles of the floor, read lock-free by pathfinding and sight lines.
+	 */
+	const WalkabilityMap &getWalkability() const {
+		return walkability;
 	}
 
 	const auto &getTiles() const {
@@ -51,6 +130,11 @@ struct Floor {
 private:
 	std::pair<std::shared_ptr<Tile>, std::shared_ptr<BasicTile>> tiles[SECTOR_SIZE][SECTOR_SIZE] = {};
 
+	// Read side of the tiles above, published by the writers once the owning pointers are in place
+	std::atomic<Tile*> tileRefs[SECTOR_SIZE][SECTOR_SIZE] = {};
+	std::atomic_bool cachedTiles[SECTOR_SIZE][SECTOR_SIZE] = {};
+	WalkabilityMap walkability;
+
 	mutable std::shared_mutex mutex;
 
 	uint8_t z { 0 };
@@ -73,6 +157,7 @@ public:
 		std::scoped_lock lock(floors_mutex);
 		if (!floors[z]) {
 			floors[z] = std::make_shared<Floor>(static_cast<uint8_t>(z));
+			floorRefs[z].store(floors[z].get(), std::memory_order_release);
 		}
 		return floors[z];
 	}
@@ -86,24 +171,43 @@ public:
 		return floors[z];
 	}
 
+	/**
+	 * Lock-free floor lookup, floors are never removed from a sector.
+	 */
+	Floor* borrowFloor(uint8_t z) const {
+		if (z >= MAP_MAX_LAYERS) {
+			return nullptr;
+		}
+		return floorRefs[z].load(std::memory_order_acquire);
+	}
+
 	void addCreature(const std::shared_ptr<Creature> &c);
 
 	void removeCreature(const std::shared_ptr<Creature> &c);
 
+	/**
+	 * Refreshes the indexed position of a creature that moved inside this sector.
+	 */
+	void updateCreature(const std::shared_ptr<Creature> &c);
+
 private:
 	static bool newSector;
 
 	MapSector* sectorS = nullptr;
 	MapSector* sectorE = nullptr;
 
-	std::vector<std::shared_ptr<Creature>> creature_list;
-	std::vector<std::shared_ptr<Creature>> player_list;
-	std::vector<std::shared_ptr<Creature>> monster_list;
-	std::vector<std::shared_ptr<Creature>> npc_list;
+	SectorCreatures creature_list;
+	SectorCreatures player_list;
+	SectorCreatures monster_list;
+	SectorCreatures npc_list;
+
+	// Spectators cache epoch of the last creature that entered or left the sector
+	uint64_t spectatorsEpoch = 0;
 
 	mutable std::mutex floors_mutex;
 
 	std::shared_ptr<Floor> floors[MAP_MAX_LAYERS] = {};
+	std::atomic<Floor*> floorRefs[MAP_MAX_LAYERS] = {};
 
 	uint32_t floorBits = 0;
 
@@ -0,0 +1,69 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "map/utils/pathfinder.hpp"
+
+#include "game/scheduling/dispatcher.hpp"
+
+void PathFinder::request(Search &&search, Callback &&callback, std::string_view context) {
+	std::scoped_lock lock(mutex);
+	pending.emplace_back(std::move(search), std::move(callback), context);
+
+	// Events added now run after the ones of the current cycle, every request until then joins the batch
+	if (!flushScheduled) {
+		flushScheduled = true;
+		dispatcher.addEvent([this] { flush(); }, "PathFinder::flush");
+	}
+}
+
+size_t PathFinder::flush() {
+	{
+		std::scoped_lock lock(mutex);
+		flushScheduled = false;
+		running.swap(pending);
+	}
+
+	const auto size = running.size();
+	if (size == 0) {
+		return 0;
+	}
+
+	if (deterministic) {
+		for (auto &request : running) {
+			request.found = request.search(request.dirList);
+		}
+
+		// Callbacks may request new paths, those go to the next batch
+		for (const auto &request : running) {
+			request.callback(request.found, request.dirList);
+		}
+	} else {
+		dispatcher.asyncWait(size, [this](size_t i) {
+			auto &request = running[i];
+			request.found = request.search(request.dirList);
+		});
+
+		for (auto &request : running) {
+			dispatcher.addEvent(
+				[callback = std::move(request.callback), found = request.found, dirList = std::move(request.dirList)] {
+					callback(found, dirList);
+				},
+				request.context
+			);
+		}
+	}
+
+	running.clear();
+	return size;
+}
+
+size_t PathFinder::getPendingRequests() const {
+	std::scoped_lock lock(mutex);
+	return pending.size();
+}
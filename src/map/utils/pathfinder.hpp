@@ -0,0 +1,74 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class Dispatcher;
+
+enum Direction : uint8_t;
+
+/**
+ * Path searches requested during a dispatcher cycle are batched and run together on the thread pool
+ * (Dispatcher::asyncWait) once the events of the cycle are done. Nothing changes the map while a batch runs,
+ * so every search of the batch sees the same tiles, and each result comes back to the dispatcher thread as an event.
+ */
+class PathFinder {
+public:
+	// Runs on a thread pool thread, it may only read the map and the creature it searches for
+	using Search = std::function<bool(std::vector<Direction> &dirList)>;
+	// Runs on the dispatcher thread
+	using Callback = std::function<void(bool found, const std::vector<Direction> &dirList)>;
+
+	explicit PathFinder(Dispatcher &dispatcher) :
+		dispatcher(dispatcher) { }
+
+	// Ensures that we don't accidentally copy it
+	PathFinder(const PathFinder &) = delete;
+	PathFinder &operator=(const PathFinder &) = delete;
+
+	void request(Search &&search, Callback &&callback, std::string_view context);
+
+	/**
+	 * Runs the pending searches, called by the event the first request of a cycle schedules.
+	 * \returns the number of searches run
+	 */
+	size_t flush();
+
+	/**
+	 * In deterministic mode (tests) the searches of a batch run one after another on the thread flushing,
+	 * then the callbacks are called right away, in the order the paths were requested.
+	 */
+	void setDeterministic(bool value) {
+		deterministic = value;
+	}
+	bool isDeterministic() const {
+		return deterministic;
+	}
+
+	size_t getPendingRequests() const;
+
+private:
+	struct Request {
+		Search search;
+		Callback callback;
+		std::string_view context;
+		std::vector<Direction> dirList;
+		bool found = false;
+	};
+
+	Dispatcher &dispatcher;
+
+	mutable std::mutex mutex;
+	std::vector<Request> pending;
+	bool flushScheduled = false;
+
+	// Only touched by the thread flushing
+	std::vector<Request> running;
+	bool deterministic = false;
+};
@@ -0,0 +1,56 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "map/utils/sectordirectory.hpp"
+
+#include "map/utils/mapsector.hpp"
+
+SectorDirectory::~SectorDirectory() {
+	for (auto &entry : root) {
+		const Block* block = entry.exchange(nullptr);
+		if (!block) {
+			continue;
+		}
+
+		for (auto &sector : block->sectors) {
+			delete sector.load();
+		}
+		delete block;
+	}
+}
+
+MapSector* SectorDirectory::findOrCreate(uint32_t x, uint32_t y, bool &created) {
+	created = false;
+	if (x > MAX_COORDINATE || y > MAX_COORDINATE) {
+		g_logger().error("[{}] coordinates {}, {} are outside of the map", __FUNCTION__, x, y);
+		return nullptr;
+	}
+
+	const uint32_t sectorX = x / SECTOR_SIZE;
+	const uint32_t sectorY = y / SECTOR_SIZE;
+
+	auto &blockEntry = root[(sectorY >> BLOCK_BITS) * ROOT_SIZE + (sectorX >> BLOCK_BITS)];
+	Block* block = blockEntry.load(std::memory_order_acquire);
+	if (!block) {
+		block = new Block();
+		blockEntry.store(block, std::memory_order_release);
+		++blockCount;
+	}
+
+	auto &sectorEntry = block->sectors[(sectorY & BLOCK_MASK) * BLOCK_SIZE + (sectorX & BLOCK_MASK)];
+	MapSector* sector = sectorEntry.load(std::memory_order_acquire);
+	if (!sector) {
+		sector = new MapSector();
+		sectorEntry.store(sector, std::memory_order_release);
+		++sectorCount;
+		created = true;
+	}
+
+	return sector;
+}
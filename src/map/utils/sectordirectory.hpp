@@ -0,0 +1,83 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "map/map_const.hpp"
+
+class MapSector;
+
+/**
+ * Two-level table of the map sectors, indexed directly by sector coordinates.
+ * The root covers the whole 16 bit coordinate space with blocks of BLOCK_SIZE x BLOCK_SIZE sectors,
+ * a block is only allocated once a sector inside it is created, so a lookup is two array reads and no hashing.
+ * Sectors of a block are laid out row by row, east/west neighbours are adjacent entries.
+ * Lookups are lock-free and may run on any thread, sectors are created by one thread at a time and live as long as the table.
+ */
+class SectorDirectory {
+public:
+	SectorDirectory() = default;
+	~SectorDirectory();
+
+	// Ensures that we don't accidentally copy it
+	SectorDirectory(const SectorDirectory &) = delete;
+	SectorDirectory &operator=(const SectorDirectory &) = delete;
+
+	MapSector* find(uint32_t x, uint32_t y) const {
+		if (x > MAX_COORDINATE || y > MAX_COORDINATE) {
+			return nullptr;
+		}
+
+		const uint32_t sectorX = x / SECTOR_SIZE;
+		const uint32_t sectorY = y / SECTOR_SIZE;
+		const Block* block = root[(sectorY >> BLOCK_BITS) * ROOT_SIZE + (sectorX >> BLOCK_BITS)].load(std::memory_order_acquire);
+		if (!block) {
+			return nullptr;
+		}
+		return block->sectors[(sectorY & BLOCK_MASK) * BLOCK_SIZE + (sectorX & BLOCK_MASK)].load(std::memory_order_acquire);
+	}
+
+	/**
+	 * Returns the sector containing the coordinates, creating it when needed.
+	 * \param created Set to true when the sector did not exist yet.
+	 */
+	MapSector* findOrCreate(uint32_t x, uint32_t y, bool &created);
+
+	[[nodiscard]] size_t size() const {
+		return sectorCount;
+	}
+
+	[[nodiscard]] size_t blocks() const {
+		return blockCount;
+	}
+
+	/**
+	 * Bytes taken by the table itself, the sectors it points to are not included.
+	 */
+	[[nodiscard]] size_t memoryUsage() const {
+		return sizeof(root) + blockCount * sizeof(Block);
+	}
+
+private:
+	static constexpr uint32_t MAX_COORDINATE = 0xFFFF;
+	static constexpr uint32_t SECTORS_PER_AXIS = (MAX_COORDINATE + 1) / SECTOR_SIZE;
+	static constexpr uint32_t BLOCK_BITS = 6;
+	static constexpr uint32_t BLOCK_SIZE = 1 << BLOCK_BITS;
+	static constexpr uint32_t BLOCK_MASK = BLOCK_SIZE - 1;
+	static constexpr uint32_t ROOT_SIZE = SECTORS_PER_AXIS / BLOCK_SIZE;
+
+	struct Block {
+		std::array<std::atomic<MapSector*>, BLOCK_SIZE * BLOCK_SIZE> sectors {};
+	};
+
+	std::array<std::atomic<Block*>, ROOT_SIZE * ROOT_SIZE> root {};
+
+	size_t sectorCount = 0;
+	size_t blockCount = 0;
+};
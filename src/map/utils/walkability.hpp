@@ -0,0 +1,107 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "map/map_const.hpp"
+
+enum WalkabilityFlags_t : uint8_t {
+	WALKABILITY_NONE = 0,
+	WALKABILITY_BLOCKSOLID = 1 << 0,
+	WALKABILITY_BLOCKPATH = 1 << 1,
+	WALKABILITY_BLOCKPROJECTILE = 1 << 2,
+	WALKABILITY_CREATURE = 1 << 3,
+	WALKABILITY_PROTECTIONZONE = 1 << 4,
+	// No ground, floor change or teleport, Tile::queryAdd refuses every creature while pathfinding
+	WALKABILITY_NOPATH = 1 << 5,
+	// The tile is still in the map cache, the other bits of the position are not known yet
+	WALKABILITY_UNLOADED = 1 << 6,
+};
+
+/**
+ * Packed walkability of the tiles of a floor, one bit per tile and flag.
+ * Each flag is a layer of SECTOR_SIZE rows, a row is a word with bit n set for x = n, so a whole
+ * row of a layer is tested with a single load and mask. The layers of a row are adjacent.
+ * Tiles keep their bits in sync when their flags, ground or creatures change (Tile::updateWalkability),
+ * the map cache keeps the unloaded layer. Reads are lock-free and may run on any thread.
+ */
+class WalkabilityMap {
+public:
+	using Row = uint16_t;
+
+	static constexpr uint8_t LAYERS = 7;
+	static constexpr uint8_t UNLOADED_LAYER = 6;
+
+	static_assert(SECTOR_SIZE <= std::numeric_limits<Row>::digits, "A row of a sector must fit in a word");
+
+	/**
+	 * \returns the flags of the tile, only WALKABILITY_UNLOADED while it is still in the map cache
+	 */
+	uint8_t get(uint16_t x, uint16_t y) const {
+		const auto &rowLayers = rows[y & SECTOR_MASK];
+		const Row bit = Row(1) << (x & SECTOR_MASK);
+
+		// The unloaded bit is cleared after the tile bits are written, so it is read first
+		if (rowLayers[UNLOADED_LAYER].load(std::memory_order_acquire) & bit) {
+			return WALKABILITY_UNLOADED;
+		}
+
+		uint8_t flags = WALKABILITY_NONE;
+		for (uint8_t layer = 0; layer < UNLOADED_LAYER; ++layer) {
+			if (rowLayers[layer].load(std::memory_order_acquire) & bit) {
+				flags |= 1 << layer;
+			}
+		}
+		return flags;
+	}
+
+	/**
+	 * Bits of the tiles of row y set in the layer of 'flag', bit n being x = n.
+	 * Bits of unloaded tiles are not meaningful.
+	 */
+	Row getRow(WalkabilityFlags_t flag, uint16_t y) const {
+		return rows[y & SECTOR_MASK][std::countr_zero(static_cast<uint8_t>(flag))].load(std::memory_order_acquire);
+	}
+
+	/**
+	 * Replaces the tile layers of a position, the unloaded layer is left as is.
+	 */
+	void set(uint16_t x, uint16_t y, uint8_t flags) {
+		auto &rowLayers = rows[y & SECTOR_MASK];
+		const Row bit = Row(1) << (x & SECTOR_MASK);
+		for (uint8_t layer = 0; layer < UNLOADED_LAYER; ++layer) {
+			auto &row = rowLayers[layer];
+			const bool isSet = row.load(std::memory_order_relaxed) & bit;
+			if (isSet == static_cast<bool>(flags & (1 << layer))) {
+				continue;
+			}
+
+			if (isSet) {
+				row.fetch_and(static_cast<Row>(~bit), std::memory_order_relaxed);
+			} else {
+				row.fetch_or(bit, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	void setUnloaded(uint16_t x, uint16_t y, bool unloaded) {
+		auto &row = rows[y & SECTOR_MASK][UNLOADED_LAYER];
+		const Row bit = Row(1) << (x & SECTOR_MASK);
+		if (unloaded) {
+			row.fetch_or(bit, std::memory_order_relaxed);
+		} else {
+			row.fetch_and(static_cast<Row>(~bit), std::memory_order_release);
+		}
+	}
+
+private:
+	static_assert(WALKABILITY_UNLOADED == 1 << UNLOADED_LAYER && UNLOADED_LAYER + 1 == LAYERS);
+
+	std::atomic<Row> rows[SECTOR_SIZE][LAYERS] = {};
+};
@@ -59,15 +59,22 @@ Connection::Connection(asio::io_service &initIoService, ConstServicePort_ptr ini
 
 void Connection::close(bool force) {
 	ConnectionManager::getInstance().releaseConnection(shared_from_this());
-
-	std::scoped_lock lock(connectionLock);
 	ip = 0;
 
+	// The rest of the state belongs to the thread running this connection's io_service
+	asio::dispatch(socket.get_executor(), [self = shared_from_this(), force] { self->closeInternal(force); });
+}
+
+void Connection::closeInternal(bool force) {
 	if (connectionState == CONNECTION_STATE_CLOSED) {
 		return;
 	}
 	connectionState = CONNECTION_STATE_CLOSED;
 
+#ifdef FEATURE_METRICS
+	g_metrics().recordHistogram("connection_write_calls", static_cast<double>(writeCalls));
+#endif
+
 	if (protocol) {
 		g_dispatcher().addEvent([protocol = protocol] { protocol->release(); }, __FUNCTION__, std::chrono::milliseconds(CONNECTION_WRITE_TIMEOUT * 1000).count());
 	}
@@ -129,7 +136,6 @@ void Connection::acceptInternal(bool toggleParseHeader) {
 }
 
 void Connection::parseProxyIdentification(const std::error_code &error) {
-	std::scoped_lock lock(connectionLock);
 	readTimer.cancel();
 
 	if (error || connectionState == CONNECTION_STATE_CLOSED) {
@@ -183,7 +189,6 @@ void Connection::parseProxyIdentification(const std::error_code &error) {
 }
 
 void Connection::parseHeader(const std::error_code &error) {
-	std::scoped_lock lock(connectionLock);
 	readTimer.cancel();
 
 	if (error) {
@@ -229,7 +234,6 @@ void Connection::parseHeader(const std::error_code &error) {
 }
 
 void Connection::parsePacket(const std::error_code &error) {
-	std::scoped_lock lock(connectionLock);
 	readTimer.cancel();
 
 	if (error || connectionState == CONNECTION_STATE_CLOSED) {
@@ -307,99 +311,162 @@ void Connection::resumeWork() {
 	}
 }
 
-void Connection::send(const OutputMessage_ptr &outputMessage) {
-	std::scoped_lock lock(connectionLock);
+bool Connection::queueInputMessage(const NetworkMessage &msg) {
 	if (connectionState == CONNECTION_STATE_CLOSED) {
-		return;
+		return true;
 	}
 
-	bool noPendingWrite = messageQueue.empty();
-	messageQueue.emplace_back(outputMessage);
+	// Reading is paused below as soon as the biggest message would not fit, so a message is only read with room for it.
+	// Should it ever not fit, the session can't go on without it: the connection is closed instead of losing the packet.
+	if (!inputQueue.push(msg)) {
+		g_logger().error("[Connection::queueInputMessage] - {} has no room left in its input queue, closing the connection", convertIPToString(getIP()));
+		close(FORCE_CLOSE);
+		return true;
+	}
 
-	if (noPendingWrite) {
-		if (socket.is_open()) {
-			try {
-				asio::post(socket.get_executor(), [self = shared_from_this()] { self->internalWorker(); });
-			} catch (const std::system_error &e) {
-				g_logger().error("[Connection::send] - Exception in posting write operation: {}", e.what());
-				close(FORCE_CLOSE);
+	// Back-pressure, the client's data stays in the socket until the dispatcher catches up
+	// Published before the drain is scheduled, so the drain always sees it
+	const bool pause = !inputQueue.hasRoom();
+	readPaused = pause;
+
+	if (!drainScheduled.exchange(true)) {
+		g_dispatcher().addEvent([self = shared_from_this()] { self->drainInputMessages(); }, "Connection::drainInputMessages");
+	}
+
+	return pause;
+}
+
+void Connection::drainInputMessages() {
+	// Cleared before draining so a message queued meanwhile schedules a new drain
+	drainScheduled = false;
+
+	static thread_local NetworkMessage msg;
+	for (size_t parsed = 0; parsed < CONNECTION_INPUT_BATCH && inputQueue.pop(msg); ++parsed) {
+		protocol->parsePacket(msg);
+	}
+
+	// Leftovers wait for the next dispatcher cycle, so a flooding client can't starve the others
+	if (!inputQueue.empty() && !drainScheduled.exchange(true)) {
+		g_dispatcher().addEvent([self = shared_from_this()] { self->drainInputMessages(); }, "Connection::drainInputMessages");
+	}
+
+	if (readPaused && inputQueue.hasRoom()) {
+		asio::post(socket.get_executor(), [self = shared_from_this()] {
+			if (self->connectionState != CONNECTION_STATE_CLOSED && self->readPaused.exchange(false)) {
+				self->resumeWork();
 			}
-		} else {
-			g_logger().error("[Connection::send] - Socket is not open for writing.");
-			close(FORCE_CLOSE);
-		}
+		});
 	}
 }
 
-void Connection::internalWorker() {
-	std::unique_lock lock(connectionLock);
-	if (messageQueue.empty()) {
-		if (connectionState == CONNECTION_STATE_CLOSED) {
-			closeSocket();
-		}
+void Connection::send(const OutputMessage_ptr &outputMessage) {
+	// Queued and written by the thread running this connection's io_service, so no lock is needed
+	try {
+		asio::post(socket.get_executor(), [self = shared_from_this(), outputMessage] { self->internalWorker(outputMessage); });
+	} catch (const std::system_error &e) {
+		g_logger().error("[Connection::send] - Exception in posting write operation: {}", e.what());
+		close(FORCE_CLOSE);
+	}
+}
+
+void Connection::internalWorker(const OutputMessage_ptr &outputMessage) {
+	if (connectionState == CONNECTION_STATE_CLOSED) {
 		return;
 	}
 
-	const auto &outputMessage = messageQueue.front();
-	lock.unlock();
-	protocol->onSendMessage(outputMessage);
-	lock.lock();
+	if (!socket.is_open()) {
+		g_logger().error("[Connection::send] - Socket is not open for writing.");
+		close(FORCE_CLOSE);
+		return;
+	}
+
+	messageQueue.emplace_back(outputMessage);
 
-	internalSend(outputMessage);
+	// Messages queued while a write is in flight go out together in the next one
+	if (writingMessages == 0) {
+		internalSend();
+	}
 }
 
 uint32_t Connection::getIP() {
-	std::scoped_lock lock(connectionLock);
+	// 1 until the remote endpoint is resolved, 0 once the connection is closed
+	uint32_t currentIp = ip;
+	if (currentIp != 1) {
+		return currentIp;
+	}
 
-	if (ip == 1) {
-		std::error_code error;
-		asio::ip::tcp::endpoint endpoint = socket.remote_endpoint(error);
-		if (error) {
-			g_logger().error("[Connection::getIP] - Failed to get remote endpoint: {}", error.message());
-			ip = 0;
-		} else {
-			ip = htonl(endpoint.address().to_v4().to_uint());
-		}
+	std::error_code error;
+	asio::ip::tcp::endpoint endpoint = socket.remote_endpoint(error);
+	uint32_t resolvedIp = 0;
+	if (error) {
+		g_logger().error("[Connection::getIP] - Failed to get remote endpoint: {}", error.message());
+	} else {
+		resolvedIp = htonl(endpoint.address().to_v4().to_uint());
 	}
-	return ip;
+
+	return ip.compare_exchange_strong(currentIp, resolvedIp) ? resolvedIp : currentIp;
 }
 
-void Connection::internalSend(const OutputMessage_ptr &outputMessage) {
+void Connection::internalSend() {
+	writeBuffers.clear();
+	size_t writeBytes = 0;
+	for (size_t i = 0; i < messageQueue.size() && writeBuffers.size() < CONNECTION_WRITE_MAX_MESSAGES; ++i) {
+		const auto &outputMessage = messageQueue[i];
+		// The first message always goes, however big it is
+		if (i != 0 && writeBytes + outputMessage->getLength() > CONNECTION_WRITE_BUDGET) {
+			break;
+		}
+
+		// Compressed and encrypted once, in queue order, right before it is written
+		protocol->onSendMessage(outputMessage);
+		writeBuffers.emplace_back(outputMessage->getOutputBuffer(), outputMessage->getLength());
+		writeBytes += outputMessage->getLength();
+	}
+	writingMessages = writeBuffers.size();
+
 	writeTimer.expires_from_now(std::chrono::seconds(CONNECTION_WRITE_TIMEOUT));
 	writeTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
 
 	try {
-		asio::async_write(socket, asio::buffer(outputMessage->getOutputBuffer(), outputMessage->getLength()), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->onWriteOperation(error); });
+		// Gather write, the kernel gets every buffer in a single writev
+		asio::async_write(socket, writeBuffers, [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->onWriteOperation(error, N); });
 	} catch (const std::system_error &e) {
 		g_logger().error("[Connection::internalSend] - Exception in async_write: {}", e.what());
 		close(FORCE_CLOSE);
 	}
 }
 
-void Connection::onWriteOperation(const std::error_code &error) {
-	std::unique_lock lock(connectionLock);
+void Connection::onWriteOperation(const std::error_code &error, std::size_t bytesTransferred) {
 	writeTimer.cancel();
 
 	if (error) {
 		g_logger().error("[Connection::onWriteOperation] - Write error: {}", error.message());
 		messageQueue.clear();
+		writingMessages = 0;
 		close(FORCE_CLOSE);
 		return;
 	}
 
-	messageQueue.pop_front();
+	recordWrite(bytesTransferred);
+	for (; writingMessages > 0; --writingMessages) {
+		messageQueue.pop_front();
+	}
 
 	if (!messageQueue.empty()) {
-		const auto &outputMessage = messageQueue.front();
-		lock.unlock();
-		protocol->onSendMessage(outputMessage);
-		lock.lock();
-		internalSend(outputMessage);
+		internalSend();
 	} else if (connectionState == CONNECTION_STATE_CLOSED) {
 		closeSocket();
 	}
 }
 
+void Connection::recordWrite([[maybe_unused]] size_t bytes) {
+	++writeCalls;
+#ifdef FEATURE_METRICS
+	g_metrics().recordHistogram("connection_write_bytes", static_cast<double>(bytes));
+	g_metrics().recordHistogram("connection_write_messages", static_cast<double>(writingMessages));
+#endif
+}
+
 void Connection::handleTimeout(ConnectionWeak_ptr connectionWeak, const std::error_code &error) {
 	if (error == asio::error::operation_aborted) {
 		return;
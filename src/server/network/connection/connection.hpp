@@ -12,9 +12,17 @@
 #include "declarations.hpp"
 // TODO: Remove circular includes (maybe shared_ptr?)
 #include "server/network/message/networkmessage.hpp"
+#include "server/network/message/inputmessagequeue.hpp"
+#include "utils/ringbuffer.hpp"
 
 static constexpr int32_t CONNECTION_WRITE_TIMEOUT = 30;
 static constexpr int32_t CONNECTION_READ_TIMEOUT = 30;
+// Inbound messages parsed per connection on each dispatcher cycle
+static constexpr size_t CONNECTION_INPUT_BATCH = 8;
+// Queued outbound messages are gathered into one write of up to this many bytes (a single message may exceed it)
+static constexpr size_t CONNECTION_WRITE_BUDGET = 64 * 1024;
+// Buffers asio passes to a single writev
+static constexpr size_t CONNECTION_WRITE_MAX_MESSAGES = 64;
 
 class Protocol;
 using Protocol_ptr = std::shared_ptr<Protocol>;
@@ -64,6 +72,12 @@ public:
 
 	void resumeWork();
 
+	/**
+	 * Queues a decoded inbound message for the dispatcher, network thread only.
+	 * Returns true when the queue is full and reading has to wait until the dispatcher drains it.
+	 */
+	bool queueInputMessage(const NetworkMessage &msg);
+
 	void send(const OutputMessage_ptr &outputMessage);
 
 	uint32_t getIP();
@@ -73,13 +87,17 @@ private:
 	void parseHeader(const std::error_code &error);
 	void parsePacket(const std::error_code &error);
 
-	void onWriteOperation(const std::error_code &error);
+	void drainInputMessages();
+
+	void onWriteOperation(const std::error_code &error, std::size_t bytesTransferred);
+	void recordWrite(size_t bytes);
 
 	static void handleTimeout(ConnectionWeak_ptr connectionWeak, const std::error_code &error);
 
+	void closeInternal(bool force);
 	void closeSocket();
-	void internalWorker();
-	void internalSend(const OutputMessage_ptr &outputMessage);
+	void internalWorker(const OutputMessage_ptr &outputMessage);
+	void internalSend();
 
 	asio::ip::tcp::socket &getSocket() {
 		return socket;
@@ -88,9 +106,11 @@ private:
 	asio::high_resolution_timer readTimer;
 	asio::high_resolution_timer writeTimer;
 
-	std::recursive_mutex connectionLock;
-
-	std::list<OutputMessage_ptr> messageQueue;
+	stdext::ring_buffer<OutputMessage_ptr> messageQueue;
+	// Buffers of the write in flight, they belong to the first writingMessages entries of messageQueue
+	std::vector<asio::const_buffer> writeBuffers;
+	size_t writingMessages = 0;
+	uint64_t writeCalls = 0;
 
 	ConstServicePort_ptr service_port;
 	Protocol_ptr protocol;
@@ -99,9 +119,13 @@ private:
 
 	NetworkMessage m_msg;
 
+	InputMessageQueue inputQueue;
+	std::atomic_bool drainScheduled = false;
+	std::atomic_bool readPaused = false;
+
 	std::time_t timeConnected = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
 	uint32_t packetsSent = 0;
-	uint32_t ip = 1;
+	std::atomic_uint32_t ip = 1;
 
 	std::underlying_type_t<ConnectionState_t> connectionState = CONNECTION_STATE_OPEN;
 	bool receivedFirst = false;
@@ -0,0 +1,64 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "server/network/connection/ioservicepool.hpp"
+
+IOServicePool::~IOServicePool() {
+	stop();
+}
+
+void IOServicePool::start(size_t count) {
+	if (!services.empty()) {
+		return;
+	}
+
+	count = std::max<size_t>(count, 1);
+	services.reserve(count);
+	workGuards.reserve(count);
+	threads.reserve(count);
+
+	for (size_t i = 0; i < count; ++i) {
+		// A connection stays on the service it was given for its whole life, but the dispatcher
+		// posts its writes from another thread, so asio keeps its default locking
+		auto &service = services.emplace_back(std::make_unique<asio::io_service>());
+		workGuards.emplace_back(asio::make_work_guard(*service));
+	}
+
+	for (const auto &service : services) {
+		threads.emplace_back([&service = *service] {
+			while (!service.stopped()) {
+				try {
+					service.run();
+				} catch (const std::exception &e) {
+					g_logger().error("[IOServicePool] - Exception in network thread: {}", e.what());
+				}
+			}
+		});
+	}
+
+	g_logger().info("Running network with {} threads.", count);
+}
+
+void IOServicePool::stop() {
+	workGuards.clear();
+	for (const auto &service : services) {
+		service->stop();
+	}
+
+	for (auto &thread : threads) {
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+	threads.clear();
+}
+
+asio::io_service &IOServicePool::getNextService() {
+	return *services[nextService.fetch_add(1, std::memory_order_relaxed) % services.size()];
+}
@@ -0,0 +1,43 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Fixed set of io_services, each one run by its own thread.
+ * Connections are pinned to a service round-robin when they are accepted, so every handler of a connection
+ * runs on the same thread and never concurrently: each service is an implicit strand for the connections it owns.
+ */
+class IOServicePool {
+public:
+	IOServicePool() = default;
+	~IOServicePool();
+
+	// non-copyable
+	IOServicePool(const IOServicePool &) = delete;
+	IOServicePool &operator=(const IOServicePool &) = delete;
+
+	/**
+	 * Creates the services and starts their threads, does nothing if the pool is already running.
+	 */
+	void start(size_t count);
+	void stop();
+
+	asio::io_service &getNextService();
+
+	size_t size() const {
+		return services.size();
+	}
+
+private:
+	std::vector<std::unique_ptr<asio::io_service>> services;
+	std::vector<asio::executor_work_guard<asio::io_service::executor_type>> workGuards;
+	std::vector<std::thread> threads;
+	std::atomic_size_t nextService = 0;
+};
@@ -0,0 +1,81 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "server/network/message/inputmessagequeue.hpp"
+
+#include "server/network/message/networkmessage.hpp"
+
+bool InputMessageQueue::push(const NetworkMessage &msg) {
+	const auto position = msg.getBufferPosition();
+	const auto length = msg.getLength();
+
+	// Same bounds NetworkMessage::canRead works with
+	const int32_t unread = std::clamp<int32_t>(length - (position - NetworkMessage::INITIAL_BUFFER_POSITION), 0, NETWORKMESSAGE_MAXSIZE - position);
+	const EntryHeader header { position, length, static_cast<uint16_t>(unread) };
+	const uint32_t entrySize = sizeof(EntryHeader) + header.size;
+
+	const auto currentTail = tail.load(std::memory_order_relaxed);
+	if (currentTail - head.load(std::memory_order_acquire) + entrySize > CAPACITY || size() >= MAX_MESSAGES) {
+		return false;
+	}
+
+	if (!storage) {
+		storage = std::make_unique<uint8_t[]>(CAPACITY);
+	}
+
+	write(currentTail, &header, sizeof(EntryHeader));
+	write(currentTail + sizeof(EntryHeader), msg.getBuffer() + position, header.size);
+
+	tail.store(currentTail + entrySize, std::memory_order_release);
+	pushed.fetch_add(1, std::memory_order_release);
+	return true;
+}
+
+bool InputMessageQueue::pop(NetworkMessage &msg) {
+	if (empty()) {
+		return false;
+	}
+
+	const auto currentHead = head.load(std::memory_order_relaxed);
+
+	EntryHeader header {};
+	read(currentHead, &header, sizeof(EntryHeader));
+
+	msg.reset();
+	msg.setBufferPosition(header.position);
+	msg.setLength(header.length);
+	read(currentHead + sizeof(EntryHeader), msg.getBuffer() + header.position, header.size);
+
+	popped.fetch_add(1, std::memory_order_release);
+	head.store(currentHead + sizeof(EntryHeader) + header.size, std::memory_order_release);
+	return true;
+}
+
+bool InputMessageQueue::hasRoom() const {
+	const auto used = tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+	return used + sizeof(EntryHeader) + INPUTMESSAGE_MAXSIZE <= CAPACITY && size() < MAX_MESSAGES;
+}
+
+void InputMessageQueue::write(uint32_t offset, const void* data, size_t size) {
+	const auto index = offset & (CAPACITY - 1);
+	const auto first = std::min<size_t>(size, CAPACITY - index);
+	const auto* bytes = static_cast<const uint8_t*>(data);
+
+	std::memcpy(storage.get() + index, bytes, first);
+	std::memcpy(storage.get(), bytes + first, size - first);
+}
+
+void InputMessageQueue::read(uint32_t offset, void* data, size_t size) const {
+	const auto index = offset & (CAPACITY - 1);
+	const auto first = std::min<size_t>(size, CAPACITY - index);
+	auto* bytes = static_cast<uint8_t*>(data);
+
+	std::memcpy(bytes, storage.get() + index, first);
+	std::memcpy(bytes + first, storage.get(), size - first);
+}
@@ -0,0 +1,76 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class NetworkMessage;
+
+/**
+ * Bounded queue of decoded inbound messages of one connection.
+ * Only the unread part of a message is stored, together with its read position and length,
+ * so the consumer gets back exactly the view the protocol would have parsed from the connection buffer.
+ * Single producer (the network thread reading the connection) and single consumer (the dispatcher),
+ * the byte ring is allocated on the first push so idle connections do not pay for it.
+ */
+class InputMessageQueue {
+public:
+	static constexpr uint32_t CAPACITY = 16384;
+	static constexpr uint32_t MAX_MESSAGES = 32;
+
+	InputMessageQueue() = default;
+
+	// Ensures that we don't accidentally copy it
+	InputMessageQueue(const InputMessageQueue &) = delete;
+	InputMessageQueue &operator=(const InputMessageQueue &) = delete;
+
+	/**
+	 * Copies the unread part of the message into the queue, returns false if there is no room for it.
+	 * Producer only.
+	 */
+	bool push(const NetworkMessage &msg);
+
+	/**
+	 * Restores the oldest message into 'msg', returns false if the queue is empty.
+	 * Consumer only.
+	 */
+	bool pop(NetworkMessage &msg);
+
+	/**
+	 * Whether a message of the biggest size a client may send still fits.
+	 */
+	[[nodiscard]] bool hasRoom() const;
+
+	[[nodiscard]] size_t size() const {
+		return pushed.load(std::memory_order_acquire) - popped.load(std::memory_order_acquire);
+	}
+
+	[[nodiscard]] bool empty() const {
+		return size() == 0;
+	}
+
+private:
+	struct EntryHeader {
+		uint16_t position;
+		uint16_t length;
+		uint16_t size;
+	};
+
+	static_assert(std::has_single_bit(CAPACITY), "InputMessageQueue capacity must be a power of two");
+
+	void write(uint32_t offset, const void* data, size_t size);
+	void read(uint32_t offset, void* data, size_t size) const;
+
+	std::unique_ptr<uint8_t[]> storage;
+
+	// Byte offsets and message counters, both only ever grow
+	std::atomic_uint32_t head = 0;
+	std::atomic_uint32_t tail = 0;
+	std::atomic_uint32_t pushed = 0;
+	std::atomic_uint32_t popped = 0;
+};
@@ -47,6 +47,15 @@ public:
 		info.position += msgLen;
 	}
 
+	// Returns where the bytes landed, so fields that differ per receiver can be patched in place
+	uint8_t* append(std::span<const uint8_t> bytes) {
+		auto* dest = buffer.data() + info.position;
+		std::ranges::copy(bytes, dest);
+		info.length += static_cast<MsgSize_t>(bytes.size());
+		info.position += static_cast<MsgSize_t>(bytes.size());
+		return dest;
+	}
+
 	void append(const OutputMessage_ptr &msg) {
 		auto msgLen = msg->getLength();
 		std::span<const unsigned char> sourceSpan(msg->getBuffer() + INITIAL_BUFFER_POSITION, msgLen);
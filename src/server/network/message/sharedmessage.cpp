@@ -0,0 +1,19 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "server/network/message/sharedmessage.hpp"
+
+SharedMessage::SharedMessage(const NetworkMessage &msg) :
+	body(msg.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION, msg.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION + msg.getLength()) { }
+
+NetworkMessage &SharedMessageCache::getEncodeBuffer() {
+	static thread_local NetworkMessage msg;
+	msg.reset();
+	return msg;
+}
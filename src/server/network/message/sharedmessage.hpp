@@ -0,0 +1,55 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "server/network/message/networkmessage.hpp"
+
+/**
+ * Encoded body of a server message that reads the same for every client receiving it.
+ * It is encoded once and then copied as-is into the output buffer of each spectator,
+ * instead of each spectator encoding the same bytes into a NetworkMessage of its own.
+ */
+class SharedMessage {
+public:
+	explicit SharedMessage(const NetworkMessage &msg);
+
+	std::span<const uint8_t> getBody() const {
+		return body;
+	}
+
+private:
+	std::vector<uint8_t> body;
+};
+
+using SharedMessage_ptr = std::shared_ptr<const SharedMessage>;
+
+/**
+ * Bodies of one broadcast, one per client protocol flavour since old clients are encoded differently.
+ * A flavour is only encoded once the first spectator using it asks for it.
+ */
+class SharedMessageCache {
+public:
+	template <typename Encoder>
+	const SharedMessage &get(bool oldProtocol, Encoder &&encode) {
+		auto &body = bodies[oldProtocol ? 1 : 0];
+		if (!body) {
+			auto &msg = getEncodeBuffer();
+			encode(msg);
+			body = std::make_shared<const SharedMessage>(msg);
+		}
+		return *body;
+	}
+
+private:
+	// Reused for every encode, a fresh NetworkMessage would clear its whole buffer first
+	static NetworkMessage &getEncodeBuffer();
+
+	std::array<SharedMessage_ptr, 2> bodies;
+};
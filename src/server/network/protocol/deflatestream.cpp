@@ -0,0 +1,147 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "server/network/protocol/deflatestream.hpp"
+
+// Same parameters the per message stream always used
+constexpr int32_t DEFLATE_WINDOW_BITS = 15;
+constexpr int32_t DEFLATE_MEM_LEVEL = 9;
+// A streaming stream lives as long as its connection: 16 KiB of history and a smaller hash
+// keep it around 200 KiB instead of the ~400 KiB of the per message parameters
+constexpr int32_t STREAMING_WINDOW_BITS = 14;
+constexpr int32_t STREAMING_MEM_LEVEL = 8;
+
+DeflateStream::DeflateStream(int32_t level, bool streaming, bool useDictionary) :
+	streaming(streaming), useDictionary(useDictionary) {
+	if (level <= 0) {
+		return;
+	}
+
+	const auto windowBits = streaming ? STREAMING_WINDOW_BITS : DEFLATE_WINDOW_BITS;
+	const auto memLevel = streaming ? STREAMING_MEM_LEVEL : DEFLATE_MEM_LEVEL;
+	// Negative window bits: raw deflate, without zlib header and checksum
+	if (deflateInit2(&stream, std::min<int32_t>(level, Z_BEST_COMPRESSION), Z_DEFLATED, -windowBits, memLevel, Z_DEFAULT_STRATEGY) != Z_OK) {
+		g_logger().error("[DeflateStream] - Zlib deflateInit2 error: {}", (stream.msg ? stream.msg : " unknown error"));
+		return;
+	}
+
+	valid = setDictionary();
+}
+
+DeflateStream::~DeflateStream() {
+	deflateEnd(&stream);
+}
+
+size_t DeflateStream::compress(std::span<const uint8_t> in, std::span<uint8_t> out) {
+	if (!valid) {
+		return 0;
+	}
+
+	stream.next_in = const_cast<Bytef*>(in.data());
+	stream.avail_in = static_cast<uInt>(in.size());
+	stream.next_out = out.data();
+	stream.avail_out = static_cast<uInt>(out.size());
+
+	const int32_t ret = deflate(&stream, streaming ? Z_SYNC_FLUSH : Z_FINISH);
+	const size_t totalSize = out.size() - stream.avail_out;
+
+	if (streaming) {
+		// The whole message and the flush marker must have made it out, otherwise the client can not follow anymore
+		if (ret != Z_OK || stream.avail_in != 0 || stream.avail_out == 0) {
+			g_logger().error("[DeflateStream::compress] - Streaming deflate failed ({}), compression disabled for this connection", ret);
+			valid = false;
+			return 0;
+		}
+		return totalSize;
+	}
+
+	deflateReset(&stream);
+	if (!setDictionary()) {
+		valid = false;
+	}
+
+	if (ret != Z_STREAM_END) {
+		return 0;
+	}
+	return totalSize;
+}
+
+bool DeflateStream::setDictionary() {
+	if (!useDictionary) {
+		return true;
+	}
+
+	const auto dictionary = getPresetDictionary();
+	if (deflateSetDictionary(&stream, dictionary.data(), static_cast<uInt>(dictionary.size())) != Z_OK) {
+		g_logger().error("[DeflateStream] - Zlib deflateSetDictionary error: {}", (stream.msg ? stream.msg : " unknown error"));
+		return false;
+	}
+	return true;
+}
+
+std::span<const uint8_t> DeflateStream::getPresetDictionary() {
+	// Deflate reaches the end of the dictionary with the shortest distances,
+	// so the least frequent patterns come first and the most frequent ones last
+	static const std::vector<uint8_t> dictionary = [] {
+		std::vector<uint8_t> bytes;
+		const auto append = [&bytes](std::initializer_list<uint8_t> sequence) {
+			bytes.insert(bytes.end(), sequence);
+		};
+		const auto appendText = [&bytes](std::string_view text) {
+			bytes.insert(bytes.end(), text.begin(), text.end());
+		};
+
+		// Server log and look texts
+		appendText("You advanced from Level ");
+		appendText("You are exhausted.");
+		appendText("Sorry, not possible.");
+		appendText("Your depot contains ");
+		appendText("Loot of a ");
+		appendText("You see a ");
+		appendText("You see ");
+		appendText(" hitpoints due to an attack by a ");
+		appendText("You lose ");
+		appendText(" damage to a ");
+		appendText("You deal ");
+		appendText(" experience points.");
+		appendText("You gained ");
+
+		// Map descriptions: items, tile ends and skip markers of empty tiles
+		append({ 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF });
+		append({ 0x01, 0xFF, 0x02, 0xFF, 0x03, 0xFF, 0x04, 0xFF });
+
+		// Unknown and known creature with outfit, light and speed
+		append({ 0x61, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x64, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xD7, 0x00, 0x00, 0x00 });
+		append({ 0x62, 0x00, 0x00, 0x00, 0x10, 0x64, 0x02 });
+
+		// Speed change, creature light, square
+		append({ 0x8F, 0x00, 0x00, 0x00, 0x40, 0xDC, 0x00 });
+		append({ 0x8E, 0x00, 0x00, 0x00, 0x10, 0x00, 0xD7 });
+		append({ 0x93, 0x00, 0x00, 0x00, 0x40, 0x01, 0x00 });
+
+		// Tile item add, update and remove
+		append({ 0x6A, 0x00, 0x00, 0x00, 0x00, 0x07, 0x01 });
+		append({ 0x6B, 0x00, 0x00, 0x00, 0x00, 0x07, 0x01 });
+		append({ 0x6C, 0x00, 0x00, 0x00, 0x00, 0x07, 0x01 });
+
+		// Creature walking: old position, stack position, new position
+		append({ 0x6D, 0x00, 0x00, 0x00, 0x00, 0x07, 0x01, 0x00, 0x00, 0x00, 0x00, 0x07 });
+
+		// Sound, distance and magic effects
+		append({ 0x83, 0x00, 0x00, 0x00, 0x00, 0x07, 0x06, 0x02, 0x00, 0x00, 0x00 });
+		append({ 0x83, 0x00, 0x00, 0x00, 0x00, 0x07, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 });
+		append({ 0x83, 0x00, 0x00, 0x00, 0x00, 0x07, 0x03, 0x00, 0x00, 0x00 });
+
+		// Creature health of monsters, then of players
+		append({ 0x8C, 0x00, 0x00, 0x00, 0x40, 0x64 });
+		append({ 0x8C, 0x00, 0x00, 0x00, 0x10, 0x64 });
+		return bytes;
+	}();
+	return dictionary;
+}
@@ -0,0 +1,55 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Raw deflate of outgoing messages, in one of two modes:
+ * - per message: every message is compressed on its own (Z_FINISH, then the stream is reset),
+ * - streaming: the window is kept across messages and each one ends with a sync flush,
+ *   so later messages refer back to earlier ones. The client has to inflate them with one
+ *   stream per connection, in order, so a streaming DeflateStream belongs to a single connection.
+ * Both modes can be primed with the preset dictionary, the client has to set the same one.
+ */
+class DeflateStream {
+public:
+	DeflateStream(int32_t level, bool streaming, bool useDictionary);
+	~DeflateStream();
+
+	// non-copyable
+	DeflateStream(const DeflateStream &) = delete;
+	DeflateStream &operator=(const DeflateStream &) = delete;
+
+	/**
+	 * Compresses 'in' into 'out', returns the compressed size or 0 if the message must be sent uncompressed.
+	 * A streaming DeflateStream that fails once is not used anymore, its window no longer matches the client.
+	 */
+	size_t compress(std::span<const uint8_t> in, std::span<uint8_t> out);
+
+	bool isValid() const {
+		return valid;
+	}
+
+	bool isStreaming() const {
+		return streaming;
+	}
+
+	/**
+	 * Byte patterns most game messages are made of, see deflatestream.cpp.
+	 */
+	static std::span<const uint8_t> getPresetDictionary();
+
+private:
+	bool setDictionary();
+
+	z_stream stream {};
+	bool streaming;
+	bool useDictionary;
+	bool valid = false;
+};
@@ -12,16 +12,28 @@
 #include "config/configmanager.hpp"
 #include "server/network/connection/connection.hpp"
 #include "server/network/message/outputmessage.hpp"
+#include "server/network/protocol/deflatestream.hpp"
 #include "security/rsa.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "utils/tools.hpp"
 
+// Below these sizes compressing does not pay off, with the window of the previous messages
+// at hand (streaming) much smaller messages still shrink
+constexpr uint16_t COMPRESSION_MIN_SIZE = 128;
+constexpr uint16_t STREAMING_COMPRESSION_MIN_SIZE = 32;
+
 Protocol::Protocol(const Connection_ptr &initConnection) :
-	connectionPtr(initConnection) { }
+	connectionPtr(initConnection),
+	// Decided once, switching modes on a live connection would leave the client behind
+	streamingCompression(g_configManager().getBoolean(PACKET_COMPRESSION_STREAMING)),
+	compressionDictionary(g_configManager().getBoolean(PACKET_COMPRESSION_DICTIONARY)) { }
+
+Protocol::~Protocol() = default;
 
 void Protocol::onSendMessage(const OutputMessage_ptr &msg) {
 	if (!rawMessages) {
-		const uint32_t sendMessageChecksum = msg->getLength() >= 128 && compression(*msg) ? (1U << 31) : 0;
+		const auto compressionMinSize = streamingCompression ? STREAMING_COMPRESSION_MIN_SIZE : COMPRESSION_MIN_SIZE;
+		const uint32_t sendMessageChecksum = msg->getLength() >= compressionMinSize && compression(*msg) ? (1U << 31) : 0;
 
 		msg->writeMessageLength();
 
@@ -49,19 +61,13 @@ bool Protocol::sendRecvMessageCallback(NetworkMessage &msg) {
 		return false;
 	}
 
-	g_dispatcher().addEvent(
-		[&msg, protocolWeak = std::weak_ptr<Protocol>(shared_from_this())]() {
-			if (const auto &protocol = protocolWeak.lock()) {
-				if (const auto &protocolConnection = protocol->getConnection()) {
-					protocol->parsePacket(msg);
-					protocolConnection->resumeWork();
-				}
-			}
-		},
-		__FUNCTION__
-	);
+	const auto connection = getConnection();
+	if (!connection) {
+		return false;
+	}
 
-	return true;
+	// The connection keeps reading while its queue has room, the dispatcher drains it
+	return connection->queueInputMessage(msg);
 }
 
 bool Protocol::onRecvMessage(NetworkMessage &msg) {
@@ -245,15 +251,13 @@ uint32_t Protocol::getIP() const {
 	return 0;
 }
 
-bool Protocol::compression(OutputMessage &outputMessage) const {
+bool Protocol::compression(OutputMessage &outputMessage) {
 	if (checksumMethod != CHECKSUM_METHOD_SEQUENCE) {
 		return false;
 	}
 
-	static thread_local auto compress_ptr = std::make_unique<ZStream>();
-	static const auto &compress = compress_ptr;
-
-	if (!compress->stream) {
+	const auto stream = getCompressionStream();
+	if (!stream) {
 		return false;
 	}
 
@@ -263,42 +267,35 @@ bool Protocol::compression(OutputMessage &outputMessage) const {
 		return false;
 	}
 
-	compress->stream->next_in = outputMessage.getOutputBuffer();
-	compress->stream->avail_in = outputMessageSize;
-	compress->stream->next_out = reinterpret_cast<Bytef*>(compress->buffer.data());
-	compress->stream->avail_out = NETWORKMESSAGE_MAXSIZE;
-
-	const int32_t ret = deflate(compress->stream.get(), Z_FINISH);
-	if (ret != Z_OK && ret != Z_STREAM_END) {
-		return false;
-	}
-
-	const auto totalSize = compress->stream->total_out;
-	deflateReset(compress->stream.get());
+	static thread_local auto buffer_ptr = std::make_unique<std::array<uint8_t, NETWORKMESSAGE_MAXSIZE>>();
+	static const auto &buffer = buffer_ptr;
 
+	const auto totalSize = stream->compress({ outputMessage.getOutputBuffer(), outputMessageSize }, *buffer);
 	if (totalSize == 0) {
 		return false;
 	}
 
 	outputMessage.reset();
-	outputMessage.addBytes(compress->buffer.data(), totalSize);
+	outputMessage.addBytes(reinterpret_cast<const char*>(buffer->data()), totalSize);
 
 	return true;
 }
 
-Protocol::ZStream::ZStream() noexcept {
+DeflateStream* Protocol::getCompressionStream() {
 	const int32_t compressionLevel = g_configManager().getNumber(COMPRESSION_LEVEL);
-	if (compressionLevel <= 0) {
-		return;
-	}
+	if (!streamingCompression) {
+		// One stream per dictionary setting, a reload must not hand a connection the other one
+		if (compressionDictionary) {
+			static thread_local DeflateStream dictionaryStream(compressionLevel, false, true);
+			return dictionaryStream.isValid() ? &dictionaryStream : nullptr;
+		}
 
-	stream = std::make_unique<z_stream>();
-	stream->zalloc = nullptr;
-	stream->zfree = nullptr;
-	stream->opaque = nullptr;
+		static thread_local DeflateStream stream(compressionLevel, false, false);
+		return stream.isValid() ? &stream : nullptr;
+	}
 
-	if (deflateInit2(stream.get(), compressionLevel, Z_DEFLATED, -15, 9, Z_DEFAULT_STRATEGY) != Z_OK) {
-		stream.reset();
-		g_logger().error("[Protocol::enableCompression()] - Zlib deflateInit2 error: {}", (stream->msg ? stream->msg : " unknown error"));
+	if (!compressionStream) {
+		compressionStream = std::make_unique<DeflateStream>(compressionLevel, true, compressionDictionary);
 	}
+	return compressionStream->isValid() ? compressionStream.get() : nullptr;
 }
@@ -18,12 +18,13 @@ using Connection_ptr = std::shared_ptr<Connection>;
 using ConnectionWeak_ptr = std::weak_ptr<Connection>;
 
 class NetworkMessage;
+class DeflateStream;
 
 class Protocol : public std::enable_shared_from_this<Protocol> {
 public:
 	explicit Protocol(const Connection_ptr &initConnection);
 
-	virtual ~Protocol() = default;
+	virtual ~Protocol();
 
 	// non-copyable
 	Protocol(const Protocol &) = delete;
@@ -75,23 +76,15 @@ protected:
 	virtual void release() { }
 
 private:
-	struct ZStream {
-		ZStream() noexcept;
-
-		~ZStream() {
-			deflateEnd(stream.get());
-		}
-
-		std::unique_ptr<z_stream> stream;
-		std::array<char, NETWORKMESSAGE_MAXSIZE> buffer {};
-	};
-
 	void XTEA_transform(uint8_t* buffer, size_t messageLength, bool encrypt) const;
 	void XTEA_encrypt(OutputMessage &msg) const;
 	bool XTEA_decrypt(NetworkMessage &msg) const;
-	bool compression(OutputMessage &msg) const;
+	bool compression(OutputMessage &msg);
+	DeflateStream* getCompressionStream();
 
 	OutputMessage_ptr outputBuffer;
+	// Only with streaming compression, then it is used by the thread the connection runs on only
+	std::unique_ptr<DeflateStream> compressionStream;
 
 	const ConnectionWeak_ptr connectionPtr;
 	std::array<uint32_t, 4> key = {};
@@ -100,6 +93,8 @@ private:
 	std::underlying_type_t<ChecksumMethods_t> checksumMethod = CHECKSUM_METHOD_NONE;
 	bool encryptionEnabled = false;
 	bool rawMessages = false;
+	bool streamingCompression = false;
+	bool compressionDictionary = false;
 
 	friend class Connection;
 };
@@ -47,6 +47,7 @@
 #include "lua/creature/creatureevent.hpp"
 #include "lua/modules/modules.hpp"
 #include "server/network/message/outputmessage.hpp"
+#include "server/network/message/sharedmessage.hpp"
 #include "utils/tools.hpp"
 #include "creatures/players/vocations/vocation.hpp"
 
@@ -904,6 +905,12 @@ void ProtocolGame::writeToOutputBuffer(const NetworkMessage &msg) {
 	out->append(msg);
 }
 
+uint8_t* ProtocolGame::writeToOutputBuffer(const SharedMessage &msg) {
+	const auto body = msg.getBody();
+	auto out = getOutputBuffer(static_cast<int32_t>(body.size()));
+	return out->append(body);
+}
+
 void ProtocolGame::parsePacket(NetworkMessage &msg) {
 	if (!acceptPackets || g_game().getGameState() == GAME_STATE_SHUTDOWN || msg.getLength() <= 0) {
 		return;
@@ -1388,13 +1395,13 @@ void ProtocolGame::parseHotkeyEquip(NetworkMessage &msg) {
 	g_game().playerEquipItem(player->getID(), itemId, Item::items[itemId].upgradeClassification > 0, tier);
 }
 
-void ProtocolGame::GetTileDescription(const std::shared_ptr<Tile> &tile, NetworkMessage &msg) {
+void ProtocolGame::GetTileDescription(Tile &tile, NetworkMessage &msg) {
 	if (oldProtocol) {
 		msg.add<uint16_t>(0x00); // Env effects
 	}
 
 	int32_t count;
-	std::shared_ptr<Item> ground = tile->getGround();
+	std::shared_ptr<Item> ground = tile.getGround();
 	if (ground) {
 		AddItem(msg, ground);
 		count = 1;
@@ -1402,13 +1409,13 @@ void ProtocolGame::GetTileDescription(const std::shared_ptr<Tile> &tile, Network
 		count = 0;
 	}
 
-	const TileItemVector* items = tile->getItemList();
+	const TileItemVector* items = tile.getItemList();
 	if (items) {
 		for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
 			AddItem(msg, *it);
 
 			count++;
-			if (count == 9 && tile->getPosition() == player->getPosition()) {
+			if (count == 9 && tile.getPosition() == player->getPosition()) {
 				break;
 			} else if (count == 10) {
 				return;
@@ -1416,7 +1423,7 @@ void ProtocolGame::GetTileDescription(const std::shared_ptr<Tile> &tile, Network
 		}
 	}
 
-	const CreatureVector* creatures = tile->getCreatures();
+	const CreatureVector* creatures = tile.getCreatures();
 	if (creatures) {
 		bool playerAdded = false;
 		for (auto creature : std::ranges::reverse_view(*creatures)) {
@@ -1424,7 +1431,7 @@ void ProtocolGame::GetTileDescription(const std::shared_ptr<Tile> &tile, Network
 				continue;
 			}
 
-			if (tile->getPosition() == player->getPosition() && count == 9 && !playerAdded) {
+			if (tile.getPosition() == player->getPosition() && count == 9 && !playerAdded) {
 				creature = player;
 			}
 
@@ -1481,7 +1488,7 @@ void ProtocolGame::GetMapDescription(int32_t x, int32_t y, int32_t z, int32_t wi
 void ProtocolGame::GetFloorDescription(NetworkMessage &msg, int32_t x, int32_t y, int32_t z, int32_t width, int32_t height, int32_t offset, int32_t &skip) {
 	for (int32_t nx = 0; nx < width; nx++) {
 		for (int32_t ny = 0; ny < height; ny++) {
-			std::shared_ptr<Tile> tile = g_game().map.getTile(static_cast<uint16_t>(x + nx + offset), static_cast<uint16_t>(y + ny + offset), static_cast<uint8_t>(z));
+			const auto tile = g_game().map.borrowTile(static_cast<uint16_t>(x + nx + offset), static_cast<uint16_t>(y + ny + offset), static_cast<uint8_t>(z));
 			if (tile) {
 				if (skip >= 0) {
 					msg.addByte(skip);
@@ -1489,7 +1496,7 @@ void ProtocolGame::GetFloorDescription(NetworkMessage &msg, int32_t x, int32_t y
 				}
 
 				skip = 0;
-				GetTileDescription(tile, msg);
+				GetTileDescription(*tile, msg);
 			} else if (skip == 0xFE) {
 				msg.addByte(0xFF);
 				msg.addByte(0xFF);
@@ -6389,11 +6396,7 @@ void ProtocolGame::sendPingBack() {
 	writeToOutputBuffer(msg);
 }
 
-void ProtocolGame::sendDistanceShoot(const Position &from, const Position &to, uint16_t type) {
-	if (oldProtocol && type > 0xFF) {
-		return;
-	}
-	NetworkMessage msg;
+void ProtocolGame::AddDistanceShoot(NetworkMessage &msg, const Position &from, const Position &to, uint16_t type, bool oldProtocol) {
 	if (oldProtocol) {
 		msg.addByte(0x85);
 		msg.addPosition(from);
@@ -6408,9 +6411,26 @@ void ProtocolGame::sendDistanceShoot(const Position &from, const Position &to, u
 		msg.addByte(static_cast<uint8_t>(static_cast<int8_t>(static_cast<int32_t>(to.y) - static_cast<int32_t>(from.y))));
 		msg.addByte(MAGIC_EFFECTS_END_LOOP);
 	}
+}
+
+void ProtocolGame::sendDistanceShoot(const Position &from, const Position &to, uint16_t type) {
+	if (oldProtocol && type > 0xFF) {
+		return;
+	}
+	NetworkMessage msg;
+	AddDistanceShoot(msg, from, to, type, oldProtocol);
 	writeToOutputBuffer(msg);
 }
 
+void ProtocolGame::sendDistanceShoot(const Position &from, const Position &to, uint16_t type, SharedMessageCache &shared) {
+	if (oldProtocol && type > 0xFF) {
+		return;
+	}
+	writeToOutputBuffer(shared.get(oldProtocol, [&](NetworkMessage &msg) {
+		AddDistanceShoot(msg, from, to, type, oldProtocol);
+	}));
+}
+
 void ProtocolGame::sendRestingStatus(uint8_t protection) {
 	if (oldProtocol || !player) {
 		return;
@@ -6456,12 +6476,7 @@ void ProtocolGame::sendRestingStatus(uint8_t protection) {
 	writeToOutputBuffer(msg);
 }
 
-void ProtocolGame::sendMagicEffect(const Position &pos, uint16_t type) {
-	if (!canSee(pos) || (oldProtocol && type > 0xFF)) {
-		return;
-	}
-
-	NetworkMessage msg;
+void ProtocolGame::AddMagicEffect(NetworkMessage &msg, const Position &pos, uint16_t type, bool oldProtocol) {
 	if (oldProtocol) {
 		msg.addByte(0x83);
 		msg.addPosition(pos);
@@ -6473,9 +6488,28 @@ void ProtocolGame::sendMagicEffect(const Position &pos, uint16_t type) {
 		msg.add<uint16_t>(type);
 		msg.addByte(MAGIC_EFFECTS_END_LOOP);
 	}
+}
+
+void ProtocolGame::sendMagicEffect(const Position &pos, uint16_t type) {
+	if (!canSee(pos) || (oldProtocol && type > 0xFF)) {
+		return;
+	}
+
+	NetworkMessage msg;
+	AddMagicEffect(msg, pos, type, oldProtocol);
 	writeToOutputBuffer(msg);
 }
 
+void ProtocolGame::sendMagicEffect(const Position &pos, uint16_t type, SharedMessageCache &shared) {
+	if (!canSee(pos) || (oldProtocol && type > 0xFF)) {
+		return;
+	}
+
+	writeToOutputBuffer(shared.get(oldProtocol, [&](NetworkMessage &msg) {
+		AddMagicEffect(msg, pos, type, oldProtocol);
+	}));
+}
+
 void ProtocolGame::removeMagicEffect(const Position &pos, uint16_t type) {
 	if (oldProtocol && type > 0xFF) {
 		return;
@@ -6491,12 +6525,7 @@ void ProtocolGame::removeMagicEffect(const Position &pos, uint16_t type) {
 	writeToOutputBuffer(msg);
 }
 
-void ProtocolGame::sendCreatureHealth(const std::shared_ptr<Creature> &creature) {
-	if (creature->isHealthHidden()) {
-		return;
-	}
-
-	NetworkMessage msg;
+void ProtocolGame::AddCreatureHealth(NetworkMessage &msg, const std::shared_ptr<Creature> &creature) {
 	msg.addByte(0x8C);
 	msg.add<uint32_t>(creature->getID());
 	if (creature->isHealthHidden()) {
@@ -6504,10 +6533,29 @@ void ProtocolGame::sendCreatureHealth(const std::shared_ptr<Creature> &creature)
 	} else {
 		msg.addByte(static_cast<uint8_t>(std::min<double>(100, std::ceil((static_cast<double>(creature->getHealth()) / std::max<int32_t>(creature->getMaxHealth(), 1)) * 100))));
 	}
+}
 
+void ProtocolGame::sendCreatureHealth(const std::shared_ptr<Creature> &creature) {
+	if (creature->isHealthHidden()) {
+		return;
+	}
+
+	NetworkMessage msg;
+	AddCreatureHealth(msg, creature);
 	writeToOutputBuffer(msg);
 }
 
+void ProtocolGame::sendCreatureHealth(const std::shared_ptr<Creature> &creature, SharedMessageCache &shared) {
+	if (creature->isHealthHidden()) {
+		return;
+	}
+
+	// Same bytes for both client flavours
+	writeToOutputBuffer(shared.get(false, [&](NetworkMessage &msg) {
+		AddCreatureHealth(msg, creature);
+	}));
+}
+
 void ProtocolGame::sendPartyCreatureUpdate(const std::shared_ptr<Creature> &target) {
 	if (!player || oldProtocol) {
 		return;
@@ -6723,7 +6771,7 @@ void ProtocolGame::sendUpdateTile(const std::shared_ptr<Tile> &tile, const Posit
 	msg.addPosition(pos);
 
 	if (tile) {
-		GetTileDescription(tile, msg);
+		GetTileDescription(*tile, msg);
 		msg.addByte(0x00);
 		msg.addByte(0xFF);
 	} else {
@@ -9228,33 +9276,45 @@ void ProtocolGame::sendBosstiaryEntryChanged(uint32_t bossid) {
 	writeToOutputBuffer(msg);
 }
 
-void ProtocolGame::sendSingleSoundEffect(const Position &pos, SoundEffect_t id, SourceEffect_t source) {
-	if (oldProtocol) {
-		return;
-	}
-
-	NetworkMessage msg;
+void ProtocolGame::AddSingleSoundEffect(NetworkMessage &msg, const Position &pos, SoundEffect_t id, SourceEffect_t source) {
 	msg.addByte(0x83);
 	msg.addPosition(pos);
 	msg.addByte(0x06); // Sound effect type
 	msg.addByte(static_cast<uint8_t>(source)); // Sound source type
 	msg.add<uint16_t>(static_cast<uint16_t>(id)); // Sound id
 	msg.addByte(0x00); // Breaking the effects loop
+}
+
+void ProtocolGame::sendSingleSoundEffect(const Position &pos, SoundEffect_t id, SourceEffect_t source) {
+	if (oldProtocol) {
+		return;
+	}
+
+	NetworkMessage msg;
+	AddSingleSoundEffect(msg, pos, id, source);
 	writeToOutputBuffer(msg);
 }
 
-void ProtocolGame::sendDoubleSoundEffect(
+void ProtocolGame::sendSingleSoundEffect(const Position &pos, SoundEffect_t id, SourceEffect_t source, SharedMessageCache &shared) {
+	if (oldProtocol) {
+		return;
+	}
+
+	auto* body = writeToOutputBuffer(shared.get(false, [&](NetworkMessage &msg) {
+		AddSingleSoundEffect(msg, pos, id, source);
+	}));
+	// The source depends on who hears the sound
+	body[SOUND_EFFECT_SOURCE_OFFSET] = static_cast<uint8_t>(source);
+}
+
+void ProtocolGame::AddDoubleSoundEffect(
+	NetworkMessage &msg,
 	const Position &pos,
 	SoundEffect_t mainSoundId,
 	SourceEffect_t mainSource,
 	SoundEffect_t secondarySoundId,
 	SourceEffect_t secondarySource
 ) {
-	if (oldProtocol) {
-		return;
-	}
-
-	NetworkMessage msg;
 	msg.addByte(0x83);
 	msg.addPosition(pos);
 
@@ -9270,9 +9330,44 @@ void ProtocolGame::sendDoubleSoundEffect(
 	msg.add<uint16_t>(static_cast<uint16_t>(secondarySoundId)); // Sound id
 
 	msg.addByte(0x00); // Breaking the effects loop
+}
+
+void ProtocolGame::sendDoubleSoundEffect(
+	const Position &pos,
+	SoundEffect_t mainSoundId,
+	SourceEffect_t mainSource,
+	SoundEffect_t secondarySoundId,
+	SourceEffect_t secondarySource
+) {
+	if (oldProtocol) {
+		return;
+	}
+
+	NetworkMessage msg;
+	AddDoubleSoundEffect(msg, pos, mainSoundId, mainSource, secondarySoundId, secondarySource);
 	writeToOutputBuffer(msg);
 }
 
+void ProtocolGame::sendDoubleSoundEffect(
+	const Position &pos,
+	SoundEffect_t mainSoundId,
+	SourceEffect_t mainSource,
+	SoundEffect_t secondarySoundId,
+	SourceEffect_t secondarySource,
+	SharedMessageCache &shared
+) {
+	if (oldProtocol) {
+		return;
+	}
+
+	auto* body = writeToOutputBuffer(shared.get(false, [&](NetworkMessage &msg) {
+		AddDoubleSoundEffect(msg, pos, mainSoundId, mainSource, secondarySoundId, secondarySource);
+	}));
+	// The sources depend on who hears the sounds
+	body[SOUND_EFFECT_SOURCE_OFFSET] = static_cast<uint8_t>(mainSource);
+	body[SECONDARY_SOUND_EFFECT_SOURCE_OFFSET] = static_cast<uint8_t>(secondarySource);
+}
+
 void ProtocolGame::parseOpenWheel(NetworkMessage &msg) {
 	if (oldProtocol || !g_configManager().getBoolean(TOGGLE_WHEELSYSTEM)) {
 		return;
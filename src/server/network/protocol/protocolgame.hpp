@@ -47,6 +47,8 @@ class Party;
 class Creature;
 class MonsterType;
 class Npc;
+class SharedMessage;
+class SharedMessageCache;
 
 struct ModalWindow;
 struct Position;
@@ -109,6 +111,17 @@ public:
 		return version;
 	}
 
+	// Encoders of the messages broadcast to every spectator, shared through SharedMessageCache
+	static void AddMagicEffect(NetworkMessage &msg, const Position &pos, uint16_t type, bool oldProtocol);
+	static void AddDistanceShoot(NetworkMessage &msg, const Position &from, const Position &to, uint16_t type, bool oldProtocol);
+	static void AddCreatureHealth(NetworkMessage &msg, const std::shared_ptr<Creature> &creature);
+	static void AddSingleSoundEffect(NetworkMessage &msg, const Position &pos, SoundEffect_t id, SourceEffect_t source);
+	static void AddDoubleSoundEffect(NetworkMessage &msg, const Position &pos, SoundEffect_t mainSoundId, SourceEffect_t mainSource, SoundEffect_t secondarySoundId, SourceEffect_t secondarySource);
+
+	// Where the source bytes sit in the sound effect bodies: opcode, position and effect type come first
+	static constexpr size_t SOUND_EFFECT_SOURCE_OFFSET = 7;
+	static constexpr size_t SECONDARY_SOUND_EFFECT_SOURCE_OFFSET = 12;
+
 private:
 	ProtocolGame_ptr getThis() {
 		return std::static_pointer_cast<ProtocolGame>(shared_from_this());
@@ -116,6 +129,7 @@ private:
 	void connect(const std::string &playerName, OperatingSystem_t operatingSystem);
 	void disconnectClient(const std::string &message) const;
 	void writeToOutputBuffer(const NetworkMessage &msg);
+	uint8_t* writeToOutputBuffer(const SharedMessage &msg);
 
 	void release() override;
 
@@ -306,10 +320,13 @@ private:
 
 	void sendAllowBugReport();
 	void sendDistanceShoot(const Position &from, const Position &to, uint16_t type);
+	void sendDistanceShoot(const Position &from, const Position &to, uint16_t type, SharedMessageCache &shared);
 	void sendMagicEffect(const Position &pos, uint16_t type);
+	void sendMagicEffect(const Position &pos, uint16_t type, SharedMessageCache &shared);
 	void removeMagicEffect(const Position &pos, uint16_t type);
 	void sendRestingStatus(uint8_t protection);
 	void sendCreatureHealth(const std::shared_ptr<Creature> &creature);
+	void sendCreatureHealth(const std::shared_ptr<Creature> &creature, SharedMessageCache &shared);
 	void sendPartyCreatureUpdate(const std::shared_ptr<Creature> &target);
 	void sendPartyCreatureShield(const std::shared_ptr<Creature> &target);
 	void sendPartyCreatureSkull(const std::shared_ptr<Creature> &target);
@@ -454,7 +471,7 @@ private:
 
 	// Help functions
 	// translate a tile to clientreadable format
-	void GetTileDescription(const std::shared_ptr<Tile> &tile, NetworkMessage &msg);
+	void GetTileDescription(Tile &tile, NetworkMessage &msg);
 
 	// translate a floor to clientreadable format
 	void GetFloorDescription(NetworkMessage &msg, int32_t x, int32_t y, int32_t z, int32_t width, int32_t height, int32_t offset, int32_t &skip);
@@ -514,7 +531,7 @@ private:
 	std::unordered_set<uint32_t> knownCreatureSet;
 	std::shared_ptr<Player> player = nullptr;
 
-	uint32_t eventConnect = 0;
+	uint64_t eventConnect = 0;
 	uint32_t challengeTimestamp = 0;
 	uint16_t version = 0;
 	int32_t clientVersion = 0;
@@ -540,7 +557,9 @@ private:
 	void addCreatureIcon(NetworkMessage &msg, const std::shared_ptr<Creature> &creature);
 
 	void sendSingleSoundEffect(const Position &pos, SoundEffect_t id, SourceEffect_t source);
+	void sendSingleSoundEffect(const Position &pos, SoundEffect_t id, SourceEffect_t source, SharedMessageCache &shared);
 	void sendDoubleSoundEffect(const Position &pos, SoundEffect_t mainSoundId, SourceEffect_t mainSource, SoundEffect_t secondarySoundId, SourceEffect_t secondarySource);
+	void sendDoubleSoundEffect(const Position &pos, SoundEffect_t mainSoundId, SourceEffect_t mainSource, SoundEffect_t secondarySoundId, SourceEffect_t secondarySource, SharedMessageCache &shared);
 
 	void sendHotkeyPreset();
 	void sendTakeScreenshot(Screenshot_t screenshotType);
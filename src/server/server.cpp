@@ -13,6 +13,7 @@
 #include "config/configmanager.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "creatures/players/management/ban.hpp"
+#include "utils/tools.hpp"
 
 ServiceManager::~ServiceManager() {
 	try {
@@ -24,6 +25,15 @@ ServiceManager::~ServiceManager() {
 
 void ServiceManager::die() {
 	io_service.stop();
+	connectionServices.stop();
+}
+
+void ServiceManager::startConnectionServices() {
+	auto threads = static_cast<size_t>(std::max<int32_t>(g_configManager().getNumber(NETWORK_THREADS), 0));
+	if (threads == 0) {
+		threads = std::max<size_t>(getNumberOfCores() / 4, 1);
+	}
+	connectionServices.start(threads);
 }
 
 void ServiceManager::run() {
@@ -87,7 +97,7 @@ void ServicePort::accept() {
 		return;
 	}
 
-	auto connection = ConnectionManager::getInstance().createConnection(io_service, shared_from_this());
+	auto connection = ConnectionManager::getInstance().createConnection(connection_services.getNextService(), shared_from_this());
 	acceptor->async_accept(connection->getSocket(), [self = shared_from_this(), connection](const std::error_code &error) { self->onAccept(connection, error); });
 }
 
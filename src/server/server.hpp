@@ -11,6 +11,7 @@
 
 #include "lib/metrics/metrics.hpp"
 #include "server/network/connection/connection.hpp"
+#include "server/network/connection/ioservicepool.hpp"
 #include "server/signals.hpp"
 
 class Protocol;
@@ -49,8 +50,8 @@ public:
 
 class ServicePort : public std::enable_shared_from_this<ServicePort> {
 public:
-	explicit ServicePort(asio::io_service &init_io_service) :
-		io_service(init_io_service) { }
+	ServicePort(asio::io_service &init_io_service, IOServicePool &init_connection_services) :
+		io_service(init_io_service), connection_services(init_connection_services) { }
 	~ServicePort();
 
 	// non-copyable
@@ -73,6 +74,8 @@ private:
 	void accept();
 
 	asio::io_service &io_service;
+	// Where the accepted connections live
+	IOServicePool &connection_services;
 	std::unique_ptr<asio::ip::tcp::acceptor> acceptor;
 	std::vector<Service_ptr> services;
 
@@ -101,10 +104,13 @@ public:
 
 private:
 	void die();
+	void startConnectionServices();
 
 	phmap::flat_hash_map<uint16_t, ServicePort_ptr> acceptors;
 
+	// Acceptors, signals and shutdown run here, connections are spread over the pool
 	asio::io_service io_service;
+	IOServicePool connectionServices;
 	Signals signals { io_service };
 	asio::high_resolution_timer death_timer { io_service };
 	bool running = false;
@@ -124,7 +130,8 @@ bool ServiceManager::add(uint16_t port) {
 	const auto foundServicePort = acceptors.find(port);
 
 	if (foundServicePort == acceptors.end()) {
-		service_port = std::make_shared<ServicePort>(io_service);
+		startConnectionServices();
+		service_port = std::make_shared<ServicePort>(io_service, connectionServices);
 		service_port->open(port);
 		acceptors[port] = service_port;
 	} else {
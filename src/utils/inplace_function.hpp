@@ -0,0 +1,149 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+template <typename Signature, size_t CAPACITY>
+class InplaceFunction;
+
+/**
+ * Move-only replacement for std::function that keeps the callable inside the object.
+ * Callables up to CAPACITY bytes (and no more aligned than a pointer) never touch the heap,
+ * bigger ones are still accepted but are allocated, exactly like std::function would.
+ */
+template <typename R, typename... Args, size_t CAPACITY>
+class InplaceFunction<R(Args...), CAPACITY> {
+	static_assert(CAPACITY >= sizeof(void*), "InplaceFunction capacity must hold at least a pointer");
+
+public:
+	InplaceFunction() noexcept = default;
+
+	InplaceFunction(std::nullptr_t) noexcept { }
+
+	template <typename F, typename D = std::decay_t<F>>
+		requires(!std::is_same_v<D, InplaceFunction> && std::is_invocable_r_v<R, D &, Args...>)
+	InplaceFunction(F &&f) {
+		if constexpr (std::is_pointer_v<D> || std::is_member_pointer_v<D> || std::is_same_v<D, std::function<R(Args...)>>) {
+			if (f == nullptr) {
+				return;
+			}
+		}
+
+		if constexpr (storesInline<D>()) {
+			std::construct_at(reinterpret_cast<D*>(storage), std::forward<F>(f));
+		} else {
+			*reinterpret_cast<D**>(storage) = new D(std::forward<F>(f));
+		}
+		ops = &OpsFor<D>::table;
+	}
+
+	InplaceFunction(InplaceFunction &&other) noexcept {
+		moveFrom(other);
+	}
+
+	InplaceFunction &operator=(InplaceFunction &&other) noexcept {
+		if (this != &other) {
+			reset();
+			moveFrom(other);
+		}
+		return *this;
+	}
+
+	InplaceFunction &operator=(std::nullptr_t) noexcept {
+		reset();
+		return *this;
+	}
+
+	~InplaceFunction() {
+		reset();
+	}
+
+	// Ensures that we don't accidentally copy it
+	InplaceFunction(const InplaceFunction &) = delete;
+	InplaceFunction &operator=(const InplaceFunction &) = delete;
+
+	R operator()(Args... args) const {
+		return ops->invoke(storage, std::forward<Args>(args)...);
+	}
+
+	explicit operator bool() const noexcept {
+		return ops != nullptr;
+	}
+
+	friend bool operator==(const InplaceFunction &f, std::nullptr_t) noexcept {
+		return f.ops == nullptr;
+	}
+
+	/**
+	 * Whether a callable of type F is stored without any heap allocation.
+	 */
+	template <typename F>
+	static constexpr bool storesInline() {
+		return sizeof(F) <= CAPACITY && alignof(F) <= alignof(void*) && std::is_nothrow_move_constructible_v<F>;
+	}
+
+private:
+	struct Ops {
+		R (*invoke)(std::byte* storage, Args &&... args);
+		// Moves the callable into 'to' and destroys what is left in 'from'
+		void (*relocate)(std::byte* from, std::byte* to) noexcept;
+		void (*destroy)(std::byte* storage) noexcept;
+	};
+
+	template <typename F>
+	struct OpsFor {
+		static F* get(std::byte* storage) {
+			if constexpr (storesInline<F>()) {
+				return std::launder(reinterpret_cast<F*>(storage));
+			} else {
+				return *reinterpret_cast<F**>(storage);
+			}
+		}
+
+		static R invoke(std::byte* storage, Args &&... args) {
+			return std::invoke(*get(storage), std::forward<Args>(args)...);
+		}
+
+		static void relocate(std::byte* from, std::byte* to) noexcept {
+			if constexpr (storesInline<F>()) {
+				auto* source = get(from);
+				std::construct_at(reinterpret_cast<F*>(to), std::move(*source));
+				std::destroy_at(source);
+			} else {
+				*reinterpret_cast<F**>(to) = get(from);
+			}
+		}
+
+		static void destroy(std::byte* storage) noexcept {
+			if constexpr (storesInline<F>()) {
+				std::destroy_at(get(storage));
+			} else {
+				delete get(storage);
+			}
+		}
+
+		static constexpr Ops table { &invoke, &relocate, &destroy };
+	};
+
+	void moveFrom(InplaceFunction &other) noexcept {
+		if (other.ops) {
+			other.ops->relocate(other.storage, storage);
+			ops = std::exchange(other.ops, nullptr);
+		}
+	}
+
+	void reset() noexcept {
+		if (ops) {
+			std::exchange(ops, nullptr)->destroy(storage);
+		}
+	}
+
+	alignas(void*) mutable std::byte storage[CAPACITY];
+	const Ops* ops = nullptr;
+};
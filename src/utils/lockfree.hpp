@@ -66,3 +66,87 @@ public:
 		::operator delete(p);
 	}
 };
+
+/**
+ * Bounded single-producer/single-consumer ring buffer.
+ * Exactly one thread may push and exactly one (possibly different) thread may consume,
+ * neither side takes a lock. Capacity must be a power of two.
+ */
+template <typename T, size_t CAPACITY>
+class SPSCQueue {
+	static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0, "SPSCQueue capacity must be a power of two");
+
+public:
+	SPSCQueue() :
+		slots(std::make_unique<Slot[]>(CAPACITY)) { }
+
+	~SPSCQueue() {
+		consume_all([](T &&) { });
+	}
+
+	// Ensures that we don't accidentally copy it
+	SPSCQueue(const SPSCQueue &) = delete;
+	SPSCQueue &operator=(const SPSCQueue &) = delete;
+
+	/**
+	 * Constructs an element in place, producer side only.
+	 * Arguments are left untouched when the ring is full, so the caller may forward them elsewhere.
+	 */
+	template <typename... Args>
+	bool try_emplace(Args &&... args) {
+		const auto tail = m_tail.load(std::memory_order_relaxed);
+		if (tail - m_headCache == CAPACITY) {
+			m_headCache = m_head.load(std::memory_order_acquire);
+			if (tail - m_headCache == CAPACITY) {
+				return false;
+			}
+		}
+
+		std::construct_at(at(tail), std::forward<Args>(args)...);
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Moves every element published so far into the callback, consumer side only.
+	 * Returns how many elements were consumed.
+	 */
+	template <typename F>
+	size_t consume_all(F &&f) {
+		const auto head = m_head.load(std::memory_order_relaxed);
+		const auto tail = m_tail.load(std::memory_order_acquire);
+		for (auto i = head; i != tail; ++i) {
+			auto* element = at(i);
+			f(std::move(*element));
+			std::destroy_at(element);
+		}
+
+		m_head.store(tail, std::memory_order_release);
+		return tail - head;
+	}
+
+	[[nodiscard]] bool empty() const {
+		return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+	}
+
+	[[nodiscard]] static constexpr size_t capacity() {
+		return CAPACITY;
+	}
+
+private:
+	struct Slot {
+		alignas(T) std::byte data[sizeof(T)];
+	};
+
+	T* at(size_t index) const {
+		return std::launder(reinterpret_cast<T*>(slots[index & (CAPACITY - 1)].data));
+	}
+
+	std::unique_ptr<Slot[]> slots;
+
+	// Consumer cursor
+	alignas(64) std::atomic_size_t m_head = 0;
+	// Producer cursor and its cached view of the consumer cursor
+	alignas(64) std::atomic_size_t m_tail = 0;
+	size_t m_headCache = 0;
+};
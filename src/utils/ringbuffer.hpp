@@ -0,0 +1,110 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include <bit>
+#include <vector>
+
+// FIFO queue over a single power of two sized vector, used instead of std::list/std::deque
+// where elements are pushed at the back and popped from the front all the time.
+// It only grows (doubling), so in steady state pushing and popping never allocate.
+
+namespace stdext {
+	template <typename T>
+	class ring_buffer {
+	public:
+		ring_buffer() = default;
+
+		explicit ring_buffer(size_t reserveSize) {
+			reserve(reserveSize);
+		}
+
+		void push_back(const T &v) {
+			emplace_back(v);
+		}
+
+		void push_back(T &&_Val) {
+			emplace_back(std::move(_Val));
+		}
+
+		template <class... _Valty>
+		T &emplace_back(_Valty &&... v) {
+			if (count == container.size()) {
+				reserve(count + 1);
+			}
+
+			auto &slot = container[(head + count) & (container.size() - 1)];
+			slot = T(std::forward<_Valty>(v)...);
+			++count;
+			return slot;
+		}
+
+		T &front() {
+			return container[head];
+		}
+
+		const T &front() const {
+			return container[head];
+		}
+
+		void pop_front() {
+			// Releases what the element holds right away, the slot itself is reused
+			container[head] = T();
+			head = (head + 1) & (container.size() - 1);
+			--count;
+		}
+
+		T &operator[](size_t index) {
+			return container[(head + index) & (container.size() - 1)];
+		}
+
+		const T &operator[](size_t index) const {
+			return container[(head + index) & (container.size() - 1)];
+		}
+
+		bool empty() const noexcept {
+			return count == 0;
+		}
+
+		size_t size() const noexcept {
+			return count;
+		}
+
+		size_t capacity() const noexcept {
+			return container.size();
+		}
+
+		void clear() noexcept {
+			while (!empty()) {
+				pop_front();
+			}
+		}
+
+		void reserve(size_t newCapacity) {
+			newCapacity = std::bit_ceil(std::max<size_t>(newCapacity, 4));
+			if (newCapacity <= container.size()) {
+				return;
+			}
+
+			std::vector<T> newContainer(newCapacity);
+			for (size_t i = 0; i < count; ++i) {
+				newContainer[i] = std::move((*this)[i]);
+			}
+
+			container = std::move(newContainer);
+			head = 0;
+		}
+
+	private:
+		std::vector<T> container;
+		size_t head = 0;
+		size_t count = 0;
+	};
+}
@@ -0,0 +1,144 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "injection_fixture.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "items/tile.hpp"
+#include "lib/thread/thread_pool.hpp"
+#include "map/map.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr uint16_t MAP_OFFSET = 1000;
+	constexpr uint16_t MAP_SIZE = 512;
+	constexpr uint8_t FLOOR = 7;
+	constexpr size_t MONSTERS = 20000;
+	constexpr size_t TARGETS_PER_MONSTER = 4;
+	constexpr int ROUNDS = 10;
+
+	// Mirrors Game::prepareCreaturesThink
+	constexpr uint8_t REGION_BITS = 7;
+	constexpr size_t MAX_SHARD_SIZE = 64;
+
+	struct SyntheticMonster {
+		Position position;
+		std::array<Position, TARGETS_PER_MONSTER> targets;
+		uint8_t attackable = 0;
+	};
+
+	void createMap(Map &map) {
+		for (uint16_t x = 0; x < MAP_SIZE; ++x) {
+			for (uint16_t y = 0; y < MAP_SIZE; ++y) {
+				map.setTile(MAP_OFFSET + x, MAP_OFFSET + y, FLOOR, std::make_shared<StaticTile>(MAP_OFFSET + x, MAP_OFFSET + y, FLOOR));
+			}
+		}
+	}
+
+	std::vector<SyntheticMonster> createMonsters() {
+		std::mt19937 rng(11);
+		// Monsters gather around hunting spots, like on a real map
+		std::uniform_int_distribution<int> spot(16, MAP_SIZE - 17);
+		std::normal_distribution<double> spread(0, 12);
+		std::uniform_int_distribution<int> offset(-7, 7);
+
+		std::vector<std::pair<int, int>> spots(64);
+		for (auto &[x, y] : spots) {
+			x = spot(rng);
+			y = spot(rng);
+		}
+
+		const auto clamp = [](double value) {
+			return static_cast<uint16_t>(MAP_OFFSET + std::clamp<int>(static_cast<int>(value), 8, MAP_SIZE - 9));
+		};
+
+		std::vector<SyntheticMonster> monsters(MONSTERS);
+		for (size_t i = 0; i < monsters.size(); ++i) {
+			const auto &[x, y] = spots[i % spots.size()];
+			auto &monster = monsters[i];
+			monster.position = Position(clamp(x + spread(rng)), clamp(y + spread(rng)), FLOOR);
+			for (auto &target : monster.targets) {
+				target = Position(monster.position.x + offset(rng), monster.position.y + offset(rng), FLOOR);
+			}
+		}
+
+		// The think list keeps creatures in a random order
+		std::ranges::shuffle(monsters, rng);
+		return monsters;
+	}
+
+	void evaluate(Map &map, SyntheticMonster &monster) {
+		monster.attackable = 0;
+		for (size_t i = 0; i < monster.targets.size(); ++i) {
+			if (map.isSightClear(monster.position, monster.targets[i], true)) {
+				monster.attackable |= 1 << i;
+			}
+		}
+	}
+}
+
+suite<"benchmark"> creatureThinkBenchmark = [] {
+	test("Creature think decisions: serial vs sharded by map region") = [] {
+		InjectionFixture fixture;
+		ThreadPool threadPool(fixture.logger());
+		Dispatcher dispatcher(threadPool);
+
+		Map map;
+		createMap(map);
+		auto monsters = createMonsters();
+
+		Benchmark serial;
+		for (int round = 0; round < ROUNDS; ++round) {
+			for (auto &monster : monsters) {
+				evaluate(map, monster);
+			}
+		}
+		const auto serialMs = serial.duration();
+
+		std::vector<uint8_t> expected;
+		expected.reserve(monsters.size());
+		for (const auto &monster : monsters) {
+			expected.emplace_back(monster.attackable);
+		}
+
+		std::vector<std::pair<uint64_t, SyntheticMonster*>> regionMonsters;
+		std::vector<size_t> shards;
+
+		Benchmark parallel;
+		for (int round = 0; round < ROUNDS; ++round) {
+			regionMonsters.clear();
+			for (auto &monster : monsters) {
+				const auto &pos = monster.position;
+				const auto region = static_cast<uint64_t>(pos.z) << 32 | static_cast<uint64_t>(pos.x >> REGION_BITS) << 16 | static_cast<uint64_t>(pos.y >> REGION_BITS);
+				regionMonsters.emplace_back(region, &monster);
+			}
+
+			std::ranges::sort(regionMonsters, {}, &std::pair<uint64_t, SyntheticMonster*>::first);
+
+			shards.clear();
+			for (size_t i = 0; i < regionMonsters.size(); ++i) {
+				if (i == 0 || regionMonsters[i].first != regionMonsters[i - 1].first || i - shards.back() == MAX_SHARD_SIZE) {
+					shards.emplace_back(i);
+				}
+			}
+			shards.emplace_back(regionMonsters.size());
+
+			dispatcher.asyncWait(shards.size() - 1, [&](size_t i) {
+				for (auto j = shards[i]; j < shards[i + 1]; ++j) {
+					evaluate(map, *regionMonsters[j].second);
+				}
+			});
+		}
+		const auto parallelMs = parallel.duration();
+
+		fmt::print("{} monsters, {} targets each, {} rounds, {} threads\n", MONSTERS, TARGETS_PER_MONSTER, ROUNDS, threadPool.get_thread_count());
+		fmt::print("  {:<14} {:>8.2f}ms\n", "serial", serialMs);
+		fmt::print("  {:<14} {:>8.2f}ms ({} shards)\n", "sharded", parallelMs, shards.size() - 1);
+
+		// The decisions must not depend on how the work was split
+		for (size_t i = 0; i < monsters.size(); ++i) {
+			expect(eq(expected[i], monsters[i].attackable));
+		}
+	};
+};
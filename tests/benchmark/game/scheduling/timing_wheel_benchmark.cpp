@@ -0,0 +1,136 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/scheduling/timing_wheel.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr size_t PENDING_TIMERS = 500000;
+	constexpr int64_t START = 1700000000000;
+	constexpr int64_t TICK = 50;
+
+	struct Timer {
+		int64_t expiry;
+		uint64_t id;
+	};
+
+	std::vector<int64_t> generateDelays() {
+		std::mt19937 rng(7);
+		// Mostly short creature/decay timers with a tail of long Lua addEvent delays
+		std::uniform_int_distribution<int64_t> shortDelay(50, 2000);
+		std::uniform_int_distribution<int64_t> longDelay(2000, 3600000);
+
+		std::vector<int64_t> delays(PENDING_TIMERS);
+		for (auto &delay : delays) {
+			delay = rng() % 4 == 0 ? longDelay(rng) : shortDelay(rng);
+		}
+		return delays;
+	}
+
+	// Mirrors the previous Dispatcher storage: ordered multiset plus a separate id map for stopEvent
+	struct BtreeTimers {
+		struct Compare {
+			bool operator()(const std::shared_ptr<Timer> &a, const std::shared_ptr<Timer> &b) const {
+				return a->expiry < b->expiry;
+			}
+		};
+
+		phmap::btree_multiset<std::shared_ptr<Timer>, Compare> ordered;
+		phmap::parallel_flat_hash_map_m<uint64_t, std::shared_ptr<Timer>> byId;
+		uint64_t lastId = 0;
+
+		uint64_t schedule(int64_t expiry) {
+			auto timer = std::make_shared<Timer>(Timer { expiry, ++lastId });
+			byId.emplace(timer->id, timer);
+			ordered.emplace(std::move(timer));
+			return lastId;
+		}
+
+		void stop(uint64_t id) {
+			byId.erase(id);
+		}
+
+		size_t expire(int64_t now) {
+			size_t fired = 0;
+			auto it = ordered.begin();
+			for (; it != ordered.end() && (*it)->expiry <= now; ++it) {
+				fired += byId.erase((*it)->id);
+			}
+			ordered.erase(ordered.begin(), it);
+			return fired;
+		}
+	};
+
+	struct WheelTimers {
+		TimerSlots slots;
+		TimingWheel wheel { slots };
+		std::vector<uint32_t> expired;
+
+		WheelTimers() {
+			wheel.start(START);
+		}
+
+		uint64_t schedule(int64_t expiry) {
+			const auto id = slots.acquire();
+			wheel.insert(TimerSlots::indexOf(id), expiry);
+			return id;
+		}
+
+		void stop(uint64_t id) {
+			if (slots.cancel(id)) {
+				wheel.remove(TimerSlots::indexOf(id));
+				slots.release(id);
+			}
+		}
+
+		size_t expire(int64_t now) {
+			expired.clear();
+			wheel.advance(now, expired);
+			for (const auto index : expired) {
+				slots.release((static_cast<uint64_t>(slots.at(index).generation.load()) << 32) | index);
+			}
+			return expired.size();
+		}
+	};
+
+	template <typename Timers>
+	void run(std::string_view name, const std::vector<int64_t> &delays) {
+		Timers timers;
+		std::vector<uint64_t> ids;
+		ids.reserve(delays.size());
+
+		Benchmark insert;
+		for (const auto delay : delays) {
+			ids.emplace_back(timers.schedule(START + delay));
+		}
+		const auto insertMs = insert.duration();
+
+		Benchmark cancel;
+		for (size_t i = 0; i < ids.size(); i += 2) {
+			timers.stop(ids[i]);
+		}
+		const auto cancelMs = cancel.duration();
+
+		// Walks the timeline the way the dispatcher does, one 50ms tick at a time
+		Benchmark expire;
+		size_t fired = 0;
+		for (auto now = START; now <= START + 3600000; now += TICK) {
+			fired += timers.expire(now);
+		}
+		const auto expireMs = expire.duration();
+
+		fmt::print("  {:<14} insert {:>8.2f}ms | cancel {:>8.2f}ms | expire {:>8.2f}ms ({} fired)\n", name, insertMs, cancelMs, expireMs, fired);
+		expect(eq(delays.size() / 2, fired));
+	}
+}
+
+suite<"benchmark"> timingWheelBenchmark = [] {
+	test("Scheduled events: btree multiset vs timing wheel") = [] {
+		const auto delays = generateDelays();
+		fmt::print("{} pending timers\n", PENDING_TIMERS);
+		run<BtreeTimers>("btree + map", delays);
+		run<WheelTimers>("timing wheel", delays);
+	};
+};
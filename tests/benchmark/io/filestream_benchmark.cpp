@@ -0,0 +1,127 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#ifndef _WIN32
+	#include <sys/resource.h>
+#endif
+
+#include "io/filestream.hpp"
+#include "io/fileloader.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr size_t TILES = 2000000;
+	constexpr uint8_t TILE_NODE = 5;
+	constexpr uint8_t ITEM_NODE = 6;
+
+	void writeEscaped(std::vector<uint8_t> &out, const uint8_t* data, size_t size) {
+		for (size_t i = 0; i < size; ++i) {
+			if (data[i] >= OTB::Node::ESCAPE) {
+				out.emplace_back(OTB::Node::ESCAPE);
+			}
+			out.emplace_back(data[i]);
+		}
+	}
+
+	template <typename T>
+	void writeValue(std::vector<uint8_t> &out, T value) {
+		writeEscaped(out, reinterpret_cast<const uint8_t*>(&value), sizeof(T));
+	}
+
+	// Tile nodes with a position and one item each, shaped like an OTBM tile area.
+	// Written in small chunks so that generating the file does not raise the peak RSS.
+	std::filesystem::path createMapFile() {
+		const auto path = std::filesystem::temp_directory_path() / "canary_filestream_benchmark.otbm";
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+		std::mt19937 rng(17);
+		std::vector<uint8_t> data;
+		for (size_t i = 0; i < TILES; ++i) {
+			data.emplace_back(OTB::Node::START);
+			data.emplace_back(TILE_NODE);
+			writeValue<uint16_t>(data, static_cast<uint16_t>(rng()));
+			writeValue<uint16_t>(data, static_cast<uint16_t>(rng()));
+			writeValue<uint32_t>(data, static_cast<uint32_t>(rng()));
+
+			data.emplace_back(OTB::Node::START);
+			data.emplace_back(ITEM_NODE);
+			writeValue<uint16_t>(data, static_cast<uint16_t>(rng()));
+			data.emplace_back(OTB::Node::END);
+
+			data.emplace_back(OTB::Node::END);
+
+			if (data.size() >= 64 * 1024 || i + 1 == TILES) {
+				file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+				data.clear();
+			}
+		}
+		return path;
+	}
+
+	uint64_t parse(FileStream &stream) {
+		uint64_t checksum = 0;
+		while (stream.startNode(TILE_NODE)) {
+			checksum += stream.getU16();
+			checksum += stream.getU16();
+			checksum += stream.getU32();
+			if (stream.startNode(ITEM_NODE)) {
+				checksum += stream.getU16();
+				stream.endNode();
+			}
+			stream.endNode();
+		}
+		return checksum;
+	}
+
+	// Peak resident set size in KB, 0 where it is not available
+	long peakRss() {
+#ifndef _WIN32
+		rusage usage {};
+		getrusage(RUSAGE_SELF, &usage);
+		return usage.ru_maxrss;
+#else
+		return 0;
+#endif
+	}
+}
+
+suite<"benchmark"> fileStreamBenchmark = [] {
+	test("Map file loading: copied buffer vs memory-mapped stream") = [] {
+		const auto path = createMapFile();
+		const auto fileSize = std::filesystem::file_size(path);
+
+		// Runs first, the peak RSS only grows
+		const auto rssBefore = peakRss();
+		Benchmark mapped;
+		uint64_t mappedChecksum = 0;
+		{
+			FileStream stream { mio::mmap_source(path.string()) };
+			mappedChecksum = parse(stream);
+		}
+		const auto mappedMs = mapped.duration();
+		const auto rssMapped = peakRss();
+
+		Benchmark copied;
+		uint64_t copiedChecksum = 0;
+		{
+			// What FileStream used to do: copy the whole mapping before parsing it
+			const auto source = mio::mmap_source(path.string());
+			std::vector<char> buffer(source.begin(), source.end());
+			FileStream stream { buffer.data(), buffer.data() + buffer.size() };
+			copiedChecksum = parse(stream);
+		}
+		const auto copiedMs = copied.duration();
+		const auto rssCopied = peakRss();
+
+		std::filesystem::remove(path);
+
+		fmt::print("{} tiles, {} MB file, peak RSS {} KB before loading\n", TILES, fileSize / (1024 * 1024), rssBefore);
+		fmt::print("  {:<10} {:>8.2f}ms, peak RSS {} KB\n", "mapped", mappedMs, rssMapped);
+		fmt::print("  {:<10} {:>8.2f}ms, peak RSS {} KB\n", "copied", copiedMs, rssCopied);
+
+		expect(eq(mappedChecksum, copiedChecksum));
+		expect(neq(mappedChecksum, uint64_t { 0 }));
+	};
+};
@@ -0,0 +1,149 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "items/decay/decaywheel.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr size_t ITEMS = 200000;
+	constexpr int64_t TICK = 50;
+	constexpr int64_t START = 1700000000000;
+
+	struct DecayingItem {
+		explicit DecayingItem(int64_t timestamp) :
+			timestamp(timestamp) { }
+
+		DecayHandle &getDecayHandle() {
+			return handle;
+		}
+
+		int64_t timestamp;
+		DecayHandle handle;
+	};
+
+	using Item_ptr = std::shared_ptr<DecayingItem>;
+
+	struct Result {
+		double ms = 0;
+		size_t expired = 0;
+		uint64_t digest = 0;
+	};
+
+	// A busy server: mostly corpses and fields decaying within minutes, some items lasting hours,
+	// and every fifth one picked up or moved (decay stopped) before it expires
+	struct Workload {
+		std::vector<Item_ptr> items;
+		std::vector<size_t> stopped;
+		int64_t end = 0;
+	};
+
+	Workload createWorkload() {
+		std::mt19937 rng(17);
+		std::uniform_int_distribution<int> roll(0, 99);
+		std::uniform_int_distribution<int64_t> fields(1000, 120000);
+		std::uniform_int_distribution<int64_t> corpses(60000, 600000);
+		std::uniform_int_distribution<int64_t> hours(3600000, 4 * 3600000);
+
+		Workload workload;
+		workload.items.reserve(ITEMS);
+		for (size_t i = 0; i < ITEMS; ++i) {
+			const auto kind = roll(rng);
+			const auto duration = kind < 40 ? fields(rng) : kind < 95 ? corpses(rng) : hours(rng);
+			workload.items.emplace_back(std::make_shared<DecayingItem>(START + duration));
+			workload.end = std::max(workload.end, START + duration + TICK);
+			if (roll(rng) < 20) {
+				workload.stopped.emplace_back(i);
+			}
+		}
+		return workload;
+	}
+
+	// Order independent, both schedulers must expire the same items in the same tick
+	void fold(Result &result, const Item_ptr &item, int64_t now) {
+		result.digest += static_cast<uint64_t>(item->timestamp) * 31 + static_cast<uint64_t>(now / TICK);
+		++result.expired;
+	}
+
+	// What Decay did before: one ordered map entry per timestamp, stopping scans the entry's vector
+	Result runMap(const Workload &workload) {
+		std::map<int64_t, std::vector<Item_ptr>> decayMap;
+		Result result;
+		Benchmark bm;
+		for (const auto &item : workload.items) {
+			decayMap[item->timestamp].push_back(item);
+		}
+
+		for (const auto index : workload.stopped) {
+			const auto &item = workload.items[index];
+			const auto it = decayMap.find(item->timestamp);
+			auto &decayItems = it->second;
+			const auto found = std::ranges::find(decayItems, item);
+			*found = decayItems.back();
+			decayItems.pop_back();
+			if (decayItems.empty()) {
+				decayMap.erase(it);
+			}
+		}
+
+		std::vector<Item_ptr> expired;
+		for (int64_t now = START; now <= workload.end && !decayMap.empty(); now += TICK) {
+			expired.clear();
+			auto it = decayMap.begin();
+			while (it != decayMap.end() && it->first <= now) {
+				expired.insert(expired.end(), it->second.begin(), it->second.end());
+				it = decayMap.erase(it);
+			}
+			for (const auto &item : expired) {
+				fold(result, item, now);
+			}
+		}
+		result.ms = bm.duration();
+		return result;
+	}
+
+	Result runWheel(const Workload &workload) {
+		auto wheel = std::make_unique<DecayWheel<DecayingItem>>();
+		Result result;
+		Benchmark bm;
+		for (const auto &item : workload.items) {
+			wheel->add(item, item->timestamp, START);
+		}
+
+		for (const auto index : workload.stopped) {
+			wheel->remove(workload.items[index]);
+		}
+
+		std::vector<Item_ptr> expired;
+		for (int64_t now = START; now <= workload.end && !wheel->empty(); now += TICK) {
+			expired.clear();
+			wheel->advance(now, expired);
+			for (const auto &item : expired) {
+				fold(result, item, now);
+			}
+		}
+		result.ms = bm.duration();
+		return result;
+	}
+}
+
+suite<"benchmark"> decayBenchmark = [] {
+	test("Decay scheduling: ordered map vs timing wheel") = [] {
+		const auto workload = createWorkload();
+
+		const auto map = runMap(workload);
+		for (auto &item : workload.items) {
+			item->handle = {};
+		}
+		const auto wheel = runWheel(workload);
+
+		fmt::print("{} decaying items, {} stopped, {} ticks of {}ms\n", ITEMS, workload.stopped.size(), (workload.end - START) / TICK, TICK);
+		fmt::print("  {:<6} {:>8.2f}ms\n", "map", map.ms);
+		fmt::print("  {:<6} {:>8.2f}ms\n", "wheel", wheel.ms);
+
+		expect(eq(map.expired, ITEMS - workload.stopped.size()));
+		expect(eq(wheel.expired, map.expired));
+		expect(eq(wheel.digest, map.digest));
+	};
+};
@@ -0,0 +1,386 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "injection_fixture.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "lib/thread/thread_pool.hpp"
+#include "map/utils/astarnodes.hpp"
+#include "map/utils/flowfield.hpp"
+#include "map/utils/pathfinder.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr int32_t AREA = 48;
+	constexpr uint16_t AREA_X = 1000;
+	constexpr uint16_t AREA_Y = 1000;
+	constexpr uint8_t AREA_Z = 8;
+	constexpr size_t MONSTERS = 30;
+	constexpr int TICKS = 300;
+	constexpr int32_t MAX_SEARCH_DIST = 12;
+	// AStarNodes::getTileWalkCost for a field the monster isn't immune to
+	constexpr int32_t FIELD_COST = 180;
+	constexpr size_t CLICKS_PER_TICK = 400;
+	constexpr int CLICK_TICKS = 50;
+
+	// A cave respawn: rocks, the odd fire field, monsters blocking each other around one player
+	struct Respawn {
+		std::vector<uint8_t> rocks;
+		std::vector<uint8_t> fields;
+		std::vector<uint8_t> occupied;
+		Position player;
+		std::vector<Position> monsters;
+
+		static size_t indexOf(const Position &pos) {
+			return static_cast<size_t>((pos.y - AREA_Y) * AREA + (pos.x - AREA_X));
+		}
+
+		bool inside(const Position &pos) const {
+			return pos.x >= AREA_X && pos.y >= AREA_Y && pos.x < AREA_X + AREA && pos.y < AREA_Y + AREA;
+		}
+
+		// What Tile::queryAdd(FLAG_PATHFINDING) says for a monster
+		bool isWalkable(const Position &pos) const {
+			return inside(pos) && !rocks[indexOf(pos)] && !occupied[indexOf(pos)];
+		}
+
+		int32_t getExtraCost(const Position &pos) const {
+			return fields[indexOf(pos)] ? FIELD_COST : 0;
+		}
+
+		// Map::canWalkTo: the tile the walker stands on is always fine
+		bool canWalkTo(const Position &from, const Position &pos) const {
+			return pos == from || isWalkable(pos);
+		}
+	};
+
+	Respawn createRespawn() {
+		std::mt19937 rng(18);
+		std::uniform_int_distribution<int> roll(0, 99);
+		std::uniform_int_distribution<int> offset(-7, 7);
+
+		Respawn respawn;
+		respawn.rocks.resize(AREA * AREA);
+		respawn.fields.resize(AREA * AREA);
+		respawn.occupied.resize(AREA * AREA);
+		for (int32_t i = 0; i < AREA * AREA; ++i) {
+			const auto kind = roll(rng);
+			respawn.rocks[i] = kind < 18 ? 1 : 0;
+			respawn.fields[i] = kind >= 97 ? 1 : 0;
+		}
+
+		respawn.player = Position(AREA_X + AREA / 2, AREA_Y + AREA / 2, AREA_Z);
+		respawn.rocks[Respawn::indexOf(respawn.player)] = 0;
+		respawn.occupied[Respawn::indexOf(respawn.player)] = 1;
+		while (respawn.monsters.size() < MONSTERS) {
+			const Position pos(respawn.player.x + offset(rng), respawn.player.y + offset(rng), AREA_Z);
+			// Still walking in from the spawn, not next to the player yet
+			if (respawn.isWalkable(pos) && std::max(Position::getDistanceX(pos, respawn.player), Position::getDistanceY(pos, respawn.player)) > 2) {
+				respawn.occupied[Respawn::indexOf(pos)] = 1;
+				respawn.monsters.emplace_back(pos);
+			}
+		}
+		return respawn;
+	}
+
+	Position step(const Position &pos, Direction dir) {
+		switch (dir) {
+			case DIRECTION_NORTH:
+				return Position(pos.x, pos.y - 1, pos.z);
+			case DIRECTION_EAST:
+				return Position(pos.x + 1, pos.y, pos.z);
+			case DIRECTION_SOUTH:
+				return Position(pos.x, pos.y + 1, pos.z);
+			case DIRECTION_WEST:
+				return Position(pos.x - 1, pos.y, pos.z);
+			case DIRECTION_NORTHWEST:
+				return Position(pos.x - 1, pos.y - 1, pos.z);
+			case DIRECTION_NORTHEAST:
+				return Position(pos.x + 1, pos.y - 1, pos.z);
+			case DIRECTION_SOUTHWEST:
+				return Position(pos.x - 1, pos.y + 1, pos.z);
+			default:
+				return Position(pos.x + 1, pos.y + 1, pos.z);
+		}
+	}
+
+	// Cost the path has for A*, the same for both searches
+	int64_t pathCost(const Respawn &respawn, Position pos, const std::vector<Direction> &dirList) {
+		int64_t cost = 0;
+		for (const auto dir : dirList) {
+			pos = step(pos, dir);
+			cost += (dir & DIRECTION_DIAGONAL_MASK ? 35 : 10) + respawn.getExtraCost(pos);
+		}
+		return cost;
+	}
+
+	bool isGoal(const Position &pos, const Position &target) {
+		return std::max(Position::getDistanceX(pos, target), Position::getDistanceY(pos, target)) == 1;
+	}
+
+	// Map::getPathMatchingCond for a melee monster (min/max target distance 1, full path search, search distance 12)
+	bool findPathAStar(const Respawn &respawn, const Position &startPos, const Position &targetPos, std::vector<Direction> &dirList) {
+		static constexpr std::array<std::pair<int32_t, int32_t>, 8> neighbors { {
+			{ -1, 0 },
+			{ 0, 1 },
+			{ 1, 0 },
+			{ 0, -1 },
+			{ -1, -1 },
+			{ 1, -1 },
+			{ 1, 1 },
+			{ -1, 1 },
+		} };
+
+		AStarNodes nodes(startPos.x, startPos.y, 0);
+		const int_fast32_t sX = std::abs(targetPos.getX() - startPos.getX());
+		const int_fast32_t sY = std::abs(targetPos.getY() - startPos.getY());
+
+		Position pos = startPos;
+		const AStarNode* found = nullptr;
+		while (true) {
+			AStarNode* n = nodes.getBestNode();
+			if (!n) {
+				break;
+			}
+
+			pos.x = n->x;
+			pos.y = n->y;
+			if (isGoal(pos, targetPos)) {
+				found = n;
+				break;
+			}
+
+			bool full = false;
+			for (const auto &[dx, dy] : neighbors) {
+				pos.x = n->x + dx;
+				pos.y = n->y + dy;
+				if (Position::getDistanceX(startPos, pos) > MAX_SEARCH_DIST || Position::getDistanceY(startPos, pos) > MAX_SEARCH_DIST) {
+					continue;
+				}
+
+				int_fast32_t extraCost;
+				AStarNode* neighborNode = nodes.getNodeByPosition(pos.x, pos.y);
+				if (neighborNode) {
+					extraCost = neighborNode->c;
+				} else {
+					if (!respawn.canWalkTo(startPos, pos)) {
+						continue;
+					}
+					extraCost = respawn.getExtraCost(pos);
+				}
+
+				const int_fast32_t newf = n->f + AStarNodes::getMapWalkCost(n, pos) + extraCost;
+				if (neighborNode) {
+					if (neighborNode->f <= newf) {
+						continue;
+					}
+					neighborNode->f = newf;
+					neighborNode->parent = n;
+					nodes.openNode(neighborNode);
+				} else {
+					const int_fast32_t dX = std::abs(targetPos.getX() - pos.getX());
+					const int_fast32_t dY = std::abs(targetPos.getY() - pos.getY());
+					if (!nodes.createOpenNode(n, pos.x, pos.y, newf, ((dX - sX) << 3) + ((dY - sY) << 3) + (std::max(dX, dY) << 3), extraCost)) {
+						full = true;
+						break;
+					}
+				}
+			}
+			if (full) {
+				break;
+			}
+			nodes.closeNode(n);
+		}
+
+		if (!found) {
+			return false;
+		}
+
+		std::vector<Direction> reversed;
+		for (const AStarNode* node = found; node->parent; node = node->parent) {
+			const int32_t dx = node->x - node->parent->x;
+			const int32_t dy = node->y - node->parent->y;
+			if (dx == 0) {
+				reversed.emplace_back(dy < 0 ? DIRECTION_NORTH : DIRECTION_SOUTH);
+			} else if (dy == 0) {
+				reversed.emplace_back(dx < 0 ? DIRECTION_WEST : DIRECTION_EAST);
+			} else if (dy < 0) {
+				reversed.emplace_back(dx < 0 ? DIRECTION_NORTHWEST : DIRECTION_NORTHEAST);
+			} else {
+				reversed.emplace_back(dx < 0 ? DIRECTION_SOUTHWEST : DIRECTION_SOUTHEAST);
+			}
+		}
+		dirList.assign(reversed.rbegin(), reversed.rend());
+		return true;
+	}
+
+	struct Totals {
+		double aStarMs = 0;
+		double flowMs = 0;
+		size_t queries = 0;
+		size_t aStarFound = 0;
+		size_t flowFound = 0;
+		size_t costlier = 0;
+		size_t fallbacks = 0;
+	};
+
+	struct ClickResult {
+		bool found = false;
+		std::vector<Direction> dirList;
+
+		bool operator==(const ClickResult &) const = default;
+	};
+
+	// Players clicking on things around them (use, move, browse field), every click needs a path first
+	std::vector<std::pair<Position, Position>> createClicks(const Respawn &respawn) {
+		std::mt19937 rng(20);
+		std::uniform_int_distribution<int> coordinate(8, AREA - 9);
+		std::uniform_int_distribution<int> offset(-7, 7);
+
+		std::vector<std::pair<Position, Position>> clicks;
+		clicks.reserve(CLICKS_PER_TICK);
+		while (clicks.size() < CLICKS_PER_TICK) {
+			const Position from(AREA_X + coordinate(rng), AREA_Y + coordinate(rng), AREA_Z);
+			const Position to(from.x + offset(rng), from.y + offset(rng), AREA_Z);
+			if (respawn.isWalkable(from)) {
+				clicks.emplace_back(from, to);
+			}
+		}
+		return clicks;
+	}
+
+	// Every tick the player steps and every follower searches again, monsters that close in end up surrounding the player
+	Totals chase(bool closeIn) {
+		auto respawn = createRespawn();
+		std::mt19937 rng(19);
+		std::uniform_int_distribution<int> direction(0, 7);
+
+		const auto center = respawn.player;
+		Totals totals;
+		FlowField field;
+		std::vector<std::vector<Direction>> aStarPaths(MONSTERS);
+		std::vector<std::vector<Direction>> flowPaths(MONSTERS);
+		std::vector<bool> aStarResults(MONSTERS);
+		std::vector<bool> flowResults(MONSTERS);
+
+		for (int tick = 0; tick < TICKS; ++tick) {
+			Benchmark aStar;
+			for (size_t i = 0; i < MONSTERS; ++i) {
+				aStarPaths[i].clear();
+				aStarResults[i] = findPathAStar(respawn, respawn.monsters[i], respawn.player, aStarPaths[i]);
+			}
+			totals.aStarMs += aStar.duration();
+
+			// Like FlowFieldCache: the first monster asking searches on its own, the second one builds the field
+			Benchmark flow;
+			field.build(respawn.player, [&](const Position &pos) {
+				return respawn.isWalkable(pos) ? respawn.getExtraCost(pos) : FlowField::NOT_WALKABLE;
+			});
+			for (size_t i = 0; i < MONSTERS; ++i) {
+				const auto &start = respawn.monsters[i];
+				flowPaths[i].clear();
+				const auto path = i == 0 ? std::nullopt : field.getPath(start, flowPaths[i], [&](const Position &pos) { return respawn.canWalkTo(start, pos); }, MAX_SEARCH_DIST);
+				// Like Creature::goToFollowCreature: when the field can't tell, the monster searches on its own
+				if (path) {
+					flowResults[i] = *path;
+				} else {
+					++totals.fallbacks;
+					flowResults[i] = findPathAStar(respawn, start, respawn.player, flowPaths[i]);
+				}
+			}
+			totals.flowMs += flow.duration();
+
+			for (size_t i = 0; i < MONSTERS; ++i) {
+				++totals.queries;
+				totals.aStarFound += aStarResults[i] ? 1 : 0;
+				totals.flowFound += flowResults[i] ? 1 : 0;
+				if (aStarResults[i] && flowResults[i] && pathCost(respawn, respawn.monsters[i], flowPaths[i]) > pathCost(respawn, respawn.monsters[i], aStarPaths[i])) {
+					++totals.costlier;
+				}
+
+				if (closeIn && !flowPaths[i].empty()) {
+					const auto next = step(respawn.monsters[i], flowPaths[i].front());
+					if (respawn.isWalkable(next)) {
+						respawn.occupied[Respawn::indexOf(respawn.monsters[i])] = 0;
+						respawn.occupied[Respawn::indexOf(next)] = 1;
+						respawn.monsters[i] = next;
+					}
+				}
+			}
+
+			const auto next = step(respawn.player, static_cast<Direction>(direction(rng)));
+			if (respawn.isWalkable(next) && Position::getDistanceX(next, center) <= 3 && Position::getDistanceY(next, center) <= 3) {
+				respawn.occupied[Respawn::indexOf(respawn.player)] = 0;
+				respawn.occupied[Respawn::indexOf(next)] = 1;
+				respawn.player = next;
+			}
+		}
+		return totals;
+	}
+}
+
+suite<"benchmark"> pathfindingBenchmark = [] {
+	test("Respawn chase: A* per monster vs shared flow field") = [] {
+		fmt::print("{} monsters chasing one player, {} ticks\n", MONSTERS, TICKS);
+		for (const auto closeIn : { false, true }) {
+			const auto totals = chase(closeIn);
+			fmt::print("  {}\n", closeIn ? "closing in, the player ends up surrounded" : "monsters kept apart");
+			fmt::print("    {:<11} {:>9.2f}ms {:>10.0f} queries/s  {:>5} found\n", "A*", totals.aStarMs, totals.queries / (totals.aStarMs / 1000), totals.aStarFound);
+			fmt::print("    {:<11} {:>9.2f}ms {:>10.0f} queries/s  {:>5} found  {:>5} searched with A*\n", "flow field", totals.flowMs, totals.queries / (totals.flowMs / 1000), totals.flowFound, totals.fallbacks);
+
+			// The field is exact, its paths are never more expensive than the ones A* finds
+			expect(eq(totals.costlier, size_t { 0 }));
+			expect(eq(totals.flowFound, totals.aStarFound));
+		}
+	};
+
+	test("Player auto walk: searches on the dispatcher vs batched on the thread pool") = [] {
+		InjectionFixture fixture;
+		ThreadPool threadPool(fixture.logger());
+		Dispatcher dispatcher(threadPool);
+
+		const auto respawn = createRespawn();
+		const auto clicks = createClicks(respawn);
+
+		// What Game did before: every click searched right away on the dispatcher
+		std::vector<ClickResult> expected(clicks.size());
+		Benchmark onDispatcher;
+		for (int tick = 0; tick < CLICK_TICKS; ++tick) {
+			for (size_t i = 0; i < clicks.size(); ++i) {
+				auto &result = expected[i];
+				result.dirList.clear();
+				result.found = findPathAStar(respawn, clicks[i].first, clicks[i].second, result.dirList);
+			}
+		}
+		const auto onDispatcherMs = onDispatcher.duration();
+
+		// Searches write their results as well, the callbacks would need a running dispatcher thread
+		PathFinder pathFinder(dispatcher);
+		std::vector<ClickResult> batched(clicks.size());
+		Benchmark batch;
+		for (int tick = 0; tick < CLICK_TICKS; ++tick) {
+			for (size_t i = 0; i < clicks.size(); ++i) {
+				pathFinder.request(
+					[&, i](std::vector<Direction> &dirList) {
+						auto &result = batched[i];
+						result.dirList.clear();
+						result.found = findPathAStar(respawn, clicks[i].first, clicks[i].second, result.dirList);
+						dirList = result.dirList;
+						return result.found;
+					},
+					[](bool, const std::vector<Direction> &) { },
+					"benchmark"
+				);
+			}
+			pathFinder.flush();
+		}
+		const auto batchMs = batch.duration();
+
+		fmt::print("{} path requests per tick, {} ticks, {} threads\n", clicks.size(), CLICK_TICKS, threadPool.get_thread_count());
+		fmt::print("  {:<26} {:>9.2f}ms\n", "on the dispatcher", onDispatcherMs);
+		fmt::print("  {:<26} {:>9.2f}ms\n", "batched on the thread pool", batchMs);
+
+		expect(batched == expected);
+	};
+};
@@ -0,0 +1,128 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "map/utils/mapsector.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr uint16_t DEPOT_X = 1024;
+	constexpr uint16_t DEPOT_Y = 1024;
+	constexpr uint8_t DEPOT_Z = 7;
+	// 3x3 sectors around the depot, the area a viewport query walks
+	constexpr int32_t SECTORS = 3;
+	constexpr size_t CREATURES = 360;
+	constexpr size_t QUERIES = 200000;
+
+	// Stands in for a Creature: the position sits behind the rest of the object, as it does in the real class
+	struct LegacyCreature {
+		std::array<std::byte, 512> state {};
+		Position position;
+	};
+
+	struct Depot {
+		std::array<std::vector<std::shared_ptr<LegacyCreature>>, SECTORS * SECTORS> legacy;
+		std::array<SectorCreatures, SECTORS * SECTORS> indexed;
+		// Maps the handles stored in the index back to the legacy objects
+		std::map<const void*, const LegacyCreature*> owners;
+	};
+
+	Depot createDepot() {
+		std::mt19937 rng(3);
+		std::uniform_int_distribution<int> coordinate(0, SECTORS * SECTOR_SIZE - 1);
+		std::uniform_int_distribution<int> floor(DEPOT_Z - 1, DEPOT_Z + 1);
+
+		Depot depot;
+		std::vector<std::unique_ptr<std::byte[]>> fragmentation;
+		for (size_t i = 0; i < CREATURES; ++i) {
+			auto creature = std::make_shared<LegacyCreature>();
+			// Creatures log in over time, their objects are not contiguous
+			fragmentation.emplace_back(std::make_unique<std::byte[]>(256 + rng() % 2048));
+
+			const int dx = coordinate(rng);
+			const int dy = coordinate(rng);
+			creature->position = Position(DEPOT_X + dx, DEPOT_Y + dy, floor(rng));
+
+			const auto sector = (dy / SECTOR_SIZE) * SECTORS + dx / SECTOR_SIZE;
+			// The index never dereferences the creatures, an aliasing handle is enough to identify them
+			std::shared_ptr<Creature> handle(creature, reinterpret_cast<Creature*>(creature.get()));
+			depot.owners.emplace(handle.get(), creature.get());
+			depot.indexed[sector].add(handle, creature->position);
+			depot.legacy[sector].emplace_back(std::move(creature));
+		}
+		return depot;
+	}
+
+	SectorRange viewport(const Position &center) {
+		// Same bounds Spectators::find<Player>(center, true) ends up with on the surface
+		SectorRange range;
+		range.minX = center.x - MAP_MAX_VIEW_PORT_X;
+		range.minY = center.y - MAP_MAX_VIEW_PORT_Y;
+		range.width = MAP_MAX_VIEW_PORT_X * 2;
+		range.height = MAP_MAX_VIEW_PORT_Y * 2;
+		range.minZ = 0;
+		range.depth = MAP_INIT_SURFACE_LAYER;
+		range.centerZ = center.z;
+		return range;
+	}
+}
+
+suite<"benchmark"> spectatorsBenchmark = [] {
+	test("Spectators in a crowded depot: shared_ptr scan vs packed coordinates") = [] {
+		auto depot = createDepot();
+
+		std::mt19937 rng(5);
+		std::uniform_int_distribution<int> offset(SECTOR_SIZE / 2, SECTOR_SIZE * SECTORS - SECTOR_SIZE / 2);
+		std::vector<Position> centers(QUERIES);
+		for (auto &center : centers) {
+			center = Position(DEPOT_X + offset(rng), DEPOT_Y + offset(rng), DEPOT_Z);
+		}
+
+		std::vector<const LegacyCreature*> legacyFound;
+		size_t legacyTotal = 0;
+		Benchmark legacy;
+		for (const auto &center : centers) {
+			legacyFound.clear();
+			const auto range = viewport(center);
+			for (const auto &sector : depot.legacy) {
+				for (const auto &creature : sector) {
+					const auto &cpos = creature->position;
+					if (static_cast<uint32_t>(static_cast<int32_t>(cpos.z) - range.minZ) <= static_cast<uint32_t>(range.depth)) {
+						const int_fast16_t offsetZ = Position::getOffsetZ(center, cpos);
+						if (static_cast<uint32_t>(cpos.x - offsetZ - range.minX) <= static_cast<uint32_t>(range.width) && static_cast<uint32_t>(cpos.y - offsetZ - range.minY) <= static_cast<uint32_t>(range.height)) {
+							legacyFound.emplace_back(creature.get());
+						}
+					}
+				}
+			}
+			legacyTotal += legacyFound.size();
+		}
+		const auto legacyMs = legacy.duration();
+
+		CreatureVector indexedFound;
+		size_t indexedTotal = 0;
+		Benchmark indexed;
+		for (const auto &center : centers) {
+			indexedFound.clear();
+			const auto range = viewport(center);
+			for (const auto &sector : depot.indexed) {
+				sector.findInRange(range, indexedFound);
+			}
+			indexedTotal += indexedFound.size();
+		}
+		const auto indexedMs = indexed.duration();
+
+		fmt::print("{} creatures over {} sectors, {} viewport queries, {:.1f} spectators per query\n", CREATURES, SECTORS * SECTORS, QUERIES, static_cast<double>(legacyTotal) / QUERIES);
+		fmt::print("  {:<14} {:>8.2f}ms\n", "shared_ptr", legacyMs);
+		fmt::print("  {:<14} {:>8.2f}ms\n", "packed", indexedMs);
+
+		expect(eq(legacyTotal, indexedTotal));
+
+		// Both scans walk the sectors in the same order, so the last query must match one to one
+		expect(eq(legacyFound.size(), indexedFound.size()));
+		for (size_t i = 0; i < std::min(legacyFound.size(), indexedFound.size()); ++i) {
+			expect(depot.owners.at(indexedFound[i].get()) == legacyFound[i]);
+		}
+	};
+};
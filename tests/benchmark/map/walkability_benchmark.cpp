@@ -0,0 +1,123 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include <appearances.pb.h>
+
+#include "creatures/npcs/npc.hpp"
+#include "creatures/npcs/npcs.hpp"
+#include "game/game.hpp"
+#include "injection_fixture.hpp"
+#include "items/item.hpp"
+#include "items/tile.hpp"
+#include "map/map.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr uint16_t MAP_OFFSET = 1000;
+	constexpr uint16_t MAP_SIZE = 128;
+	constexpr uint8_t FLOOR = 7;
+	constexpr uint16_t GROUND_ID = 100;
+	constexpr size_t CHASES = 20000;
+	constexpr int32_t CHASE_DISTANCE = 7;
+
+	// A single ground item type, registered the way the appearances file does it
+	void registerGround() {
+		auto &appearances = g_game().m_appearancesPtr;
+		appearances = std::make_unique<Canary::protobuf::appearances::Appearances>();
+		auto* ground = appearances->add_object();
+		ground->set_id(GROUND_ID);
+		ground->mutable_flags()->mutable_bank()->set_waypoints(150);
+		Item::items.loadFromProtobuf();
+	}
+
+	// Walls and trees: a fifth of the tiles block movement and projectiles, a few more only block paths
+	void createMap(Map &map) {
+		std::mt19937 rng(20);
+		std::uniform_int_distribution<int> roll(0, 99);
+		for (uint16_t x = 0; x < MAP_SIZE; ++x) {
+			for (uint16_t y = 0; y < MAP_SIZE; ++y) {
+				const auto &tile = map.getOrCreateTile(MAP_OFFSET + x, MAP_OFFSET + y, FLOOR, true);
+				tile->internalAddThing(std::make_shared<Item>(GROUND_ID));
+
+				// Set once the tile is on its floor, so the bitmap is kept up to date by the tile
+				const auto kind = roll(rng);
+				if (kind < 20) {
+					tile->setFlag(TILESTATE_BLOCKSOLID | TILESTATE_BLOCKPROJECTILE);
+				} else if (kind < 25) {
+					tile->setFlag(TILESTATE_BLOCKPATH);
+				}
+			}
+		}
+	}
+
+	// A creature chasing a target a few tiles away, from a tile it can stand on
+	std::vector<std::pair<Position, Position>> createChases(Map &map) {
+		std::mt19937 rng(21);
+		std::uniform_int_distribution<int> coordinate(CHASE_DISTANCE + 1, MAP_SIZE - CHASE_DISTANCE - 2);
+		std::uniform_int_distribution<int> offset(-CHASE_DISTANCE, CHASE_DISTANCE);
+
+		std::vector<std::pair<Position, Position>> chases;
+		chases.reserve(CHASES);
+		while (chases.size() < CHASES) {
+			const Position from(MAP_OFFSET + coordinate(rng), MAP_OFFSET + coordinate(rng), FLOOR);
+			if (map.getWalkability(from.x, from.y, from.z) & WALKABILITY_BLOCKSOLID) {
+				continue;
+			}
+			chases.emplace_back(from, Position(from.x + offset(rng), from.y + offset(rng), FLOOR));
+		}
+		return chases;
+	}
+
+	void moveTo(Map &map, const std::shared_ptr<Creature> &creature, const Position &pos) {
+		if (const auto &tile = creature->getTile()) {
+			tile->removeThing(creature, 0);
+		}
+		map.getTile(pos)->internalAddThing(creature);
+	}
+}
+
+suite<"benchmark"> walkabilityBenchmark = [] {
+	test("A* path search: Map::getPathMatching throughput") = [] {
+		InjectionFixture fixture;
+		registerGround();
+
+		// The game's map, FrozenPathingConditionCall checks the sight line on it
+		auto &map = g_game().map;
+		createMap(map);
+		const auto chases = createChases(map);
+
+		// Walls block an NPC as they block a monster that can't push items
+		const auto walker = std::make_shared<Npc>(std::make_shared<NpcType>("walkability benchmark"));
+
+		FindPathParams fpp;
+		fpp.maxSearchDist = 12;
+		fpp.minTargetDist = 1;
+		fpp.maxTargetDist = 1;
+
+		size_t found = 0;
+		size_t steps = 0;
+		std::vector<Direction> dirList;
+		std::chrono::steady_clock::duration searching {};
+		for (const auto &[from, to] : chases) {
+			moveTo(map, walker, from);
+			dirList.clear();
+
+			const auto start = std::chrono::steady_clock::now();
+			const bool result = map.getPathMatching(walker, to, dirList, FrozenPathingConditionCall(to), fpp);
+			searching += std::chrono::steady_clock::now() - start;
+
+			if (result) {
+				++found;
+				steps += dirList.size();
+			}
+		}
+
+		const auto searchingMs = std::chrono::duration<double, std::milli>(searching).count();
+		fmt::print("{} chases up to {} tiles away on a {}x{} map\n", chases.size(), CHASE_DISTANCE, MAP_SIZE, MAP_SIZE);
+		fmt::print("  {:>8.2f}ms {:>8.2f}K paths/s {:>6.2f}us per path, {} found, {:.1f} steps on average\n", searchingMs, chases.size() / searchingMs, searchingMs * 1000 / chases.size(), found, found ? static_cast<double>(steps) / found : 0.0);
+
+		expect(gt(found, size_t { 0 }));
+	};
+};
@@ -0,0 +1,157 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "creatures/creatures_definitions.hpp"
+#include "server/network/message/outputmessage.hpp"
+#include "server/network/message/sharedmessage.hpp"
+#include "server/network/protocol/protocolgame.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr size_t PLAYERS = 200;
+	constexpr int ROUNDS = 5;
+	constexpr uint16_t ARENA_X = 1000;
+	constexpr uint16_t ARENA_Y = 1000;
+	constexpr uint8_t ARENA_Z = 7;
+
+	// What one attack makes every spectator receive
+	struct Attack {
+		size_t attacker;
+		Position from;
+		Position to;
+		uint16_t missile;
+		uint16_t effect;
+		SoundEffect_t sound;
+	};
+
+	// Output side of a spectator: full buffers are "sent" by folding them into a digest
+	struct Viewer {
+		OutputMessage_ptr out = OutputMessagePool::getOutputMessage();
+		uint64_t digest = 1469598103934665603ULL;
+		size_t bytes = 0;
+
+		OutputMessage &reserve(size_t size) {
+			if (out->getLength() + size > MAX_PROTOCOL_BODY_LENGTH) {
+				flush();
+			}
+			return *out;
+		}
+
+		void flush() {
+			const auto* data = out->getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION;
+			for (size_t i = 0; i < out->getLength(); ++i) {
+				digest = (digest ^ data[i]) * 1099511628211ULL;
+			}
+			bytes += out->getLength();
+			out = OutputMessagePool::getOutputMessage();
+		}
+	};
+
+	std::vector<Attack> createFight() {
+		std::mt19937 rng(14);
+		std::uniform_int_distribution<int> offset(-7, 7);
+		std::uniform_int_distribution<int> effect(1, 250);
+
+		std::vector<Attack> attacks;
+		attacks.reserve(PLAYERS * ROUNDS);
+		for (int round = 0; round < ROUNDS; ++round) {
+			// Everybody in the crowd attacks once per round
+			for (size_t attacker = 0; attacker < PLAYERS; ++attacker) {
+				const Position from(ARENA_X + offset(rng), ARENA_Y + offset(rng), ARENA_Z);
+				const Position to(ARENA_X + offset(rng), ARENA_Y + offset(rng), ARENA_Z);
+				attacks.emplace_back(attacker, from, to, static_cast<uint16_t>(effect(rng)), static_cast<uint16_t>(effect(rng)), SoundEffect_t::HUMAN_CLOSE_ATK_FIST);
+			}
+		}
+		return attacks;
+	}
+
+	SourceEffect_t soundSource(const Attack &attack, size_t viewer) {
+		return attack.attacker == viewer ? SourceEffect_t::OWN : SourceEffect_t::OTHERS;
+	}
+
+	// What every ProtocolGame did before: its own NetworkMessage for each message it is sent
+	void sendPerViewer(const std::vector<Attack> &attacks, std::vector<Viewer> &viewers) {
+		for (const auto &attack : attacks) {
+			for (size_t i = 0; i < viewers.size(); ++i) {
+				{
+					NetworkMessage msg;
+					ProtocolGame::AddDistanceShoot(msg, attack.from, attack.to, attack.missile, false);
+					viewers[i].reserve(msg.getLength()).append(msg);
+				}
+				{
+					NetworkMessage msg;
+					ProtocolGame::AddMagicEffect(msg, attack.to, attack.effect, false);
+					viewers[i].reserve(msg.getLength()).append(msg);
+				}
+				{
+					NetworkMessage msg;
+					ProtocolGame::AddSingleSoundEffect(msg, attack.to, attack.sound, soundSource(attack, i));
+					viewers[i].reserve(msg.getLength()).append(msg);
+				}
+			}
+		}
+	}
+
+	// Encoded once per attack, copied into every output buffer, sound source patched per spectator
+	void sendShared(const std::vector<Attack> &attacks, std::vector<Viewer> &viewers) {
+		for (const auto &attack : attacks) {
+			SharedMessageCache missile;
+			SharedMessageCache effect;
+			SharedMessageCache sound;
+			for (size_t i = 0; i < viewers.size(); ++i) {
+				const auto &missileBody = missile.get(false, [&](NetworkMessage &msg) {
+					ProtocolGame::AddDistanceShoot(msg, attack.from, attack.to, attack.missile, false);
+				});
+				viewers[i].reserve(missileBody.getBody().size()).append(missileBody.getBody());
+
+				const auto &effectBody = effect.get(false, [&](NetworkMessage &msg) {
+					ProtocolGame::AddMagicEffect(msg, attack.to, attack.effect, false);
+				});
+				viewers[i].reserve(effectBody.getBody().size()).append(effectBody.getBody());
+
+				const auto source = soundSource(attack, i);
+				const auto &soundBody = sound.get(false, [&](NetworkMessage &msg) {
+					ProtocolGame::AddSingleSoundEffect(msg, attack.to, attack.sound, source);
+				});
+				auto* body = viewers[i].reserve(soundBody.getBody().size()).append(soundBody.getBody());
+				body[ProtocolGame::SOUND_EFFECT_SOURCE_OFFSET] = static_cast<uint8_t>(source);
+			}
+		}
+	}
+}
+
+suite<"benchmark"> broadcastBenchmark = [] {
+	test("Fight scene broadcast: per spectator encode vs shared encode") = [] {
+		const auto attacks = createFight();
+
+		std::vector<Viewer> perViewer(PLAYERS);
+		Benchmark legacy;
+		sendPerViewer(attacks, perViewer);
+		const auto legacyMs = legacy.duration();
+
+		std::vector<Viewer> shared(PLAYERS);
+		Benchmark sharedEncode;
+		sendShared(attacks, shared);
+		const auto sharedMs = sharedEncode.duration();
+
+		size_t totalBytes = 0;
+		size_t mismatches = 0;
+		for (size_t i = 0; i < PLAYERS; ++i) {
+			perViewer[i].flush();
+			shared[i].flush();
+			totalBytes += shared[i].bytes;
+			if (perViewer[i].digest != shared[i].digest || perViewer[i].bytes != shared[i].bytes) {
+				++mismatches;
+			}
+		}
+
+		fmt::print("{} players, {} attacks seen by everyone, {:.1f} MB sent\n", PLAYERS, attacks.size(), static_cast<double>(totalBytes) / (1024 * 1024));
+		fmt::print("  {:<12} {:>8.2f}ms\n", "per viewer", legacyMs);
+		fmt::print("  {:<12} {:>8.2f}ms\n", "shared", sharedMs);
+
+		// Every spectator must receive exactly the bytes it got before
+		expect(eq(mismatches, size_t { 0 }));
+	};
+};
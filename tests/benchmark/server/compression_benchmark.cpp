@@ -0,0 +1,210 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "creatures/creatures_definitions.hpp"
+#include "server/network/message/networkmessage.hpp"
+#include "server/network/protocol/deflatestream.hpp"
+#include "server/network/protocol/protocolgame.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr size_t PACKETS = 4000;
+	constexpr int32_t COMPRESSION_LEVEL = 6;
+	// Same thresholds Protocol::onSendMessage uses
+	constexpr size_t COMPRESSION_MIN_SIZE = 128;
+	constexpr size_t STREAMING_COMPRESSION_MIN_SIZE = 32;
+
+	using Packet = std::vector<uint8_t>;
+
+	struct Mode {
+		std::string_view name;
+		bool streaming;
+		bool useDictionary;
+	};
+
+	struct Result {
+		size_t bytesIn = 0;
+		size_t bytesOut = 0;
+		size_t compressed = 0;
+		double ms = 0;
+		bool roundTrip = true;
+	};
+
+	// Stands in for a capture of what a hunting player receives: every autosend flush is one packet,
+	// mostly creatures walking, effects and health updates around it, with the odd text and map slice
+	std::vector<Packet> recordSession() {
+		std::mt19937 rng(15);
+		std::uniform_int_distribution<int> roll(0, 99);
+		std::uniform_int_distribution<int> step(-1, 1);
+		std::uniform_int_distribution<int> offset(-7, 7);
+		std::uniform_int_distribution<int> count(1, 6);
+		std::uniform_int_distribution<int> percent(1, 100);
+		std::uniform_int_distribution<int> damage(40, 900);
+		std::uniform_int_distribution<uint32_t> creature(0, 30);
+		std::uniform_int_distribution<uint16_t> item(100, 40000);
+
+		Position center(1000, 1000, 7);
+		const auto around = [&] {
+			return Position(center.x + offset(rng), center.y + offset(rng), center.z);
+		};
+		const auto monsterId = [&] {
+			return 0x40000000 + creature(rng);
+		};
+
+		std::vector<Packet> session;
+		session.reserve(PACKETS);
+		NetworkMessage msg;
+		for (size_t i = 0; i < PACKETS; ++i) {
+			msg.reset();
+			for (int message = count(rng); message > 0; --message) {
+				const auto kind = roll(rng);
+				if (kind < 30) {
+					const auto from = around();
+					msg.addByte(0x6D);
+					msg.addPosition(from);
+					msg.addByte(1);
+					msg.addPosition(Position(from.x + step(rng), from.y + step(rng), from.z));
+				} else if (kind < 50) {
+					msg.addByte(0x8C);
+					msg.add<uint32_t>(monsterId());
+					msg.addByte(static_cast<uint8_t>(percent(rng)));
+				} else if (kind < 65) {
+					ProtocolGame::AddMagicEffect(msg, around(), static_cast<uint16_t>(1 + roll(rng) % 12), false);
+				} else if (kind < 75) {
+					ProtocolGame::AddDistanceShoot(msg, around(), around(), static_cast<uint16_t>(1 + roll(rng) % 8), false);
+				} else if (kind < 82) {
+					ProtocolGame::AddSingleSoundEffect(msg, around(), SoundEffect_t::HUMAN_CLOSE_ATK_FIST, SourceEffect_t::OTHERS);
+				} else if (kind < 88) {
+					msg.addByte(0x8F);
+					msg.add<uint32_t>(monsterId());
+					msg.add<uint16_t>(220);
+					msg.add<uint16_t>(static_cast<uint16_t>(200 + roll(rng)));
+				} else if (kind < 96) {
+					msg.addByte(0xB4);
+					msg.addByte(0x17);
+					msg.addString(fmt::format("You deal {} damage to a dragon lord.", damage(rng)));
+				} else if (kind < 99) {
+					msg.addByte(0xB4);
+					msg.addByte(0x1A);
+					msg.addString(fmt::format("You lose {} hitpoints due to an attack by a dragon lord.", damage(rng)));
+				} else {
+					// The player stepped: a row of new tiles, ground plus the odd item, runs of empty tiles skipped
+					center.x += 1;
+					msg.addByte(0x66);
+					for (int tile = 0; tile < 14; ++tile) {
+						msg.add<uint16_t>(0x00);
+						msg.add<uint16_t>(item(rng) % 8 + 4526);
+						if (roll(rng) < 20) {
+							msg.add<uint16_t>(item(rng));
+						}
+						msg.addByte(static_cast<uint8_t>(roll(rng) % 3));
+						msg.addByte(0xFF);
+					}
+				}
+			}
+			session.emplace_back(msg.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION, msg.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION + msg.getLength());
+		}
+		return session;
+	}
+
+	// What the client has to do for each mode: one inflate stream per connection when streaming
+	class Inflater {
+	public:
+		explicit Inflater(const Mode &mode) :
+			mode(mode) {
+			inflateInit2(&stream, -15);
+			setDictionary();
+		}
+
+		~Inflater() {
+			inflateEnd(&stream);
+		}
+
+		bool inflatesTo(std::span<const uint8_t> compressed, const Packet &expected) {
+			output.resize(NETWORKMESSAGE_MAXSIZE);
+			stream.next_in = const_cast<Bytef*>(compressed.data());
+			stream.avail_in = static_cast<uInt>(compressed.size());
+			stream.next_out = output.data();
+			stream.avail_out = static_cast<uInt>(output.size());
+			const auto ret = inflate(&stream, mode.streaming ? Z_SYNC_FLUSH : Z_FINISH);
+			output.resize(output.size() - stream.avail_out);
+
+			if (!mode.streaming) {
+				inflateReset(&stream);
+				setDictionary();
+			}
+			return (ret == Z_OK || ret == Z_STREAM_END) && output == expected;
+		}
+
+	private:
+		void setDictionary() {
+			if (mode.useDictionary) {
+				const auto dictionary = DeflateStream::getPresetDictionary();
+				inflateSetDictionary(&stream, dictionary.data(), static_cast<uInt>(dictionary.size()));
+			}
+		}
+
+		const Mode &mode;
+		z_stream stream {};
+		Packet output;
+	};
+
+	Result replay(const Mode &mode, const std::vector<Packet> &session) {
+		DeflateStream stream(COMPRESSION_LEVEL, mode.streaming, mode.useDictionary);
+		const auto minSize = mode.streaming ? STREAMING_COMPRESSION_MIN_SIZE : COMPRESSION_MIN_SIZE;
+
+		std::vector<uint8_t> buffer(NETWORKMESSAGE_MAXSIZE);
+		std::vector<Packet> sent;
+		std::vector<bool> compressed;
+		sent.reserve(session.size());
+		compressed.reserve(session.size());
+
+		Result result;
+		Benchmark bm;
+		for (const auto &packet : session) {
+			result.bytesIn += packet.size();
+			const auto size = packet.size() >= minSize ? stream.compress(packet, buffer) : 0;
+			if (size != 0) {
+				sent.emplace_back(buffer.begin(), buffer.begin() + size);
+			} else {
+				sent.emplace_back(packet);
+			}
+			compressed.emplace_back(size != 0);
+			result.bytesOut += sent.back().size();
+		}
+		result.ms = bm.duration();
+
+		Inflater inflater(mode);
+		for (size_t i = 0; i < session.size(); ++i) {
+			if (compressed[i]) {
+				++result.compressed;
+				result.roundTrip = result.roundTrip && inflater.inflatesTo(sent[i], session[i]);
+			} else {
+				result.roundTrip = result.roundTrip && sent[i] == session[i];
+			}
+		}
+		return result;
+	}
+}
+
+suite<"benchmark"> compressionBenchmark = [] {
+	test("Packet compression: per message vs streaming, with and without dictionary") = [] {
+		const auto session = recordSession();
+
+		static constexpr std::array<Mode, 4> modes { {
+			{ "per message", false, false },
+			{ "per message + dictionary", false, true },
+			{ "streaming", true, false },
+			{ "streaming + dictionary", true, true },
+		} };
+
+		fmt::print("{} packets, compression level {}\n", session.size(), COMPRESSION_LEVEL);
+		for (const auto &mode : modes) {
+			const auto result = replay(mode, session);
+			fmt::print("  {:<26} {:>8} -> {:>8} bytes ({:>5.1f}%)  {:>5} compressed  {:>7.2f}ms\n", mode.name, result.bytesIn, result.bytesOut, 100.0 * result.bytesOut / result.bytesIn, result.compressed, result.ms);
+			expect(result.roundTrip) << mode.name;
+		}
+	};
+};
@@ -0,0 +1,283 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#ifndef _WIN32
+	#include <sys/resource.h>
+#endif
+
+#include "config/configmanager.hpp"
+#include "injection_fixture.hpp"
+#include "server/network/connection/connection.hpp"
+#include "server/network/connection/ioservicepool.hpp"
+#include "server/network/message/outputmessage.hpp"
+#include "server/network/protocol/protocol.hpp"
+#include "server/server.hpp"
+#include "utils/tools.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+
+	constexpr size_t MAX_CONNECTIONS = 2000;
+	constexpr size_t CLIENT_THREADS = 2;
+	constexpr int TICKS = 40;
+	constexpr auto TICK_INTERVAL = std::chrono::milliseconds(50);
+	constexpr size_t MESSAGE_SIZE = 1024;
+	// Ban::acceptConnection blocks an address opening more than 5 connections within half a second
+	constexpr size_t CONNECTIONS_PER_ADDRESS = 4;
+
+	struct LoadResult {
+		uint64_t bytes = 0;
+		uint64_t messages = 0;
+		double seconds = 0;
+		std::vector<uint32_t> latencies;
+	};
+
+	// Both ends of every connection live in this process
+	size_t connectionCount() {
+#ifndef __linux__
+		// Only Linux answers on the whole 127.0.0.0/8, elsewhere both runs share 127.0.0.1
+		return CONNECTIONS_PER_ADDRESS / 2;
+#else
+		rlimit limit {};
+		if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+			limit.rlim_cur = limit.rlim_max;
+			setrlimit(RLIMIT_NOFILE, &limit);
+			getrlimit(RLIMIT_NOFILE, &limit);
+			return std::min<size_t>(MAX_CONNECTIONS, (std::max<size_t>(limit.rlim_cur, 128) - 64) / 2);
+		}
+		return MAX_CONNECTIONS;
+#endif
+	}
+
+	asio::ip::address_v4 clientAddress(size_t connection) {
+		return asio::ip::address_v4(static_cast<asio::ip::address_v4::uint_type>(0x7F000001 + connection / CONNECTIONS_PER_ADDRESS));
+	}
+
+	// A game protocol reduced to its write path: server sends first, sequence checksums enable compression
+	class LoadProtocol final : public Protocol {
+	public:
+		static constexpr bool SERVER_SENDS_FIRST = true;
+		static constexpr bool USE_CHECKSUM = false;
+		static constexpr uint8_t PROTOCOL_IDENTIFIER = 0;
+		static const char* protocol_name() {
+			return "load benchmark protocol";
+		}
+
+		explicit LoadProtocol(const Connection_ptr &connection) :
+			Protocol(connection) {
+			setChecksumMethod(CHECKSUM_METHOD_SEQUENCE);
+		}
+
+		void onRecvFirstMessage(NetworkMessage &) override { }
+	};
+
+	// Hands the benchmark every protocol the real ServicePort accepts
+	class LoadService final : public ServiceBase {
+	public:
+		bool is_single_socket() const override {
+			return LoadProtocol::SERVER_SENDS_FIRST;
+		}
+		bool is_checksummed() const override {
+			return LoadProtocol::USE_CHECKSUM;
+		}
+		uint8_t get_protocol_identifier() const override {
+			return LoadProtocol::PROTOCOL_IDENTIFIER;
+		}
+		const char* get_protocol_name() const override {
+			return LoadProtocol::protocol_name();
+		}
+
+		Protocol_ptr make_protocol(const Connection_ptr &c) const override {
+			auto protocol = std::make_shared<LoadProtocol>(c);
+			std::scoped_lock lock(mutex);
+			protocols.emplace_back(protocol);
+			return protocol;
+		}
+
+		std::vector<std::shared_ptr<LoadProtocol>> takeProtocols() {
+			std::scoped_lock lock(mutex);
+			return std::exchange(protocols, {});
+		}
+
+		size_t accepted() const {
+			std::scoped_lock lock(mutex);
+			return protocols.size();
+		}
+
+	private:
+		mutable std::mutex mutex;
+		mutable std::vector<std::shared_ptr<LoadProtocol>> protocols;
+	};
+
+	// Plays the game client, the n-th message of a connection was sent on the n-th tick
+	class LoadClient : public std::enable_shared_from_this<LoadClient> {
+	public:
+		LoadClient(asio::io_service &service, const std::vector<std::atomic_int64_t> &tickStarts, std::atomic_uint64_t &received) :
+			socket(service), tickStarts(tickStarts), received(received) { }
+
+		void read() {
+			asio::async_read(socket, asio::buffer(header), [self = shared_from_this()](const std::error_code &error, std::size_t) {
+				if (error) {
+					return;
+				}
+				self->body.resize(self->header[0] | self->header[1] << 8);
+				self->readBody();
+			});
+		}
+
+		asio::ip::tcp::socket socket;
+		std::vector<uint32_t> latencies;
+		uint64_t bytes = 0;
+
+	private:
+		void readBody() {
+			asio::async_read(socket, asio::buffer(body), [self = shared_from_this()](const std::error_code &error, std::size_t) {
+				if (error) {
+					return;
+				}
+
+				const auto tick = std::min(self->latencies.size(), self->tickStarts.size() - 1);
+				const auto sentAt = Clock::time_point(Clock::duration(self->tickStarts[tick].load(std::memory_order_acquire)));
+				self->latencies.emplace_back(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - sentAt).count()));
+				self->bytes += self->header.size() + self->body.size();
+				self->received.fetch_add(1, std::memory_order_relaxed);
+				self->read();
+			});
+		}
+
+		std::array<uint8_t, 2> header {};
+		std::vector<uint8_t> body;
+		const std::vector<std::atomic_int64_t> &tickStarts;
+		std::atomic_uint64_t &received;
+	};
+
+	uint16_t freePort() {
+		asio::io_service service;
+		asio::ip::tcp::acceptor probe(service, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+		return probe.local_endpoint().port();
+	}
+
+	// Ban remembers every address between runs, so each run connects from addresses of its own
+	LoadResult runLoad(size_t networkThreads, size_t connections, size_t firstClient, const std::vector<uint8_t> &payload) {
+		// Declared first so that every socket is destroyed before the services it belongs to
+		IOServicePool serverServices;
+		IOServicePool clientServices;
+		serverServices.start(networkThreads);
+		clientServices.start(CLIENT_THREADS);
+
+		// The server side is the real accept path: ServicePort, Connection and the Protocol write path
+		asio::io_service acceptorService;
+		auto acceptorWork = asio::make_work_guard(acceptorService);
+		std::jthread acceptorThread([&acceptorService] { acceptorService.run(); });
+
+		const auto service = std::make_shared<LoadService>();
+		const auto servicePort = std::make_shared<ServicePort>(acceptorService, serverServices);
+		servicePort->add_service(service);
+		const auto port = freePort();
+		servicePort->open(port);
+
+		std::vector<std::atomic_int64_t> tickStarts(TICKS);
+		std::atomic_uint64_t received = 0;
+		std::vector<std::shared_ptr<LoadClient>> clients;
+		clients.reserve(connections);
+		for (size_t i = 0; i < connections; ++i) {
+			auto client = std::make_shared<LoadClient>(clientServices.getNextService(), tickStarts, received);
+			client->socket.open(asio::ip::tcp::v4());
+#ifdef __linux__
+			client->socket.bind(asio::ip::tcp::endpoint(clientAddress(firstClient + i), 0));
+#endif
+			client->socket.connect(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), port));
+			asio::post(client->socket.get_executor(), [client] { client->read(); });
+			clients.emplace_back(std::move(client));
+		}
+
+		const auto acceptDeadline = Clock::now() + std::chrono::seconds(10);
+		while (service->accepted() < connections && Clock::now() < acceptDeadline) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		const auto protocols = service->takeProtocols();
+
+		// Plays the dispatcher: every tick each player gets a message, written by the thread its connection runs on
+		const auto start = Clock::now();
+		for (int tick = 0; tick < TICKS; ++tick) {
+			tickStarts[tick].store(Clock::now().time_since_epoch().count(), std::memory_order_release);
+			for (const auto &protocol : protocols) {
+				const auto message = OutputMessagePool::getOutputMessage();
+				message->addBytes(reinterpret_cast<const char*>(payload.data()), payload.size());
+				protocol->send(message);
+			}
+			std::this_thread::sleep_until(start + TICK_INTERVAL * (tick + 1));
+		}
+
+		const auto expected = static_cast<uint64_t>(protocols.size()) * TICKS;
+		const auto deadline = Clock::now() + std::chrono::seconds(60);
+		while (received.load(std::memory_order_relaxed) < expected && Clock::now() < deadline) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		LoadResult result;
+		result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		servicePort->close();
+		ConnectionManager::getInstance().closeAll();
+		serverServices.stop();
+		clientServices.stop();
+		acceptorWork.reset();
+		acceptorService.stop();
+
+		result.messages = received.load();
+		result.latencies.reserve(result.messages);
+		for (const auto &client : clients) {
+			result.bytes += client->bytes;
+			result.latencies.insert(result.latencies.end(), client->latencies.begin(), client->latencies.end());
+		}
+		return result;
+	}
+
+	uint32_t percentile(std::vector<uint32_t> &values, double rank) {
+		if (values.empty()) {
+			return 0;
+		}
+		const auto nth = values.begin() + static_cast<ptrdiff_t>((values.size() - 1) * rank);
+		std::ranges::nth_element(values, nth);
+		return *nth;
+	}
+}
+
+suite<"network"> networkLoadBenchmark = [] {
+	test("Outbound game traffic: one network thread vs an io_service pool") = [] {
+		InjectionFixture fixture;
+
+		// Defaults of every setting, compression included
+		const auto configPath = (std::filesystem::temp_directory_path() / "canary_network_benchmark.lua").string();
+		std::ofstream(configPath, std::ios::trunc) << "maxPacketsPerSecond = 25\n";
+		g_configManager().setConfigFileLua(configPath);
+		expect(g_configManager().load() >> fatal);
+
+		// Creature and item updates compress reasonably well, like real game messages
+		std::mt19937 rng(12);
+		std::uniform_int_distribution<int> byte(0, 15);
+		std::vector<uint8_t> payload(MESSAGE_SIZE);
+		for (auto &value : payload) {
+			value = static_cast<uint8_t>(byte(rng) * 3);
+		}
+
+		const auto connections = connectionCount();
+		const auto threads = std::max<size_t>(getNumberOfCores() / 2, 2);
+
+		fmt::print("{} loopback connections, {} messages of {} bytes each every {}ms\n", connections, TICKS, MESSAGE_SIZE, TICK_INTERVAL.count());
+		size_t firstClient = 0;
+		for (const auto networkThreads : { size_t { 1 }, threads }) {
+			auto result = runLoad(networkThreads, connections, firstClient, payload);
+			firstClient += connections + CONNECTIONS_PER_ADDRESS;
+			const auto p50 = percentile(result.latencies, 0.5);
+			const auto p99 = percentile(result.latencies, 0.99);
+
+			fmt::print("  {:>2} network threads {:>9.2f} MB/s   p50 {:>7}us   p99 {:>7}us\n", networkThreads, result.bytes / result.seconds / (1024 * 1024), p50, p99);
+			expect(eq(result.messages, static_cast<uint64_t>(connections) * TICKS));
+		}
+	};
+};
@@ -0,0 +1,69 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/scheduling/dispatcher.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr size_t PRODUCERS = 4;
+	constexpr size_t TASKS_PER_PRODUCER = 250000;
+
+	// Mirrors the previous Dispatcher::ThreadTask submission path: one mutex-guarded vector per producer thread.
+	struct MutexChannel {
+		std::mutex mutex;
+		std::vector<std::function<void(void)>> tasks;
+
+		void emplace(std::function<void(void)> &&f) {
+			std::scoped_lock lock(mutex);
+			tasks.emplace_back(std::move(f));
+		}
+
+		template <typename F>
+		void drain(F &&f) {
+			std::scoped_lock lock(mutex);
+			for (auto &task : tasks) {
+				f(std::move(task));
+			}
+			tasks.clear();
+		}
+	};
+
+	template <typename Channel>
+	double tasksPerSecond() {
+		std::array<Channel, PRODUCERS> channels;
+		std::atomic_size_t executed = 0;
+		std::vector<std::jthread> producers;
+
+		Benchmark bm;
+		for (auto &channel : channels) {
+			producers.emplace_back([&channel, &executed] {
+				for (size_t i = 0; i < TASKS_PER_PRODUCER; ++i) {
+					channel.emplace([&executed] { executed.fetch_add(1, std::memory_order_relaxed); });
+				}
+			});
+		}
+
+		while (executed.load(std::memory_order_relaxed) < PRODUCERS * TASKS_PER_PRODUCER) {
+			for (auto &channel : channels) {
+				channel.drain([](std::function<void(void)> &&task) { task(); });
+			}
+		}
+
+		return (PRODUCERS * TASKS_PER_PRODUCER) / (bm.duration() / 1000);
+	}
+}
+
+suite<"benchmark"> dispatcherSubmissionBenchmark = [] {
+	test("Dispatcher submission: mutex vector vs SPSC ring") = [] {
+		const auto mutexRate = tasksPerSecond<MutexChannel>();
+		const auto ringRate = tasksPerSecond<TaskChannel<std::function<void(void)>>>();
+
+		fmt::print("{} producers x {} tasks\n", PRODUCERS, TASKS_PER_PRODUCER);
+		fmt::print("  mutex vector: {:.0f} tasks/s\n", mutexRate);
+		fmt::print("  SPSC ring:    {:.0f} tasks/s ({:.2f}x)\n", ringRate, ringRate / mutexRate);
+
+		expect(gt(ringRate, 0.0));
+	};
+};
@@ -160,4 +160,64 @@ int main() {
 		// sessionExpires is not saved
 		expect(eq(acc2->sessionExpires, 0));
 	});
+
+	test("Database pool leases distinct connections and gives them back") = [&dbConfig] {
+		Database pooled {};
+		expect(pooled.connect(&dbConfig.host, &dbConfig.user, &dbConfig.password, &dbConfig.database, dbConfig.port, &dbConfig.sock, 4) >> fatal);
+		expect(eq(pooled.getPoolSize(), 4));
+
+		const auto connectionId = [](MYSQL* handle) {
+			return mysql_thread_id(handle);
+		};
+
+		{
+			const Database::ConnectionLease first(pooled);
+			const Database::ConnectionLease second(pooled);
+			expect(neq(connectionId(first.get()), connectionId(second.get())));
+			expect(eq(pooled.getIdleConnections(), 2));
+		}
+		expect(eq(pooled.getIdleConnections(), 4));
+
+		// A single thread keeps getting the connection it handed back last
+		MYSQL* last = Database::ConnectionLease(pooled).get();
+		expect(eq(connectionId(Database::ConnectionLease(pooled).get()), connectionId(last)));
+	};
+
+	test("Database pool keeps the last insert id per thread") = [&dbConfig] {
+		Database pooled {};
+		expect(pooled.connect(&dbConfig.host, &dbConfig.user, &dbConfig.password, &dbConfig.database, dbConfig.port, &dbConfig.sock, 4) >> fatal);
+		pooled.executeQuery("CREATE TEMPORARY TABLE `pool_test` (`id` INT AUTO_INCREMENT PRIMARY KEY, `value` INT)");
+		pooled.executeQuery("INSERT INTO `pool_test` (`value`) VALUES (1), (2)");
+		expect(eq(pooled.getLastInsertId(), 1));
+
+		uint64_t otherThreadId = 42;
+		std::thread([&pooled, &otherThreadId] { otherThreadId = pooled.getLastInsertId(); }).join();
+		expect(eq(otherThreadId, 0));
+	};
+
+	test("Database prepared statements bind and read values in the binary protocol") = databaseTest(db, [&db] {
+		createAccount(db);
+
+		const std::string email = "@test";
+		const auto byEmail = db.storeQuery(DBStatement("SELECT `id`, `email`, `premdays`, `creation` FROM `accounts` WHERE `email` = ?").bind(email));
+		expect(eq(byEmail != nullptr, true) >> fatal);
+		expect(eq(byEmail->getNumber<uint32_t>(0), 111));
+		expect(eq(byEmail->getString(1), email));
+		expect(eq(byEmail->getNumber<uint32_t>("premdays"), 11));
+		expect(eq(byEmail->getNumber<int64_t>(3), 42183281));
+
+		const std::string blob("\0'\x01\"", 4);
+		db.executeQuery("CREATE TEMPORARY TABLE `statement_test` (`id` INT UNSIGNED AUTO_INCREMENT PRIMARY KEY, `value` BIGINT, `data` BLOB)");
+		expect(db.executeQuery(DBStatement("INSERT INTO `statement_test` (`value`, `data`) VALUES (?, ?)").bind(int64_t { -5 }).bindBlob(blob.data(), blob.size())));
+		expect(eq(db.getLastInsertId(), 1));
+
+		const auto stored = db.storeQuery(DBStatement("SELECT `value`, `data` FROM `statement_test` WHERE `id` = ?").bind(1));
+		expect(eq(stored != nullptr, true) >> fatal);
+		expect(eq(stored->getNumber<int64_t>(0), -5));
+		unsigned long size;
+		const char* data = stored->getStream(1, size);
+		expect(eq(std::string(data, size), blob));
+
+		expect(db.storeQuery(DBStatement("SELECT `id` FROM `statement_test` WHERE `id` = ?").bind(2)) == nullptr);
+	});
 }
@@ -0,0 +1,77 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "config/configmanager.hpp"
+#include "injection_fixture.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	void writeConfig(const std::string &path, int32_t maxPlayers, int32_t gamePort) {
+		std::ofstream file(path, std::ios::trunc);
+		file << "maxPlayers = " << maxPlayers << "\n";
+		file << "serverName = \"" << maxPlayers << "\"\n";
+		file << "gameProtocolPort = " << gamePort << "\n";
+	}
+}
+
+suite<"config"> configManagerTest = [] {
+	InjectionFixture injectionFixture {};
+	const auto path = (std::filesystem::temp_directory_path() / "canary_configmanager_test.lua").string();
+
+	test("ConfigManager publishes a new snapshot on every load") = [&path] {
+		ConfigManager config;
+		config.setConfigFileLua(path);
+		expect(eq(config.getNumber(MAX_PLAYERS), 0));
+
+		writeConfig(path, 50, 7000);
+		expect(config.load());
+		const auto &first = config.getSnapshot();
+		expect(eq(config.getNumber(MAX_PLAYERS), 50));
+		expect(eq(config.getString(SERVER_NAME), std::string { "50" }));
+		expect(eq(config.getNumber(GAME_PORT), 7000));
+		// Wrong type
+		expect(eq(config.getBoolean(MAX_PLAYERS), false));
+
+		writeConfig(path, 80, 7100);
+		expect(config.load());
+		expect(eq(config.getNumber(MAX_PLAYERS), 80));
+		// Only read by the first load
+		expect(eq(config.getNumber(GAME_PORT), 7000));
+
+		// The old snapshot did not change under its readers
+		expect(eq(first.getNumber(MAX_PLAYERS), 50));
+		expect(eq(first.getString(SERVER_NAME), std::string { "50" }));
+	};
+
+	test("ConfigManager readers never see a half loaded snapshot") = [&path] {
+		ConfigManager config;
+		config.setConfigFileLua(path);
+		writeConfig(path, 0, 7000);
+		expect(config.load());
+
+		std::atomic_bool done = false;
+		size_t torn = 0;
+		std::jthread reader([&] {
+			while (!done.load(std::memory_order_acquire)) {
+				const auto &snapshot = config.getSnapshot();
+				if (std::to_string(snapshot.getNumber(MAX_PLAYERS)) != snapshot.getString(SERVER_NAME)) {
+					++torn;
+				}
+			}
+		});
+
+		for (int32_t i = 1; i <= 100; ++i) {
+			writeConfig(path, i, 7000);
+			config.load();
+		}
+		done.store(true, std::memory_order_release);
+		reader.join();
+
+		expect(eq(torn, size_t { 0 }));
+		expect(eq(config.getNumber(MAX_PLAYERS), 100));
+	};
+
+	std::filesystem::remove(path);
+};
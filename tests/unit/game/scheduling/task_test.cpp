@@ -0,0 +1,101 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/scheduling/task.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// Only allocations made by the thread that enabled counting are recorded
+	thread_local bool countAllocations = false;
+	thread_local size_t allocations = 0;
+
+	class AllocationCounter {
+	public:
+		AllocationCounter() {
+			allocations = 0;
+			countAllocations = true;
+		}
+
+		~AllocationCounter() {
+			countAllocations = false;
+		}
+
+		[[nodiscard]] size_t count() const {
+			return allocations;
+		}
+	};
+}
+
+void* operator new(std::size_t size) {
+	if (countAllocations) {
+		++allocations;
+	}
+
+	if (auto* p = std::malloc(size == 0 ? 1 : size)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+suite<"scheduling"> taskTest = [] {
+	test("TaskFunction keeps small callables inline") = [] {
+		uint32_t creatureId = 0x10000001;
+		auto sharedState = std::make_shared<int>(0);
+
+		AllocationCounter counter;
+		TaskFunction f = [creatureId, sharedState] { *sharedState += static_cast<int>(creatureId & 0xFF); };
+		TaskFunction moved = std::move(f);
+		moved();
+
+		expect(eq(counter.count(), size_t { 0 }));
+		expect(f == nullptr);
+		expect(static_cast<bool>(moved));
+		expect(eq(*sharedState, 1));
+	};
+
+	test("TaskFunction falls back to the heap for oversized callables") = [] {
+		std::array<uint64_t, 16> payload {};
+		payload.fill(1);
+
+		AllocationCounter counter;
+		TaskFunction f = [payload] { (void)payload; };
+		TaskFunction moved = std::move(f);
+		moved = nullptr;
+
+		expect(eq(counter.count(), size_t { 1 }));
+	};
+
+	test("Task construction and moves do not allocate") = [] {
+		uint32_t creatureId = 0x10000001;
+
+		AllocationCounter counter;
+		Task task(0, [creatureId] { (void)creatureId; }, "Game::checkCreatureWalk");
+		Task moved(std::move(task));
+
+		expect(eq(counter.count(), size_t { 0 }));
+		expect(eq(moved.getContext(), std::string_view { "Game::checkCreatureWalk" }));
+	};
+
+	test("Scheduled tasks reuse pooled nodes in steady state") = [] {
+		// Warms the pool up, the first node has to come from the allocator
+		Task::create([] { }, "Task::warmUp", 100).reset();
+
+		AllocationCounter counter;
+		for (int i = 0; i < 1000; ++i) {
+			auto task = Task::create([i] { (void)i; }, "Game::checkCreatures", 100, true);
+			expect(task->isCycle());
+		}
+
+		expect(eq(counter.count(), size_t { 0 }));
+	};
+};
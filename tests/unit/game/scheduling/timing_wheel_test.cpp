@@ -0,0 +1,76 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/scheduling/timing_wheel.hpp"
+
+using namespace boost::ut;
+
+suite<"scheduling"> timingWheelTest = [] {
+	constexpr int64_t start = 1700000000123;
+
+	test("TimingWheel expires timers in order, including far and overflowed ones") = [] {
+		TimerSlots slots;
+		TimingWheel wheel(slots);
+		wheel.start(start);
+
+		const std::vector<int64_t> delays { 1, 63, 64, 65, 4095, 4096, 300000, 2000, 5, 1LL << 31, 1LL << 36 };
+		std::map<uint32_t, int64_t> expiries;
+		for (const auto delay : delays) {
+			const auto eventId = slots.acquire();
+			expect(neq(eventId, uint64_t { 0 }));
+			wheel.insert(TimerSlots::indexOf(eventId), start + delay);
+			expiries[TimerSlots::indexOf(eventId)] = start + delay;
+		}
+
+		std::vector<uint32_t> expired;
+		std::vector<int64_t> fired;
+		for (auto now = start; !wheel.empty(); now = wheel.nextExpiration()) {
+			expired.clear();
+			wheel.advance(now, expired);
+			for (const auto index : expired) {
+				expect(le(expiries[index], now));
+				fired.emplace_back(expiries[index]);
+			}
+		}
+
+		expect(eq(delays.size(), fired.size()));
+		expect(std::ranges::is_sorted(fired));
+	};
+
+	test("TimerSlots invalidates cancelled and released event ids") = [] {
+		TimerSlots slots;
+
+		const auto eventId = slots.acquire();
+		expect(slots.isActive(eventId));
+		expect(slots.cancel(eventId));
+		expect(!slots.isActive(eventId));
+		expect(!slots.cancel(eventId)) << "an event can only be cancelled once";
+
+		slots.release(eventId);
+		const auto reusedId = slots.acquire();
+		expect(eq(TimerSlots::indexOf(eventId), TimerSlots::indexOf(reusedId))) << "released slots are reused";
+		expect(neq(eventId, reusedId)) << "a reused slot gets a new generation";
+		expect(!slots.cancel(eventId)) << "stale ids do not affect the new event";
+		expect(slots.isActive(reusedId));
+	};
+
+	test("TimingWheel::remove unlinks a pending timer") = [] {
+		TimerSlots slots;
+		TimingWheel wheel(slots);
+		wheel.start(start);
+
+		const auto kept = slots.acquire();
+		const auto removed = slots.acquire();
+		wheel.insert(TimerSlots::indexOf(kept), start + 100);
+		wheel.insert(TimerSlots::indexOf(removed), start + 50);
+		wheel.remove(TimerSlots::indexOf(removed));
+
+		expect(eq(size_t { 1 }, wheel.size()));
+		expect(le(wheel.nextExpiration(), start + 100));
+
+		std::vector<uint32_t> expired;
+		wheel.advance(start + 100, expired);
+		expect(eq(std::vector<uint32_t> { TimerSlots::indexOf(kept) }, expired));
+	};
+};
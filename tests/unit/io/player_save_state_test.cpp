@@ -0,0 +1,79 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "injection_fixture.hpp"
+#include "io/functions/player_save_state.hpp"
+
+using namespace boost::ut;
+
+suite<"io"> playerSaveStateTest = [] {
+	InjectionFixture fixture;
+
+	test("PlayerSaveState skips sections whose rows did not change since the last commit") = [] {
+		PlayerSaveState saveState;
+		expect(saveState.stage(PlayerSaveSection_t::Items, 42, 100));
+		expect(saveState.stage(PlayerSaveSection_t::Stash, 7, 20));
+		saveState.commit();
+		expect(eq(saveState.getLastSave().written, uint8_t { 2 }));
+		expect(eq(saveState.getLastSave().bytes, size_t { 120 }));
+
+		expect(!saveState.stage(PlayerSaveSection_t::Items, 42, 100));
+		expect(saveState.stage(PlayerSaveSection_t::Stash, 8, 20));
+		saveState.commit();
+		expect(eq(saveState.getLastSave().written, uint8_t { 1 }));
+		expect(eq(saveState.getLastSave().skipped, uint8_t { 1 }));
+		expect(eq(saveState.getLastSave().bytes, size_t { 20 }));
+	};
+
+	test("PlayerSaveState keeps the last committed rows when a save rolls back") = [] {
+		PlayerSaveState saveState;
+		expect(saveState.stage(PlayerSaveSection_t::Inbox, 1, 10));
+		saveState.discard();
+		// Never committed, still unknown
+		expect(saveState.stage(PlayerSaveSection_t::Inbox, 1, 10));
+		saveState.commit();
+
+		expect(saveState.stage(PlayerSaveSection_t::Inbox, 2, 10));
+		saveState.discard();
+		expect(!saveState.stage(PlayerSaveSection_t::Inbox, 1, 10));
+	};
+
+	test("PlayerSaveState takes the storage of the load and of each committed save") = [] {
+		PlayerSaveState saveState;
+		expect(!saveState.hasSavedStorage());
+
+		saveState.stage(PlayerSaveSection_t::Items, 1, 10);
+		saveState.commit();
+		saveState.onLoad({ { 1000, 1 }, { 1001, 2 } });
+		expect(saveState.hasSavedStorage());
+		// Loading forgets the other sections
+		expect(saveState.stage(PlayerSaveSection_t::Items, 1, 10));
+
+		saveState.stageStorage({ { 1000, 1 }, { 1001, 3 } }, true, 12);
+		saveState.discard();
+		expect(eq(saveState.getSavedStorage().at(1001), 2));
+
+		saveState.stageStorage({ { 1000, 1 }, { 1001, 3 } }, true, 12);
+		saveState.commit();
+		expect(eq(saveState.getSavedStorage().at(1001), 3));
+		expect(eq(saveState.getLastSave().bytes, size_t { 12 }));
+	};
+
+	test("PlayerSaveState tells a snapshot older than the last written one") = [] {
+		PlayerSaveState saveState;
+		const auto first = saveState.nextSnapshot();
+		const auto second = saveState.nextSnapshot();
+		expect(second > first);
+		expect(!saveState.isStale(first));
+
+		// The later snapshot is written first, the earlier one would roll the player back
+		saveState.commit(second);
+		expect(saveState.isStale(first));
+		expect(saveState.isStale(second));
+		expect(!saveState.isStale(saveState.nextSnapshot()));
+
+		saveState.commit(first);
+		expect(saveState.isStale(second));
+	};
+};
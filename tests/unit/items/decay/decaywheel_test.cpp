@@ -0,0 +1,90 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "items/decay/decaywheel.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	struct DecayingItem {
+		explicit DecayingItem(int64_t timestamp) :
+			timestamp(timestamp) { }
+
+		DecayHandle &getDecayHandle() {
+			return handle;
+		}
+
+		int64_t timestamp;
+		DecayHandle handle;
+	};
+
+	using Wheel = DecayWheel<DecayingItem>;
+	constexpr int64_t START = 1700000000000;
+}
+
+suite<"decay"> decayWheelTest = [] {
+	test("DecayWheel expires items at most one slot late, never early") = [] {
+		auto wheel = std::make_unique<Wheel>();
+		std::mt19937 rng(17);
+		// Up to a bit over a day: first level, second level and clamped past it
+		std::uniform_int_distribution<int64_t> duration(0, 90000000);
+
+		std::vector<std::shared_ptr<DecayingItem>> items;
+		for (int i = 0; i < 20000; ++i) {
+			const auto &item = items.emplace_back(std::make_shared<DecayingItem>(START + duration(rng)));
+			wheel->add(item, item->timestamp, START);
+		}
+		expect(eq(wheel->size(), items.size()));
+
+		size_t early = 0;
+		size_t late = 0;
+		size_t expired = 0;
+		std::vector<std::shared_ptr<DecayingItem>> batch;
+		for (int64_t now = START; !wheel->empty(); now = std::max(now + Wheel::SLOT_DURATION, wheel->getNextCheck())) {
+			batch.clear();
+			wheel->advance(now, batch);
+			for (const auto &item : batch) {
+				expect(!item->handle.isQueued());
+				early += item->timestamp > now ? 1 : 0;
+				late += now - item->timestamp > Wheel::SLOT_DURATION ? 1 : 0;
+			}
+			expired += batch.size();
+		}
+
+		expect(eq(expired, items.size()));
+		expect(eq(early, size_t { 0 }));
+		expect(eq(late, size_t { 0 }));
+	};
+
+	test("DecayWheel removes and re-adds items in any slot") = [] {
+		auto wheel = std::make_unique<Wheel>();
+		std::vector<std::shared_ptr<DecayingItem>> items;
+		for (int64_t i = 0; i < 1000; ++i) {
+			const auto &item = items.emplace_back(std::make_shared<DecayingItem>(START + (i % 10) * 100000));
+			wheel->add(item, item->timestamp, START);
+		}
+
+		// Every other one stops decaying, a few start again later
+		for (size_t i = 0; i < items.size(); i += 2) {
+			expect(wheel->remove(items[i]));
+			expect(!wheel->remove(items[i]));
+		}
+		for (size_t i = 0; i < items.size(); i += 10) {
+			items[i]->timestamp = START + 5000;
+			wheel->add(items[i], items[i]->timestamp, START);
+		}
+		expect(eq(wheel->size(), size_t { 600 }));
+
+		std::vector<std::shared_ptr<DecayingItem>> expired;
+		wheel->advance(START + 4950, expired);
+		expect(expired.empty());
+		wheel->advance(START + 5000, expired);
+		expect(eq(expired.size(), size_t { 100 }));
+
+		wheel->advance(START + 1000000, expired);
+		expect(wheel->empty());
+		expect(eq(expired.size(), size_t { 600 }));
+		expect(eq(wheel->getNextCheck(), int64_t { 0 }));
+	};
+};
@@ -0,0 +1,97 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "injection_fixture.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "lib/thread/thread_pool.hpp"
+#include "map/utils/pathfinder.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// Walks 'steps' tiles east, or finds nothing for negative values
+	PathFinder::Search walkEast(int steps) {
+		return [steps](std::vector<Direction> &dirList) {
+			if (steps < 0) {
+				return false;
+			}
+			dirList.assign(static_cast<size_t>(steps), DIRECTION_EAST);
+			return true;
+		};
+	}
+}
+
+suite<"map"> pathFinderTest = [] {
+	InjectionFixture fixture;
+	ThreadPool threadPool(fixture.logger());
+	Dispatcher dispatcher(threadPool);
+
+	test("PathFinder batches requests and delivers them in request order") = [&] {
+		PathFinder pathFinder(dispatcher);
+		pathFinder.setDeterministic(true);
+
+		std::vector<std::pair<bool, size_t>> results;
+		for (const auto steps : { 3, -1, 0, 5 }) {
+			pathFinder.request(
+				walkEast(steps),
+				[&results](bool found, const std::vector<Direction> &dirList) {
+					results.emplace_back(found, dirList.size());
+				},
+				"test"
+			);
+		}
+
+		expect(eq(pathFinder.getPendingRequests(), size_t { 4 }));
+		expect(results.empty());
+
+		expect(eq(pathFinder.flush(), size_t { 4 }));
+		expect(eq(pathFinder.getPendingRequests(), size_t { 0 }));
+		expect(results == std::vector<std::pair<bool, size_t>> { { true, 3 }, { false, 0 }, { true, 0 }, { true, 5 } });
+	};
+
+	test("PathFinder leaves paths requested by callbacks to the next batch") = [&] {
+		PathFinder pathFinder(dispatcher);
+		pathFinder.setDeterministic(true);
+
+		size_t delivered = 0;
+		pathFinder.request(
+			walkEast(1),
+			[&](bool, const std::vector<Direction> &) {
+				++delivered;
+				pathFinder.request(walkEast(2), [&](bool, const std::vector<Direction> &) { ++delivered; }, "test");
+			},
+			"test"
+		);
+
+		expect(eq(pathFinder.flush(), size_t { 1 }));
+		expect(eq(delivered, size_t { 1 }));
+		expect(eq(pathFinder.flush(), size_t { 1 }));
+		expect(eq(delivered, size_t { 2 }));
+		expect(eq(pathFinder.flush(), size_t { 0 }));
+	};
+
+	test("PathFinder runs a batch on the thread pool and hands the results to the dispatcher") = [&] {
+		PathFinder pathFinder(dispatcher);
+
+		static constexpr size_t REQUESTS = 64;
+		std::vector<std::atomic_bool> searched(REQUESTS);
+		size_t delivered = 0;
+		for (size_t i = 0; i < REQUESTS; ++i) {
+			pathFinder.request(
+				[&searched, i](std::vector<Direction> &dirList) {
+					searched[i] = true;
+					dirList.emplace_back(DIRECTION_NORTH);
+					return true;
+				},
+				[&delivered](bool, const std::vector<Direction> &) { ++delivered; },
+				"test"
+			);
+		}
+
+		expect(eq(pathFinder.flush(), REQUESTS));
+		expect(std::ranges::all_of(searched, [](const auto &value) { return value.load(); }));
+		// Delivered by the dispatcher thread, which isn't running here
+		expect(eq(delivered, size_t { 0 }));
+	};
+};
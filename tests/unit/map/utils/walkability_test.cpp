@@ -0,0 +1,147 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include <appearances.pb.h>
+
+#include "creatures/npcs/npc.hpp"
+#include "creatures/npcs/npcs.hpp"
+#include "game/game.hpp"
+#include "injection_fixture.hpp"
+#include "items/item.hpp"
+#include "items/tile.hpp"
+#include "map/map.hpp"
+#include "map/utils/walkability.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr uint16_t TILE_X = 1000;
+	constexpr uint16_t TILE_Y = 1000;
+	constexpr uint8_t FLOOR = 7;
+	constexpr uint16_t GROUND_ID = 100;
+
+	// A single ground item type, registered the way the appearances file does it
+	void registerGround() {
+		auto &appearances = g_game().m_appearancesPtr;
+		appearances = std::make_unique<Canary::protobuf::appearances::Appearances>();
+		auto* ground = appearances->add_object();
+		ground->set_id(GROUND_ID);
+		ground->mutable_flags()->mutable_bank()->set_waypoints(150);
+		Item::items.loadFromProtobuf();
+	}
+
+	std::shared_ptr<Tile> placeTile(Map &map) {
+		auto tile = std::make_shared<DynamicTile>(TILE_X, TILE_Y, FLOOR);
+		map.setTile(TILE_X, TILE_Y, FLOOR, tile);
+		return tile;
+	}
+}
+
+suite<"map"> walkabilityTest = [] {
+	test("WalkabilityMap keeps one bit per tile and layer") = [] {
+		WalkabilityMap walkability;
+		expect(eq(walkability.get(1000, 1000), uint8_t { WALKABILITY_NONE }));
+
+		walkability.set(1003, 1005, WALKABILITY_BLOCKSOLID | WALKABILITY_BLOCKPROJECTILE);
+		walkability.set(1004, 1005, WALKABILITY_CREATURE);
+		expect(eq(walkability.get(1003, 1005), uint8_t { WALKABILITY_BLOCKSOLID | WALKABILITY_BLOCKPROJECTILE }));
+		expect(eq(walkability.get(1004, 1005), uint8_t { WALKABILITY_CREATURE }));
+		expect(eq(walkability.get(1003, 1004), uint8_t { WALKABILITY_NONE }));
+
+		// Rows are indexed inside the sector, bit n being x = n
+		expect(eq(walkability.getRow(WALKABILITY_BLOCKPROJECTILE, 1005), WalkabilityMap::Row { 1 << (1003 & SECTOR_MASK) }));
+		expect(eq(walkability.getRow(WALKABILITY_CREATURE, 1005), WalkabilityMap::Row { 1 << (1004 & SECTOR_MASK) }));
+
+		walkability.set(1003, 1005, WALKABILITY_BLOCKPROJECTILE);
+		expect(eq(walkability.get(1003, 1005), uint8_t { WALKABILITY_BLOCKPROJECTILE }));
+		expect(eq(walkability.getRow(WALKABILITY_BLOCKSOLID, 1005), WalkabilityMap::Row { 0 }));
+	};
+
+	test("WalkabilityMap leaves the unloaded layer to the map cache") = [] {
+		WalkabilityMap walkability;
+		walkability.setUnloaded(1002, 1001, true);
+		// The tile bits are written by the tile created from the cache, before the position is loaded
+		walkability.set(1002, 1001, WALKABILITY_NOPATH);
+		expect(eq(walkability.get(1002, 1001), uint8_t { WALKABILITY_UNLOADED }));
+		expect(eq(walkability.getRow(WALKABILITY_UNLOADED, 1001), WalkabilityMap::Row { 1 << (1002 & SECTOR_MASK) }));
+
+		walkability.setUnloaded(1002, 1001, false);
+		expect(eq(walkability.get(1002, 1001), uint8_t { WALKABILITY_NOPATH }));
+	};
+
+	test("Tile flags reach the walkability of its floor") = [] {
+		InjectionFixture fixture;
+		Map map;
+		const auto tile = placeTile(map);
+		// No ground yet
+		expect(eq(map.getWalkability(TILE_X, TILE_Y, FLOOR), uint8_t { WALKABILITY_NOPATH }));
+
+		tile->setFlag(TILESTATE_BLOCKSOLID | TILESTATE_PROTECTIONZONE);
+		expect(eq(map.getWalkability(TILE_X, TILE_Y, FLOOR), uint8_t { WALKABILITY_NOPATH | WALKABILITY_BLOCKSOLID | WALKABILITY_PROTECTIONZONE }));
+
+		tile->resetFlag(TILESTATE_BLOCKSOLID);
+		tile->setFlag(TILESTATE_BLOCKPROJECTILE);
+		expect(eq(map.getWalkability(TILE_X, TILE_Y, FLOOR), uint8_t { WALKABILITY_NOPATH | WALKABILITY_BLOCKPROJECTILE | WALKABILITY_PROTECTIONZONE }));
+
+		tile->resetFlag(TILESTATE_BLOCKPROJECTILE | TILESTATE_PROTECTIONZONE);
+		expect(eq(map.getWalkability(TILE_X, TILE_Y, FLOOR), uint8_t { WALKABILITY_NOPATH }));
+	};
+
+	test("Adding and removing the ground of a tile updates its walkability") = [] {
+		InjectionFixture fixture;
+		registerGround();
+		Map map;
+		const auto tile = placeTile(map);
+
+		const auto ground = std::make_shared<Item>(GROUND_ID);
+		tile->internalAddThing(ground);
+		expect(eq(map.getWalkability(TILE_X, TILE_Y, FLOOR), uint8_t { WALKABILITY_NONE }));
+
+		tile->removeThing(ground, 0);
+		expect(eq(map.getWalkability(TILE_X, TILE_Y, FLOOR), uint8_t { WALKABILITY_NOPATH }));
+	};
+
+	test("Creatures entering and leaving a tile update its walkability") = [] {
+		InjectionFixture fixture;
+		Map map;
+		const auto tile = placeTile(map);
+		const auto npc = std::make_shared<Npc>(std::make_shared<NpcType>("walkability test"));
+
+		const auto hasCreature = [&map] {
+			return (map.getWalkability(TILE_X, TILE_Y, FLOOR) & WALKABILITY_CREATURE) != 0;
+		};
+
+		tile->internalAddThing(npc);
+		expect(hasCreature());
+		tile->removeThing(npc, 0);
+		expect(!hasCreature());
+
+		// Map::moveCreature path
+		tile->addThing(npc);
+		expect(hasCreature());
+		tile->removeThing(npc, 0);
+		expect(!hasCreature());
+	};
+
+	test("Floor::setTile binds the new tile and releases the replaced one") = [] {
+		InjectionFixture fixture;
+		Map map;
+		const auto first = placeTile(map);
+		first->setFlag(TILESTATE_BLOCKSOLID);
+		expect(eq(map.getWalkability(TILE_X, TILE_Y, FLOOR), uint8_t { WALKABILITY_NOPATH | WALKABILITY_BLOCKSOLID }));
+
+		const auto second = placeTile(map);
+		expect(eq(map.getWalkability(TILE_X, TILE_Y, FLOOR), uint8_t { WALKABILITY_NOPATH }));
+
+		// The replaced tile no longer writes into the floor
+		first->setFlag(TILESTATE_BLOCKPATH);
+		expect(eq(map.getWalkability(TILE_X, TILE_Y, FLOOR), uint8_t { WALKABILITY_NOPATH }));
+
+		second->setFlag(TILESTATE_BLOCKPATH);
+		expect(eq(map.getWalkability(TILE_X, TILE_Y, FLOOR), uint8_t { WALKABILITY_NOPATH | WALKABILITY_BLOCKPATH }));
+
+		map.setTile(TILE_X, TILE_Y, FLOOR, nullptr);
+		expect(eq(map.getWalkability(TILE_X, TILE_Y, FLOOR), uint8_t { WALKABILITY_NONE }));
+	};
+};
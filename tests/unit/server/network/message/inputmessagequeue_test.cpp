@@ -0,0 +1,136 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "server/network/message/inputmessagequeue.hpp"
+#include "server/network/message/networkmessage.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	struct RecordedMessage {
+		uint16_t position;
+		uint16_t length;
+		std::vector<uint8_t> payload;
+	};
+
+	// Stands in for a capture of client traffic: mostly tiny walk/turn/ping packets,
+	// some chat sized ones and the occasional message as big as a client may send
+	std::vector<RecordedMessage> recordStream(size_t count) {
+		std::mt19937 rng(25);
+		std::uniform_int_distribution<int> kind(0, 99);
+		std::uniform_int_distribution<int> byte(0, 255);
+
+		std::vector<RecordedMessage> stream(count);
+		for (auto &message : stream) {
+			const auto roll = kind(rng);
+			size_t size = 1 + roll % 8;
+			if (roll >= 99) {
+				size = INPUTMESSAGE_MAXSIZE;
+			} else if (roll >= 90) {
+				size = 64 + roll * 3;
+			}
+
+			// Decrypted messages are read right after the headers
+			message.position = NetworkMessage::INITIAL_BUFFER_POSITION;
+			message.length = static_cast<uint16_t>(size);
+			message.payload.resize(size);
+			for (auto &value : message.payload) {
+				value = static_cast<uint8_t>(byte(rng));
+			}
+		}
+		return stream;
+	}
+
+	void load(NetworkMessage &msg, const RecordedMessage &message) {
+		msg.reset();
+		msg.setBufferPosition(message.position);
+		msg.setLength(message.length);
+		std::ranges::copy(message.payload, msg.getBuffer() + message.position);
+	}
+
+	bool matches(NetworkMessage &msg, const RecordedMessage &message) {
+		if (msg.getBufferPosition() != message.position || msg.getLength() != message.length) {
+			return false;
+		}
+		return std::equal(message.payload.begin(), message.payload.end(), msg.getBuffer() + message.position);
+	}
+}
+
+suite<"networkmessage"> inputMessageQueueTest = [] {
+	test("InputMessageQueue restores the unread part of a message") = [] {
+		InputMessageQueue queue;
+		NetworkMessage in;
+		in.addByte(0x64);
+		in.add<uint16_t>(1000);
+		in.addString("hello");
+		in.setBufferPosition(NetworkMessage::INITIAL_BUFFER_POSITION + 1);
+
+		expect(queue.push(in));
+		expect(eq(queue.size(), size_t { 1 }));
+
+		NetworkMessage out;
+		expect(queue.pop(out));
+		expect(eq(out.get<uint16_t>(), uint16_t { 1000 }));
+		expect(eq(out.getString(), std::string { "hello" }));
+		expect(!out.canRead(1));
+		expect(queue.empty());
+		expect(!queue.pop(out));
+	};
+
+	test("InputMessageQueue stops accepting messages when it is full") = [] {
+		InputMessageQueue queue;
+		NetworkMessage msg;
+		load(msg, { NetworkMessage::INITIAL_BUFFER_POSITION, 1, { 0x1E } });
+
+		size_t accepted = 0;
+		while (queue.hasRoom()) {
+			expect(queue.push(msg));
+			++accepted;
+		}
+
+		expect(eq(accepted, size_t { InputMessageQueue::MAX_MESSAGES }));
+		expect(!queue.push(msg));
+
+		NetworkMessage out;
+		expect(queue.pop(out));
+		expect(queue.hasRoom());
+	};
+
+	test("InputMessageQueue soak: replayed stream arrives complete and in order") = [] {
+		constexpr size_t MESSAGES = 200000;
+		const auto stream = recordStream(MESSAGES);
+
+		InputMessageQueue queue;
+
+		// Same protocol as the connection: the reader stops while the queue has no room for the biggest message
+		std::jthread reader([&] {
+			NetworkMessage msg;
+			for (const auto &message : stream) {
+				while (!queue.hasRoom()) {
+					std::this_thread::yield();
+				}
+				load(msg, message);
+				queue.push(msg);
+			}
+		});
+
+		NetworkMessage msg;
+		size_t received = 0;
+		size_t mismatches = 0;
+		while (received < MESSAGES) {
+			if (!queue.pop(msg)) {
+				std::this_thread::yield();
+				continue;
+			}
+			if (!matches(msg, stream[received])) {
+				++mismatches;
+			}
+			++received;
+		}
+		reader.join();
+
+		expect(eq(mismatches, size_t { 0 }));
+		expect(queue.empty());
+	};
+};
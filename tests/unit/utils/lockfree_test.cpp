@@ -0,0 +1,50 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/lockfree.hpp"
+
+using namespace boost::ut;
+
+suite<"utils"> spscQueueTest = [] {
+	test("SPSCQueue keeps FIFO order and rejects pushes when full") = [] {
+		SPSCQueue<std::string, 4> queue;
+		for (int i = 0; i < 4; ++i) {
+			expect(queue.try_emplace(std::to_string(i)));
+		}
+
+		std::string overflow = "overflow";
+		expect(!queue.try_emplace(std::move(overflow)));
+		expect(eq(std::string { "overflow" }, overflow)) << "rejected argument must not be moved from";
+
+		std::vector<std::string> consumed;
+		expect(eq(4, queue.consume_all([&consumed](std::string &&value) { consumed.emplace_back(std::move(value)); })));
+		expect(eq(std::vector<std::string> { "0", "1", "2", "3" }, consumed));
+		expect(queue.empty());
+	};
+
+	test("SPSCQueue delivers every element across threads") = [] {
+		constexpr size_t total = 100000;
+		SPSCQueue<size_t, 256> queue;
+
+		std::jthread producer([&queue] {
+			for (size_t i = 0; i < total; ++i) {
+				while (!queue.try_emplace(i)) {
+					std::this_thread::yield();
+				}
+			}
+		});
+
+		size_t expected = 0;
+		bool ordered = true;
+		while (expected < total) {
+			queue.consume_all([&expected, &ordered](size_t &&value) {
+				ordered = ordered && value == expected;
+				++expected;
+			});
+		}
+
+		expect(ordered);
+		expect(eq(total, expected));
+	};
+};
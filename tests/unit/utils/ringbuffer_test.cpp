@@ -0,0 +1,51 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/ringbuffer.hpp"
+
+using namespace boost::ut;
+
+suite<"utils"> ringBufferTest = [] {
+	test("ring_buffer keeps FIFO order while it wraps around and grows") = [] {
+		stdext::ring_buffer<int> buffer;
+		std::vector<int> popped;
+		int next = 0;
+
+		// Pops lag behind pushes so the head moves around the ring several times before it has to grow
+		for (int round = 0; round < 50; ++round) {
+			for (int i = 0; i < 3 + round % 5; ++i) {
+				buffer.push_back(next++);
+			}
+			for (int i = 0; i < 3 && !buffer.empty(); ++i) {
+				popped.emplace_back(buffer.front());
+				buffer.pop_front();
+			}
+		}
+
+		expect(eq(buffer.size(), static_cast<size_t>(next) - popped.size()));
+		for (size_t i = 0; i < buffer.size(); ++i) {
+			expect(eq(buffer[i], static_cast<int>(popped.size() + i)));
+		}
+		while (!buffer.empty()) {
+			popped.emplace_back(buffer.front());
+			buffer.pop_front();
+		}
+
+		std::vector<int> expected(next);
+		std::iota(expected.begin(), expected.end(), 0);
+		expect(eq(expected, popped));
+		expect(std::has_single_bit(buffer.capacity()));
+	};
+
+	test("ring_buffer releases popped elements right away") = [] {
+		stdext::ring_buffer<std::shared_ptr<int>> buffer;
+		auto value = std::make_shared<int>(7);
+		buffer.push_back(value);
+		expect(eq(value.use_count(), 2));
+
+		buffer.pop_front();
+		expect(eq(value.use_count(), 1));
+		expect(buffer.empty());
+	};
+};